@@ -0,0 +1,23 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive :enable
+#include "constants.h"
+
+layout(location = 0) in vec3 inPosition;
+
+// per instance
+layout(location = 3) in mat4 inModel;
+layout(location = 7) in vec4 inColor;
+
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 proj_view_matrix;
+} ubo;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+void main() {
+    gl_Position = ubo.proj_view_matrix * inModel * vec4(inPosition, 1.0);
+    fragColor = inColor;
+    fragTexCoord = vec2(-1.0, -1.0);
+}
@@ -60,6 +60,7 @@ layout(location = 0) out vec3 out_world_position; // output in framebuffer 0 for
 layout(location = 1) out vec3 out_normal;
 layout(location = 2) out vec3 out_tangent;
 layout(location = 3) out vec2 out_texcoord;
+layout(location = 4) flat out highp uint out_material_index; // only read by the bindless material shaders
 
 void main()
 {
@@ -126,4 +127,6 @@ void main()
     out_tangent           = normalize(tangent_matrix * model_tangent);
 
     out_texcoord = in_texcoord;
+
+    out_material_index = mesh_instances[gl_InstanceIndex].material_index;
 }
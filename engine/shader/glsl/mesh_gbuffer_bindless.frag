@@ -0,0 +1,60 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+#include "constants.h"
+#include "gbuffer.h"
+
+#include "bindless_material.h"
+
+// read in fragnormal (from vertex shader)
+layout(location = 0) in highp vec3 in_world_position;
+layout(location = 1) in highp vec3 in_normal;
+layout(location = 2) in highp vec3 in_tangent;
+layout(location = 3) in highp vec2 in_texcoord;
+layout(location = 4) flat in highp uint in_material_index;
+
+// output screen color to location 0
+layout(location = 0) out highp vec4 out_gbuffer_a;
+layout(location = 1) out highp vec4 out_gbuffer_b;
+layout(location = 2) out highp vec4 out_gbuffer_c;
+// layout(location = 3) out highp vec4 out_scene_color;
+
+highp vec3 getBasecolor(BindlessMaterial material)
+{
+    highp vec3 basecolor =
+        sampleMaterialTexture(material.base_color_texture_index, in_texcoord).xyz * material.baseColorFactor.xyz;
+    return basecolor;
+}
+
+highp vec3 calculateNormal(BindlessMaterial material)
+{
+    highp vec3 tangent_normal = sampleMaterialTexture(material.normal_texture_index, in_texcoord).xyz * 2.0 - 1.0;
+
+    highp vec3 N = normalize(in_normal);
+    highp vec3 T = normalize(in_tangent.xyz);
+    highp vec3 B = normalize(cross(N, T));
+
+    highp mat3 TBN = mat3(T, B, N);
+    return normalize(TBN * tangent_normal);
+}
+
+void main()
+{
+    BindlessMaterial material = materials[in_material_index];
+
+    PGBufferData gbuffer;
+    gbuffer.worldNormal    = calculateNormal(material);
+    gbuffer.baseColor      = getBasecolor(material);
+    gbuffer.metallic       = sampleMaterialTexture(material.metallic_roughness_texture_index, in_texcoord).z * material.metallicFactor;
+    gbuffer.specular       = 0.5;
+    gbuffer.roughness      = sampleMaterialTexture(material.metallic_roughness_texture_index, in_texcoord).y * material.roughnessFactor;
+    gbuffer.shadingModelID = SHADINGMODELID_DEFAULT_LIT;
+
+    highp vec3 Le = sampleMaterialTexture(material.emissive_texture_index, in_texcoord).xyz * material.emissiveFactor;
+
+    EncodeGBufferData(gbuffer, out_gbuffer_a, out_gbuffer_b, out_gbuffer_c);
+
+    // out_scene_color.rgba = vec4(Le, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+
+// tone mapping、color grading、vignette 合并为一个 subpass，只读写一次全屏 attachment
+// 开启哪些效果由 specialization constant 决定，关闭的效果在创建 pipeline 时被编译器剔除
+// 开启动态分辨率时场景只渲染在 attachment 左上角缩小的区域，此时改为双线性采样该区域来放大到整个 viewport
+
+layout(constant_id = 0) const bool enable_tone_mapping       = true;
+layout(constant_id = 1) const bool enable_color_grading      = true;
+layout(constant_id = 2) const bool enable_vignette           = true;
+layout(constant_id = 3) const bool enable_dynamic_resolution = false;
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform highp subpassInput in_color;
+
+layout(set = 0, binding = 1) uniform sampler2D color_grading_lut_texture_sampler;
+
+layout(set = 0, binding = 2) uniform highp sampler2D in_color_sampler;
+
+layout(set = 0, binding = 3) readonly buffer _dynamic_resolution
+{
+    highp vec4 viewport;
+    highp vec4 scene_viewport;
+    highp vec4 inv_extent;
+};
+
+layout(location = 0) in highp vec2 in_uv;
+
+layout(location = 0) out highp vec4 out_color;
+
+highp vec3 Uncharted2Tonemap(highp vec3 x);
+
+void main()
+{
+    highp vec4 color;
+    if (enable_dynamic_resolution)
+    {
+        highp vec2 scale          = scene_viewport.zw / viewport.zw;
+        highp vec2 scene_position = scene_viewport.xy + (gl_FragCoord.xy - viewport.xy) * scale;
+        // 不采样到场景区域之外的像素
+        scene_position = clamp(scene_position, scene_viewport.xy + 0.5f, scene_viewport.xy + scene_viewport.zw - 0.5f);
+        color          = textureLod(in_color_sampler, scene_position * inv_extent.xy, 0.0f);
+    }
+    else
+    {
+        color = subpassLoad(in_color).rgba;
+    }
+
+    if (enable_tone_mapping)
+    {
+        highp vec3 mapped = Uncharted2Tonemap(color.rgb * 4.5f);
+        mapped            = mapped * (1.0f / Uncharted2Tonemap(vec3(11.2f)));
+
+        // Gamma correct
+        // TODO: select the VK_FORMAT_B8G8R8A8_SRGB surface format,
+        // there is no need to do gamma correction in the fragment shader
+        color = vec4(pow(mapped.x, 1.0 / 2.2), pow(mapped.y, 1.0 / 2.2), pow(mapped.z, 1.0 / 2.2), 1.0f);
+    }
+
+    if (enable_color_grading)
+    {
+        highp ivec2 lut_tex_size = textureSize(color_grading_lut_texture_sampler, 0);
+        highp float _COLORS      = float(lut_tex_size.y); // Number of colors in the LUT
+
+        highp float b       = color.b * _COLORS;
+        highp float b_floor = floor(b);
+        highp float b_ceil  = ceil(b);
+
+        highp vec4 color_floor = texture(color_grading_lut_texture_sampler, vec2((b_floor + color.r) / _COLORS, color.g));
+        highp vec4 color_ceil  = texture(color_grading_lut_texture_sampler, vec2((b_ceil + color.r) / _COLORS, color.g));
+
+        color = mix(color_floor, color_ceil, b - b_floor);
+    }
+
+    if (enable_vignette)
+    {
+        highp float cutoff   = 0.4f;
+        highp float exponent = 1.5f;
+        highp float len      = length(in_uv - 0.5f);
+        highp float ratio    = pow(cutoff / len, exponent);
+
+        color = color * min(ratio, 1.0f);
+    }
+
+    out_color = color;
+}
+
+highp vec3 Uncharted2Tonemap(highp vec3 x)
+{
+    highp float A = 0.15;
+    highp float B = 0.50;
+    highp float C = 0.10;
+    highp float D = 0.20;
+    highp float E = 0.02;
+    highp float F = 0.30;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
@@ -0,0 +1,30 @@
+// must match MeshBindlessMaterialStorageBufferObject in render_common.h (std430, 80 bytes)
+struct BindlessMaterial
+{
+    highp vec4  baseColorFactor;
+    highp float metallicFactor;
+    highp float roughnessFactor;
+    highp float normalScale;
+    highp float occlusionStrength;
+    highp vec3  emissiveFactor;
+    uint        is_blend;
+    uint        is_double_sided;
+    uint        base_color_texture_index;
+    uint        metallic_roughness_texture_index;
+    uint        normal_texture_index;
+    uint        occlusion_texture_index;
+    uint        emissive_texture_index;
+    uint        _padding_texture_index_1;
+    uint        _padding_texture_index_2;
+};
+
+layout(set = 2, binding = 0) readonly buffer _unused_name_bindless_material
+{
+    BindlessMaterial materials[];
+};
+
+// partially bound, only the slots registered by materials are valid
+layout(set = 2, binding = 1) uniform sampler2D material_textures[];
+
+// instances of one draw call may use different materials, so the index is not dynamically uniform
+#define sampleMaterialTexture(texture_index, uv) texture(material_textures[nonuniformEXT(texture_index)], uv)
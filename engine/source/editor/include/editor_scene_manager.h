@@ -5,6 +5,7 @@
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/render/render_object.h"
 
+#include <functional>
 #include <memory>
 
 namespace Piccolo {
@@ -44,7 +45,9 @@ public:
 
     void setEditorCamera(std::shared_ptr<RenderCamera> camera) { m_camera = camera; }
     void uploadAxisResource();
-    size_t getGuidOfPickedMesh(const Vector2 &picked_uv) const;
+    // CPU 拾取时立即调用 on_picked，否则在 pick pass 完成之后调用
+    void requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(size_t)> on_picked) const;
+    void setCpuPickingEnabled(bool enabled) { m_is_cpu_picking_enabled = enabled; }
 
 public:
     std::shared_ptr<RenderCamera> getEditorCamera() { return m_camera; };
@@ -70,5 +73,8 @@ private:
     size_t m_selected_axis{ 3 };
 
     bool   m_is_show_axis = true;
+
+    // CPU 拾取不经过 GPU，蒙皮 mesh 只按包围盒命中；需要逐像素结果时切换到 pick pass
+    bool m_is_cpu_picking_enabled {true};
 };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "editor/include/axis.h"
 
 #include "runtime/core/math/vector2.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/ui/window_ui.h"
@@ -36,6 +37,7 @@ private:
     void showEditorFileContentWindow(bool* p_open);
     void showEditorGameWindow(bool* p_open);
     void showEditorDetailWindow(bool* p_open);
+    void showEditorProfilerWindow(bool* p_open);
 
     void setUIColorStyle();
 
@@ -58,5 +60,13 @@ private:
     bool m_detail_window_open            = true;
     bool m_scene_lights_window_open      = true;
     bool m_scene_lights_data_window_open = true;
+    bool m_profiler_window_open          = false;
+
+    // profiler 窗口显示的帧，暂停时保持不变，便于查看偶发的长帧
+    std::vector<std::pair<std::string, std::vector<ProfileEvent>>> m_profiler_frame_tracks;
+    uint64_t                                                       m_profiler_frame_begin_ns {0};
+    uint64_t                                                       m_profiler_frame_end_ns {0};
+    bool                                                           m_is_profiler_paused {false};
+    float                                                          m_profiler_spike_threshold_ms {0.f};
 };
 } // namespace Piccolo
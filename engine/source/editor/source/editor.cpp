@@ -27,6 +27,8 @@ void PiccoloEditor::initialize(PiccoloEngine* engine_runtime) {
 
     g_is_editor_mode = true;
     m_engine_runtime = engine_runtime;
+    // 编辑器 UI 在渲染 tick 中直接读写场景中的对象，只能与逻辑在同一线程
+    m_engine_runtime->setRenderThreadEnabled(false);
 
     EditorGlobalContextInitInfo init_info = {g_runtime_global_context.m_window_system.get(),
                                              g_runtime_global_context.m_render_system.get(),
@@ -467,7 +467,11 @@ void EditorSceneManager::uploadAxisResource() {
     {m_translation_axis.m_mesh_data, m_rotation_axis.m_mesh_data, m_scale_axis.m_mesh_data});
 }
 
-size_t EditorSceneManager::getGuidOfPickedMesh(const Vector2 &picked_uv) const {
-    return g_editor_global_context.m_render_system->getGuidOfPickedMesh(picked_uv);
+void EditorSceneManager::requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(size_t)> on_picked) const {
+    if (m_is_cpu_picking_enabled) {
+        on_picked(g_editor_global_context.m_render_system->getGuidOfRayPickedMesh(picked_uv));
+        return;
+    }
+    g_editor_global_context.m_render_system->requestGuidOfPickedMesh(picked_uv, std::move(on_picked));
 }
 } // namespace Piccolo
@@ -326,6 +326,7 @@ void EditorUI::showEditorUI() {
     showEditorGameWindow(&m_game_engine_window_open);
     showEditorFileContentWindow(&m_file_content_window_open);
     showEditorDetailWindow(&m_detail_window_open);
+    showEditorProfilerWindow(&m_profiler_window_open);
 }
 
 void EditorUI::showEditorMenu(bool* p_open) {
@@ -416,6 +417,7 @@ void EditorUI::showEditorMenu(bool* p_open) {
             ImGui::MenuItem("Game", nullptr, &m_game_engine_window_open);
             ImGui::MenuItem("File Content", nullptr, &m_file_content_window_open);
             ImGui::MenuItem("Detail", nullptr, &m_detail_window_open);
+            ImGui::MenuItem("Profiler", nullptr, &m_profiler_window_open);
             ImGui::EndMenu();
         }
         // Render pipeline button
@@ -454,11 +456,10 @@ void EditorUI::showEditorWorldObjectsWindow(bool* p_open) {
     if (current_active_level == nullptr)
         return;
 
-    const LevelObjectsMap &all_gobjects = current_active_level->getAllGObjects();
-    for (auto &id_object_pair : all_gobjects) {
-        const GObjectID          object_id = id_object_pair.first;
-        std::shared_ptr<GObject> object    = id_object_pair.second;
-        const std::string        name      = object->getName();
+    const LevelObjects &all_gobjects = current_active_level->getAllGObjects();
+    for (const std::shared_ptr<GObject> &object : all_gobjects) {
+        const GObjectID   object_id = object->getID();
+        const std::string name      = object->getName();
         if (name.size() > 0) {
             bool is_object_active = object->isActive();
             if (!is_object_active) // 如果对象未激活
@@ -627,6 +628,72 @@ void EditorUI::showEditorFileContentWindow(bool* p_open) {
     ImGui::End();
 }
 
+void EditorUI::showEditorProfilerWindow(bool* p_open) {
+    if (!*p_open)
+        return;
+
+    if (!ImGui::Begin("Profiler", p_open, ImGuiWindowFlags_None)) {
+        ImGui::End();
+        return;
+    }
+
+#ifndef ENABLE_PROFILER
+    ImGui::TextUnformatted("profiler is compiled out (ENABLE_PROFILER is off)");
+#else
+    std::shared_ptr<Profiler> profiler = g_runtime_global_context.m_profiler;
+
+    // 取最近一个完整帧，超过阈值时自动暂停；GPU 等延迟读回的 track 显示各自最近读回的一帧
+    uint64_t frame_begin_ns, frame_end_ns;
+    if (!m_is_profiler_paused && profiler->getLastFrameRange(frame_begin_ns, frame_end_ns)) {
+        m_profiler_frame_begin_ns = frame_begin_ns;
+        m_profiler_frame_end_ns   = frame_end_ns;
+
+        m_profiler_frame_tracks.clear();
+        for (const std::shared_ptr<ProfileTrack> &track : profiler->getTracks()) {
+            uint64_t track_begin_ns = frame_begin_ns, track_end_ns = frame_end_ns;
+            track->getLastFrameRange(track_begin_ns, track_end_ns);
+            m_profiler_frame_tracks.emplace_back(track->getName(), std::vector<ProfileEvent>());
+            track->collect(track_begin_ns, track_end_ns, m_profiler_frame_tracks.back().second);
+        }
+
+        float frame_time_ms = (frame_end_ns - frame_begin_ns) / 1e6f;
+        if (m_profiler_spike_threshold_ms > 0.f && frame_time_ms > m_profiler_spike_threshold_ms)
+            m_is_profiler_paused = true;
+    }
+
+    ImGui::Checkbox("Pause", &m_is_profiler_paused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.f);
+    ImGui::DragFloat("Pause above (ms, 0 = off)", &m_profiler_spike_threshold_ms, 0.1f, 0.f, 1000.f, "%.1f");
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace")) {
+        std::filesystem::path trace_path =
+            g_runtime_global_context.m_config_manager->getRootFolder() / "profile_trace.json";
+        if (profiler->exportChromeTrace(trace_path.generic_string()))
+            LOG_INFO("profile trace exported to {}", trace_path.generic_string());
+        else
+            LOG_ERROR("failed to export profile trace to {}", trace_path.generic_string());
+    }
+
+    ImGui::Text("frame: %.3f ms", (m_profiler_frame_end_ns - m_profiler_frame_begin_ns) / 1e6f);
+    ImGui::Separator();
+
+    for (const auto &track : m_profiler_frame_tracks) {
+        if (track.second.empty())
+            continue;
+        if (!ImGui::CollapsingHeader(track.first.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+            continue;
+        for (const ProfileEvent &event : track.second) {
+            ImGui::Indent(12.f * (event.depth + 1));
+            ImGui::Text("%s  %.3f ms", event.name, (event.end_ns - event.begin_ns) / 1e6f);
+            ImGui::Unindent(12.f * (event.depth + 1));
+        }
+    }
+#endif
+
+    ImGui::End();
+}
+
 void EditorUI::showEditorGameWindow(bool* p_open) {
     ImGuiIO         &io           = ImGui::GetIO();
     ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_MenuBar;
@@ -1,9 +1,14 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include <filesystem>
-#include <iostream>
+#include <limits>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
+#include "runtime/core/base/macro.h"
 #include "runtime/engine.h"
 
 #include "editor/include/editor.h"
@@ -12,15 +17,114 @@
 #define PICCOLO_XSTR(s) PICCOLO_STR(s)
 #define PICCOLO_STR(s) #s
 
+// --headless [--frames N] [--delta-time SECONDS]
+//   不创建窗口和渲染，以固定步长运行 N 帧后退出，用于服务器模拟和 CI 中的逻辑性能测试
+// --game [--render-thread]
+//   不启动编辑器，直接运行默认场景；--render-thread 让渲染在独立线程上与下一帧的逻辑并行
+struct LaunchOptions {
+    bool     is_headless {false};
+    uint32_t frame_count {600};
+    float    delta_time {1.f / 60.f};
+
+    bool is_game {false};
+    bool enable_render_thread {false};
+
+    std::vector<std::string> errors;
+};
+
+static bool parseUInt32(const char* text, uint32_t &out_value) {
+    errno                   = 0;
+    char*         end       = nullptr;
+    unsigned long value     = std::strtoul(text, &end, 10);
+    bool          is_digits = text[0] >= '0' && text[0] <= '9'; // strtoul 接受负号和前导空白
+    if (!is_digits || end == text || *end != '\0' || errno == ERANGE || value > std::numeric_limits<uint32_t>::max())
+        return false;
+    out_value = static_cast<uint32_t>(value);
+    return true;
+}
+
+static bool parsePositiveFloat(const char* text, float &out_value) {
+    errno       = 0;
+    char* end   = nullptr;
+    float value = std::strtof(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(value) || value <= 0.f)
+        return false;
+    out_value = value;
+    return true;
+}
+
+static LaunchOptions parseLaunchOptions(int argc, char** argv) {
+    LaunchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            options.is_headless = true;
+        } else if (arg == "--game") {
+            options.is_game = true;
+        } else if (arg == "--render-thread") {
+            options.enable_render_thread = true;
+        } else if (arg == "--frames") {
+            if (i + 1 >= argc || !parseUInt32(argv[++i], options.frame_count))
+                options.errors.push_back("--frames expects a non-negative integer");
+        } else if (arg == "--delta-time") {
+            if (i + 1 >= argc || !parsePositiveFloat(argv[++i], options.delta_time))
+                options.errors.push_back("--delta-time expects a positive number of seconds");
+        } else {
+            options.errors.push_back("unknown argument: " + arg);
+        }
+    }
+    if (options.is_headless && options.is_game)
+        options.errors.push_back("--headless and --game cannot be used together");
+    if (options.enable_render_thread && !options.is_game)
+        options.errors.push_back("--render-thread requires --game");
+    return options;
+}
+
 int main(int argc, char** argv) {
     std::filesystem::path executable_path(argv[0]);
     std::filesystem::path config_file_path = executable_path.parent_path() / "PiccoloEditor.ini";
 
+    LaunchOptions launch_options = parseLaunchOptions(argc, argv);
+    if (!launch_options.errors.empty()) {
+        // 引擎尚未启动，临时创建日志系统输出错误
+        using namespace Piccolo;
+        g_runtime_global_context.m_logger_system = std::make_shared<LogSystem>();
+        for (const std::string &error : launch_options.errors)
+            LOG_ERROR("{}", error);
+        LOG_ERROR("usage: PiccoloEditor [--headless [--frames N] [--delta-time SECONDS] | --game [--render-thread]]");
+        g_runtime_global_context.m_logger_system.reset();
+        return 1;
+    }
+    Piccolo::g_is_headless_mode = launch_options.is_headless;
+
     Piccolo::PiccoloEngine* engine = new Piccolo::PiccoloEngine();
 
     engine->startEngine(config_file_path.generic_string());
     engine->initialize();
 
+    if (launch_options.is_headless) {
+        engine->runHeadless(launch_options.frame_count, launch_options.delta_time);
+
+        engine->shutdownEngine();
+        engine->clear();
+        delete engine;
+
+        return 0;
+    }
+
+    if (launch_options.is_game) {
+        // 没有编辑器 UI 在渲染 tick 中访问场景，可以使用渲染线程
+        if (launch_options.enable_render_thread)
+            engine->setRenderThreadEnabled(true);
+        engine->run();
+
+        engine->shutdownEngine();
+        engine->clear();
+        delete engine;
+
+        return 0;
+    }
+
     Piccolo::PiccoloEditor* editor = new Piccolo::PiccoloEditor();
     editor->initialize(engine);
 
@@ -18,6 +18,7 @@ void ReflectionGenerator::prepareStatus(std::string path) {
     GeneratorInterface::prepareStatus(path);
     TemplateManager::getInstance()->loadTemplates(m_root_path, "commonReflectionFile");
     TemplateManager::getInstance()->loadTemplates(m_root_path, "allReflectionFile");
+    TemplateManager::getInstance()->loadTemplates(m_root_path, "allComponentTypeIdFile");
     return;
 }
 
@@ -47,6 +48,10 @@ int ReflectionGenerator::generate(std::string path, SchemaMoudle schema) {
         class_names.insert_or_assign(class_temp->getClassName(), false);
         class_names[class_temp->getClassName()] = true;
 
+        std::vector<std::string> &base_names = m_class_base_names[class_temp->getClassName()];
+        for (auto &base_class : class_temp->m_base_classes)
+            base_names.push_back(base_class->name);
+
         std::vector<std::string>                                   field_names;
         std::map<std::string, std::pair<std::string, std::string>> vector_map;
 
@@ -118,6 +123,52 @@ void ReflectionGenerator::finish() {
     std::string render_string =
         TemplateManager::getInstance()->renderByTemplate("allReflectionFile", mustache_data);
     Utils::saveFile(render_string, m_out_path + "/all_reflection.h");
+
+    generateComponentTypeIDs();
+}
+
+// every reflected subclass of Component gets a dense id, assigned in the order of the class names so that
+// the ids only change when components are added or removed
+void ReflectionGenerator::generateComponentTypeIDs() {
+    std::map<std::string, bool> is_component_cache;
+    std::function<bool(const std::string &)> isComponent = [&](const std::string &class_name) {
+        auto cache_iter = is_component_cache.find(class_name);
+        if (cache_iter != is_component_cache.end())
+            return cache_iter->second;
+
+        is_component_cache[class_name] = false; // guard against malformed inheritance cycles
+        bool result = false;
+        auto class_iter = m_class_base_names.find(class_name);
+        if (class_iter != m_class_base_names.end()) {
+            for (auto &base_name : class_iter->second) {
+                if (base_name == "Component" || isComponent(base_name)) {
+                    result = true;
+                    break;
+                }
+            }
+        }
+        is_component_cache[class_name] = result;
+        return result;
+    };
+
+    Mustache::data mustache_data;
+    Mustache::data component_defines = Mustache::data::type::list;
+
+    uint32_t component_type_id = 0;
+    for (auto &class_iter : m_class_base_names) {
+        if (!isComponent(class_iter.first))
+            continue;
+        Mustache::data component_define;
+        component_define.set("class_name", class_iter.first);
+        component_define.set("component_type_id", std::to_string(component_type_id++));
+        component_defines.push_back(component_define);
+    }
+    mustache_data.set("component_defines", component_defines);
+    mustache_data.set("component_type_count", std::to_string(component_type_id));
+
+    std::string render_string =
+        TemplateManager::getInstance()->renderByTemplate("allComponentTypeIdFile", mustache_data);
+    Utils::saveFile(render_string, m_out_path + "/all_component_type_id.h");
 }
 
 ReflectionGenerator::~ReflectionGenerator() {}
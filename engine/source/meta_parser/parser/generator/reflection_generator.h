@@ -1,5 +1,8 @@
 #pragma once
 #include "generator/generator.h"
+
+#include <map>
+
 namespace Generator {
 class ReflectionGenerator : public GeneratorInterface {
 public:
@@ -14,7 +17,11 @@ protected:
     virtual std::string processFileName(std::string path) override;
 
 private:
+    void generateComponentTypeIDs();
+
     std::vector<std::string> m_head_file_list;
     std::vector<std::string> m_sourcefile_list;
+    // base class names of every reflected class, used to find the subclasses of Component
+    std::map<std::string, std::vector<std::string>> m_class_base_names;
 };
 } // namespace Generator
@@ -0,0 +1,182 @@
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/core/profiler/profiler.h"
+#include "runtime/function/global/global_context.h"
+
+#include <algorithm>
+#include <string>
+
+namespace Piccolo {
+thread_local uint32_t JobSystem::s_queue_index {0};
+
+void JobSystem::initialize(uint32_t worker_count) {
+    clear();
+
+    if (worker_count == 0) {
+        uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+        worker_count                   = hardware_thread_count > 1 ? hardware_thread_count - 1 : 0;
+    }
+
+    m_queues.clear();
+    for (uint32_t queue_index = 0; queue_index <= worker_count; ++queue_index)
+        m_queues.push_back(std::make_unique<JobQueue>());
+
+    m_is_running = true;
+    for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+        m_workers.emplace_back(&JobSystem::workerLoop, this, worker_index + 1);
+}
+
+void JobSystem::clear() {
+    if (m_is_running) {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_is_running = false;
+        }
+        m_wake_condition.notify_all();
+    }
+
+    for (std::thread &worker : m_workers)
+        worker.join();
+    m_workers.clear();
+    m_queues.clear();
+    m_queued_job_count = 0;
+}
+
+void JobSystem::submit(JobFunction job, JobCounter* counter) {
+    if (counter)
+        counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+    // 未初始化时直接在当前线程执行
+    if (m_queues.empty()) {
+        job();
+        finishJob(counter);
+        return;
+    }
+
+    // 先增加计数再入队，取出 job 时的减一不会先于这里发生
+    m_queued_job_count.fetch_add(1);
+
+    JobQueue &queue = *m_queues[s_queue_index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.emplace_back(std::move(job), counter);
+    }
+    wakeSleepingThreads(false);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    uint32_t idle_count = 0;
+    while (!counter.isDone()) {
+        if (tryRunJob(s_queue_index)) {
+            idle_count = 0;
+            continue;
+        }
+
+        // 剩下的 job 都在其他线程上执行，先让出一段时间，仍未完成就睡眠，由 counter 归零或新 job 唤醒
+        if (++idle_count < s_wait_yield_count) {
+            std::this_thread::yield();
+            continue;
+        }
+        sleep(&counter);
+        idle_count = 0;
+    }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t chunk_size, const std::function<void(uint32_t, uint32_t)> &func) {
+    if (count == 0)
+        return;
+
+    chunk_size = std::max(chunk_size, 1u);
+
+    // 第一个区间留给调用线程，其余的提交给 worker
+    JobCounter counter;
+    for (uint32_t begin = chunk_size; begin < count; begin += chunk_size) {
+        uint32_t end = std::min(begin + chunk_size, count);
+        submit([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+
+    func(0, std::min(chunk_size, count));
+    wait(counter);
+}
+
+bool JobSystem::popJob(uint32_t queue_index, std::pair<JobFunction, JobCounter*> &job) {
+    JobQueue                   &queue = *m_queues[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+        return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::stealJob(uint32_t thief_index, std::pair<JobFunction, JobCounter*> &job) {
+    uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+    for (uint32_t offset = 1; offset < queue_count; ++offset) {
+        JobQueue                   &queue = *m_queues[(thief_index + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryRunJob(uint32_t queue_index) {
+    if (m_queues.empty())
+        return false;
+
+    std::pair<JobFunction, JobCounter*> job;
+    if (!popJob(queue_index, job) && !stealJob(queue_index, job))
+        return false;
+
+    m_queued_job_count.fetch_sub(1, std::memory_order_relaxed);
+
+    job.first();
+    finishJob(job.second);
+    return true;
+}
+
+void JobSystem::finishJob(JobCounter* counter) {
+    // 最后一个 job 完成时唤醒可能在 wait 中睡眠的线程
+    if (counter && counter->m_count.fetch_sub(1) == 1)
+        wakeSleepingThreads(true);
+}
+
+void JobSystem::workerLoop(uint32_t queue_index) {
+    s_queue_index = queue_index;
+    PROFILE_THREAD("worker " + std::to_string(queue_index));
+
+    while (true) {
+        if (tryRunJob(queue_index))
+            continue;
+
+        sleep(nullptr);
+        if (!m_is_running)
+            return;
+    }
+}
+
+void JobSystem::sleep(JobCounter* counter) {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    // 先登记再检查条件，与 submit 和 finishJob 中先修改计数再检查睡眠数配对，两边至少有一方能看到对方
+    m_sleeping_thread_count.fetch_add(1);
+    m_wake_condition.wait(lock, [this, counter]() {
+        return !m_is_running || m_queued_job_count.load() > 0 || (counter && counter->m_count.load() == 0);
+    });
+    m_sleeping_thread_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void JobSystem::wakeSleepingThreads(bool wake_all) {
+    if (m_sleeping_thread_count.load() == 0)
+        return;
+
+    // 空的临界区保证睡眠方要么还没检查条件，要么已经进入 wait，不会错过通知
+    { std::lock_guard<std::mutex> lock(m_wake_mutex); }
+    if (wake_all)
+        m_wake_condition.notify_all();
+    else
+        m_wake_condition.notify_one();
+}
+} // namespace Piccolo
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Piccolo {
+// 一组 job 的未完成计数，归零表示全部完成
+class JobCounter {
+public:
+    bool isDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+private:
+    std::atomic<uint32_t> m_count {0};
+
+    friend class JobSystem;
+};
+
+using JobFunction = std::function<void()>;
+
+// 每个 worker 线程一个双端队列，自己从队尾取 job，空闲时从其他队列的队首偷取
+// 不是 worker 的线程（主线程等）共用 0 号队列，wait 时也会参与执行 job
+class JobSystem {
+public:
+    ~JobSystem() { clear(); }
+
+    // worker_count 为 0 时每个硬件线程一个 worker（除去调用线程）
+    void initialize(uint32_t worker_count = 0);
+    void clear();
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    // counter 可以为空，job 完成后 counter 减一
+    void submit(JobFunction job, JobCounter* counter);
+
+    // 等待 counter 归零，等待期间当前线程会执行队列中的 job，因此可以在 job 中嵌套等待
+    void wait(JobCounter &counter);
+
+    // 把 [0, count) 切分为长度不超过 chunk_size 的区间，并行执行 func(begin, end)，返回时全部完成
+    void parallelFor(uint32_t count, uint32_t chunk_size, const std::function<void(uint32_t, uint32_t)> &func);
+
+private:
+    struct JobQueue {
+        std::mutex                                      mutex;
+        std::deque<std::pair<JobFunction, JobCounter*>> jobs;
+    };
+
+    bool popJob(uint32_t queue_index, std::pair<JobFunction, JobCounter*> &job);
+    bool stealJob(uint32_t thief_index, std::pair<JobFunction, JobCounter*> &job);
+    bool tryRunJob(uint32_t queue_index);
+    void finishJob(JobCounter* counter);
+    void workerLoop(uint32_t queue_index);
+
+    // 睡眠直到有新 job、counter 归零（counter 不为空时）或 clear
+    void sleep(JobCounter* counter);
+    void wakeSleepingThreads(bool wake_all);
+
+    // 0 号给非 worker 线程使用，i + 1 号属于第 i 个 worker
+    std::vector<std::unique_ptr<JobQueue>> m_queues;
+    std::vector<std::thread>               m_workers;
+
+    std::atomic<bool>     m_is_running {false};
+    std::atomic<uint32_t> m_queued_job_count {0};
+    std::atomic<uint32_t> m_sleeping_thread_count {0}; // 睡眠中的 worker 和 wait 中的线程，为 0 时 submit 不需要加锁唤醒
+
+    std::mutex              m_wake_mutex;
+    std::condition_variable m_wake_condition;
+
+    // wait 在睡眠前让出的次数，剩下的 job 通常很快就会完成
+    static constexpr uint32_t s_wait_yield_count {64};
+
+    static thread_local uint32_t s_queue_index;
+};
+} // namespace Piccolo
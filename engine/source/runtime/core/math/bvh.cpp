@@ -0,0 +1,163 @@
+#include "runtime/core/math/bvh.h"
+
+#include <algorithm>
+
+namespace Piccolo {
+bool RayIntersectsBox(const Ray     &ray,
+                      const Vector3 &inv_direction,
+                      const Vector3 &min_corner,
+                      const Vector3 &max_corner,
+                      float          t_max,
+                      float         &t_enter) {
+    float t_min = 0.0f;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        float t0 = (min_corner[axis] - ray.origin[axis]) * inv_direction[axis];
+        float t1 = (max_corner[axis] - ray.origin[axis]) * inv_direction[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        t_min = std::max(t_min, t0);
+        t_max = std::min(t_max, t1);
+        if (t_min > t_max)
+            return false;
+    }
+    t_enter = t_min;
+    return true;
+}
+
+bool RayIntersectsBox(const Ray &ray, const Vector3 &inv_direction, const AxisAlignedBox &box, float t_max, float &t_enter) {
+    return RayIntersectsBox(ray, inv_direction, box.getMinCorner(), box.getMaxCorner(), t_max, t_enter);
+}
+
+bool RayIntersectsTriangle(const Ray     &ray,
+                           const Vector3 &v0,
+                           const Vector3 &v1,
+                           const Vector3 &v2,
+                           float          t_max,
+                           float         &t) {
+    Vector3 edge1 = v1 - v0;
+    Vector3 edge2 = v2 - v0;
+    Vector3 p     = ray.direction.crossProduct(edge2);
+    float   det   = edge1.dotProduct(p);
+    if (det == 0.0f)
+        return false;
+
+    float   inv_det = 1.0f / det;
+    Vector3 s       = ray.origin - v0;
+    float   u       = s.dotProduct(p) * inv_det;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    Vector3 q = s.crossProduct(edge1);
+    float   v = ray.direction.dotProduct(q) * inv_det;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    float hit_t = edge2.dotProduct(q) * inv_det;
+    if (hit_t < 0.0f || hit_t >= t_max)
+        return false;
+    t = hit_t;
+    return true;
+}
+
+void BVH::build(const std::vector<AxisAlignedBox> &primitive_bounds) {
+    clear();
+    if (primitive_bounds.empty())
+        return;
+
+    uint32_t primitive_count = static_cast<uint32_t>(primitive_bounds.size());
+    std::vector<Vector3> centroids(primitive_count);
+    m_primitive_indices.resize(primitive_count);
+    for (uint32_t i = 0; i < primitive_count; ++i) {
+        centroids[i]           = primitive_bounds[i].getCenter();
+        m_primitive_indices[i] = i;
+    }
+
+    // 中位数划分得到平衡的树，节点数不超过 2 * primitive_count - 1
+    m_nodes.reserve(2 * primitive_count);
+    buildNode(primitive_bounds, centroids, 0, primitive_count);
+}
+
+void BVH::clear() {
+    m_nodes.clear();
+    m_primitive_indices.clear();
+}
+
+uint32_t BVH::buildNode(const std::vector<AxisAlignedBox> &primitive_bounds,
+                        const std::vector<Vector3>        &centroids,
+                        uint32_t                           begin,
+                        uint32_t                           end) {
+    uint32_t node_index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    const AxisAlignedBox &first_bounds = primitive_bounds[m_primitive_indices[begin]];
+    Vector3 min_corner          = first_bounds.getMinCorner();
+    Vector3 max_corner          = first_bounds.getMaxCorner();
+    Vector3 centroid_min_corner = centroids[m_primitive_indices[begin]];
+    Vector3 centroid_max_corner = centroid_min_corner;
+    for (uint32_t i = begin + 1; i < end; ++i) {
+        min_corner.makeFloor(primitive_bounds[m_primitive_indices[i]].getMinCorner());
+        max_corner.makeCeil(primitive_bounds[m_primitive_indices[i]].getMaxCorner());
+        centroid_min_corner.makeFloor(centroids[m_primitive_indices[i]]);
+        centroid_max_corner.makeCeil(centroids[m_primitive_indices[i]]);
+    }
+    m_nodes[node_index].min_corner = min_corner;
+    m_nodes[node_index].max_corner = max_corner;
+
+    if (end - begin <= s_max_leaf_primitive_count) {
+        m_nodes[node_index].first = begin;
+        m_nodes[node_index].count = end - begin;
+        return node_index;
+    }
+
+    // 沿 centroid 跨度最大的轴划分
+    Vector3 extent = centroid_max_corner - centroid_min_corner;
+    size_t  axis   = 0;
+    if (extent.y > extent.x)
+        axis = 1;
+    if (extent.z > extent[axis])
+        axis = 2;
+
+    uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(m_primitive_indices.begin() + begin,
+                     m_primitive_indices.begin() + middle,
+                     m_primitive_indices.begin() + end,
+                     [&](uint32_t lhs, uint32_t rhs) { return centroids[lhs][axis] < centroids[rhs][axis]; });
+
+    buildNode(primitive_bounds, centroids, begin, middle);
+    uint32_t right = buildNode(primitive_bounds, centroids, middle, end);
+    m_nodes[node_index].first = right;
+    m_nodes[node_index].count = 0;
+    return node_index;
+}
+
+void TriangleBVH::build(std::vector<Vector3> triangle_vertices) {
+    m_triangle_vertices = std::move(triangle_vertices);
+    m_triangle_vertices.resize(m_triangle_vertices.size() / 3 * 3);
+
+    std::vector<AxisAlignedBox> triangle_bounds;
+    triangle_bounds.reserve(m_triangle_vertices.size() / 3);
+    for (size_t i = 0; i < m_triangle_vertices.size(); i += 3) {
+        AxisAlignedBox bounds;
+        bounds.merge(m_triangle_vertices[i]);
+        bounds.merge(m_triangle_vertices[i + 1]);
+        bounds.merge(m_triangle_vertices[i + 2]);
+        triangle_bounds.push_back(bounds);
+    }
+
+    m_bvh.build(triangle_bounds);
+}
+
+bool TriangleBVH::raycast(const Ray &ray, float t_max, float &hit_t) const {
+    auto intersectTriangle = [&](uint32_t triangle_index, float triangle_t_max, float &t) {
+        return RayIntersectsTriangle(ray,
+                                     m_triangle_vertices[triangle_index * 3],
+                                     m_triangle_vertices[triangle_index * 3 + 1],
+                                     m_triangle_vertices[triangle_index * 3 + 2],
+                                     triangle_t_max,
+                                     t);
+    };
+
+    uint32_t hit_triangle;
+    return m_bvh.raycast(ray, intersectTriangle, t_max, hit_triangle, hit_t);
+}
+} // namespace Piccolo
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/vector3.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Piccolo {
+struct Ray {
+    Vector3 origin;
+    Vector3 direction; // 不要求归一化，命中距离 t 以 direction 的长度为单位
+};
+
+// slab test，返回 ray 在 [0, t_max) 内是否与 box 相交，t_enter 为进入 box 的距离
+bool RayIntersectsBox(const Ray     &ray,
+                      const Vector3 &inv_direction,
+                      const Vector3 &min_corner,
+                      const Vector3 &max_corner,
+                      float          t_max,
+                      float         &t_enter);
+bool RayIntersectsBox(const Ray &ray, const Vector3 &inv_direction, const AxisAlignedBox &box, float t_max, float &t_enter);
+
+// Möller–Trumbore，双面，返回 ray 在 [0, t_max) 内是否与三角形 (v0, v1, v2) 相交
+bool RayIntersectsTriangle(const Ray     &ray,
+                           const Vector3 &v0,
+                           const Vector3 &v1,
+                           const Vector3 &v2,
+                           float          t_max,
+                           float         &t);
+
+// 对一组 primitive 的包围盒建立的 BVH，只保存 primitive 的下标，primitive 本身由使用者保存
+// 不依赖渲染，逻辑和渲染两侧都可以使用
+class BVH {
+public:
+    void build(const std::vector<AxisAlignedBox> &primitive_bounds);
+    void clear();
+    bool empty() const { return m_nodes.empty(); }
+
+    // intersect_primitive(primitive_index, t_max, t) 在 [0, t_max) 内命中时写入 t 并返回 true
+    // 返回 [0, t_max) 内最近命中的 primitive
+    template<typename IntersectPrimitiveFunc>
+    bool raycast(const Ray              &ray,
+                 IntersectPrimitiveFunc &&intersect_primitive,
+                 float                   t_max,
+                 uint32_t               &hit_primitive,
+                 float                  &hit_t) const;
+
+private:
+    struct Node {
+        Vector3  min_corner;
+        Vector3  max_corner;
+        uint32_t first {0}; // 叶节点：m_primitive_indices 中的起始下标；内部节点：右子节点的下标，左子节点紧跟在自身之后
+        uint32_t count {0}; // 为 0 时是内部节点
+    };
+
+    static constexpr uint32_t s_max_leaf_primitive_count {4};
+
+    uint32_t buildNode(const std::vector<AxisAlignedBox> &primitive_bounds,
+                       const std::vector<Vector3>        &centroids,
+                       uint32_t                           begin,
+                       uint32_t                           end);
+
+    std::vector<Node>     m_nodes;
+    std::vector<uint32_t> m_primitive_indices;
+};
+
+// 三角形网格的 BVH，用于精确的 ray 拾取，ray 与三角形在同一个空间中
+class TriangleBVH {
+public:
+    // 每 3 个顶点为一个三角形
+    void build(std::vector<Vector3> triangle_vertices);
+    bool empty() const { return m_bvh.empty(); }
+    bool raycast(const Ray &ray, float t_max, float &hit_t) const;
+
+private:
+    BVH                  m_bvh;
+    std::vector<Vector3> m_triangle_vertices;
+};
+
+template<typename IntersectPrimitiveFunc>
+bool BVH::raycast(const Ray              &ray,
+                  IntersectPrimitiveFunc &&intersect_primitive,
+                  float                   t_max,
+                  uint32_t               &hit_primitive,
+                  float                  &hit_t) const {
+    if (m_nodes.empty())
+        return false;
+
+    Vector3 inv_direction(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    bool  is_hit  = false;
+    float t_enter = 0.0f;
+
+    uint32_t stack[64];
+    uint32_t stack_size = 0;
+    if (RayIntersectsBox(ray, inv_direction, m_nodes[0].min_corner, m_nodes[0].max_corner, t_max, t_enter))
+        stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const Node &node = m_nodes[stack[--stack_size]];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (intersect_primitive(m_primitive_indices[i], t_max, t) && t < t_max) {
+                    t_max         = t;
+                    hit_primitive = m_primitive_indices[i];
+                    is_hit        = true;
+                }
+            }
+            continue;
+        }
+
+        // 先访问较近的子节点，较远的子节点先入栈
+        uint32_t    left       = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+        uint32_t    right      = node.first;
+        const Node &left_node  = m_nodes[left];
+        const Node &right_node = m_nodes[right];
+        float       t_left, t_right;
+        bool is_left_hit  = RayIntersectsBox(ray, inv_direction, left_node.min_corner, left_node.max_corner, t_max, t_left);
+        bool is_right_hit = RayIntersectsBox(ray, inv_direction, right_node.min_corner, right_node.max_corner, t_max, t_right);
+        if (is_left_hit && is_right_hit) {
+            if (t_left > t_right)
+                std::swap(left, right);
+            stack[stack_size++] = right;
+            stack[stack_size++] = left;
+        } else if (is_left_hit)
+            stack[stack_size++] = left;
+        else if (is_right_hit)
+            stack[stack_size++] = right;
+    }
+
+    if (is_hit)
+        hit_t = t_max;
+    return is_hit;
+}
+} // namespace Piccolo
@@ -0,0 +1,184 @@
+#include "runtime/core/profiler/profiler.h"
+
+#include "runtime/function/global/global_context.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace Piccolo {
+thread_local uint32_t Profiler::s_scope_depth {0};
+
+std::string ProfileTrack::getName() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_name;
+}
+
+void ProfileTrack::setName(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_name = name;
+}
+
+void ProfileTrack::record(const ProfileEvent &event) {
+    // 只有写入方修改这两个计数，自己读取不需要同步
+    uint64_t index = m_event_count.load(std::memory_order_relaxed);
+
+    // 先公开将要覆盖的槽，release fence 保证读取方看到新写入的字段时也能看到这里的序号
+    m_write_begin.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    EventSlot &slot = m_events[index % s_capacity];
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.begin_ns.store(event.begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(event.end_ns, std::memory_order_relaxed);
+    slot.depth.store(event.depth, std::memory_order_relaxed);
+
+    m_event_count.store(index + 1, std::memory_order_release);
+}
+
+void ProfileTrack::collect(uint64_t begin_ns, uint64_t end_ns, std::vector<ProfileEvent> &out_events) const {
+    size_t first_index = out_events.size();
+
+    uint64_t event_end   = m_event_count.load(std::memory_order_acquire);
+    uint64_t event_begin = event_end > s_capacity ? event_end - s_capacity : 0;
+
+    std::vector<ProfileEvent> snapshot;
+    snapshot.reserve(event_end - event_begin);
+    for (uint64_t i = event_begin; i < event_end; ++i) {
+        const EventSlot &slot = m_events[i % s_capacity];
+        snapshot.push_back(ProfileEvent {slot.name.load(std::memory_order_relaxed),
+                                         slot.begin_ns.load(std::memory_order_relaxed),
+                                         slot.end_ns.load(std::memory_order_relaxed),
+                                         slot.depth.load(std::memory_order_relaxed)});
+    }
+
+    // 复制期间写入方可能已经开始覆盖最旧的槽，序号 i 的槽在写入序号 i + s_capacity 时被覆盖
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t write_begin = m_write_begin.load(std::memory_order_relaxed);
+    uint64_t valid_begin = write_begin > s_capacity ? write_begin - s_capacity : 0;
+
+    for (uint64_t i = std::max(event_begin, valid_begin); i < event_end; ++i) {
+        const ProfileEvent &event = snapshot[i - event_begin];
+        if (event.end_ns > begin_ns && event.begin_ns < end_ns)
+            out_events.push_back(event);
+    }
+
+    // 父 scope 晚于子 scope 写入，按开始时间排序后恢复层级顺序
+    std::sort(out_events.begin() + first_index, out_events.end(), [](const ProfileEvent &lhs, const ProfileEvent &rhs) {
+        return lhs.begin_ns != rhs.begin_ns ? lhs.begin_ns < rhs.begin_ns : lhs.depth < rhs.depth;
+    });
+}
+
+void ProfileTrack::setLastFrameRange(uint64_t begin_ns, uint64_t end_ns) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_last_frame_begin_ns = begin_ns;
+    m_last_frame_end_ns   = end_ns;
+}
+
+bool ProfileTrack::getLastFrameRange(uint64_t &out_begin_ns, uint64_t &out_end_ns) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_last_frame_end_ns == 0)
+        return false;
+    out_begin_ns = m_last_frame_begin_ns;
+    out_end_ns   = m_last_frame_end_ns;
+    return true;
+}
+
+void Profiler::setThreadName(const std::string &name) { getThreadTrack().setName(name); }
+
+void Profiler::beginFrame() {
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+    m_last_frame_begin_ns = m_frame_begin_ns;
+    m_frame_begin_ns      = now();
+}
+
+void Profiler::record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth) {
+    getThreadTrack().record(ProfileEvent {name, begin_ns, end_ns, depth});
+}
+
+std::shared_ptr<ProfileTrack> Profiler::getOrCreateTrack(const std::string &name) {
+    std::lock_guard<std::mutex> lock(m_track_mutex);
+    for (const std::shared_ptr<ProfileTrack> &track : m_tracks) {
+        if (track->getName() == name)
+            return track;
+    }
+    m_tracks.push_back(std::make_shared<ProfileTrack>(name));
+    return m_tracks.back();
+}
+
+bool Profiler::getLastFrameRange(uint64_t &out_begin_ns, uint64_t &out_end_ns) const {
+    std::lock_guard<std::mutex> lock(m_frame_mutex);
+    if (m_last_frame_begin_ns == 0)
+        return false;
+    out_begin_ns = m_last_frame_begin_ns;
+    out_end_ns   = m_frame_begin_ns;
+    return true;
+}
+
+std::vector<std::shared_ptr<ProfileTrack>> Profiler::getTracks() const {
+    std::lock_guard<std::mutex> lock(m_track_mutex);
+    return m_tracks;
+}
+
+bool Profiler::exportChromeTrace(const std::string &file_path) const {
+    std::ofstream trace_file(file_path, std::ios::trunc);
+    if (!trace_file)
+        return false;
+
+    std::vector<std::shared_ptr<ProfileTrack>> tracks = getTracks();
+
+    std::vector<std::vector<ProfileEvent>> track_events(tracks.size());
+    uint64_t                               base_ns = std::numeric_limits<uint64_t>::max();
+    for (size_t track_index = 0; track_index < tracks.size(); ++track_index) {
+        tracks[track_index]->collect(0, std::numeric_limits<uint64_t>::max(), track_events[track_index]);
+        if (!track_events[track_index].empty())
+            base_ns = std::min(base_ns, track_events[track_index].front().begin_ns);
+    }
+
+    // 时间单位为微秒，以最早的事件为零点
+    trace_file << "{\"traceEvents\":[\n";
+    bool is_first_event = true;
+    auto write_separator = [&]() {
+        if (!is_first_event)
+            trace_file << ",\n";
+        is_first_event = false;
+    };
+    trace_file.setf(std::ios::fixed);
+    trace_file.precision(3);
+    for (size_t track_index = 0; track_index < tracks.size(); ++track_index) {
+        write_separator();
+        trace_file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track_index
+                   << ",\"args\":{\"name\":\"" << tracks[track_index]->getName() << "\"}}";
+
+        for (const ProfileEvent &event : track_events[track_index]) {
+            write_separator();
+            trace_file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << track_index
+                       << ",\"ts\":" << (event.begin_ns - base_ns) / 1000.0
+                       << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.0 << "}";
+        }
+    }
+    trace_file << "\n]}\n";
+    return true;
+}
+
+ProfileTrack &Profiler::getThreadTrack() {
+    thread_local std::shared_ptr<ProfileTrack> t_track;
+    thread_local const Profiler*               t_owner {nullptr};
+    if (t_owner != this || !t_track) {
+        std::lock_guard<std::mutex> lock(m_track_mutex);
+        t_track = std::make_shared<ProfileTrack>("thread " + std::to_string(m_tracks.size()));
+        t_owner = this;
+        m_tracks.push_back(t_track);
+    }
+    return *t_track;
+}
+
+ProfileScope::ProfileScope(const char* name) :
+    m_name(name), m_begin_ns(Profiler::now()), m_depth(Profiler::s_scope_depth++) {}
+
+ProfileScope::~ProfileScope() {
+    --Profiler::s_scope_depth;
+    if (g_runtime_global_context.m_profiler)
+        g_runtime_global_context.m_profiler->record(m_name, m_begin_ns, Profiler::now(), m_depth);
+}
+} // namespace Piccolo
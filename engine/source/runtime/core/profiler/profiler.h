@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Piccolo {
+// 一段计时，name 必须是生命周期贯穿整个程序的字符串（字面量）
+struct ProfileEvent {
+    const char* name {nullptr};
+    uint64_t    begin_ns {0};
+    uint64_t    end_ns {0};
+    uint32_t    depth {0};
+};
+
+// 一个线程（或 GPU 等外部时间线）的事件，写满后覆盖最旧的
+// 每个 track 只有一个写入方，record 不加锁；读取方复制一份快照，丢弃复制期间可能被覆盖的事件
+class ProfileTrack {
+public:
+    static constexpr uint32_t s_capacity {1u << 14};
+
+    explicit ProfileTrack(std::string name) : m_name(std::move(name)) {}
+
+    std::string getName() const;
+    void        setName(const std::string &name);
+
+    // 只能由唯一的写入方调用
+    void record(const ProfileEvent &event);
+
+    // 取出与 [begin_ns, end_ns) 有交集的事件，按开始时间排序
+    void collect(uint64_t begin_ns, uint64_t end_ns, std::vector<ProfileEvent> &out_events) const;
+
+    // 延迟写入的外部时间线（GPU）自行记录最近一帧的范围，线程 track 没有，返回 false
+    void setLastFrameRange(uint64_t begin_ns, uint64_t end_ns);
+    bool getLastFrameRange(uint64_t &out_begin_ns, uint64_t &out_end_ns) const;
+
+private:
+    // 读取方可能与写入方同时访问同一个槽，字段都是 relaxed 原子量，由 m_write_begin / m_event_count 判断是否有效
+    struct EventSlot {
+        std::atomic<const char*> name {nullptr};
+        std::atomic<uint64_t>    begin_ns {0};
+        std::atomic<uint64_t>    end_ns {0};
+        std::atomic<uint32_t>    depth {0};
+    };
+
+    std::array<EventSlot, s_capacity> m_events;
+    std::atomic<uint64_t>             m_write_begin {0}; // 正在写入的事件序号 + 1，先于槽的写入公开
+    std::atomic<uint64_t>             m_event_count {0}; // 已写完的事件数，槽写完之后 release
+
+    // 名字和帧范围很少修改，继续用锁
+    mutable std::mutex m_mutex;
+    std::string        m_name;
+    uint64_t           m_last_frame_begin_ns {0};
+    uint64_t           m_last_frame_end_ns {0};
+};
+
+// 层级 CPU 计时：每个线程第一次计时时注册自己的 ProfileTrack，计时本身只写本线程的 track
+class Profiler {
+public:
+    static uint64_t now() {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 当前线程的 track 名，不设置时按注册顺序命名
+    void setThreadName(const std::string &name);
+
+    // 由主线程在每帧开始时调用，作为 overlay 划分帧的依据
+    void beginFrame();
+
+    void record(const char* name, uint64_t begin_ns, uint64_t end_ns, uint32_t depth);
+
+    // 非当前线程的时间线（如 GPU）使用独立的 track
+    std::shared_ptr<ProfileTrack> getOrCreateTrack(const std::string &name);
+
+    // 最近一个完整帧的时间范围，没有完整帧时返回 false
+    bool getLastFrameRange(uint64_t &out_begin_ns, uint64_t &out_end_ns) const;
+
+    std::vector<std::shared_ptr<ProfileTrack>> getTracks() const;
+
+    // 导出 Chrome trace 格式（chrome://tracing、Perfetto 可直接打开），包含所有 track 中仍保留的事件
+    bool exportChromeTrace(const std::string &file_path) const;
+
+    static thread_local uint32_t s_scope_depth;
+
+private:
+    ProfileTrack &getThreadTrack();
+
+    mutable std::mutex                         m_track_mutex;
+    std::vector<std::shared_ptr<ProfileTrack>> m_tracks;
+
+    mutable std::mutex m_frame_mutex;
+    uint64_t           m_frame_begin_ns {0};
+    uint64_t           m_last_frame_begin_ns {0};
+};
+
+// 构造时开始计时，析构时写入当前线程的 track
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope &)            = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char* m_name;
+    uint64_t    m_begin_ns;
+    uint32_t    m_depth;
+};
+} // namespace Piccolo
+
+// shipping 构建关闭 ENABLE_PROFILER，计时宏展开为空
+// PROFILE_THREAD 和 PROFILE_FRAME 需要 g_runtime_global_context，使用处自行包含 global_context.h
+#ifdef ENABLE_PROFILER
+    #define PICCOLO_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define PICCOLO_PROFILE_CONCAT(a, b) PICCOLO_PROFILE_CONCAT_IMPL(a, b)
+    #define PROFILE_SCOPE(name) ::Piccolo::ProfileScope PICCOLO_PROFILE_CONCAT(_profile_scope_, __LINE__)(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+    #define PROFILE_THREAD(name) \
+        do { \
+            if (g_runtime_global_context.m_profiler) \
+                g_runtime_global_context.m_profiler->setThreadName(name); \
+        } while (0)
+    #define PROFILE_FRAME() \
+        do { \
+            if (g_runtime_global_context.m_profiler) \
+                g_runtime_global_context.m_profiler->beginFrame(); \
+        } while (0)
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FUNCTION()
+    #define PROFILE_THREAD(name)
+    #define PROFILE_FRAME()
+#endif
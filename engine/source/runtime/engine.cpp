@@ -2,6 +2,7 @@
 
 #include "runtime/core/base/macro.h"
 #include "runtime/core/meta/reflection/reflection_register.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/global/global_context.h"
@@ -11,9 +12,14 @@
 #include "runtime/function/render/render_system.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Piccolo {
 bool                            g_is_editor_mode {false};
+bool                            g_is_headless_mode {false};
 std::unordered_set<std::string> g_editor_tick_component_types {};
 
 void PiccoloEngine::startEngine(const std::string &config_file_path) {
@@ -27,14 +33,30 @@ void PiccoloEngine::startEngine(const std::string &config_file_path) {
 void PiccoloEngine::shutdownEngine() {
     LOG_INFO("engine shutdown");
 
+    stopRenderThread();
+
     g_runtime_global_context.shutdownSystems();
 
     Reflection::TypeMetaRegister::metaUnregister();
 }
 
-void PiccoloEngine::initialize() {}
+void PiccoloEngine::initialize() {
+    std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+
+    m_enable_render_thread = config_manager->isRenderThreadEnabled() && !g_is_headless_mode;
+
+    uint32_t logic_tick_frequency = config_manager->getLogicTickFrequency();
+    m_logic_tick_interval         = logic_tick_frequency > 0 ? 1.f / logic_tick_frequency : 0.f;
+    m_max_logic_ticks_per_frame   = std::max(config_manager->getMaxLogicTicksPerFrame(), 1u);
+    m_logic_time_accumulator      = 0.f;
+}
 void PiccoloEngine::clear() {}
 
+void PiccoloEngine::setRenderThreadEnabled(bool enable) {
+    ASSERT(!m_render_thread.joinable());
+    m_enable_render_thread = enable && !g_is_headless_mode;
+}
+
 void PiccoloEngine::run() {
     std::shared_ptr<WindowSystem> window_system = g_runtime_global_context.m_window_system;
     ASSERT(window_system);
@@ -45,6 +67,30 @@ void PiccoloEngine::run() {
     }
 }
 
+void PiccoloEngine::runHeadless(uint32_t frame_count, float delta_time, const std::function<bool()> &should_stop) {
+    ASSERT(g_is_headless_mode);
+
+    LOG_INFO("headless run started, frame count: {}, delta time: {}", frame_count, delta_time);
+
+    using namespace std::chrono;
+    steady_clock::time_point start_time_point = steady_clock::now();
+
+    uint32_t frame_index = 0;
+    while (frame_count == 0 || frame_index < frame_count) {
+        if (should_stop && should_stop())
+            break;
+        tickOneFrame(delta_time);
+        ++frame_index;
+    }
+
+    // 每帧的实际耗时，供 CI 中的逻辑性能测试使用
+    duration<double, std::milli> time_span = steady_clock::now() - start_time_point;
+    LOG_INFO("headless run finished, {} frames in {:.3f} ms, {:.3f} ms per frame",
+             frame_index,
+             time_span.count(),
+             frame_index > 0 ? time_span.count() / frame_index : 0.0);
+}
+
 float PiccoloEngine::calculateDeltaTime() {
     float delta_time;
     {
@@ -60,14 +106,35 @@ float PiccoloEngine::calculateDeltaTime() {
 }
 
 bool PiccoloEngine::tickOneFrame(float delta_time) {
+    PROFILE_FRAME();
+    PROFILE_SCOPE("PiccoloEngine::tickOneFrame");
+
+    if (m_enable_render_thread && !m_render_thread.joinable())
+        startRenderThread();
+
     logicalTick(delta_time);
     calculateFPS(delta_time);
 
-    // single thread
-    // exchange data between logic and render contexts
-    g_runtime_global_context.m_render_system->swapLogicRenderData();
+    if (g_is_headless_mode)
+        return true;
 
-    rendererTick(delta_time);
+    if (m_render_thread.joinable()) {
+        // 等渲染线程处理完上一帧再交换，之后本帧的渲染与下一帧的逻辑并行
+        waitForRenderThread();
+        swapLogicRenderData(delta_time);
+        {
+            std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+            m_render_delta_time       = delta_time;
+            m_is_render_frame_pending = true;
+        }
+        m_render_thread_condition.notify_all();
+    } else {
+        // single thread
+        // exchange data between logic and render contexts
+        swapLogicRenderData(delta_time);
+
+        rendererTick(delta_time);
+    }
 
     #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     g_runtime_global_context.m_physics_manager->renderPhysicsWorld(delta_time);
@@ -83,12 +150,118 @@ bool PiccoloEngine::tickOneFrame(float delta_time) {
     return !should_window_close;
 }
 
+void PiccoloEngine::swapLogicRenderData(float delta_time) {
+    PROFILE_SCOPE("PiccoloEngine::swapLogicRenderData");
+
+    g_runtime_global_context.m_render_system->swapLogicRenderData();
+    // debug draw 各线程录制的 primitive 也只能在这里收集
+    g_runtime_global_context.m_debugdraw_manager->collectRecordedPrimitives(delta_time);
+}
+
+void PiccoloEngine::startRenderThread() {
+    m_is_render_frame_pending  = false;
+    m_is_render_thread_exiting = false;
+    m_render_thread            = std::thread(&PiccoloEngine::renderThreadLoop, this);
+    LOG_INFO("render thread started");
+}
+
+void PiccoloEngine::stopRenderThread() {
+    if (!m_render_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+        m_is_render_thread_exiting = true;
+    }
+    m_render_thread_condition.notify_all();
+    m_render_thread.join();
+}
+
+void PiccoloEngine::waitForRenderThread() {
+    PROFILE_SCOPE("PiccoloEngine::waitForRenderThread");
+
+    std::unique_lock<std::mutex> lock(m_render_thread_mutex);
+    while (m_is_render_frame_pending) {
+        // 渲染线程可能在等待窗口从最小化恢复，而窗口事件只能在主线程处理
+        bool is_render_frame_done = m_render_thread_condition.wait_for(
+            lock, std::chrono::milliseconds(10), [this]() { return !m_is_render_frame_pending; });
+        if (!is_render_frame_done) {
+            lock.unlock();
+            g_runtime_global_context.m_window_system->pollEvents();
+            lock.lock();
+        }
+    }
+}
+
+void PiccoloEngine::renderThreadLoop() {
+    PROFILE_THREAD("render");
+
+    while (true) {
+        float delta_time;
+        {
+            std::unique_lock<std::mutex> lock(m_render_thread_mutex);
+            m_render_thread_condition.wait(
+                lock, [this]() { return m_is_render_frame_pending || m_is_render_thread_exiting; });
+            // 退出前先渲染完已经交换的一帧
+            if (!m_is_render_frame_pending)
+                return;
+            delta_time = m_render_delta_time;
+        }
+
+        rendererTick(delta_time);
+
+        {
+            std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+            m_is_render_frame_pending = false;
+        }
+        m_render_thread_condition.notify_all();
+    }
+}
+
 void PiccoloEngine::logicalTick(float delta_time) {
-    g_runtime_global_context.m_world_manager->tick(delta_time);
-    g_runtime_global_context.m_input_system->tick();
+    PROFILE_SCOPE("PiccoloEngine::logicalTick");
+
+    float interpolation_alpha = 1.f;
+    if (m_logic_tick_interval > 0.f) {
+        m_logic_time_accumulator += delta_time;
+
+        uint32_t logic_tick_count = std::min(static_cast<uint32_t>(m_logic_time_accumulator / m_logic_tick_interval),
+                                             m_max_logic_ticks_per_frame);
+        // 不推进逻辑的帧不处理输入，光标位移留给之后推进逻辑的帧
+        inputTick(logic_tick_count);
+        for (uint32_t i = 0; i < logic_tick_count; ++i) {
+            logicalStep(m_logic_tick_interval);
+            m_logic_time_accumulator -= m_logic_tick_interval;
+        }
+
+        // 追不上时丢弃多出的整步，逻辑变慢但不会越积越多（spiral of death）
+        if (m_logic_time_accumulator >= m_logic_tick_interval)
+            m_logic_time_accumulator = std::fmod(m_logic_time_accumulator, m_logic_tick_interval);
+
+        interpolation_alpha = m_logic_time_accumulator / m_logic_tick_interval;
+    } else {
+        inputTick(1);
+        logicalStep(delta_time);
+    }
+
+    g_runtime_global_context.m_world_manager->tickRenderExtract(delta_time, interpolation_alpha);
+}
+
+void PiccoloEngine::logicalStep(float step_time) {
+    PROFILE_SCOPE("PiccoloEngine::logicalStep");
+
+    g_runtime_global_context.m_world_manager->tick(step_time);
+}
+
+void PiccoloEngine::inputTick(uint32_t logic_step_count) {
+    if (g_is_headless_mode || logic_step_count == 0)
+        return;
+    g_runtime_global_context.m_input_system->tick(logic_step_count);
 }
 
 bool PiccoloEngine::rendererTick(float delta_time) {
+    PROFILE_SCOPE("PiccoloEngine::rendererTick");
+
     g_runtime_global_context.m_render_system->tick(delta_time);
     return true;
 }
@@ -2,12 +2,18 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 namespace Piccolo {
 extern bool                            g_is_editor_mode;
+extern bool                            g_is_headless_mode;
 extern std::unordered_set<std::string> g_editor_tick_component_types;
 
 class PiccoloEngine {
@@ -26,14 +32,34 @@ public:
     void run();
     bool tickOneFrame(float delta_time);
 
+    // headless 模式下没有窗口、输入和渲染，以固定的 delta_time 运行 frame_count 帧（为 0 时不限帧数），
+    // should_stop 返回 true 时提前结束
+    void runHeadless(uint32_t frame_count, float delta_time, const std::function<bool()> &should_stop = nullptr);
+
     int getFPS() const { return m_fps; }
 
+    // 覆盖配置中的 EnableRenderThread，需要在 initialize 之后、第一帧 tick 之前调用；headless 模式下始终关闭
+    void setRenderThreadEnabled(bool enable);
+
 protected:
+    // 逻辑按固定步长推进，一帧可能推进多步或不推进，之后按剩余时间插值提交给渲染
     void logicalTick(float delta_time);
+    void logicalStep(float step_time);
+    // 每帧最多一次，在本帧的逻辑步之前
+    void inputTick(uint32_t logic_step_count);
     bool rendererTick(float delta_time);
 
     void calculateFPS(float delta_time);
 
+    // 在逻辑与渲染之间交换 swap data，调用时渲染一侧必须空闲
+    void swapLogicRenderData(float delta_time);
+
+    // 渲染线程上的 rendererTick 比逻辑晚一帧，swap 是两者唯一的同步点，渲染线程中最多排队一帧
+    void startRenderThread();
+    void stopRenderThread();
+    void waitForRenderThread();
+    void renderThreadLoop();
+
     /**
      *  Each frame can only be called once
      */
@@ -47,6 +73,21 @@ protected:
     float m_average_duration {0.f};
     int   m_frame_count {0};
     int   m_fps {0};
+
+    // 为 0 时不使用固定步长，每帧按帧时间 tick 一次逻辑
+    float    m_logic_tick_interval {0.f};
+    uint32_t m_max_logic_ticks_per_frame {1};
+    float    m_logic_time_accumulator {0.f};
+
+    // 由配置或 setRenderThreadEnabled 决定是否使用渲染线程，编辑器的 UI 在渲染 tick 中读写场景，会关闭它
+    bool m_enable_render_thread {false};
+
+    std::thread             m_render_thread;
+    std::mutex              m_render_thread_mutex;
+    std::condition_variable m_render_thread_condition;
+    bool                    m_is_render_frame_pending {false}; // 已交换 swap data，渲染线程尚未处理完这一帧
+    bool                    m_is_render_thread_exiting {false};
+    float                   m_render_delta_time {0.f};
 };
 
 } // namespace Piccolo
@@ -10,8 +10,10 @@ std::map<std::string, std::shared_ptr<SkeletonData>>  AnimationManager::m_skelet
 std::map<std::string, std::shared_ptr<AnimationClip>> AnimationManager::m_animation_data_cache;
 std::map<std::string, std::shared_ptr<AnimSkelMap>>   AnimationManager::m_animation_skeleton_map_cache;
 std::map<std::string, std::shared_ptr<BoneBlendMask>> AnimationManager::m_skeleton_mask_cache;
+std::mutex                                            AnimationManager::m_cache_mutex;
 
 std::shared_ptr<SkeletonData> AnimationManager::tryLoadSkeleton(std::string file_path) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
     std::shared_ptr<SkeletonData> res;
     AnimationLoader               loader;
     auto                          found = m_skeleton_definition_cache.find(file_path);
@@ -24,6 +26,7 @@ std::shared_ptr<SkeletonData> AnimationManager::tryLoadSkeleton(std::string file
 }
 
 std::shared_ptr<AnimationClip> AnimationManager::tryLoadAnimation(std::string file_path) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
     std::shared_ptr<AnimationClip> res;
     AnimationLoader                loader;
     auto                           found = m_animation_data_cache.find(file_path);
@@ -36,6 +39,7 @@ std::shared_ptr<AnimationClip> AnimationManager::tryLoadAnimation(std::string fi
 }
 
 std::shared_ptr<AnimSkelMap> AnimationManager::tryLoadAnimationSkeletonMap(std::string file_path) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
     std::shared_ptr<AnimSkelMap> res;
     AnimationLoader              loader;
     auto                         found = m_animation_skeleton_map_cache.find(file_path);
@@ -48,6 +52,7 @@ std::shared_ptr<AnimSkelMap> AnimationManager::tryLoadAnimationSkeletonMap(std::
 }
 
 std::shared_ptr<BoneBlendMask> AnimationManager::tryLoadSkeletonMask(std::string file_path) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
     std::shared_ptr<BoneBlendMask> res;
     AnimationLoader                loader;
     auto                           found = m_skeleton_mask_cache.find(file_path);
@@ -61,26 +66,20 @@ std::shared_ptr<BoneBlendMask> AnimationManager::tryLoadSkeletonMask(std::string
 
 BlendStateWithClipData AnimationManager::getBlendStateWithClipData(const BlendState &blend_state) {
 
-    for (auto animation_file_path : blend_state.blend_clip_file_path)
-        tryLoadAnimation(animation_file_path);
-    for (auto anim_skel_map_path : blend_state.blend_anim_skel_map_path)
-        tryLoadAnimationSkeletonMap(anim_skel_map_path);
-    for (auto skeleton_mask_path : blend_state.blend_mask_file_path)
-        tryLoadSkeletonMask(skeleton_mask_path);
-
+    // 通过 tryLoad* 取得缓存中的数据，不直接访问可能被其他线程修改的 map
     BlendStateWithClipData blend_state_with_clip_data;
     blend_state_with_clip_data.clip_count  = blend_state.clip_count;
     blend_state_with_clip_data.blend_ratio = blend_state.blend_ratio;
-    for (const auto &iter : blend_state.blend_clip_file_path)
-        blend_state_with_clip_data.blend_clip.push_back(*m_animation_data_cache[iter]);
-    for (const auto &iter : blend_state.blend_anim_skel_map_path)
-        blend_state_with_clip_data.blend_anim_skel_map.push_back(*m_animation_skeleton_map_cache[iter]);
+    for (const auto &animation_file_path : blend_state.blend_clip_file_path)
+        blend_state_with_clip_data.blend_clip.push_back(*tryLoadAnimation(animation_file_path));
+    for (const auto &anim_skel_map_path : blend_state.blend_anim_skel_map_path)
+        blend_state_with_clip_data.blend_anim_skel_map.push_back(*tryLoadAnimationSkeletonMap(anim_skel_map_path));
     std::vector<std::shared_ptr<BoneBlendMask>> blend_masks;
-    for (auto &iter : blend_state.blend_mask_file_path) {
-        blend_masks.push_back(m_skeleton_mask_cache[iter]);
-        tryLoadAnimationSkeletonMap(m_skeleton_mask_cache[iter]->skeleton_file_path);
+    for (const auto &skeleton_mask_path : blend_state.blend_mask_file_path) {
+        blend_masks.push_back(tryLoadSkeletonMask(skeleton_mask_path));
+        tryLoadAnimationSkeletonMap(blend_masks.back()->skeleton_file_path);
     }
-    size_t skeleton_bone_count = m_skeleton_definition_cache[blend_masks[0]->skeleton_file_path]->bones_map.size();
+    size_t skeleton_bone_count = tryLoadSkeleton(blend_masks[0]->skeleton_file_path)->bones_map.size();
     blend_state_with_clip_data.blend_weight.resize(blend_state.clip_count);
     for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
         blend_state_with_clip_data.blend_weight[clip_index].blend_weight.resize(skeleton_bone_count);
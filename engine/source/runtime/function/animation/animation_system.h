@@ -8,6 +8,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace Piccolo {
@@ -17,6 +18,8 @@ private:
     static std::map<std::string, std::shared_ptr<AnimationClip>> m_animation_data_cache;
     static std::map<std::string, std::shared_ptr<AnimSkelMap>>   m_animation_skeleton_map_cache;
     static std::map<std::string, std::shared_ptr<BoneBlendMask>> m_skeleton_mask_cache;
+    // 缓存的查找和加载需要加锁；animation component 只在 postLoadResource 中访问缓存，并行 tick 时不经过这里
+    static std::mutex                                             m_cache_mutex;
 
 public:
     static std::shared_ptr<SkeletonData>  tryLoadSkeleton(std::string file_path);
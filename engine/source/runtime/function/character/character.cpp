@@ -70,6 +70,15 @@ void Character::tick(float delta_time) {
     //    (m_position * (s_camera_blend_time - frame_length) + new_position * frame_length) / s_camera_blend_time;
 }
 
+void Character::tickRenderExtract(float interpolation_alpha) {
+    if (m_character_object == nullptr)
+        return;
+
+    CameraComponent* camera_component = m_character_object->tryGetComponent(CameraComponent);
+    if (camera_component)
+        camera_component->tickRenderExtract(interpolation_alpha);
+}
+
 void Character::toggleFreeCamera() {
     CameraComponent* camera_component = m_character_object->tryGetComponent(CameraComponent);
     if (camera_component == nullptr) return;
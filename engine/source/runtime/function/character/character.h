@@ -25,6 +25,8 @@ public:
     const Quaternion &getRotation() const { return m_rotation; }
 
     void tick(float delta_time);
+    // 每帧调用一次，在 transform 插值之后
+    void tickRenderExtract(float interpolation_alpha);
 
 private:
     void toggleFreeCamera();
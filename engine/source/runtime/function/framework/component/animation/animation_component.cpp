@@ -5,11 +5,13 @@
 
 namespace Piccolo {
 void AnimationComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
     auto skeleton_res = AnimationManager::tryLoadSkeleton(m_animation_res.skeleton_file_path);
 
     m_skeleton.buildSkeleton(*skeleton_res);
+
+    m_blend_state_with_clip_data = AnimationManager::getBlendStateWithClipData(m_animation_res.blend_state);
 }
 
 void AnimationComponent::tick(float delta_time) {
@@ -17,7 +19,8 @@ void AnimationComponent::tick(float delta_time) {
         (delta_time / m_animation_res.blend_state.blend_clip_file_length[0]);
     m_animation_res.blend_state.blend_ratio[0] -= floor(m_animation_res.blend_state.blend_ratio[0]);
 
-    m_skeleton.applyAnimation(AnimationManager::getBlendStateWithClipData(m_animation_res.blend_state));
+    m_blend_state_with_clip_data.blend_ratio = m_animation_res.blend_state.blend_ratio;
+    m_skeleton.applyAnimation(m_blend_state_with_clip_data);
     m_animation_res.animation_result = m_skeleton.outputAnimationResult();
 }
 
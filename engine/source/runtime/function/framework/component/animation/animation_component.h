@@ -16,6 +16,9 @@ public:
 
     void tick(float delta_time) override;
 
+    ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::animation; }
+    uint32_t           getTickSharedWrites() const override { return k_tick_write_none; }
+
     const AnimationResult &getResult() const;
 
     const Skeleton &getSkeleton() const;
@@ -25,5 +28,8 @@ protected:
     AnimationComponentRes m_animation_res;
 
     Skeleton m_skeleton;
+
+    // 在 postLoadResource 中从 AnimationManager 取得一次，tick 中只更新 blend_ratio，不加锁也不复制 clip
+    BlendStateWithClipData m_blend_state_with_clip_data;
 };
 } // namespace Piccolo
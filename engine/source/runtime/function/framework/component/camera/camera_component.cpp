@@ -15,9 +15,11 @@
 #include "runtime/function/render/render_swap_context.h"
 #include "runtime/function/render/render_system.h"
 
+#include "runtime/engine.h"
+
 namespace Piccolo {
 void CameraComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
     const std::string &camera_type_name = m_camera_res.m_parameter.getTypeName();
     if (camera_type_name == "FirstPersonCameraParameter")
@@ -29,6 +31,9 @@ void CameraComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
     else
         LOG_ERROR("invalid camera type");
 
+    if (g_is_headless_mode)
+        return;
+
     RenderSwapContext &swap_context = g_runtime_global_context.m_render_system->getSwapContext();
     CameraSwapData     camera_swap_data;
     camera_swap_data.m_fov_x                           = m_camera_res.m_parameter->m_fov;
@@ -36,7 +41,7 @@ void CameraComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
 }
 
 void CameraComponent::tick(float delta_time) {
-    if (!m_parent_object.lock())
+    if (!m_parent_object)
         return;
 
     std::shared_ptr<Level> current_level = g_runtime_global_context.m_world_manager->getCurrentActiveLevel().lock();
@@ -44,7 +49,7 @@ void CameraComponent::tick(float delta_time) {
     if (current_character == nullptr)
         return;
 
-    if (current_character->getObjectID() != m_parent_object.lock()->getID())
+    if (current_character->getObjectID() != m_parent_object->getID())
         return;
 
     // Common input processing
@@ -75,11 +80,42 @@ void CameraComponent::tick(float delta_time) {
         break;
     }
 
-    updateCameraRenderData();
+    updatePose(current_character);
+}
+
+void CameraComponent::tickRenderExtract(float interpolation_alpha) {
+    if (!m_parent_object || m_pose_camera_mode == CameraMode::invalid)
+        return;
+
+    // mesh 提交的是插值后的 transform，相机也以它为参考点，否则会按逻辑步长相对 character 跳动
+    Vector3 anchor_position = Vector3::ZERO;
+    if (m_pose_camera_mode != CameraMode::free) {
+        const TransformComponent* transform_component = m_parent_object->tryGetComponentConst(TransformComponent);
+        if (transform_component)
+            anchor_position = transform_component->getRenderPosition();
+    }
+
+    Vector3 position_offset =
+        Vector3::lerp(m_previous_pose.position_offset, m_current_pose.position_offset, interpolation_alpha);
+    Vector3 forward = Vector3::lerp(m_previous_pose.forward, m_current_pose.forward, interpolation_alpha);
+    Vector3 up      = Vector3::lerp(m_previous_pose.up, m_current_pose.up, interpolation_alpha);
+    updateCameraRenderData(anchor_position + position_offset, forward, up);
 }
 
-void CameraComponent::updateCameraRenderData() {
-    Matrix4x4 desired_mat = Math::makeLookAtMatrix(m_position, m_position + m_forward, m_up);
+void CameraComponent::updatePose(std::shared_ptr<Character> current_character) {
+    Vector3 anchor_position = m_camera_mode == CameraMode::free ? Vector3::ZERO : current_character->getPosition();
+    CameraComponentPose pose {m_position - anchor_position, m_forward, m_up};
+
+    m_previous_pose    = m_pose_camera_mode == m_camera_mode ? m_current_pose : pose;
+    m_current_pose     = pose;
+    m_pose_camera_mode = m_camera_mode;
+}
+
+void CameraComponent::updateCameraRenderData(const Vector3 &position, const Vector3 &forward, const Vector3 &up) {
+    if (g_is_headless_mode)
+        return;
+
+    Matrix4x4 desired_mat = Math::makeLookAtMatrix(position, position + forward, up);
 
     RenderSwapContext &swap_context = g_runtime_global_context.m_render_system->getSwapContext();
     CameraSwapData camera_swap_data;
@@ -136,7 +172,7 @@ void CameraComponent::tickFreeCamera(float delta_time, float delta_pitch_rad, co
     // Game command check specific to free camera's operation
     unsigned int command = g_runtime_global_context.m_input_system->getGameCommand();
     // If command is invalid, free camera doesn't update its state.
-    // The common updateCameraRenderData() in tick() will use the unchanged state from the previous frame.
+    // The common updatePose() in tick() will record the unchanged state from the previous frame.
     if (command >= (unsigned int)GameCommand::invalid) return;
 
     Quaternion q_pitch;
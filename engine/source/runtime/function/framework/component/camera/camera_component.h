@@ -11,6 +11,13 @@ namespace Piccolo {
 class RenderCamera;
 class Character;
 
+// 一个逻辑步长结束时的相机姿态，位置相对于 character（自由相机相对于原点）
+struct CameraComponentPose {
+    Vector3 position_offset;
+    Vector3 forward;
+    Vector3 up;
+};
+
 REFLECTION_TYPE(CameraComponent)
 CLASS(CameraComponent : public Component, WhiteListFields) {
     REFLECTION_BODY(CameraComponent)
@@ -20,6 +27,12 @@ public:
     void postLoadResource(std::weak_ptr<GObject> parent_object) override;
     void tick(float delta_time) override;
 
+    // 按逻辑步长处理输入并跟随 character 的逻辑位置，会修改 character 的朝向
+    ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::post_physics; }
+
+    // 每帧由 Character 调用一次，按与 transform 相同的 alpha 插值后提交相机，和 mesh 的插值位置保持一致
+    void tickRenderExtract(float interpolation_alpha);
+
     CameraMode getCameraMode() const { return m_camera_mode; }
     Vector3    getPosition() const { return m_position; }
     void       setCameraMode(CameraMode mode) { m_camera_mode = mode; }
@@ -35,7 +48,8 @@ private:
     void tickThirdPersonCamera(float delta_time, std::shared_ptr<Character> current_character, float delta_pitch_rad, const Quaternion& q_yaw);
     void tickFreeCamera(float delta_time, float delta_pitch_rad, const Quaternion& q_yaw);
 
-    void updateCameraRenderData();
+    void updatePose(std::shared_ptr<Character> current_character);
+    void updateCameraRenderData(const Vector3 &position, const Vector3 &forward, const Vector3 &up);
 
     META(Enable)
     CameraComponentRes m_camera_res;
@@ -49,5 +63,10 @@ private:
     Vector3 m_forward {Vector3::NEGATIVE_UNIT_Y};
     Vector3 m_up {Vector3::UNIT_Z};
     Vector3 m_left {Vector3::UNIT_X};
+
+    // 最近两个逻辑步长的姿态，切换相机模式后 offset 的参考点不同，不在两者之间插值
+    CameraComponentPose m_previous_pose;
+    CameraComponentPose m_current_pose;
+    CameraMode          m_pose_camera_mode {CameraMode::invalid};
 };
 } // namespace Piccolo
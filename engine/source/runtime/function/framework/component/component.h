@@ -1,30 +1,68 @@
 #pragma once
 #include "runtime/core/meta/reflection/reflection.h"
 
+#include <array>
+#include <vector>
+
 namespace Piccolo {
 class GObject;
+class Component;
+
+// Level::tick 按以下顺序逐个阶段 tick component
+enum class ComponentTickPhase : uint8_t {
+    pre_physics,
+    physics,
+    post_physics,
+    animation,
+    render_extract,
+    count
+};
+
+// component tick 时会写入的共享数据（所属 GObject 以外的数据）
+// 为 none 的 component 只读写自身 GObject 的数据，同一阶段内可以与其他 GObject 并行 tick
+enum ComponentTickSharedWrite : uint32_t {
+    k_tick_write_none         = 0,
+    k_tick_write_render_swap  = 1 << 0, // RenderSwapContext 中的 logic swap data
+    k_tick_write_physics      = 1 << 1, // PhysicsScene
+    k_tick_write_any          = ~0u     // 未声明，可能写入任意全局状态
+};
+
+struct ComponentTickQueue {
+    std::vector<Component*> parallel_components;
+    std::vector<Component*> serial_components;
+};
+
+using ComponentTickQueues = std::array<ComponentTickQueue, static_cast<size_t>(ComponentTickPhase::count)>;
+
 // Component
 REFLECTION_TYPE(Component)
 CLASS(Component, WhiteListFields) {
     REFLECTION_BODY(Component)
 protected:
-    std::weak_ptr<GObject> m_parent_object;
-    bool                   m_is_dirty {false};
-    bool                   m_is_scale_dirty {false};
+    // component 由所属 GObject 持有，生命周期不会超过它，直接保存指针，访问时不必 weak_ptr::lock
+    GObject* m_parent_object {nullptr};
+    bool     m_is_dirty {false};
+    bool     m_is_scale_dirty {false};
+    bool     m_is_ticked_by_system {false}; // 由 Level 中的 system 统一更新，GObject::tick 中跳过
 
 public:
     Component() = default;
     virtual ~Component() {}
 
     // Instantiating the component after definition loaded
-    virtual void postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
+    virtual void postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object.lock().get(); }
 
     virtual void tick(float delta_time) {};
 
+    virtual ComponentTickPhase getTickPhase() const { return ComponentTickPhase::pre_physics; }
+    virtual uint32_t           getTickSharedWrites() const { return k_tick_write_any; }
+
     bool isDirty() const { return m_is_dirty; }
 
     void setDirtyFlag(bool is_dirty) { m_is_dirty = is_dirty; }
 
+    bool isTickedBySystem() const { return m_is_ticked_by_system; }
+
     bool m_tick_in_editor_mode {false};
 };
 
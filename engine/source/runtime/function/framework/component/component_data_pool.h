@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Piccolo {
+using ComponentDataHandle = uint32_t;
+
+constexpr ComponentDataHandle k_invalid_component_data_handle = std::numeric_limits<uint32_t>::max();
+
+// 把某类 component 的热数据按列（SoA）连续存放，system 可以按下标线性遍历
+// 释放时把最后一项搬到空位上保持紧凑，handle 经过一层间接表，搬动后仍然有效
+template<typename... TColumns>
+class ComponentDataPool {
+public:
+    template<size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<TColumns...>>;
+
+    ComponentDataHandle allocate(const TColumns &... values) {
+        ComponentDataHandle handle;
+        if (!m_free_handles.empty()) {
+            handle = m_free_handles.back();
+            m_free_handles.pop_back();
+        } else {
+            handle = static_cast<ComponentDataHandle>(m_handle_to_index.size());
+            m_handle_to_index.push_back(k_invalid_component_data_handle);
+        }
+
+        m_handle_to_index[handle] = size();
+        m_index_to_handle.push_back(handle);
+        pushBack(std::index_sequence_for<TColumns...> {}, values...);
+        return handle;
+    }
+
+    void free(ComponentDataHandle handle) {
+        assert(isValid(handle));
+        uint32_t index      = m_handle_to_index[handle];
+        uint32_t last_index = size() - 1;
+        if (index != last_index) {
+            moveEntry(std::index_sequence_for<TColumns...> {}, last_index, index);
+            m_index_to_handle[index]                    = m_index_to_handle[last_index];
+            m_handle_to_index[m_index_to_handle[index]] = index;
+        }
+        popBack(std::index_sequence_for<TColumns...> {});
+        m_index_to_handle.pop_back();
+
+        m_handle_to_index[handle] = k_invalid_component_data_handle;
+        m_free_handles.push_back(handle);
+    }
+
+    bool isValid(ComponentDataHandle handle) const {
+        return handle < m_handle_to_index.size() && m_handle_to_index[handle] != k_invalid_component_data_handle;
+    }
+
+    uint32_t size() const { return static_cast<uint32_t>(m_index_to_handle.size()); }
+
+    uint32_t            getIndex(ComponentDataHandle handle) const { return m_handle_to_index[handle]; }
+    ComponentDataHandle getHandle(uint32_t index) const { return m_index_to_handle[index]; }
+
+    template<size_t I>
+    ColumnType<I> &get(ComponentDataHandle handle) {
+        return std::get<I>(m_columns)[m_handle_to_index[handle]];
+    }
+
+    template<size_t I>
+    const ColumnType<I> &get(ComponentDataHandle handle) const {
+        return std::get<I>(m_columns)[m_handle_to_index[handle]];
+    }
+
+    // 整列数据，下标与 getIndex 一致
+    template<size_t I>
+    std::vector<ColumnType<I>> &getColumn() {
+        return std::get<I>(m_columns);
+    }
+
+    template<size_t I>
+    const std::vector<ColumnType<I>> &getColumn() const {
+        return std::get<I>(m_columns);
+    }
+
+private:
+    template<size_t... Is>
+    void pushBack(std::index_sequence<Is...>, const TColumns &... values) {
+        (std::get<Is>(m_columns).push_back(values), ...);
+    }
+
+    template<size_t... Is>
+    void moveEntry(std::index_sequence<Is...>, uint32_t from, uint32_t to) {
+        ((std::get<Is>(m_columns)[to] = std::move(std::get<Is>(m_columns)[from])), ...);
+    }
+
+    template<size_t... Is>
+    void popBack(std::index_sequence<Is...>) {
+        (std::get<Is>(m_columns).pop_back(), ...);
+    }
+
+    std::tuple<std::vector<TColumns>...> m_columns;
+
+    std::vector<uint32_t>            m_handle_to_index;
+    std::vector<ComponentDataHandle> m_index_to_handle;
+    std::vector<ComponentDataHandle> m_free_handles;
+};
+} // namespace Piccolo
@@ -0,0 +1,17 @@
+#include "runtime/function/framework/component/component_type_id.h"
+
+#include <unordered_map>
+
+namespace Piccolo {
+ComponentTypeID getComponentTypeID(const std::string &component_type_name) {
+    static const std::unordered_map<std::string, ComponentTypeID> type_ids = []() {
+        std::unordered_map<std::string, ComponentTypeID> ids;
+        for (ComponentTypeID id = 0; id < k_component_type_count; ++id)
+            ids.emplace(k_component_type_names[id], id);
+        return ids;
+    }();
+
+    auto iter = type_ids.find(component_type_name);
+    return iter == type_ids.end() ? k_invalid_component_type_id : iter->second;
+}
+} // namespace Piccolo
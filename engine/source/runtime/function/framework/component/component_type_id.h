@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Piccolo {
+using ComponentTypeID = uint32_t;
+
+static constexpr ComponentTypeID k_invalid_component_type_id = UINT32_MAX;
+
+// meta parser 为每个反射的 Component 子类生成一个特化，value 为从 0 开始连续的 id
+template<typename TComponent>
+struct ComponentTypeIDOf;
+} // namespace Piccolo
+
+#include "_generated/reflection/all_component_type_id.h"
+
+namespace Piccolo {
+// 每个 GObject 以一个 64 位的 mask 记录拥有哪些类型的 component
+static_assert(k_component_type_count <= 64, "component type mask only holds 64 component types");
+
+// 字符串到 id 的查找，供反射和编辑器使用，未知的类型返回 k_invalid_component_type_id
+ComponentTypeID getComponentTypeID(const std::string &component_type_name);
+} // namespace Piccolo
@@ -115,12 +115,13 @@ void LuaComponent::invoke(std::weak_ptr<GObject> game_object, const char* name)
 }
 
 void LuaComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
     m_lua_state.open_libraries(sol::lib::base);
     m_lua_state.set_function("set_float", &LuaComponent::set<float>);
     m_lua_state.set_function("get_bool", &LuaComponent::get<bool>);
     m_lua_state.set_function("invoke", &LuaComponent::invoke);
-    m_lua_state["GameObject"] = m_parent_object;
+    // 脚本通过 weak_ptr 访问对象，对象删除后的调用能安全失败
+    m_lua_state["GameObject"] = parent_object;
 
     loadLuaScript(); // load lua script from file or string
 }
@@ -13,7 +13,7 @@
 
 namespace Piccolo {
 void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
     std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
     ASSERT(asset_manager);
@@ -53,12 +53,12 @@ void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
 }
 
 void MeshComponent::tick(float delta_time) {
-    if (!m_parent_object.lock())
+    if (!m_parent_object)
         return;
 
-    TransformComponent*       transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
+    TransformComponent*       transform_component = m_parent_object->tryGetComponent(TransformComponent);
     const AnimationComponent* animation_component =
-        m_parent_object.lock()->tryGetComponentConst(AnimationComponent);
+        m_parent_object->tryGetComponentConst(AnimationComponent);
 
     if (transform_component->isDirty()) {
         std::vector<GameObjectPartDesc> dirty_mesh_parts;
@@ -78,7 +78,7 @@ void MeshComponent::tick(float delta_time) {
             Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
 
             mesh_part.m_transform_desc.m_transform_matrix =
-                transform_component->getMatrix() * object_transform_matrix;
+                transform_component->getRenderMatrix() * object_transform_matrix;
             dirty_mesh_parts.push_back(mesh_part);
 
             mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
@@ -87,7 +87,7 @@ void MeshComponent::tick(float delta_time) {
         RenderSwapContext &render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
         RenderSwapData    &logic_swap_data     = render_swap_context.getLogicSwapData();
 
-        logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object.lock()->getID(), dirty_mesh_parts});
+        logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object->getID(), dirty_mesh_parts});
 
         transform_component->setDirtyFlag(false);
     }
@@ -23,6 +23,9 @@ public:
 
     void tick(float delta_time) override;
 
+    ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::render_extract; }
+    uint32_t           getTickSharedWrites() const override { return k_tick_write_render_swap; }
+
 private:
     META(Enable)
     MeshComponentRes m_mesh_res;
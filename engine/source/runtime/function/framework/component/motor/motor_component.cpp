@@ -16,7 +16,7 @@
 
 namespace Piccolo {
 void MotorComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
     if (m_motor_res.m_controller_config.getTypeName() == "PhysicsControllerConfig") {
         m_controller_type = ControllerType::physics;
@@ -43,7 +43,7 @@ MotorComponent::~MotorComponent() {
 }
 
 void MotorComponent::tick(float delta_time) {
-    if (!m_parent_object.lock())
+    if (!m_parent_object)
         return;
 
     std::shared_ptr<Level> current_level = g_runtime_global_context.m_world_manager->getCurrentActiveLevel().lock();
@@ -51,11 +51,11 @@ void MotorComponent::tick(float delta_time) {
     if (current_character == nullptr)
         return;
 
-    if (current_character->getObjectID() != m_parent_object.lock()->getID())
+    if (current_character->getObjectID() != m_parent_object->getID())
         return;
 
     TransformComponent* transform_component =
-        m_parent_object.lock()->tryGetComponent<TransformComponent>("TransformComponent");
+        m_parent_object->tryGetComponent(TransformComponent);
 
     Radian turn_angle_yaw = g_runtime_global_context.m_input_system->getCursorDeltaYaw();
 
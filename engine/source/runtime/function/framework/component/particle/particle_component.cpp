@@ -11,7 +11,7 @@
 
 namespace Piccolo {
 void ParticleComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
     std::shared_ptr<ParticleManager> particle_manager = g_runtime_global_context.m_particle_manager;
     ASSERT(particle_manager);
@@ -25,7 +25,7 @@ void ParticleComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
 
 void ParticleComponent::computeGlobalTransform() {
     TransformComponent* transform_component =
-        m_parent_object.lock()->tryGetComponent<TransformComponent>("TransformComponent");
+        m_parent_object->tryGetComponent(TransformComponent);
 
     Matrix4x4 global_transform_matrix = transform_component->getMatrix() * m_local_transform;
 
@@ -45,7 +45,7 @@ void ParticleComponent::tick(float delta_time) {
 
     logic_swap_data.addTickParticleEmitter(m_transform_desc.m_id);
 
-    TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
+    TransformComponent* transform_component = m_parent_object->tryGetComponent(TransformComponent);
     if (transform_component->isDirty()) {
         computeGlobalTransform();
 
@@ -20,6 +20,9 @@ public:
 
     void tick(float delta_time) override;
 
+    ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::render_extract; }
+    uint32_t           getTickSharedWrites() const override { return k_tick_write_render_swap; }
+
 private:
     void computeGlobalTransform();
 
@@ -12,9 +12,9 @@
 
 namespace Piccolo {
 void RigidBodyComponent::postLoadResource(std::weak_ptr<GObject> parent_object) {
-    m_parent_object = parent_object;
+    m_parent_object = parent_object.lock().get();
 
-    const TransformComponent* parent_transform = m_parent_object.lock()->tryGetComponentConst(TransformComponent);
+    const TransformComponent* parent_transform = m_parent_object->tryGetComponentConst(TransformComponent);
     if (parent_transform == nullptr) {
         LOG_ERROR("No transform component in the object");
         return;
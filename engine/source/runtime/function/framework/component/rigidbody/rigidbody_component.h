@@ -15,6 +15,9 @@ public:
     void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
     void tick(float delta_time) override {}
+
+    ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::post_physics; }
+
     void updateGlobalTransform(const Transform & transform, bool is_scale_dirty);
     void getShapeBoundingBoxes(std::vector<AxisAlignedBox>  &out_boudning_boxes) const;
 
@@ -1,56 +1,147 @@
 #include "runtime/function/framework/component/transform/transform_component.h"
 
+#include "runtime/core/profiler/profiler.h"
 #include "runtime/engine.h"
 #include "runtime/function/framework/component/rigidbody/rigidbody_component.h"
 
+#include <algorithm>
+
 namespace Piccolo {
+void TransformDataPool::tick(float delta_time) {
+    PROFILE_SCOPE("TransformDataPool::tick");
+
+    const std::vector<uint8_t> &enabled = getColumn<k_enabled_column>();
+    for (uint32_t index = 0; index < size(); ++index) {
+        if (enabled[index])
+            tickEntry(index);
+    }
+}
+
+void TransformDataPool::tickEntry(uint32_t index) {
+    std::array<Transform, 2> &buffer        = getColumn<k_buffer_column>()[index];
+    uint8_t                  &current_index = getColumn<k_current_index_column>()[index];
+    TransformComponent*       owner         = getColumn<k_owner_column>()[index];
+
+    getColumn<k_previous_column>()[index] = buffer[current_index];
+    current_index ^= 1;
+
+    // setter 写的是下一个 buffer，交换后才把 dirty 标记给当前 buffer，与 setter 和 mesh component tick 的先后无关
+    uint8_t &is_dirty         = getColumn<k_dirty_column>()[index];
+    uint8_t &is_pending_dirty = getColumn<k_pending_dirty_column>()[index];
+    is_dirty |= is_pending_dirty;
+    getColumn<k_interpolating_column>()[index] = is_pending_dirty;
+    is_pending_dirty                           = false;
+
+    if (is_dirty) {
+        // update transform component, dirty flag will be reset in mesh component
+        owner->tryUpdateRigidBodyComponent();
+    }
+
+    if (g_is_editor_mode)
+        buffer[current_index ^ 1] = owner->m_transform;
+}
+
+void TransformDataPool::updateRenderTransforms(float interpolation_alpha) {
+    PROFILE_SCOPE("TransformDataPool::updateRenderTransforms");
+
+    const std::vector<uint8_t> &enabled = getColumn<k_enabled_column>();
+    for (uint32_t index = 0; index < size(); ++index) {
+        if (!enabled[index])
+            continue;
+
+        const Transform &current    = getColumn<k_buffer_column>()[index][getColumn<k_current_index_column>()[index]];
+        Transform       &render     = getColumn<k_render_column>()[index];
+        uint8_t         &is_dirty   = getColumn<k_dirty_column>()[index];
+        uint8_t         &is_lagging = getColumn<k_render_lagging_column>()[index];
+
+        if (getColumn<k_interpolating_column>()[index]) {
+            const Transform &previous = getColumn<k_previous_column>()[index];
+            render.m_position = Vector3::lerp(previous.m_position, current.m_position, interpolation_alpha);
+            render.m_scale    = Vector3::lerp(previous.m_scale, current.m_scale, interpolation_alpha);
+            render.m_rotation = Quaternion::nLerp(interpolation_alpha, previous.m_rotation, current.m_rotation, true);
+            is_dirty          = true;
+            is_lagging        = interpolation_alpha < 1.f;
+        } else if (is_lagging || is_dirty) {
+            // 停止运动后补交一次当前的 transform，否则会停在最后一次插值的位置
+            render     = current;
+            is_dirty   = true;
+            is_lagging = false;
+        }
+    }
+}
+
+void TransformDataPool::clearDirtyFlags() {
+    std::vector<uint8_t> &dirty = getColumn<k_dirty_column>();
+    std::fill(dirty.begin(), dirty.end(), false);
+}
+
+TransformComponent &TransformComponent::operator=(const TransformComponent &other) {
+    // pool 中的数据属于各自的 GObject，不随赋值转移，由 postLoadResource 重新分配
+    Component::operator=(other);
+    m_transform = other.m_transform;
+    return *this;
+}
+
+TransformComponent::~TransformComponent() { releaseData(); }
+
 void TransformComponent::postLoadResource(std::weak_ptr<GObject> parent_gobject) {
-    m_parent_object       = parent_gobject;
-    m_transform_buffer[0] = m_transform;
-    m_transform_buffer[1] = m_transform;
-    m_is_dirty            = true;
+    m_parent_object = parent_gobject.lock().get();
+    releaseData();
+
+    std::shared_ptr<GObject> parent_object = parent_gobject.lock();
+    if (parent_object)
+        m_data_pool = parent_object->getTransformDataPool();
+
+    // 属于 level 的 transform 由 Level::tick 通过 pool 统一更新，否则单独使用一个 pool，仍由自身的 tick 更新
+    m_is_ticked_by_system = m_data_pool != nullptr;
+    if (!m_data_pool)
+        m_data_pool = std::make_shared<TransformDataPool>();
+
+    bool is_active = parent_object ? parent_object->isActive() : true;
+    m_data_handle  = m_data_pool->allocate({m_transform, m_transform}, m_transform, m_transform, 0, true, false, false, false, false, is_active, this);
+}
+
+void TransformComponent::releaseData() {
+    if (m_data_pool && m_data_pool->isValid(m_data_handle))
+        m_data_pool->free(m_data_handle);
+    m_data_pool.reset();
+    m_data_handle         = k_invalid_component_data_handle;
+    m_is_ticked_by_system = false;
 }
 
 void TransformComponent::setPosition(const Vector3 &new_translation) {
-    m_transform_buffer[m_next_index].m_position = new_translation;
-    m_transform.m_position                      = new_translation;
-    m_is_dirty                                  = true;
+    getTransform().m_position = new_translation;
+    m_transform.m_position    = new_translation;
+    markNextBufferDirty();
 }
 
 void TransformComponent::setScale(const Vector3 &new_scale) {
-    m_transform_buffer[m_next_index].m_scale = new_scale;
-    m_transform.m_scale                      = new_scale;
-    m_is_dirty                               = true;
-    m_is_scale_dirty                         = true;
+    getTransform().m_scale = new_scale;
+    m_transform.m_scale    = new_scale;
+    markNextBufferDirty();
+    m_data_pool->get<TransformDataPool::k_scale_dirty_column>(m_data_handle) = true;
 }
 
 void TransformComponent::setRotation(const Quaternion &new_rotation) {
-    m_transform_buffer[m_next_index].m_rotation = new_rotation;
-    m_transform.m_rotation                      = new_rotation;
-    m_is_dirty                                  = true;
+    getTransform().m_rotation = new_rotation;
+    m_transform.m_rotation    = new_rotation;
+    markNextBufferDirty();
 }
 
 void TransformComponent::tick(float delta_time) {
-    std::swap(m_current_index, m_next_index);
-
-    if (m_is_dirty) {
-        // update transform component, dirty flag will be reset in mesh component
-        tryUpdateRigidBodyComponent();
-    }
-
-    if (g_is_editor_mode)
-        m_transform_buffer[m_next_index] = m_transform;
+    m_data_pool->tickEntry(m_data_pool->getIndex(m_data_handle));
 }
 
 void TransformComponent::tryUpdateRigidBodyComponent() {
-    if (!m_parent_object.lock())
+    if (!m_parent_object)
         return;
 
-    RigidBodyComponent* rigid_body_component = m_parent_object.lock()->tryGetComponent(RigidBodyComponent);
+    RigidBodyComponent* rigid_body_component = m_parent_object->tryGetComponent(RigidBodyComponent);
     if (rigid_body_component) {
-        rigid_body_component->updateGlobalTransform(m_transform_buffer[m_current_index], m_is_scale_dirty);
-        m_is_scale_dirty = false;
+        uint8_t &is_scale_dirty = m_data_pool->get<TransformDataPool::k_scale_dirty_column>(m_data_handle);
+        rigid_body_component->updateGlobalTransform(getTransformConst(), is_scale_dirty);
+        is_scale_dirty = false;
     }
 }
 
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
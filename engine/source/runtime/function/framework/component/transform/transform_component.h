@@ -4,21 +4,65 @@
 #include "runtime/core/math/transform.h"
 
 #include "runtime/function/framework/component/component.h"
+#include "runtime/function/framework/component/component_data_pool.h"
 #include "runtime/function/framework/object/object.h"
 
+#include <array>
+
 namespace Piccolo {
+class TransformComponent;
+
+// 一个 level 中所有 TransformComponent 的双缓冲 transform 和 dirty 标记
+class TransformDataPool : public ComponentDataPool<std::array<Transform, 2>,
+                                                   Transform,
+                                                   Transform,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   uint8_t,
+                                                   TransformComponent*> {
+public:
+    static constexpr size_t k_buffer_column         = 0;
+    static constexpr size_t k_previous_column       = 1; // 上一次交换前的当前 buffer，用于插值
+    static constexpr size_t k_render_column         = 2; // 交给渲染的插值结果
+    static constexpr size_t k_current_index_column  = 3;
+    static constexpr size_t k_dirty_column          = 4; // 渲染用的 transform 有变化，由 mesh component 清除
+    static constexpr size_t k_pending_dirty_column  = 5; // 下一个 buffer 有变化，交换 buffer 时并入 dirty
+    static constexpr size_t k_scale_dirty_column    = 6;
+    static constexpr size_t k_interpolating_column  = 7; // 最近一次交换时 buffer 有变化，需要在 previous 与当前之间插值
+    static constexpr size_t k_render_lagging_column = 8; // 渲染用的 transform 停在了插值的中间，还没有追上当前 buffer
+    static constexpr size_t k_enabled_column        = 9; // 所属 GObject 是否 active
+    static constexpr size_t k_owner_column          = 10;
+
+    // 线性更新所有 enabled 的项，代替逐个调用 TransformComponent::tick，每个逻辑步长调用一次
+    void tick(float delta_time);
+    void tickEntry(uint32_t index);
+
+    // 每帧调用一次，alpha 为距离上一个逻辑步长的时间占步长的比例
+    void updateRenderTransforms(float interpolation_alpha);
+
+    // 没有渲染时代替 mesh component 清除 dirty 标记
+    void clearDirtyFlags();
+};
+
 REFLECTION_TYPE(TransformComponent)
 CLASS(TransformComponent : public Component, WhiteListFields) {
     REFLECTION_BODY(TransformComponent)
 
 public:
     TransformComponent() = default;
+    TransformComponent(const TransformComponent & other) : Component(other), m_transform(other.m_transform) {}
+    TransformComponent &operator=(const TransformComponent &other);
+    ~TransformComponent() override;
 
     void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
-    Vector3    getPosition() const { return m_transform_buffer[m_current_index].m_position; }
-    Vector3    getScale() const { return m_transform_buffer[m_current_index].m_scale; }
-    Quaternion getRotation() const { return m_transform_buffer[m_current_index].m_rotation; }
+    Vector3    getPosition() const { return getTransformConst().m_position; }
+    Vector3    getScale() const { return getTransformConst().m_scale; }
+    Quaternion getRotation() const { return getTransformConst().m_rotation; }
 
     void setPosition(const Vector3 & new_translation);
 
@@ -26,10 +70,25 @@ public:
 
     void setRotation(const Quaternion & new_rotation);
 
-    const Transform &getTransformConst() const { return m_transform_buffer[m_current_index]; }
-    Transform       &getTransform() { return m_transform_buffer[m_next_index]; }
+    const Transform &getTransformConst() const { return getBuffer()[getCurrentIndex()]; }
+    Transform       &getTransform() { return getBuffer()[getCurrentIndex() ^ 1]; }
+
+    Matrix4x4 getMatrix() const { return getTransformConst().getMatrix(); }
+
+    // 按渲染帧插值后的 transform，只用于提交给渲染
+    Matrix4x4 getRenderMatrix() const {
+        return m_data_pool->get<TransformDataPool::k_render_column>(m_data_handle).getMatrix();
+    }
+    Vector3 getRenderPosition() const {
+        return m_data_pool->get<TransformDataPool::k_render_column>(m_data_handle).m_position;
+    }
+
+    // dirty 标记保存在 TransformDataPool 中
+    bool isDirty() const { return m_data_pool->get<TransformDataPool::k_dirty_column>(m_data_handle); }
+    void setDirtyFlag(bool is_dirty) { m_data_pool->get<TransformDataPool::k_dirty_column>(m_data_handle) = is_dirty; }
 
-    Matrix4x4 getMatrix() const { return m_transform_buffer[m_current_index].getMatrix(); }
+    // GObject active 状态变化时同步到 pool
+    void setTickEnabled(bool enabled) { m_data_pool->get<TransformDataPool::k_enabled_column>(m_data_handle) = enabled; }
 
     void tick(float delta_time) override;
 
@@ -39,8 +98,18 @@ protected:
     META(Enable)
     Transform m_transform;
 
-    Transform m_transform_buffer[2];
-    size_t    m_current_index {0};
-    size_t    m_next_index {1};
+    std::shared_ptr<TransformDataPool> m_data_pool;
+    ComponentDataHandle                m_data_handle {k_invalid_component_data_handle};
+
+    std::array<Transform, 2> &getBuffer() { return m_data_pool->get<TransformDataPool::k_buffer_column>(m_data_handle); }
+    const std::array<Transform, 2> &getBuffer() const {
+        return m_data_pool->get<TransformDataPool::k_buffer_column>(m_data_handle);
+    }
+    uint8_t getCurrentIndex() const { return m_data_pool->get<TransformDataPool::k_current_index_column>(m_data_handle); }
+
+    void releaseData();
+    void markNextBufferDirty() { m_data_pool->get<TransformDataPool::k_pending_dirty_column>(m_data_handle) = true; }
+
+    friend class TransformDataPool;
 };
 } // namespace Piccolo
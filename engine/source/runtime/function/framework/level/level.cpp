@@ -1,48 +1,111 @@
 #include "runtime/function/framework/level/level.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/res_type/common/level.h"
 
 #include "runtime/engine.h"
 #include "runtime/function/character/character.h"
+#include "runtime/function/framework/component/transform/transform_component.h"
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/particle/particle_manager.h"
 #include "runtime/function/physics/physics_manager.h"
 #include "runtime/function/physics/physics_scene.h"
+#include "runtime/function/render/render_swap_context.h"
+#include "runtime/function/render/render_system.h"
+#include <iterator>
 #include <limits>
+#include <unordered_map>
 
 namespace Piccolo {
 void Level::clear() {
+    // 未执行的命令直接丢弃，command buffer 持有的 component 需要在这里删除
+    m_command_buffer.takeCommands(m_applying_commands);
+    for (LevelCommandBuffer::AddComponentCommand &command : m_applying_commands.component_adds)
+        PICCOLO_REFLECTION_DELETE(command.component);
+    m_applying_commands.clear();
+
     m_current_active_character.reset();
     m_gobjects.clear();
+    m_gobject_dense_indices.clear();
+    m_object_id_allocator.clear();
+    m_transform_data_pool.reset();
 
     ASSERT(g_runtime_global_context.m_physics_manager);
     g_runtime_global_context.m_physics_manager->deletePhysicsScene(m_physics_scene);
 }
 
 GObjectID Level::createObject(const ObjectInstanceRes &object_instance_res) {
-    GObjectID object_id = ObjectIDAllocator::alloc();
-    ASSERT(object_id != k_invalid_gobject_id);
+    ASSERT(!m_is_ticking);
+
+    ObjectDefinitionRes definition_res;
+    if (!g_runtime_global_context.m_asset_manager->loadAsset(object_instance_res.m_definition, definition_res)) {
+        LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
+        return k_invalid_gobject_id;
+    }
+    return createObject(object_instance_res, definition_res);
+}
+
+GObjectID Level::createObject(const ObjectInstanceRes &object_instance_res, const ObjectDefinitionRes &definition_res) {
+    GObjectID object_id = m_object_id_allocator.alloc();
+    if (object_id == k_invalid_gobject_id)
+        return k_invalid_gobject_id;
 
     std::shared_ptr<GObject> gobject;
     try {
-        gobject = std::make_shared<GObject>(object_id);
+        gobject = std::make_shared<GObject>(object_id, m_transform_data_pool);
     } catch (const std::bad_alloc &) {
         LOG_FATAL("cannot allocate memory for new gobject");
     }
 
-    bool is_loaded = gobject->load(object_instance_res);
-    if (is_loaded)
-        m_gobjects.emplace(object_id, gobject);
-    else {
+    bool is_loaded = gobject->load(object_instance_res, definition_res);
+    if (!is_loaded) {
         LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
+        m_object_id_allocator.free(object_id);
         return k_invalid_gobject_id;
     }
+
+    uint32_t slot_index = getGObjectIndex(object_id);
+    if (slot_index >= m_gobject_dense_indices.size())
+        m_gobject_dense_indices.resize(slot_index + 1, s_invalid_dense_index);
+    m_gobject_dense_indices[slot_index] = static_cast<uint32_t>(m_gobjects.size());
+    m_gobjects.push_back(std::move(gobject));
     return object_id;
 }
 
+void Level::createObjects(const std::vector<const ObjectInstanceRes*> &object_instance_reses,
+                          std::vector<GObjectID>                      &out_object_ids) {
+    PROFILE_SCOPE("Level::createObjects");
+
+    out_object_ids.resize(object_instance_reses.size(), k_invalid_gobject_id);
+    m_gobjects.reserve(m_gobjects.size() + object_instance_reses.size());
+
+    // 读取失败的定义也记录下来（为 null），避免重复尝试；每个对象再从 json 反序列化出自己的 component
+    std::unordered_map<std::string, Json> definition_jsons;
+    for (size_t index = 0; index < object_instance_reses.size(); ++index) {
+        const ObjectInstanceRes &object_instance_res = *object_instance_reses[index];
+
+        auto iter = definition_jsons.find(object_instance_res.m_definition);
+        if (iter == definition_jsons.end()) {
+            Json definition_json;
+            if (!g_runtime_global_context.m_asset_manager->loadAssetJson(object_instance_res.m_definition, definition_json))
+                definition_json = Json();
+            iter = definition_jsons.emplace(object_instance_res.m_definition, std::move(definition_json)).first;
+        }
+        if (iter->second.is_null()) {
+            LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
+            continue;
+        }
+
+        ObjectDefinitionRes definition_res;
+        Serializer::read(iter->second, definition_res);
+        out_object_ids[index] = createObject(object_instance_res, definition_res);
+    }
+}
+
 bool Level::load(const std::string &level_res_url) {
     LOG_INFO("loading level: {}", level_res_url);
 
@@ -56,13 +119,17 @@ bool Level::load(const std::string &level_res_url) {
     ASSERT(g_runtime_global_context.m_physics_manager);
     m_physics_scene = g_runtime_global_context.m_physics_manager->createPhysicsScene(level_res.m_gravity);
     ParticleEmitterIDAllocator::reset();
+    m_transform_data_pool = std::make_shared<TransformDataPool>();
 
+    std::vector<const ObjectInstanceRes*> object_instance_reses;
+    object_instance_reses.reserve(level_res.m_objects.size());
     for (const ObjectInstanceRes &object_instance_res : level_res.m_objects)
-        createObject(object_instance_res);
+        object_instance_reses.push_back(&object_instance_res);
+    std::vector<GObjectID> object_ids;
+    createObjects(object_instance_reses, object_ids);
 
     // create active character
-    for (const auto &object_pair : m_gobjects) {
-        std::shared_ptr<GObject> object = object_pair.second;
+    for (const std::shared_ptr<GObject> &object : m_gobjects) {
         if (object == nullptr)
             continue;
 
@@ -93,9 +160,9 @@ bool Level::save() {
     output_objects.resize(object_cout);
 
     size_t object_index = 0;
-    for (const auto &id_object_pair : m_gobjects) {
-        if (id_object_pair.second) {
-            id_object_pair.second->save(output_objects[object_index]);
+    for (const std::shared_ptr<GObject> &object : m_gobjects) {
+        if (object) {
+            object->save(output_objects[object_index]);
             ++object_index;
         }
     }
@@ -112,41 +179,178 @@ bool Level::save() {
 }
 
 void Level::tick(float delta_time) {
+    PROFILE_SCOPE("Level::tick");
+
     if (!m_is_loaded)
         return;
 
-    for (const auto &id_object_pair : m_gobjects) {
-        assert(id_object_pair.second);
-        if (id_object_pair.second)
-            id_object_pair.second->tick(delta_time);
-    }
+    m_is_ticking = true;
+    collectTickComponents(ComponentTickPhase::pre_physics, ComponentTickPhase::render_extract);
+
+    // transform 先按 pool 中的连续数据统一更新，不经过 tick queue
+    if (m_transform_data_pool)
+        m_transform_data_pool->tick(delta_time);
+
+    tickPhase(ComponentTickPhase::pre_physics, delta_time);
+
     if (m_current_active_character && g_is_editor_mode == false)
         m_current_active_character->tick(delta_time);
+    tickPhase(ComponentTickPhase::physics, delta_time);
 
     std::shared_ptr<PhysicsScene> physics_scene = m_physics_scene.lock();
     if (physics_scene)
         physics_scene->tick(delta_time);
-}
 
-std::weak_ptr<GObject> Level::getGObjectByID(GObjectID go_id) const {
-    auto iter = m_gobjects.find(go_id);
-    if (iter != m_gobjects.end())
-        return iter->second;
+    tickPhase(ComponentTickPhase::post_physics, delta_time);
+    tickPhase(ComponentTickPhase::animation, delta_time);
+    m_is_ticking = false;
 
-    return std::weak_ptr<GObject>();
+    applyCommandBuffer();
 }
 
-void Level::deleteGObjectByID(GObjectID go_id) {
-    auto iter = m_gobjects.find(go_id);
-    if (iter != m_gobjects.end()) {
-        std::shared_ptr<GObject> object = iter->second;
-        if (object) {
-            if (m_current_active_character && m_current_active_character->getObjectID() == object->getID())
-                m_current_active_character->setObject(nullptr);
+void Level::applyCommandBuffer() {
+    ASSERT(!m_is_ticking);
+
+    m_command_buffer.takeCommands(m_applying_commands);
+    if (m_applying_commands.empty())
+        return;
+
+    PROFILE_SCOPE("Level::applyCommandBuffer");
+
+    // 先修改已有的对象，再删除，最后批量创建，同一批中创建的对象不受前面命令的影响
+    for (LevelCommandBuffer::AddComponentCommand &command : m_applying_commands.component_adds) {
+        GObject* object = getGObject(command.go_id);
+        if (object == nullptr || !object->addComponent(command.component))
+            PICCOLO_REFLECTION_DELETE(command.component);
+    }
+
+    for (const LevelCommandBuffer::SetActiveCommand &command : m_applying_commands.activations) {
+        GObject* object = getGObject(command.go_id);
+        if (object)
+            object->setActive(command.is_active);
+    }
+
+    for (GObjectID go_id : m_applying_commands.destroys) {
+        if (getGObject(go_id) == nullptr)
+            continue;
+        deleteGObjectByID(go_id);
+        if (!g_is_headless_mode && g_runtime_global_context.m_render_system) {
+            RenderSwapContext &swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+            swap_context.getLogicSwapData().addDeleteGameObject(GameObjectDesc {go_id, {}});
+        }
+    }
+
+    if (!m_applying_commands.creates.empty()) {
+        std::vector<const ObjectInstanceRes*> object_instance_reses;
+        object_instance_reses.reserve(m_applying_commands.creates.size());
+        for (const LevelCommandBuffer::CreateCommand &command : m_applying_commands.creates)
+            object_instance_reses.push_back(&command.object_instance_res);
+
+        std::vector<GObjectID> object_ids;
+        createObjects(object_instance_reses, object_ids);
+        for (size_t index = 0; index < object_ids.size(); ++index) {
+            if (m_applying_commands.creates[index].on_created)
+                m_applying_commands.creates[index].on_created(object_ids[index]);
         }
     }
 
-    m_gobjects.erase(go_id);
+    m_applying_commands.clear();
+}
+
+void Level::tickRenderExtract(float delta_time, float interpolation_alpha) {
+    PROFILE_SCOPE("Level::tickRenderExtract");
+
+    if (!m_is_loaded)
+        return;
+
+    // headless 模式下没有渲染，不提交任何数据，只清除 dirty 标记
+    if (g_is_headless_mode) {
+        if (m_transform_data_pool)
+            m_transform_data_pool->clearDirtyFlags();
+        return;
+    }
+
+    // 先更新插值后的 transform，mesh component 在 render_extract 阶段提交它；编辑器中直接显示编辑结果，不做插值
+    if (m_transform_data_pool)
+        m_transform_data_pool->updateRenderTransforms(g_is_editor_mode ? 1.f : interpolation_alpha);
+
+    // 相机跟随插值后的 character，与 Level::tick 一样只在游戏模式下更新
+    if (m_current_active_character && g_is_editor_mode == false)
+        m_current_active_character->tickRenderExtract(interpolation_alpha);
+
+    m_is_ticking = true;
+    collectTickComponents(ComponentTickPhase::render_extract, ComponentTickPhase::count);
+    tickPhase(ComponentTickPhase::render_extract, delta_time);
+    m_is_ticking = false;
+}
+
+void Level::collectTickComponents(ComponentTickPhase begin_phase, ComponentTickPhase end_phase) {
+    for (const std::shared_ptr<GObject> &object : m_gobjects) {
+        assert(object);
+        if (object)
+            object->collectTickComponents(m_tick_queues, begin_phase, end_phase);
+    }
+}
+
+void Level::tickPhase(ComponentTickPhase phase, float delta_time) {
+    static constexpr const char* s_phase_profile_names[] = {"Level::tickPhase pre_physics",
+                                                            "Level::tickPhase physics",
+                                                            "Level::tickPhase post_physics",
+                                                            "Level::tickPhase animation",
+                                                            "Level::tickPhase render_extract"};
+    static_assert(std::size(s_phase_profile_names) == static_cast<size_t>(ComponentTickPhase::count));
+    PROFILE_SCOPE(s_phase_profile_names[static_cast<size_t>(phase)]);
+
+    ComponentTickQueue &tick_queue = m_tick_queues[static_cast<size_t>(phase)];
+
+    std::vector<Component*> &parallel_components = tick_queue.parallel_components;
+    g_runtime_global_context.m_job_system->parallelFor(
+        static_cast<uint32_t>(parallel_components.size()),
+        s_parallel_tick_chunk_size,
+        [&parallel_components, delta_time](uint32_t begin, uint32_t end) {
+            PROFILE_SCOPE("Level::tickPhase parallel chunk");
+            for (uint32_t index = begin; index < end; ++index)
+                parallel_components[index]->tick(delta_time);
+        });
+
+    for (Component* component : tick_queue.serial_components)
+        component->tick(delta_time);
+
+    tick_queue.parallel_components.clear();
+    tick_queue.serial_components.clear();
+}
+
+GObject* Level::getGObject(GObjectID go_id) const {
+    if (!m_object_id_allocator.isAlive(go_id))
+        return nullptr;
+    return m_gobjects[m_gobject_dense_indices[getGObjectIndex(go_id)]].get();
+}
+
+std::weak_ptr<GObject> Level::getGObjectByID(GObjectID go_id) const {
+    if (!m_object_id_allocator.isAlive(go_id))
+        return std::weak_ptr<GObject>();
+    return m_gobjects[m_gobject_dense_indices[getGObjectIndex(go_id)]];
+}
+
+void Level::deleteGObjectByID(GObjectID go_id) {
+    ASSERT(!m_is_ticking);
+
+    if (!m_object_id_allocator.isAlive(go_id))
+        return;
+
+    if (m_current_active_character && m_current_active_character->getObjectID() == go_id)
+        m_current_active_character->setObject(nullptr);
+
+    // 把末尾的对象移到被删除的位置，保持连续
+    uint32_t slot_index  = getGObjectIndex(go_id);
+    uint32_t dense_index = m_gobject_dense_indices[slot_index];
+    if (dense_index + 1 != m_gobjects.size()) {
+        m_gobjects[dense_index] = std::move(m_gobjects.back());
+        m_gobject_dense_indices[getGObjectIndex(m_gobjects[dense_index]->getID())] = dense_index;
+    }
+    m_gobjects.pop_back();
+    m_gobject_dense_indices[slot_index] = s_invalid_dense_index;
+    m_object_id_allocator.free(go_id);
 }
 
 } // namespace Piccolo
@@ -1,18 +1,24 @@
 #pragma once
 
+#include "runtime/function/framework/component/component.h"
+#include "runtime/function/framework/level/level_command_buffer.h"
 #include "runtime/function/framework/object/object_id_allocator.h"
 
+#include <limits>
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace Piccolo {
 class Character;
 class GObject;
+class ObjectDefinitionRes;
 class ObjectInstanceRes;
 class PhysicsScene;
+class TransformDataPool;
 
-using LevelObjectsMap = std::unordered_map<GObjectID, std::shared_ptr<GObject>>;
+// 连续存放，删除时与末尾的对象交换，顺序不固定
+using LevelObjects = std::vector<std::shared_ptr<GObject>>;
 
 /// The main class to manage all game objects
 class Level {
@@ -24,31 +30,69 @@ public:
 
     bool save();
 
+    // 按固定步长调用，可能一帧多次或零次，tick render_extract 之前的所有阶段，最后执行 command buffer
     void tick(float delta_time);
 
+    // 每帧调用一次，把 transform 按 interpolation_alpha 插值后 tick render_extract 阶段
+    void tickRenderExtract(float delta_time, float interpolation_alpha);
+
     const std::string &getLevelResUrl() const { return m_level_res_url; }
 
-    const LevelObjectsMap &getAllGObjects() const { return m_gobjects; }
+    const LevelObjects &getAllGObjects() const { return m_gobjects; }
 
+    // O(1) 查找，id 已失效（对象已删除、slot 已复用）时返回 nullptr；不增加引用计数，热路径使用它
+    GObject*                 getGObject(GObjectID go_id) const;
     std::weak_ptr<GObject>   getGObjectByID(GObjectID go_id) const;
     std::weak_ptr<Character> getCurrentActiveCharacter() const { return m_current_active_character; }
 
+    // 立即修改结构，不能在 tick 期间调用，tick 中使用 getCommandBuffer()
     GObjectID createObject(const ObjectInstanceRes &object_instance_res);
     void      deleteGObjectByID(GObjectID go_id);
 
+    LevelCommandBuffer &getCommandBuffer() { return m_command_buffer; }
+    // 执行 command buffer 中记录的修改，tick 结束时会自动调用
+    void applyCommandBuffer();
+
     std::weak_ptr<PhysicsScene> getPhysicsScene() const { return m_physics_scene; }
 
 protected:
     void clear();
 
+    GObjectID createObject(const ObjectInstanceRes &object_instance_res, const ObjectDefinitionRes &definition_res);
+    // 批量创建，每个定义只读取、解析一次 json；out_object_ids 与 object_instance_reses 一一对应
+    void createObjects(const std::vector<const ObjectInstanceRes*> &object_instance_reses,
+                       std::vector<GObjectID>                      &out_object_ids);
+
+    void collectTickComponents(ComponentTickPhase begin_phase, ComponentTickPhase end_phase);
+
+    // 先把可并行的 component 分块交给 job system，再在当前线程按原顺序 tick 其余的
+    void tickPhase(ComponentTickPhase phase, float delta_time);
+
     bool        m_is_loaded {false};
     std::string m_level_res_url;
 
-    // all game objects in this level, key: object id, value: object instance
-    LevelObjectsMap m_gobjects;
+    // all game objects in this level
+    LevelObjects m_gobjects;
+    // 以 GObjectID 的 slot 下标索引，记录对象在 m_gobjects 中的位置
+    std::vector<uint32_t> m_gobject_dense_indices;
+    ObjectIDAllocator     m_object_id_allocator;
+
+    static constexpr uint32_t s_invalid_dense_index {std::numeric_limits<uint32_t>::max()};
 
     std::shared_ptr<Character> m_current_active_character;
 
     std::weak_ptr<PhysicsScene> m_physics_scene;
+
+    // 所有 GObject 的 TransformComponent 数据连续存放于此，在 tick 中线性更新
+    std::shared_ptr<TransformDataPool> m_transform_data_pool;
+
+    // 每帧重新收集，保留容量避免重复分配
+    ComponentTickQueues m_tick_queues;
+
+    LevelCommandBuffer           m_command_buffer;
+    LevelCommandBuffer::Commands m_applying_commands; // 与 m_command_buffer 交换，两边的容量都能复用
+    bool                         m_is_ticking {false};
+
+    static constexpr uint32_t s_parallel_tick_chunk_size {64};
 };
 } // namespace Piccolo
@@ -0,0 +1,45 @@
+#include "runtime/function/framework/level/level_command_buffer.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <utility>
+
+namespace Piccolo {
+void LevelCommandBuffer::Commands::clear() {
+    creates.clear();
+    destroys.clear();
+    component_adds.clear();
+    activations.clear();
+}
+
+void LevelCommandBuffer::createObject(ObjectInstanceRes object_instance_res, CreatedCallback on_created) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.creates.push_back(CreateCommand {std::move(object_instance_res), std::move(on_created)});
+}
+
+void LevelCommandBuffer::destroyObject(GObjectID go_id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.destroys.push_back(go_id);
+}
+
+void LevelCommandBuffer::addComponent(GObjectID go_id, Reflection::ReflectionPtr<Component> component) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.component_adds.push_back(AddComponentCommand {go_id, component});
+}
+
+void LevelCommandBuffer::setActive(GObjectID go_id, bool is_active) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.activations.push_back(SetActiveCommand {go_id, is_active});
+}
+
+bool LevelCommandBuffer::isEmpty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_commands.empty();
+}
+
+void LevelCommandBuffer::takeCommands(Commands &out_commands) {
+    ASSERT(out_commands.empty());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(m_commands, out_commands);
+}
+} // namespace Piccolo
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "runtime/core/meta/reflection/reflection.h"
+#include "runtime/function/framework/object/object_id_allocator.h"
+#include "runtime/resource/res_type/common/object.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Piccolo {
+class Component;
+
+// 记录对 Level 结构的修改（创建、删除对象，添加 component，修改激活状态），由 Level 在 tick 结束时统一执行；
+// tick 期间（包括并行 tick 的 component）只能通过它修改结构，可以在任意线程记录
+class LevelCommandBuffer {
+public:
+    using CreatedCallback = std::function<void(GObjectID)>;
+
+    // 对象在执行时才创建，on_created 在执行时于主线程调用，创建失败时传入 k_invalid_gobject_id
+    void createObject(ObjectInstanceRes object_instance_res, CreatedCallback on_created = nullptr);
+    void destroyObject(GObjectID go_id);
+    // component 交给 command buffer 持有，执行时对象已删除或已有同类型 component 时删除它
+    void addComponent(GObjectID go_id, Reflection::ReflectionPtr<Component> component);
+    void setActive(GObjectID go_id, bool is_active);
+
+    bool isEmpty() const;
+
+    struct CreateCommand {
+        ObjectInstanceRes object_instance_res;
+        CreatedCallback   on_created;
+    };
+    struct AddComponentCommand {
+        GObjectID                            go_id;
+        Reflection::ReflectionPtr<Component> component;
+    };
+    struct SetActiveCommand {
+        GObjectID go_id;
+        bool      is_active;
+    };
+    struct Commands {
+        std::vector<CreateCommand>       creates;
+        std::vector<GObjectID>           destroys;
+        std::vector<AddComponentCommand> component_adds;
+        std::vector<SetActiveCommand>    activations;
+
+        bool empty() const { return creates.empty() && destroys.empty() && component_adds.empty() && activations.empty(); }
+        void clear();
+    };
+
+    // 与 out_commands 交换，out_commands 需为空，交换后双方都保留各自的容量
+    void takeCommands(Commands &out_commands);
+
+private:
+    mutable std::mutex m_mutex;
+    Commands           m_commands;
+};
+} // namespace Piccolo
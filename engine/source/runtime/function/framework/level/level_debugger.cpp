@@ -28,9 +28,8 @@ void LevelDebugger::tick(std::shared_ptr<Level> level) const {
 }
 
 void LevelDebugger::showAllBones(std::shared_ptr<Level> level) const {
-    const LevelObjectsMap &go_map = level->getAllGObjects();
-    for (const auto &gobject_pair : go_map)
-        drawBones(gobject_pair.second);
+    for (const std::shared_ptr<GObject> &gobject : level->getAllGObjects())
+        drawBones(gobject);
 }
 
 void LevelDebugger::showBones(std::shared_ptr<Level> level, GObjectID go_id) const {
@@ -39,9 +38,8 @@ void LevelDebugger::showBones(std::shared_ptr<Level> level, GObjectID go_id) con
 }
 
 void LevelDebugger::showAllBonesName(std::shared_ptr<Level> level) const {
-    const LevelObjectsMap &go_map = level->getAllGObjects();
-    for (const auto &gobject_pair : go_map)
-        drawBonesName(gobject_pair.second);
+    for (const std::shared_ptr<GObject> &gobject : level->getAllGObjects())
+        drawBonesName(gobject);
 }
 
 void LevelDebugger::showBonesName(std::shared_ptr<Level> level, GObjectID go_id) const {
@@ -50,9 +48,8 @@ void LevelDebugger::showBonesName(std::shared_ptr<Level> level, GObjectID go_id)
 }
 
 void LevelDebugger::showAllBoundingBox(std::shared_ptr<Level> level) const {
-    const LevelObjectsMap &go_map = level->getAllGObjects();
-    for (const auto &gobject_pair : go_map)
-        drawBoundingBox(gobject_pair.second);
+    for (const std::shared_ptr<GObject> &gobject : level->getAllGObjects())
+        drawBoundingBox(gobject);
 }
 
 void LevelDebugger::showBoundingBox(std::shared_ptr<Level> level, GObjectID go_id) const {
@@ -67,9 +64,9 @@ void LevelDebugger::showCameraInfo(std::shared_ptr<Level> level) const {
 
 void LevelDebugger::drawBones(std::shared_ptr<GObject> object) const {
     const TransformComponent* transform_component =
-        object->tryGetComponentConst<TransformComponent>("TransformComponent");
+        object->tryGetComponentConst(TransformComponent);
     const AnimationComponent* animation_component =
-        object->tryGetComponentConst<AnimationComponent>("AnimationComponent");
+        object->tryGetComponentConst(AnimationComponent);
 
     if (transform_component == nullptr || animation_component == nullptr)
         return;
@@ -122,9 +119,9 @@ void LevelDebugger::drawBones(std::shared_ptr<GObject> object) const {
 
 void LevelDebugger::drawBonesName(std::shared_ptr<GObject> object) const {
     const TransformComponent* transform_component =
-        object->tryGetComponentConst<TransformComponent>("TransformComponent");
+        object->tryGetComponentConst(TransformComponent);
     const AnimationComponent* animation_component =
-        object->tryGetComponentConst<AnimationComponent>("AnimationComponent");
+        object->tryGetComponentConst(AnimationComponent);
 
     if (transform_component == nullptr || animation_component == nullptr)
         return;
@@ -162,7 +159,7 @@ void LevelDebugger::drawBonesName(std::shared_ptr<GObject> object) const {
 
 void LevelDebugger::drawBoundingBox(std::shared_ptr<GObject> object) const {
     const RigidBodyComponent* rigidbody_component =
-        object->tryGetComponentConst<RigidBodyComponent>("RigidBodyComponent");
+        object->tryGetComponentConst(RigidBodyComponent);
     if (rigidbody_component == nullptr)
         return;
 
@@ -183,7 +180,7 @@ void LevelDebugger::drawBoundingBox(std::shared_ptr<GObject> object) const {
 }
 
 void LevelDebugger::drawCameraInfo(std::shared_ptr<GObject> object) const {
-    const CameraComponent* camera_component = object->tryGetComponentConst<CameraComponent>("CameraComponent");
+    const CameraComponent* camera_component = object->tryGetComponentConst(CameraComponent);
     if (camera_component == nullptr)
         return;
 
@@ -13,7 +13,6 @@
 #include <cassert>
 #include <unordered_set>
 
-#include "editor/include/editor_global_context.h"
 #include "function/render/render_system.h"
 #include "_generated/serializer/all_serializer.h"
 
@@ -35,12 +34,39 @@ void GObject::tick(float delta_time) {
     if (!isActive())
         return;
     for (auto &component : m_components) {
+        if (component->isTickedBySystem())
+            continue;
         if (shouldComponentTick(component.getTypeName()))
             component->tick(delta_time);
     }
 }
 
+void GObject::collectTickComponents(ComponentTickQueues &tick_queues,
+                                    ComponentTickPhase   begin_phase,
+                                    ComponentTickPhase   end_phase) {
+    if (!isActive())
+        return;
+    for (auto &component : m_components) {
+        if (component->isTickedBySystem() || !shouldComponentTick(component.getTypeName()))
+            continue;
+
+        ComponentTickPhase phase = component->getTickPhase();
+        if (phase < begin_phase || phase >= end_phase)
+            continue;
+
+        ComponentTickQueue &tick_queue = tick_queues[static_cast<size_t>(phase)];
+        if (component->getTickSharedWrites() == k_tick_write_none)
+            tick_queue.parallel_components.push_back(component.operator->());
+        else
+            tick_queue.serial_components.push_back(component.operator->());
+    }
+}
+
 bool GObject::hasComponent(const std::string &compenent_type_name) const {
+    ComponentTypeID type_id = getComponentTypeID(compenent_type_name);
+    if (type_id != k_invalid_component_type_id)
+        return (m_component_mask >> type_id) & 1;
+
     for (const auto &component : m_components) {
         if (component.getTypeName() == compenent_type_name)
             return true;
@@ -49,7 +75,28 @@ bool GObject::hasComponent(const std::string &compenent_type_name) const {
     return false;
 }
 
+bool GObject::addComponent(Reflection::ReflectionPtr<Component> component) {
+    if (!component || hasComponent(component.getTypeName()))
+        return false;
+
+    component->postLoadResource(weak_from_this());
+    m_components.push_back(component);
+    addComponentSlot(m_components.back());
+    return true;
+}
+
 bool GObject::load(const ObjectInstanceRes &object_instance_res) {
+    ObjectDefinitionRes definition_res;
+
+    const bool is_loaded_success =
+        g_runtime_global_context.m_asset_manager->loadAsset(object_instance_res.m_definition, definition_res);
+    if (!is_loaded_success)
+        return false;
+
+    return load(object_instance_res, definition_res);
+}
+
+bool GObject::load(const ObjectInstanceRes &object_instance_res, const ObjectDefinitionRes &definition_res) {
     // clear old components
     m_components.clear();
 
@@ -59,6 +106,7 @@ bool GObject::load(const ObjectInstanceRes &object_instance_res) {
 
     // load object instanced components
     m_components = object_instance_res.m_instanced_components;
+    rebuildComponentSlots();
     for (auto component : m_components) {
         if (component)
             component->postLoadResource(weak_from_this());
@@ -67,12 +115,6 @@ bool GObject::load(const ObjectInstanceRes &object_instance_res) {
     // load object definition components
     m_definition_url = object_instance_res.m_definition;
 
-    ObjectDefinitionRes definition_res;
-
-    const bool is_loaded_success = g_runtime_global_context.m_asset_manager->loadAsset(m_definition_url, definition_res);
-    if (!is_loaded_success)
-        return false;
-
     for (auto loaded_component : definition_res.m_components) {
         const std::string type_name = loaded_component.getTypeName();
         // don't create component if it has been instanced
@@ -82,6 +124,7 @@ bool GObject::load(const ObjectInstanceRes &object_instance_res) {
         loaded_component->postLoadResource(weak_from_this());
 
         m_components.push_back(loaded_component);
+        addComponentSlot(m_components.back());
     }
 
     return true;
@@ -95,9 +138,31 @@ void GObject::save(ObjectInstanceRes &out_object_instance_res) {
     out_object_instance_res.m_instanced_components = m_components;
 }
 
+void GObject::rebuildComponentSlots() {
+    m_component_mask = 0;
+    m_component_slots.fill(nullptr);
+    for (auto &component : m_components)
+        addComponentSlot(component);
+}
+
+void GObject::addComponentSlot(Reflection::ReflectionPtr<Component> &component) {
+    if (!component)
+        return;
+    ComponentTypeID type_id = getComponentTypeID(component.getTypeName());
+    if (type_id == k_invalid_component_type_id || m_component_slots[type_id])
+        return; // 同类型只保留第一个，与按类型名查找的行为一致
+    m_component_mask |= uint64_t(1) << type_id;
+    m_component_slots[type_id] = component.operator->();
+}
+
 void GObject::setActive(bool active) {
     if (m_active != active) {
         m_active = active;
+
+        TransformComponent* transform_component = tryGetComponent(TransformComponent);
+        if (transform_component)
+            transform_component->setTickEnabled(m_active);
+
         if (m_active)
             onActive();
         else
@@ -107,11 +172,15 @@ void GObject::setActive(bool active) {
 
 void GObject::onActive() {
     TransformComponent* transform_component = tryGetComponent(TransformComponent);
-    transform_component->setDirtyFlag(true); // 设为 dirty 能自动触发更新以及加入到 swap context 的逻辑
+    if (transform_component)
+        transform_component->setDirtyFlag(true); // 设为 dirty 能自动触发更新以及加入到 swap context 的逻辑
 }
 
 void GObject::onDeactive() const {
-    RenderSwapContext& swap_context = g_editor_global_context.m_render_system->getSwapContext();
+    // headless 模式下没有渲染系统
+    if (g_is_headless_mode || !g_runtime_global_context.m_render_system)
+        return;
+    RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
     swap_context.getLogicSwapData().addDeleteGameObject(GameObjectDesc {getID(), {}});
 }
 
@@ -1,27 +1,40 @@
 #pragma once
 
 #include "runtime/function/framework/component/component.h"
+#include "runtime/function/framework/component/component_type_id.h"
 #include "runtime/function/framework/object/object_id_allocator.h"
 
 #include "runtime/resource/res_type/common/object.h"
 
+#include <array>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
 namespace Piccolo {
+class TransformDataPool;
+
 /// GObject : Game Object base class
 class GObject : public std::enable_shared_from_this<GObject> {
     typedef std::unordered_set<std::string> TypeNameSet;
 
 public:
-    GObject(GObjectID id) : m_id {id} {}
+    GObject(GObjectID id, std::shared_ptr<TransformDataPool> transform_data_pool = nullptr) :
+        m_id {id}, m_transform_data_pool {std::move(transform_data_pool)} {}
     virtual ~GObject();
 
     virtual void tick(float delta_time);
 
+    // 把阶段在 [begin_phase, end_phase) 内、需要 tick 的 component 按阶段和是否可并行放入 tick_queues，由 Level 统一调度
+    void collectTickComponents(ComponentTickQueues &tick_queues,
+                               ComponentTickPhase   begin_phase,
+                               ComponentTickPhase   end_phase);
+
     bool load(const ObjectInstanceRes &object_instance_res);
+    // 使用已经读取的定义，definition_res 中被用到的 component 交给这个对象持有
+    bool load(const ObjectInstanceRes &object_instance_res, const ObjectDefinitionRes &definition_res);
     void save(ObjectInstanceRes &out_object_instance_res);
 
     GObjectID getID() const { return m_id; }
@@ -33,10 +46,33 @@ public:
     void setActive(bool active);
     bool isActive() const { return m_active; }
 
+    // 所属 level 的 transform 数据，不属于任何 level 时为空
+    const std::shared_ptr<TransformDataPool> &getTransformDataPool() const { return m_transform_data_pool; }
+
     bool hasComponent(const std::string &compenent_type_name) const;
 
+    // 添加 component 并交给这个对象持有，已有同类型的 component 时返回 false，不接管它
+    bool addComponent(Reflection::ReflectionPtr<Component> component);
+
+    template<typename TComponent>
+    bool hasComponent() const {
+        return (m_component_mask >> ComponentTypeIDOf<std::remove_const_t<TComponent>>::value) & 1;
+    }
+
     std::vector<Reflection::ReflectionPtr<Component>> getComponents() { return m_components; }
 
+    // 按编译期的 component type id 查 slot 表，热路径使用
+    template<typename TComponent>
+    TComponent* tryGetComponent() {
+        return static_cast<TComponent*>(m_component_slots[ComponentTypeIDOf<std::remove_const_t<TComponent>>::value]);
+    }
+
+    template<typename TComponent>
+    const TComponent* tryGetComponentConst() const {
+        return static_cast<const TComponent*>(m_component_slots[ComponentTypeIDOf<std::remove_const_t<TComponent>>::value]);
+    }
+
+    // 按类型名查找，供反射和编辑器等只知道类型名的地方使用
     template<typename TComponent>
     TComponent* tryGetComponent(const std::string &compenent_type_name) {
         for (auto &component : m_components) {
@@ -56,8 +92,8 @@ public:
         return nullptr;
     }
 
-#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>(#COMPONENT_TYPE)
-#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>(#COMPONENT_TYPE)
+#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>()
+#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>()
 
 protected:
     GObjectID   m_id {k_invalid_gobject_id};
@@ -65,10 +101,19 @@ protected:
     std::string m_definition_url;
     bool        m_active {true};
 
+    std::shared_ptr<TransformDataPool> m_transform_data_pool;
+
     // we have to use the ReflectionPtr due to that the components need to be reflected
     // in editor, and it's polymorphism
     std::vector<Reflection::ReflectionPtr<Component>> m_components;
 
+    // 以 ComponentTypeID 为下标，m_components 变化后需要同步更新
+    uint64_t                                       m_component_mask {0};
+    std::array<Component*, k_component_type_count> m_component_slots {};
+
+    void rebuildComponentSlots();
+    void addComponentSlot(Reflection::ReflectionPtr<Component> &component);
+
     // active state
     void onActive();
     void onDeactive() const;
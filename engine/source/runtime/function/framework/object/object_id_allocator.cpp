@@ -3,15 +3,47 @@
 #include "core/base/macro.h"
 
 namespace Piccolo {
-std::atomic<GObjectID> ObjectIDAllocator::m_next_id {0};
-
 GObjectID ObjectIDAllocator::alloc() {
-    std::atomic<GObjectID> new_object_ret = m_next_id.load();
-    m_next_id++;
-    if (m_next_id >= k_invalid_gobject_id)
-        LOG_FATAL("gobject id overflow");
+    uint32_t index;
+    if (!m_free_indices.empty()) {
+        index = m_free_indices.back();
+        m_free_indices.pop_back();
+    } else {
+        if (m_generations.size() >= s_max_slot_count) {
+            LOG_ERROR("gobject slot overflow");
+            return k_invalid_gobject_id;
+        }
+        index = static_cast<uint32_t>(m_generations.size());
+        m_generations.push_back(0);
+        m_is_alive.push_back(false);
+    }
+
+    m_is_alive[index] = true;
+    return makeGObjectID(index, m_generations[index]);
+}
+
+void ObjectIDAllocator::free(GObjectID id) {
+    if (!isAlive(id))
+        return;
+
+    uint32_t index    = getGObjectIndex(id);
+    m_is_alive[index] = false;
+    // generation 回绕后旧 ID 理论上可能重新匹配，需要同一 slot 复用 2^32 次，忽略
+    ++m_generations[index];
+    m_free_indices.push_back(index);
+}
+
+bool ObjectIDAllocator::isAlive(GObjectID id) const {
+    uint32_t index = getGObjectIndex(id);
+    return index < m_generations.size() && m_is_alive[index] && m_generations[index] == getGObjectGeneration(id);
+}
 
-    return new_object_ret;
+void ObjectIDAllocator::clear() {
+    // 保留 generation，清空前分配的 ID 之后仍能被识别为失效
+    for (uint32_t index = 0; index < m_generations.size(); ++index) {
+        if (m_is_alive[index])
+            free(makeGObjectID(index, m_generations[index]));
+    }
 }
 
 } // namespace Piccolo
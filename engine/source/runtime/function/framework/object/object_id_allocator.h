@@ -1,18 +1,42 @@
 #pragma once
 
-#include <atomic>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace Piccolo {
+// 低 32 位为 slot 下标，高 32 位为 slot 的 generation；slot 释放后 generation 加一，指向它的旧 ID 随之失效
 using GObjectID = std::size_t;
+static_assert(sizeof(GObjectID) == sizeof(uint64_t), "GObjectID packs a 32-bit index and a 32-bit generation");
 
 constexpr GObjectID k_invalid_gobject_id = std::numeric_limits<std::size_t>::max();
 
+constexpr GObjectID makeGObjectID(uint32_t index, uint32_t generation) {
+    return (static_cast<GObjectID>(generation) << 32) | index;
+}
+constexpr uint32_t getGObjectIndex(GObjectID id) { return static_cast<uint32_t>(id); }
+constexpr uint32_t getGObjectGeneration(GObjectID id) { return static_cast<uint32_t>(id >> 32); }
+
+// 每个 Level 一个，slot 下标被复用，不会耗尽；只在主线程上由 Level 调用，不加锁
 class ObjectIDAllocator {
 public:
-    static GObjectID alloc();
+    // slot 数量达到上限时返回 k_invalid_gobject_id
+    GObjectID alloc();
+    void      free(GObjectID id);
+
+    // id 的 slot 仍在使用且 generation 一致
+    bool isAlive(GObjectID id) const;
+
+    uint32_t getSlotCount() const { return static_cast<uint32_t>(m_generations.size()); }
+
+    // 释放所有 slot
+    void clear();
 
 private:
-    static std::atomic<GObjectID> m_next_id;
+    static constexpr uint32_t s_max_slot_count {std::numeric_limits<uint32_t>::max()};
+
+    std::vector<uint32_t> m_generations;
+    std::vector<bool>     m_is_alive;
+    std::vector<uint32_t> m_free_indices;
 };
 } // namespace Piccolo
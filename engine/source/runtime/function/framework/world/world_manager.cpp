@@ -1,6 +1,8 @@
 #include "runtime/function/framework/world/world_manager.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+#include "runtime/engine.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/config_manager/config_manager.h"
@@ -40,14 +42,26 @@ void WorldManager::clear() {
 }
 
 void WorldManager::tick(float delta_time) {
+    PROFILE_SCOPE("WorldManager::tick");
+
     if (!m_is_world_loaded)
         loadWorld(m_current_world_url);
 
     // tick the active level
     std::shared_ptr<Level> active_level = m_current_active_level.lock();
-    if (active_level) {
+    if (active_level)
         active_level->tick(delta_time);
-        m_level_debugger->tick(active_level);
+}
+
+void WorldManager::tickRenderExtract(float delta_time, float interpolation_alpha) {
+    PROFILE_SCOPE("WorldManager::tickRenderExtract");
+
+    std::shared_ptr<Level> active_level = m_current_active_level.lock();
+    if (active_level) {
+        active_level->tickRenderExtract(delta_time, interpolation_alpha);
+        // debug draw 按帧收集，放在这里避免一帧多个逻辑步长时重复绘制
+        if (!g_is_headless_mode)
+            m_level_debugger->tick(active_level);
     }
 }
 
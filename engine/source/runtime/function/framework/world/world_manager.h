@@ -23,6 +23,7 @@ public:
     void saveCurrentLevel();
 
     void                 tick(float delta_time);
+    void                 tickRenderExtract(float delta_time, float interpolation_alpha);
     std::weak_ptr<Level> getCurrentActiveLevel() const { return m_current_active_level; }
 
     std::weak_ptr<PhysicsScene> getCurrentActivePhysicsScene() const;
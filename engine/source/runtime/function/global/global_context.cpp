@@ -1,6 +1,9 @@
 #include "runtime/function/global/global_context.h"
 
+#include "core/base/macro.h"
+#include "core/job/job_system.h"
 #include "core/log/log_system.h"
+#include "core/profiler/profiler.h"
 
 #include "runtime/engine.h"
 
@@ -23,6 +26,10 @@ namespace Piccolo {
 RuntimeGlobalContext g_runtime_global_context;
 
 void RuntimeGlobalContext::startSystems(const std::string &config_file_path) {
+    // 最先创建，其余系统的初始化（如资源加载）也能计时
+    m_profiler = std::make_shared<Profiler>();
+    PROFILE_THREAD("main");
+
     m_config_manager = std::make_shared<ConfigManager>();
     m_config_manager->initialize(config_file_path);
 
@@ -30,6 +37,9 @@ void RuntimeGlobalContext::startSystems(const std::string &config_file_path) {
 
     m_logger_system = std::make_shared<LogSystem>();
 
+    m_job_system = std::make_shared<JobSystem>();
+    m_job_system->initialize();
+
     m_asset_manager = std::make_shared<AssetManager>();
 
     m_physics_manager = std::make_shared<PhysicsManager>();
@@ -38,16 +48,25 @@ void RuntimeGlobalContext::startSystems(const std::string &config_file_path) {
     m_world_manager = std::make_shared<WorldManager>();
     m_world_manager->initialize();
 
+    // headless 模式不创建窗口和渲染系统，input system 不注册窗口回调，只保留空的输入状态
+    m_input_system = std::make_shared<InputSystem>();
+
+    m_particle_manager = std::make_shared<ParticleManager>();
+    m_particle_manager->initialize();
+
+    m_render_debug_config = std::make_shared<RenderDebugConfig>();
+
+    if (g_is_headless_mode) {
+        LOG_INFO("headless mode, window and render systems are not created");
+        return;
+    }
+
     m_window_system = std::make_shared<WindowSystem>();
     WindowCreateInfo window_create_info;
     m_window_system->initialize(window_create_info);
 
-    m_input_system = std::make_shared<InputSystem>();
     m_input_system->initialize();
 
-    m_particle_manager = std::make_shared<ParticleManager>();
-    m_particle_manager->initialize();
-
     m_render_system = std::make_shared<RenderSystem>();
     RenderSystemInitInfo render_init_info;
     render_init_info.window_system = m_window_system;
@@ -55,8 +74,6 @@ void RuntimeGlobalContext::startSystems(const std::string &config_file_path) {
 
     m_debugdraw_manager = std::make_shared<DebugDrawManager>();
     m_debugdraw_manager->initialize();
-
-    m_render_debug_config = std::make_shared<RenderDebugConfig>();
 }
 
 void RuntimeGlobalContext::shutdownSystems() {
@@ -64,7 +81,8 @@ void RuntimeGlobalContext::shutdownSystems() {
 
     m_debugdraw_manager.reset();
 
-    m_render_system->clear();
+    if (m_render_system)
+        m_render_system->clear();
     m_render_system.reset();
 
     m_window_system.reset();
@@ -80,6 +98,9 @@ void RuntimeGlobalContext::shutdownSystems() {
 
     m_asset_manager.reset();
 
+    m_job_system->clear();
+    m_job_system.reset();
+
     m_logger_system.reset();
 
     m_file_system.reset();
@@ -87,5 +108,7 @@ void RuntimeGlobalContext::shutdownSystems() {
     m_config_manager.reset();
 
     m_particle_manager.reset();
+
+    m_profiler.reset();
 }
 } // namespace Piccolo
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 namespace Piccolo {
 class LogSystem;
+class Profiler;
+class JobSystem;
 class InputSystem;
 class PhysicsManager;
 class FileSystem;
@@ -28,7 +30,9 @@ public:
     void shutdownSystems();
 
 public:
+    std::shared_ptr<Profiler>          m_profiler;
     std::shared_ptr<LogSystem>         m_logger_system;
+    std::shared_ptr<JobSystem>         m_job_system;
     std::shared_ptr<InputSystem>       m_input_system;
     std::shared_ptr<FileSystem>        m_file_system;
     std::shared_ptr<AssetManager>      m_asset_manager;
@@ -1,6 +1,7 @@
 #include "runtime/function/input/input_system.h"
 
 #include "core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/engine.h"
 #include "runtime/function/global/global_context.h"
@@ -10,6 +11,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+
 namespace Piccolo {
 unsigned int k_complement_control_command = 0xFFFFFFFF;
 
@@ -22,8 +25,10 @@ void InputSystem::initialize() {
     window_system->registerOnCursorPosFunc(std::bind(&InputSystem::onCursorPos, this, std::placeholders::_1, std::placeholders::_2));
 }
 
-void InputSystem::tick() {
-    calculateCursorDeltaAngles();
+void InputSystem::tick(uint32_t logic_step_count) {
+    PROFILE_SCOPE("InputSystem::tick");
+
+    calculateCursorDeltaAngles(logic_step_count);
     clear();
 
     std::shared_ptr<WindowSystem> window_system = g_runtime_global_context.m_window_system;
@@ -108,14 +113,14 @@ void InputSystem::onKey(int key, int scancode, int action, int mods) {
 
 void InputSystem::onCursorPos(double current_cursor_x, double current_cursor_y) {
     if (g_runtime_global_context.m_window_system->getFocusMode()) {
-        m_cursor_delta_x = m_last_cursor_x - current_cursor_x;
-        m_cursor_delta_y = m_last_cursor_y - current_cursor_y;
+        m_cursor_delta_x += m_last_cursor_x - current_cursor_x;
+        m_cursor_delta_y += m_last_cursor_y - current_cursor_y;
     }
     m_last_cursor_x = current_cursor_x;
     m_last_cursor_y = current_cursor_y;
 }
 
-void InputSystem::calculateCursorDeltaAngles() {
+void InputSystem::calculateCursorDeltaAngles(uint32_t logic_step_count) {
     std::array<int, 2> window_size = g_runtime_global_context.m_window_system->getWindowSize();
 
     if (window_size[0] < 1 || window_size[1] < 1)
@@ -127,7 +132,9 @@ void InputSystem::calculateCursorDeltaAngles() {
     Radian cursor_delta_x(Math::degreesToRadians(m_cursor_delta_x));
     Radian cursor_delta_y(Math::degreesToRadians(m_cursor_delta_y));
 
-    m_cursor_delta_yaw   = (cursor_delta_x / (float)window_size[0]) * fov.x;
-    m_cursor_delta_pitch = -(cursor_delta_y / (float)window_size[1]) * fov.y;
+    // 每个逻辑步都读取同样的角度，总和等于本帧的光标位移
+    float step_count     = static_cast<float>(std::max(logic_step_count, 1u));
+    m_cursor_delta_yaw   = (cursor_delta_x / (float)window_size[0]) * fov.x / step_count;
+    m_cursor_delta_pitch = -(cursor_delta_y / (float)window_size[1]) * fov.y / step_count;
 }
 } // namespace Piccolo
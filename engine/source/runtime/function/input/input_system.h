@@ -2,6 +2,8 @@
 
 #include "runtime/core/math/math.h"
 
+#include <cstdint>
+
 // input_system 是 Game Mode 下输入系统，Editor Mode 对应逻辑在 editor_input_manager 中
 // initialize() 函数会注册输入事件回调函数到 window_system 中
 
@@ -24,7 +26,8 @@ extern unsigned int k_complement_control_command;
 class InputSystem {
 public:
     void initialize();
-    void tick();
+    // 每帧在逻辑步之前调用一次，本帧累积的光标位移平分到 logic_step_count 个逻辑步中
+    void tick(uint32_t logic_step_count = 1);
     void clear();
 
 public:
@@ -39,13 +42,14 @@ public:
     void resetGameCommand() { m_game_command = 0; }
 
 private:
-    void calculateCursorDeltaAngles();
+    void calculateCursorDeltaAngles(uint32_t logic_step_count);
 
     unsigned int m_game_command {0};
 
     int m_last_cursor_x {0};
     int m_last_cursor_y {0};
 
+    // 两次 tick 之间累积，帧率高于逻辑频率时不推进逻辑的帧不会丢失光标位移
     int m_cursor_delta_x {0};
     int m_cursor_delta_y {0};
 
@@ -3,6 +3,7 @@
 #include "runtime/function/render/passes/particle_pass.h"
 #include "runtime/function/render/render_system.h"
 
+#include "runtime/engine.h"
 #include "runtime/function/global/global_context.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
@@ -44,6 +45,12 @@ void ParticleManager::initialize() {
 
 void ParticleManager::createParticleEmitter(const ParticleComponentRes   &particle_res,
     ParticleEmitterTransformDesc &transform_desc) {
+    // headless 模式下没有渲染，只分配 id
+    if (g_is_headless_mode) {
+        transform_desc.m_id = ParticleEmitterIDAllocator::alloc();
+        return;
+    }
+
     RenderSwapContext &swap_context = g_runtime_global_context.m_render_system->getSwapContext();
     RenderSwapData    &swap_data    = swap_context.getLogicSwapData();
 
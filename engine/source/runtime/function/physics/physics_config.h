@@ -20,6 +20,7 @@ public:
 
     Vector3 m_gravity {0.f, 0.f, -9.8f};
 
+    // 内部 collision step 的最低频率，tick 的 delta_time 更长时会拆分成多步
     float m_update_frequency {60.f};
 };
 } // namespace Piccolo
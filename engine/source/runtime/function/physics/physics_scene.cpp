@@ -1,6 +1,7 @@
 #include "runtime/function/physics/physics_scene.h"
 
 #include "core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/resource/res_type/components/rigid_body.h"
 
@@ -29,6 +30,9 @@
 #include "Jolt/Physics/Collision/ShapeCast.h"
 #include "Jolt/Physics/PhysicsSystem.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace Piccolo {
 PhysicsScene::PhysicsScene(const Vector3 &gravity) {
     static_assert(s_invalid_rigidbody_id == JPH::BodyID::cInvalidBodyID);
@@ -151,10 +155,14 @@ void PhysicsScene::updateRigidBodyGlobalTransform(uint32_t body_id, const Transf
 }
 
 void PhysicsScene::tick(float delta_time) {
-    const float time_step = 1.f / m_config.m_update_frequency;
+    PROFILE_SCOPE("PhysicsScene::tick");
+
+    // 按调用方给的 delta_time 推进，过长时拆成多个 collision step，保证内部步长不超过 1 / m_update_frequency
+    const int collision_steps =
+        std::max(m_physics.m_collision_steps, static_cast<int>(std::ceil(delta_time * m_config.m_update_frequency)));
 
-    m_physics.m_jolt_physics_system->Update(time_step,
-                                            m_physics.m_collision_steps,
+    m_physics.m_jolt_physics_system->Update(delta_time,
+                                            collision_steps,
                                             m_physics.m_integration_substeps,
                                             m_physics.m_temp_allocator,
                                             m_physics.m_jolt_job_system);
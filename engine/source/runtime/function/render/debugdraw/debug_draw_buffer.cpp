@@ -20,6 +20,7 @@ void DebugDrawAllocator::tick() {
 }
 
 RHIBuffer* DebugDrawAllocator::getVertexBuffer() {return m_vertex_resource.buffer;}
+RHIBuffer* DebugDrawAllocator::getInstanceBuffer() { return m_instance_resource.buffer; }
 RHIDescriptorSet* &DebugDrawAllocator::getDescriptorSet() { return m_descriptor.descriptor_set[m_rhi->getCurrentFrameIndex()]; }
 
 size_t DebugDrawAllocator::cacheVertexs(const std::vector<DebugDrawVertex> &vertexs) {
@@ -42,6 +43,12 @@ size_t DebugDrawAllocator::cacheUniformDynamicObject(const std::vector<std::pair
     return offset;
 }
 
+size_t DebugDrawAllocator::cacheInstances(const std::vector<DebugDrawInstance> &instances) {
+    size_t offset = m_instance_cache.size();
+    m_instance_cache.insert(m_instance_cache.end(), instances.begin(), instances.end());
+    return offset;
+}
+
 size_t DebugDrawAllocator::getVertexCacheOffset() const {
     return m_vertex_cache.size();
 }
@@ -67,6 +74,21 @@ void DebugDrawAllocator::allocator() {
         m_rhi->unmapMemory(m_vertex_resource.memory);
     }
 
+    uint64_t instance_bufferSize = static_cast<uint64_t>(m_instance_cache.size() * sizeof(DebugDrawInstance));
+    if (instance_bufferSize > 0) {
+        m_rhi->createBuffer(
+            instance_bufferSize,
+            RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_instance_resource.buffer,
+            m_instance_resource.memory);
+
+        void* data;
+        m_rhi->mapMemory(m_instance_resource.memory, 0, instance_bufferSize, 0, &data);
+        memcpy(data, m_instance_cache.data(), instance_bufferSize);
+        m_rhi->unmapMemory(m_instance_resource.memory);
+    }
+
     uint64_t uniform_BufferSize = static_cast<uint64_t>(sizeof(UniformBufferObject));
     if (uniform_BufferSize > 0) {
         m_rhi->createBuffer(
@@ -105,6 +127,7 @@ void DebugDrawAllocator::clear() {
     m_vertex_cache.clear();
     m_uniform_buffer_object.proj_view_matrix = Matrix4x4::IDENTITY;
     m_uniform_buffer_dynamic_object_cache.clear();
+    m_instance_cache.clear();
 }
 
 void DebugDrawAllocator::clearBuffer() {
@@ -113,6 +136,11 @@ void DebugDrawAllocator::clearBuffer() {
         m_vertex_resource.buffer = nullptr;
         m_vertex_resource.memory = nullptr;
     }
+    if (m_instance_resource.buffer) {
+        m_deffer_delete_queue[m_current_frame].push(m_instance_resource);
+        m_instance_resource.buffer = nullptr;
+        m_instance_resource.memory = nullptr;
+    }
     if (m_uniform_resource.buffer) {
         m_deffer_delete_queue[m_current_frame].push(m_uniform_resource);
         m_uniform_resource.buffer = nullptr;
@@ -242,6 +270,9 @@ void DebugDrawAllocator::updateDescriptorSet() {
 }
 
 void DebugDrawAllocator::unloadMeshBuffer() {
+    m_deffer_delete_queue[m_current_frame].push(m_box_resource);
+    m_box_resource.buffer = nullptr;
+    m_box_resource.memory = nullptr;
     m_deffer_delete_queue[m_current_frame].push(m_sphere_resource);
     m_sphere_resource.buffer = nullptr;
     m_sphere_resource.memory = nullptr;
@@ -253,6 +284,45 @@ void DebugDrawAllocator::unloadMeshBuffer() {
     m_capsule_resource.memory = nullptr;
 }
 
+void DebugDrawAllocator::loadBoxMeshBuffer() {
+    //half extents is 1
+    std::vector<DebugDrawVertex> vertexs(24);
+
+    float f[2] = { -1.0f, 1.0f };
+    static const size_t indies[] = { 0, 1, 1, 3, 3, 2, 2, 0, 4, 5, 5, 7, 7, 6, 6, 4, 0, 4, 1, 5, 3, 7, 2, 6 };
+    for (size_t i = 0; i < vertexs.size(); i++) {
+        size_t corner = indies[i];
+        vertexs[i].pos = Vector3(f[corner & 1], f[(corner >> 1) & 1], f[(corner >> 2) & 1]);
+        vertexs[i].color = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    uint64_t bufferSize = static_cast<uint64_t>(vertexs.size() * sizeof(DebugDrawVertex));
+
+    m_rhi->createBuffer(
+        bufferSize,
+        RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY,
+        m_box_resource.buffer,
+        m_box_resource.memory);
+
+    Resource stagingBuffer;
+    m_rhi->createBuffer(
+        bufferSize,
+        RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stagingBuffer.buffer,
+        stagingBuffer.memory);
+    void* data;
+    m_rhi->mapMemory(stagingBuffer.memory, 0, bufferSize, 0, &data);
+    memcpy(data, vertexs.data(), bufferSize);
+    m_rhi->unmapMemory(stagingBuffer.memory);
+
+    m_rhi->copyBuffer(stagingBuffer.buffer, m_box_resource.buffer, 0, 0, bufferSize);
+
+    m_rhi->destroyBuffer(stagingBuffer.buffer);
+    m_rhi->freeMemory(stagingBuffer.memory);
+}
+
 void DebugDrawAllocator::loadSphereMeshBuffer() {
     int32_t param = m_circle_sample_count;
     //radios is 1
@@ -466,6 +536,11 @@ void DebugDrawAllocator::loadCapsuleMeshBuffer() {
 }
 
 
+RHIBuffer* DebugDrawAllocator::getBoxVertexBuffer() {
+    if (m_box_resource.buffer == nullptr)
+        loadBoxMeshBuffer();
+    return m_box_resource.buffer;
+}
 RHIBuffer* DebugDrawAllocator::getSphereVertexBuffer() {
     if (m_sphere_resource.buffer == nullptr)
         loadSphereMeshBuffer();
@@ -482,6 +557,9 @@ RHIBuffer* DebugDrawAllocator::getCapsuleVertexBuffer() {
     return m_capsule_resource.buffer;
 }
 
+const size_t DebugDrawAllocator::getBoxVertexBufferSize() const {
+    return 24;
+}
 const size_t DebugDrawAllocator::getSphereVertexBufferSize() const {
     return ((m_circle_sample_count * 2 + 2) * (m_circle_sample_count * 2) * 2 + (m_circle_sample_count * 2 + 1) * (m_circle_sample_count * 2) * 2);
 }
@@ -18,18 +18,22 @@ public:
     size_t cacheVertexs(const std::vector<DebugDrawVertex> &vertexs);
     void cacheUniformObject(Matrix4x4 proj_view_matrix);
     size_t cacheUniformDynamicObject(const std::vector<std::pair<Matrix4x4, Vector4> > &model_colors);
+    size_t cacheInstances(const std::vector<DebugDrawInstance> &instances);
 
     size_t getVertexCacheOffset() const;
     size_t getUniformDynamicCacheOffset() const;
     void allocator();
 
     RHIBuffer* getVertexBuffer();
+    RHIBuffer* getInstanceBuffer();
     RHIDescriptorSet* &getDescriptorSet();
 
+    RHIBuffer* getBoxVertexBuffer();
     RHIBuffer* getSphereVertexBuffer();
     RHIBuffer* getCylinderVertexBuffer();
     RHIBuffer* getCapsuleVertexBuffer();
 
+    const size_t getBoxVertexBufferSize() const;
     const size_t getSphereVertexBufferSize() const;
     const size_t getCylinderVertexBufferSize() const;
     const size_t getCapsuleVertexBufferSize() const;
@@ -71,7 +75,11 @@ private:
     Resource m_uniform_dynamic_resource;
     std::vector<UniformBufferDynamicObject> m_uniform_buffer_dynamic_object_cache;
 
+    Resource m_instance_resource;
+    std::vector<DebugDrawInstance> m_instance_cache;
+
     //static mesh resource
+    Resource m_box_resource;
     Resource m_sphere_resource;
     Resource m_cylinder_resource;
     Resource m_capsule_resource;
@@ -90,6 +98,7 @@ private:
     void updateDescriptorSet();
     void flushPendingDelete();
     void unloadMeshBuffer();
+    void loadBoxMeshBuffer();
     void loadSphereMeshBuffer();
     void loadCylinderMeshBuffer();
     void loadCapsuleMeshBuffer();
@@ -1,20 +1,40 @@
 #include "debug_draw_context.h"
 
-namespace Piccolo {
-DebugDrawGroup* DebugDrawContext::tryGetOrCreateDebugDrawGroup(const std::string &name) {
-    std::lock_guard<std::mutex> guard(m_mutex);
+#include "runtime/core/base/macro.h"
 
-    size_t debug_draw_group_count = m_debug_draw_groups.size();
+namespace Piccolo {
+DebugDrawGroup* DebugDrawContext::findDebugDrawGroup(const std::string &name, size_t debug_draw_group_count) const {
     for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++) {
         DebugDrawGroup* debug_draw_group = m_debug_draw_groups[debug_draw_group_index];
         if (debug_draw_group->getName() == name)
             return debug_draw_group;
     }
+    return nullptr;
+}
+
+DebugDrawGroup* DebugDrawContext::tryGetOrCreateDebugDrawGroup(const std::string &name) {
+    DebugDrawGroup* debug_draw_group = findDebugDrawGroup(name, getDebugDrawGroupCount());
+    if (debug_draw_group)
+        return debug_draw_group;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    // 加锁之前可能已经被其它线程创建
+    size_t debug_draw_group_count = m_debug_draw_group_count.load(std::memory_order_relaxed);
+    debug_draw_group = findDebugDrawGroup(name, debug_draw_group_count);
+    if (debug_draw_group)
+        return debug_draw_group;
+
+    if (debug_draw_group_count == s_max_debug_draw_group_count) {
+        LOG_ERROR("too many debug draw groups, {} is not created", name);
+        return nullptr;
+    }
 
     DebugDrawGroup* new_debug_draw_group = new DebugDrawGroup;
     new_debug_draw_group->initialize();
     new_debug_draw_group->setName(name);
-    m_debug_draw_groups.push_back(new_debug_draw_group);
+    m_debug_draw_groups[debug_draw_group_count] = new_debug_draw_group;
+    m_debug_draw_group_count.store(debug_draw_group_count + 1, std::memory_order_release);
 
     return new_debug_draw_group;
 }
@@ -22,24 +42,24 @@ DebugDrawGroup* DebugDrawContext::tryGetOrCreateDebugDrawGroup(const std::string
 void DebugDrawContext::clear() {
     std::lock_guard<std::mutex> guard(m_mutex);
 
-    size_t debug_draw_group_count = m_debug_draw_groups.size();
-    for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++)
+    size_t debug_draw_group_count = m_debug_draw_group_count.load(std::memory_order_relaxed);
+    m_debug_draw_group_count.store(0, std::memory_order_release);
+    for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++) {
         delete m_debug_draw_groups[debug_draw_group_index];
-
-    m_debug_draw_groups.clear();
+        m_debug_draw_groups[debug_draw_group_index] = nullptr;
+    }
 }
 
 void DebugDrawContext::tick(float delta_time) {
     removeDeadPrimitives(delta_time);
 }
 
+// 在帧边界调用：先收集各线程本帧录制的 primitive，再按生命周期删除
 void DebugDrawContext::removeDeadPrimitives(float delta_time) {
-    std::lock_guard<std::mutex> guard(m_mutex);
-
-    size_t debug_draw_group_count = m_debug_draw_groups.size();
+    size_t debug_draw_group_count = getDebugDrawGroupCount();
     for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++) {
-        if (m_debug_draw_groups[debug_draw_group_index] == nullptr)continue;
+        m_debug_draw_groups[debug_draw_group_index]->collectRecordedPrimitives();
         m_debug_draw_groups[debug_draw_group_index]->removeDeadPrimitives(delta_time);
     }
 }
-}
\ No newline at end of file
+}
@@ -2,17 +2,28 @@
 
 #include "debug_draw_group.h"
 
+#include <array>
+#include <atomic>
+
 namespace Piccolo {
 class DebugDrawContext {
 public:
-    std::vector<DebugDrawGroup*> m_debug_draw_groups;
+    // 已有的 group 不加锁查找，只有创建新 group 时加锁；group 只在 clear 时删除
     DebugDrawGroup* tryGetOrCreateDebugDrawGroup(const std::string &name);
+    size_t          getDebugDrawGroupCount() const { return m_debug_draw_group_count.load(std::memory_order_acquire); }
+    DebugDrawGroup* getDebugDrawGroup(size_t index) const { return m_debug_draw_groups[index]; }
     void clear();
     void tick(float delta_time);
 
 private:
+    static constexpr size_t s_max_debug_draw_group_count {256};
+
     std::mutex m_mutex;
+    std::array<DebugDrawGroup*, s_max_debug_draw_group_count> m_debug_draw_groups {};
+    std::atomic<size_t>                                        m_debug_draw_group_count {0};
+
+    DebugDrawGroup* findDebugDrawGroup(const std::string &name, size_t debug_draw_group_count) const;
     void removeDeadPrimitives(float delta_time);
 };
 
-}
\ No newline at end of file
+}
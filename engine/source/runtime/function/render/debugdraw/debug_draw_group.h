@@ -2,25 +2,41 @@
 
 #include "debug_draw_primitive.h"
 #include "debug_draw_font.h"
+#include <memory>
 #include <mutex>
-#include <list>
+#include <vector>
 
 namespace Piccolo {
+// 按类型连续存放的 primitive，clear 时保留容量，作为每帧复用的线性 arena
+struct DebugDrawPrimitiveArrays {
+    std::vector<DebugDrawPoint>    m_points;
+    std::vector<DebugDrawLine>     m_lines;
+    std::vector<DebugDrawTriangle> m_triangles;
+    std::vector<DebugDrawQuad>     m_quads;
+    std::vector<DebugDrawBox>      m_boxes;
+    std::vector<DebugDrawCylinder> m_cylinders;
+    std::vector<DebugDrawSphere>   m_spheres;
+    std::vector<DebugDrawCapsule>  m_capsules;
+    std::vector<DebugDrawText>     m_texts;
+
+    void clear();
+    void append(const DebugDrawPrimitiveArrays &rhs);
+};
+
+// add* 可以在任意线程中调用，不加锁：每个线程写入自己的 arena（每个线程只在第一次写入时注册一次）
+// DebugDrawManager::collectRecordedPrimitives 在帧边界把各线程的 arena 收集到 m_primitives 中，此时不能有线程在录制
+// m_primitives 只在渲染一侧访问
 class DebugDrawGroup {
 private:
-    std::mutex m_mutex;
+    std::mutex m_mutex; // 只保护 m_thread_arenas 的注册与收集
 
     std::string m_name;
+    uint32_t    m_id; // 线程本地的 arena 缓存以此查找，group 删除后不会被复用
+
+    std::vector<std::unique_ptr<DebugDrawPrimitiveArrays>> m_thread_arenas;
+    DebugDrawPrimitiveArrays                               m_primitives;
 
-    std::list<DebugDrawPoint>    m_points;
-    std::list<DebugDrawLine>     m_lines;
-    std::list<DebugDrawTriangle> m_triangles;
-    std::list<DebugDrawQuad>     m_quads;
-    std::list<DebugDrawBox>      m_boxes;
-    std::list<DebugDrawCylinder> m_cylinders;
-    std::list<DebugDrawSphere>   m_spheres;
-    std::list<DebugDrawCapsule>  m_capsules;
-    std::list<DebugDrawText>     m_texts;
+    DebugDrawPrimitiveArrays &getThreadArena();
 
 public:
     virtual ~DebugDrawGroup();
@@ -101,20 +117,26 @@ public:
                  const bool         is_screen_text,
                  const float        life_time = k_debug_draw_one_frame);
 
+    DebugDrawGroup();
+
+    void collectRecordedPrimitives();
     void removeDeadPrimitives(float delta_time);
     void mergeFrom(DebugDrawGroup* group);
 
     size_t getPointCount(bool no_depth_test) const;
     size_t getLineCount(bool no_depth_test) const;
     size_t getTriangleCount(bool no_depth_test) const;
-    size_t getUniformDynamicDataCount() const;
 
     void writePointData(std::vector<DebugDrawVertex> &vertexs, bool no_depth_test);
     void writeLineData(std::vector<DebugDrawVertex> &vertexs, bool no_depth_test);
     void writeTriangleData(std::vector<DebugDrawVertex> &vertexs, bool no_depth_test);
-    void writeUniformDynamicDataToCache(std::vector<std::pair<Matrix4x4, Vector4> > &datas);
+    void writeBoxInstanceData(std::vector<DebugDrawInstance> &instances, bool no_depth_test);
+    void writeSphereInstanceData(std::vector<DebugDrawInstance> &instances, bool no_depth_test);
+    void writeCylinderInstanceData(std::vector<DebugDrawInstance> &instances, bool no_depth_test);
+    void writeCapsuleInstanceData(std::vector<DebugDrawInstance> &instances, bool no_depth_test);
     void writeTextData(std::vector<DebugDrawVertex> &vertexs, DebugDrawFont* font, Matrix4x4 m_proj_view_matrix);
 
+    size_t getBoxCount(bool no_depth_test) const;
     size_t getSphereCount(bool no_depth_test) const;
     size_t getCylinderCount(bool no_depth_test) const;
     size_t getCapsuleCount(bool no_depth_test) const;
@@ -1,4 +1,7 @@
 #include "debug_draw_manager.h"
+
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_system.h"
 #include "runtime/core/math/math_headers.h"
@@ -34,15 +37,13 @@ void DebugDrawManager::destory() {
     delete m_font;
 }
 void DebugDrawManager::clear() {
-    std::lock_guard<std::mutex> guard(m_mutex);
     m_debug_draw_context.clear();
 }
 
-void DebugDrawManager::tick(float delta_time) {
-    std::lock_guard<std::mutex> guard(m_mutex);
-    m_buffer_allocator->tick();
-    m_debug_draw_context.tick(delta_time);
-}
+// 渲染一侧在帧边界调用，各线程的录制在此之前完成
+void DebugDrawManager::tick(float delta_time) { m_buffer_allocator->tick(); }
+
+void DebugDrawManager::collectRecordedPrimitives(float delta_time) { m_debug_draw_context.tick(delta_time); }
 
 void DebugDrawManager::updateAfterRecreateSwapchain() {
     for (uint8_t i = 0; i < DebugDrawPipelineType::_debug_draw_pipeline_type_count; i++)
@@ -55,19 +56,17 @@ void DebugDrawManager::preparePassData(std::shared_ptr<RenderResourceBase> rende
 
 }
 
+// tick 已经把录制的 primitive 收集到各 group 中，这里只在渲染一侧合并，不需要加锁
 void DebugDrawManager::swapDataToRender() {
-    std::lock_guard<std::mutex> guard(m_mutex);
-
-    m_debug_draw_group_for_render.clear();
-    size_t debug_draw_group_count = m_debug_draw_context.m_debug_draw_groups.size();
-    for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++) {
-        DebugDrawGroup* debug_draw_group = m_debug_draw_context.m_debug_draw_groups[debug_draw_group_index];
-        if (debug_draw_group == nullptr)continue;
-        m_debug_draw_group_for_render.mergeFrom(debug_draw_group);
-    }
+    m_debug_draw_group_for_render.clearData();
+    size_t debug_draw_group_count = m_debug_draw_context.getDebugDrawGroupCount();
+    for (size_t debug_draw_group_index = 0; debug_draw_group_index < debug_draw_group_count; debug_draw_group_index++)
+        m_debug_draw_group_for_render.mergeFrom(m_debug_draw_context.getDebugDrawGroup(debug_draw_group_index));
 }
 
 void DebugDrawManager::draw(uint32_t current_swapchain_image_index) {
+    PROFILE_SCOPE("DebugDrawManager::draw");
+
 
     static uint32_t once = 1;
     swapDataToRender();
@@ -121,8 +120,26 @@ void DebugDrawManager::prepareDrawBuffer() {
     std::vector<std::pair<Matrix4x4, Vector4> > dynamicObject = { std::make_pair(Matrix4x4::IDENTITY, Vector4(0, 0, 0, 0)) };
     m_buffer_allocator->cacheUniformDynamicObject(dynamicObject);//cache the first model matrix as Identity matrix, color as empty color. (default object)
 
-    m_debug_draw_group_for_render.writeUniformDynamicDataToCache(dynamicObject);
-    m_buffer_allocator->cacheUniformDynamicObject(dynamicObject);//cache the wire frame uniform dynamic object
+    std::vector<DebugDrawInstance> instances;
+    for (int32_t i = 0; i < 2; i++) {
+        bool no_depth_test = i == 1;
+
+        m_debug_draw_group_for_render.writeBoxInstanceData(instances, no_depth_test);
+        m_box_instance_range[i].start_offset = m_buffer_allocator->cacheInstances(instances);
+        m_box_instance_range[i].count = instances.size();
+
+        m_debug_draw_group_for_render.writeSphereInstanceData(instances, no_depth_test);
+        m_sphere_instance_range[i].start_offset = m_buffer_allocator->cacheInstances(instances);
+        m_sphere_instance_range[i].count = instances.size();
+
+        m_debug_draw_group_for_render.writeCylinderInstanceData(instances, no_depth_test);
+        m_cylinder_instance_range[i].start_offset = m_buffer_allocator->cacheInstances(instances);
+        m_cylinder_instance_range[i].count = instances.size();
+
+        m_debug_draw_group_for_render.writeCapsuleInstanceData(instances, no_depth_test);
+        m_capsule_instance_range[i].start_offset = m_buffer_allocator->cacheInstances(instances);
+        m_capsule_instance_range[i].count = instances.size() / 3;
+    }
 
     m_buffer_allocator->allocator();
 }
@@ -190,16 +207,22 @@ void DebugDrawManager::drawPointLineTriangleBox(uint32_t current_swapchain_image
     }
 }
 void DebugDrawManager::drawWireFrameObject(uint32_t current_swapchain_image_index) {
-    //draw wire frame object : sphere, cylinder, capsule
+    //draw wire frame object : box, sphere, cylinder, capsule
+    //每种 mesh 在每种深度测试模式下只有一次 instanced draw（capsule 三段各一次），实例数据来自 instance buffer
+
+    RHIBuffer* instance_buffer = m_buffer_allocator->getInstanceBuffer();
+    if (instance_buffer == nullptr)
+        return;
 
-    std::vector<DebugDrawPipeline*>vc_pipelines{ m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_line],
-        m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_line_no_depth_test] };
-    std::vector<bool>no_depth_tests = { false, true };
+    std::vector<DebugDrawPipeline*>vc_pipelines{ m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_line_instance],
+        m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_line_instance_no_depth_test] };
 
     for (int32_t i = 0; i < 2; i++) {
-        bool no_depth_test = no_depth_tests[i];
+        size_t instance_count = m_box_instance_range[i].count + m_sphere_instance_range[i].count +
+                                m_cylinder_instance_range[i].count + m_capsule_instance_range[i].count;
+        if (instance_count == 0)
+            continue;
 
-        RHIDeviceSize offsets[] = { 0 };
         RHIClearValue clear_values[2];
         clear_values[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
         clear_values[1].depthStencil = { 1.0f, 0 };
@@ -214,92 +237,57 @@ void DebugDrawManager::drawWireFrameObject(uint32_t current_swapchain_image_inde
         m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(), &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
         m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, vc_pipelines[i]->getPipeline().pipeline);
 
-        size_t uniform_dynamic_size = m_buffer_allocator->getSizeOfUniformBufferObject();
-        uint32_t dynamicOffset = uniform_dynamic_size;
-
-        size_t sphere_count = m_debug_draw_group_for_render.getSphereCount(no_depth_test);
-        size_t cylinder_count = m_debug_draw_group_for_render.getCylinderCount(no_depth_test);
-        size_t capsule_count = m_debug_draw_group_for_render.getCapsuleCount(no_depth_test);
-
-        if (sphere_count > 0) {
-            RHIBuffer* sphere_vertex_buffers[] = { m_buffer_allocator->getSphereVertexBuffer() };
-            m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, sphere_vertex_buffers, offsets);
-            for (size_t j = 0; j < sphere_count; j++) {
-
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                vc_pipelines[i]->getPipeline().layout,
-                                                0,
-                                                1,
-                                                &m_buffer_allocator->getDescriptorSet(),
-                                                1,
-                                                &dynamicOffset);
-                m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), m_buffer_allocator->getSphereVertexBufferSize(), 1, 0, 0);
-                dynamicOffset += uniform_dynamic_size;
-            }
-        }
-
-        if (cylinder_count > 0) {
-            RHIBuffer* cylinder_vertex_buffers[] = { m_buffer_allocator->getCylinderVertexBuffer() };
-            m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, cylinder_vertex_buffers, offsets);
-            for (size_t j = 0; j < cylinder_count; j++) {
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                vc_pipelines[i]->getPipeline().layout,
-                                                0,
-                                                1,
-                                                &m_buffer_allocator->getDescriptorSet(),
-                                                1,
-                                                &dynamicOffset);
-                m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), m_buffer_allocator->getCylinderVertexBufferSize(), 1, 0, 0);
-                dynamicOffset += uniform_dynamic_size;
-            }
-        }
+        uint32_t dynamicOffset = 0;
+        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        vc_pipelines[i]->getPipeline().layout,
+                                        0,
+                                        1,
+                                        &m_buffer_allocator->getDescriptorSet(),
+                                        1,
+                                        &dynamicOffset);
 
-        if (capsule_count > 0) {
-            RHIBuffer* capsule_vertex_buffers[] = { m_buffer_allocator->getCapsuleVertexBuffer() };
-            m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, capsule_vertex_buffers, offsets);
-            for (size_t j = 0; j < capsule_count; j++) {
-                //draw capsule up part
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                vc_pipelines[i]->getPipeline().layout,
-                                                0,
-                                                1,
-                                                &m_buffer_allocator->getDescriptorSet(),
-                                                1,
-                                                &dynamicOffset);
-                m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), m_buffer_allocator->getCapsuleVertexBufferUpSize(), 1, 0, 0);
-                dynamicOffset += uniform_dynamic_size;
-
-                //draw capsule mid part
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                vc_pipelines[i]->getPipeline().layout,
-                                                0,
-                                                1,
-                                                &m_buffer_allocator->getDescriptorSet(),
-                                                1,
-                                                &dynamicOffset);
-                m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), m_buffer_allocator->getCapsuleVertexBufferMidSize(), 1, m_buffer_allocator->getCapsuleVertexBufferUpSize(), 0);
-                dynamicOffset += uniform_dynamic_size;
-
-                //draw capsule down part
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                vc_pipelines[i]->getPipeline().layout,
-                                                0,
-                                                1,
-                                                &m_buffer_allocator->getDescriptorSet(),
-                                                1,
-                                                &dynamicOffset);
-                m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(),
-                               m_buffer_allocator->getCapsuleVertexBufferDownSize(),
-                               1,
-                               m_buffer_allocator->getCapsuleVertexBufferUpSize() + m_buffer_allocator->getCapsuleVertexBufferMidSize(),
-                               0);
-                dynamicOffset += uniform_dynamic_size;
-            }
+        RHIDeviceSize offsets[] = { 0, 0 };
+        auto drawInstances = [&](RHIBuffer* mesh_vertex_buffer, size_t vertex_count, size_t first_vertex, size_t instance_count, size_t first_instance) {
+            RHIBuffer* vertex_buffers[] = { mesh_vertex_buffer, instance_buffer };
+            m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 2, vertex_buffers, offsets);
+            m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), vertex_count, instance_count, first_vertex, first_instance);
+        };
+
+        if (m_box_instance_range[i].count > 0)
+            drawInstances(m_buffer_allocator->getBoxVertexBuffer(),
+                          m_buffer_allocator->getBoxVertexBufferSize(),
+                          0,
+                          m_box_instance_range[i].count,
+                          m_box_instance_range[i].start_offset);
+
+        if (m_sphere_instance_range[i].count > 0)
+            drawInstances(m_buffer_allocator->getSphereVertexBuffer(),
+                          m_buffer_allocator->getSphereVertexBufferSize(),
+                          0,
+                          m_sphere_instance_range[i].count,
+                          m_sphere_instance_range[i].start_offset);
+
+        if (m_cylinder_instance_range[i].count > 0)
+            drawInstances(m_buffer_allocator->getCylinderVertexBuffer(),
+                          m_buffer_allocator->getCylinderVertexBufferSize(),
+                          0,
+                          m_cylinder_instance_range[i].count,
+                          m_cylinder_instance_range[i].start_offset);
+
+        const InstanceRange &capsule_range = m_capsule_instance_range[i];
+        if (capsule_range.count > 0) {
+            RHIBuffer* capsule_vertex_buffer = m_buffer_allocator->getCapsuleVertexBuffer();
+            size_t up_size = m_buffer_allocator->getCapsuleVertexBufferUpSize();
+            size_t mid_size = m_buffer_allocator->getCapsuleVertexBufferMidSize();
+            size_t down_size = m_buffer_allocator->getCapsuleVertexBufferDownSize();
+
+            //draw capsule up part
+            drawInstances(capsule_vertex_buffer, up_size, 0, capsule_range.count, capsule_range.start_offset);
+            //draw capsule mid part
+            drawInstances(capsule_vertex_buffer, mid_size, up_size, capsule_range.count, capsule_range.start_offset + capsule_range.count);
+            //draw capsule down part
+            drawInstances(capsule_vertex_buffer, down_size, up_size + mid_size, capsule_range.count, capsule_range.start_offset + capsule_range.count * 2);
         }
 
         m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
@@ -313,7 +301,6 @@ void DebugDrawManager::drawDebugObject(uint32_t current_swapchain_image_index) {
 }
 
 DebugDrawGroup* DebugDrawManager::tryGetOrCreateDebugDrawGroup(const std::string &name) {
-    std::lock_guard<std::mutex> guard(m_mutex);
     return m_debug_draw_context.tryGetOrCreateDebugDrawGroup(name);
 }
 }
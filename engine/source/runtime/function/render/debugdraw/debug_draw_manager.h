@@ -18,7 +18,10 @@ public:
     void destory();
     void clear();
     void tick(float delta_time);
+    // 在逻辑与渲染的同步点调用，此时没有线程在录制：收集各线程录制的 primitive 并删除过期的
+    void collectRecordedPrimitives(float delta_time);
     void updateAfterRecreateSwapchain();
+    // 可以在任意线程中调用，返回的 group 在 clear 之前一直有效
     DebugDrawGroup* tryGetOrCreateDebugDrawGroup(const std::string &name);
 
     void draw(uint32_t current_swapchain_image_index);
@@ -31,7 +34,6 @@ private:
     void drawPointLineTriangleBox(uint32_t current_swapchain_image_index);
     void drawWireFrameObject(uint32_t current_swapchain_image_index);
 
-    std::mutex m_mutex;
     std::shared_ptr<RHI> m_rhi = nullptr;
     DebugDrawPipeline* m_debug_draw_pipeline[DebugDrawPipelineType::_debug_draw_pipeline_type_count] = {};
 
@@ -59,6 +61,16 @@ private:
     size_t m_no_depth_test_triangle_end_offset;
     size_t m_text_start_offset;
     size_t m_text_end_offset;
+
+    // 实例化绘制的线框 mesh 在 instance buffer 中的范围，下标为 no_depth_test
+    struct InstanceRange {
+        size_t start_offset = 0;
+        size_t count = 0;
+    };
+    InstanceRange m_box_instance_range[2];
+    InstanceRange m_sphere_instance_range[2];
+    InstanceRange m_cylinder_instance_range[2];
+    InstanceRange m_capsule_instance_range[2]; // count 为 capsule 个数，上半球、中段、下半球依次各占 count 个实例
 };
 
 }
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <debugdraw_vert.h>
 #include <debugdraw_frag.h>
+#include <debugdraw_instance_vert.h>
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_system.h"
 namespace Piccolo {
@@ -146,7 +147,10 @@ void DebugDrawPipeline::setupPipelines() {
     if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[0].layout) != RHI_SUCCESS)
         throw std::runtime_error("create mesh inefficient pick pipeline layout");
 
-    RHIShader* vert_shader_module = m_rhi->createShaderModule(DEBUGDRAW_VERT);
+    bool is_instance_pipeline = m_pipeline_type == _debug_draw_pipeline_type_line_instance ||
+                                m_pipeline_type == _debug_draw_pipeline_type_line_instance_no_depth_test;
+
+    RHIShader* vert_shader_module = m_rhi->createShaderModule(is_instance_pipeline ? DEBUGDRAW_INSTANCE_VERT : DEBUGDRAW_VERT);
     RHIShader* frag_shader_module = m_rhi->createShaderModule(DEBUGDRAW_FRAG);
 
     RHIPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info{};
@@ -165,8 +169,19 @@ void DebugDrawPipeline::setupPipelines() {
                                                          frag_pipeline_shader_stage_create_info
                                                        };
 
-    auto vertex_binding_descriptions = DebugDrawVertex::getBindingDescriptions();
-    auto vertex_attribute_descriptions = DebugDrawVertex::getAttributeDescriptions();
+    // 实例化的 pipeline 在 binding 0 的 mesh 顶点之外再读取 binding 1 的实例数据
+    std::vector<RHIVertexInputBindingDescription> vertex_binding_descriptions;
+    std::vector<RHIVertexInputAttributeDescription> vertex_attribute_descriptions;
+    for (const auto &description : DebugDrawVertex::getBindingDescriptions())
+        vertex_binding_descriptions.push_back(description);
+    for (const auto &description : DebugDrawVertex::getAttributeDescriptions())
+        vertex_attribute_descriptions.push_back(description);
+    if (is_instance_pipeline) {
+        for (const auto &description : DebugDrawInstance::getBindingDescriptions())
+            vertex_binding_descriptions.push_back(description);
+        for (const auto &description : DebugDrawInstance::getAttributeDescriptions())
+            vertex_attribute_descriptions.push_back(description);
+    }
     RHIPipelineVertexInputStateCreateInfo vertex_input_state_create_info{};
     vertex_input_state_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertex_input_state_create_info.vertexBindingDescriptionCount = static_cast<uint32_t>(vertex_binding_descriptions.size());
@@ -271,10 +286,15 @@ void DebugDrawPipeline::setupPipelines() {
     } else if (m_pipeline_type == _debug_draw_pipeline_type_triangle_no_depth_test) {
         input_assembly_create_info.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         depth_stencil_create_info.depthTestEnable = RHI_FALSE;
+    } else if (m_pipeline_type == _debug_draw_pipeline_type_line_instance)
+        input_assembly_create_info.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    else if (m_pipeline_type == _debug_draw_pipeline_type_line_instance_no_depth_test) {
+        input_assembly_create_info.topology = RHI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        depth_stencil_create_info.depthTestEnable = RHI_FALSE;
     }
 
     if (m_rhi->createGraphicsPipelines(
-            RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline) !=
+            m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline) !=
         RHI_SUCCESS)
         throw std::runtime_error("create debug draw graphics pipeline");
 
@@ -33,6 +33,8 @@ enum DebugDrawPipelineType : uint8_t {
     _debug_draw_pipeline_type_point_no_depth_test,
     _debug_draw_pipeline_type_line_no_depth_test,
     _debug_draw_pipeline_type_triangle_no_depth_test,
+    _debug_draw_pipeline_type_line_instance, // 线框 mesh 的实例化绘制，每个实例的 model 与 color 来自 instance buffer
+    _debug_draw_pipeline_type_line_instance_no_depth_test,
     _debug_draw_pipeline_type_count,
 };
 
@@ -74,6 +74,40 @@ struct DebugDrawVertex {
     }
 };
 
+// 实例化绘制的线框 mesh（box, sphere, cylinder, capsule）每个实例的数据，作为 binding 1 按实例读取
+struct DebugDrawInstance {
+    Matrix4x4 model_matrix;
+    Vector4   color;
+
+    static std::array<RHIVertexInputBindingDescription, 1> getBindingDescriptions() {
+        std::array<RHIVertexInputBindingDescription, 1> binding_descriptions;
+        binding_descriptions[0].binding = 1;
+        binding_descriptions[0].stride = sizeof(DebugDrawInstance);
+        binding_descriptions[0].inputRate = RHI_VERTEX_INPUT_RATE_INSTANCE;
+
+        return binding_descriptions;
+    }
+
+    // model_matrix 按 4 个 vec4 占用 location 3 ~ 6，color 占用 location 7
+    static std::array<RHIVertexInputAttributeDescription, 5> getAttributeDescriptions() {
+        std::array<RHIVertexInputAttributeDescription, 5> attribute_descriptions{};
+
+        for (uint32_t i = 0; i < 4; i++) {
+            attribute_descriptions[i].binding = 1;
+            attribute_descriptions[i].location = 3 + i;
+            attribute_descriptions[i].format = RHI_FORMAT_R32G32B32A32_SFLOAT;
+            attribute_descriptions[i].offset = offsetof(DebugDrawInstance, model_matrix) + sizeof(Vector4) * i;
+        }
+
+        attribute_descriptions[4].binding = 1;
+        attribute_descriptions[4].location = 7;
+        attribute_descriptions[4].format = RHI_FORMAT_R32G32B32A32_SFLOAT;
+        attribute_descriptions[4].offset = offsetof(DebugDrawInstance, color);
+
+        return attribute_descriptions;
+    }
+};
+
 class DebugDrawPrimitive {
 public:
     DebugDrawTimeType m_time_type{ _debugDrawTimeType_infinity };
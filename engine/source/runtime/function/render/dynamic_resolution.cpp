@@ -0,0 +1,59 @@
+#include "runtime/function/render/dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Piccolo {
+void DynamicResolutionController::initialize(const DynamicResolutionConfig &config) {
+    m_config           = config;
+    m_config.min_scale = std::clamp(m_config.min_scale, s_scale_step, 1.0f);
+
+    m_scale              = 1.0f;
+    m_average_frame_time = 0.0f;
+    m_cooldown_frames    = 0;
+}
+
+void DynamicResolutionController::addFrameTimeSample(float frame_time) {
+    if (!m_config.enable || frame_time <= 0.0f)
+        return;
+
+    if (m_average_frame_time == 0.0f)
+        m_average_frame_time = frame_time;
+    else
+        m_average_frame_time += (frame_time - m_average_frame_time) * s_smoothing_factor;
+
+    if (m_cooldown_frames > 0) {
+        --m_cooldown_frames;
+        return;
+    }
+
+    float target = m_config.target_frame_time;
+    if (m_average_frame_time > target * s_downscale_threshold) {
+        // 场景的开销近似与像素数即比例的平方成正比
+        float desired_scale = m_scale * std::sqrt(target / m_average_frame_time);
+        desired_scale       = std::floor(desired_scale / s_scale_step) * s_scale_step;
+        desired_scale       = std::max(desired_scale, m_config.min_scale);
+        if (desired_scale < m_scale) {
+            m_scale           = desired_scale;
+            m_cooldown_frames = s_cooldown_frame_count;
+        }
+    } else if (m_average_frame_time < target * s_upscale_threshold && m_scale < 1.0f) {
+        // 每次只升高一个步长，避免在预算附近来回振荡
+        m_scale           = std::min(m_scale + s_scale_step, 1.0f);
+        m_cooldown_frames = s_cooldown_frame_count;
+    }
+}
+
+void DynamicResolutionController::computeSceneViewport(const RHIViewport &viewport,
+                                                       RHIViewport       &scene_viewport,
+                                                       RHIRect2D         &scene_scissor) const {
+    scene_viewport        = viewport;
+    scene_viewport.width  = std::max(std::ceil(viewport.width * m_scale), 1.0f);
+    scene_viewport.height = std::max(std::ceil(viewport.height * m_scale), 1.0f);
+
+    scene_scissor.offset.x      = static_cast<int32_t>(scene_viewport.x);
+    scene_scissor.offset.y      = static_cast<int32_t>(scene_viewport.y);
+    scene_scissor.extent.width  = static_cast<uint32_t>(scene_viewport.width);
+    scene_scissor.extent.height = static_cast<uint32_t>(scene_viewport.height);
+}
+} // namespace Piccolo
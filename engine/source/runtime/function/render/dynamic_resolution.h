@@ -0,0 +1,42 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <cstdint>
+
+namespace Piccolo {
+struct DynamicResolutionConfig {
+    bool  enable {false};
+    float target_frame_time {16.6f}; // ms
+    float min_scale {0.5f};
+};
+
+// 根据最近的帧耗时在 [min_scale, 1] 内选择场景的渲染比例
+// 场景 subpass 只渲染到全尺寸 attachment 左上角按比例缩小的区域，再由 post process subpass 放大回整个 viewport
+class DynamicResolutionController {
+public:
+    void initialize(const DynamicResolutionConfig &config);
+
+    // 每帧传入一次上一帧的耗时（ms）
+    void addFrameTimeSample(float frame_time);
+
+    bool  isEnabled() const { return m_config.enable; }
+    float getScale() const { return m_scale; }
+
+    // 由整个 viewport 得到场景 subpass 使用的缩小后的 viewport 和 scissor，左上角保持不变
+    void computeSceneViewport(const RHIViewport &viewport, RHIViewport &scene_viewport, RHIRect2D &scene_scissor) const;
+
+private:
+    static constexpr float    s_smoothing_factor     = 0.1f;  // 帧耗时的指数滑动平均系数
+    static constexpr float    s_scale_step           = 0.05f; // 比例按步长量化，避免每帧都有微小的变化
+    static constexpr float    s_upscale_threshold    = 0.85f; // 平均耗时低于预算的这个比例时才提高比例
+    static constexpr float    s_downscale_threshold  = 1.05f; // 平均耗时超过预算的这个比例时才降低比例
+    static constexpr uint32_t s_cooldown_frame_count = 16;    // 比例变化后等待若干帧，让新比例反映到测量结果中
+
+    DynamicResolutionConfig m_config;
+
+    float    m_scale {1.0f};
+    float    m_average_frame_time {0.0f};
+    uint32_t m_cooldown_frames {0};
+};
+} // namespace Piccolo
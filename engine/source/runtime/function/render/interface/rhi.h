@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 #include <vk_mem_alloc.h>
 
+#include <filesystem>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -14,6 +15,15 @@ class WindowSystem;
 
 struct RHIInitInfo {
     std::shared_ptr<WindowSystem> window_system;
+    std::filesystem::path         pipeline_cache_folder; // empty means the pipeline cache is not persisted
+    bool                          enable_bindless_material {false}; // only a request, falls back when the device lacks descriptor indexing
+};
+
+// submitRendering 的结果，只有 is_submitted 为 true 时 frame_index 上的 texture copy semaphore 才会被 signal
+struct RHISubmitResult {
+    bool    is_submitted {false};
+    uint8_t frame_index {0}; // 提交时使用的 frame index，提交后当前 frame index 已经前进
+    bool    is_swapchain_recreated {false}; // present 后重建了 swapchain，依赖 swapchain 尺寸的资源已经重新创建
 };
 
 class RHI {
@@ -24,6 +34,7 @@ public:
     virtual void prepareContext() = 0;
 
     virtual bool isPointLightShadowEnabled() = 0;
+    virtual bool isBindlessMaterialEnabled() = 0;
     // allocate and create
     virtual bool allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers) = 0;
     virtual bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) = 0;
@@ -105,9 +116,12 @@ public:
     virtual void cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) = 0;
     virtual void cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) = 0;
     virtual void cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) = 0;
+    virtual void cmdFillBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* dstBuffer, RHIDeviceSize dstOffset, RHIDeviceSize size, uint32_t data) = 0;
     virtual void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
+    virtual void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) = 0;
     virtual void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
     virtual void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) = 0;
+    virtual void cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) = 0;
     virtual void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) = 0;
     virtual bool endCommandBuffer(RHICommandBuffer* commandBuffer) = 0;
     virtual void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) = 0;
@@ -126,17 +140,21 @@ public:
     virtual QueueFamilyIndices getQueueFamilyIndices() const = 0;
     virtual RHIQueue* getGraphicsQueue() const = 0;
     virtual RHIQueue* getComputeQueue() const = 0;
+    virtual RHIPipelineCache* getPipelineCache() const = 0;
+    virtual uint32_t getMaxBindlessTextureCount() const = 0;
     virtual RHISwapChainDesc getSwapchainInfo() = 0;
     virtual RHIDepthImageDesc getDepthImageInfo() const = 0;
     virtual uint8_t getMaxFramesInFlight() const = 0;
     virtual uint8_t getCurrentFrameIndex() const = 0;
     virtual void setCurrentFrameIndex(uint8_t index) = 0;
+    // 最近一次读回的 GPU 帧耗时（ms），不支持 timestamp 或尚未读回时返回 false
+    virtual bool getLastGPUFrameTime(float &out_frame_time) const = 0;
 
     // command write
     virtual RHICommandBuffer* beginSingleTimeCommands() = 0;
     virtual void            endSingleTimeCommands(RHICommandBuffer* command_buffer) = 0;
     virtual bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) = 0;
-    virtual void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) = 0;
+    virtual RHISubmitResult submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) = 0;
     virtual void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) = 0;
     virtual void popEvent(RHICommandBuffer* commond_buffer) = 0;
 
@@ -167,6 +185,8 @@ public:
 
     //semaphores
     virtual RHISemaphore* &getTextureCopySemaphore(uint32_t index) = 0;
+    // 下一次 submitRendering 额外等待的 semaphore，用于其它队列上的工作（如粒子模拟）与渲染同步
+    virtual void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage) = 0;
 
 private:
 };
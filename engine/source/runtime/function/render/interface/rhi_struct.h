@@ -338,6 +338,14 @@ struct RHIDescriptorSetLayoutCreateInfo {
     const RHIDescriptorSetLayoutBinding* pBindings;
 };
 
+// chained through pNext as-is, keep the layout identical to the vulkan struct
+struct RHIDescriptorSetLayoutBindingFlagsCreateInfo {
+    RHIStructureType sType;
+    const void* pNext;
+    uint32_t bindingCount;
+    const RHIDescriptorBindingFlags* pBindingFlags;
+};
+
 struct RHIDeviceCreateInfo {
     RHIStructureType sType;
     const void* pNext;
@@ -903,7 +911,7 @@ struct RHISubmitInfo {
     uint32_t commandBufferCount;
     RHICommandBuffer* const* pCommandBuffers;
     uint32_t signalSemaphoreCount;
-    const RHISemaphore** pSignalSemaphores;
+    RHISemaphore* const* pSignalSemaphores;
 };
 
 struct RHISubpassDependency {
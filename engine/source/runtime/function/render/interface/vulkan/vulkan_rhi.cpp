@@ -3,8 +3,11 @@
 
 #include "runtime/function/render/window_system.h"
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
+#include "runtime/function/global/global_context.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 // https://gcc.gnu.org/onlinedocs/cpp/Stringizing.html
@@ -69,6 +72,7 @@
 #endif
 
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -80,7 +84,10 @@ VulkanRHI::~VulkanRHI() {
 }
 
 void VulkanRHI::initialize(RHIInitInfo init_info) {
-    m_window = init_info.window_system->getWindow();
+    m_window                = init_info.window_system->getWindow();
+    m_window_thread_id      = std::this_thread::get_id();
+    m_pipeline_cache_folder = init_info.pipeline_cache_folder;
+    m_enable_bindless_material = init_info.enable_bindless_material;
 
     std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
@@ -134,12 +141,16 @@ void VulkanRHI::initialize(RHIInitInfo init_info) {
 
     createLogicalDevice();
 
+    createGPUTimestampQueryPools();
+
     createCommandPool();
 
     createCommandBuffers();
 
     createDescriptorPool();
 
+    createPipelineCache();
+
     createSyncPrimitives();
 
     createSwapchain();
@@ -157,15 +168,27 @@ void VulkanRHI::prepareContext() {
 }
 
 void VulkanRHI::clear() {
+    savePipelineCache();
+    destroyPipelineCache();
+
+    destroyGPUTimestampQueryPools();
+
     if (m_enable_validation_Layers)
         destroyDebugUtilsMessengerEXT(m_instance, m_debug_messenger, nullptr);
 }
 
 void VulkanRHI::waitForFences() {
+    PROFILE_SCOPE("VulkanRHI::waitForFences");
+
     VkResult res_wait_for_fences =
         _vkWaitForFences(m_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index], VK_TRUE, UINT64_MAX);
-    if (VK_SUCCESS != res_wait_for_fences)
+    if (VK_SUCCESS != res_wait_for_fences) {
         LOG_ERROR("failed to synchronize!");
+        return;
+    }
+
+    // 这个 frame 上一轮录制的命令已经执行完，可以无等待地读回 timestamp
+    readbackGPUTimestampFrame(m_current_frame_index);
 }
 
 bool VulkanRHI::waitForFences(uint32_t fenceCount, const RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout) {
@@ -330,6 +353,12 @@ void VulkanRHI::resetCommandPool() {
 }
 
 bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) {
+    // 跳过的帧不录制 pass，避免在上一帧的 query pool 上继续写入
+    {
+        std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+        m_is_gpu_timestamp_recording = false;
+    }
+
     VkResult acquire_image_result =
         vkAcquireNextImageKHR(m_device,
                               m_swapchain,
@@ -392,15 +421,22 @@ bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateS
         LOG_ERROR("_vkBeginCommandBuffer failed!");
         return false;
     }
+
+    beginGPUTimestampFrame();
     return false;
 }
 
-void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) {
+RHISubmitResult VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) {
+    RHISubmitResult submit_result;
+
+    // 结束整帧的 scope，之后 compute 队列上的粒子模拟仍记录到这个 frame 的 query pool 中
+    popGPUTimestampScope(m_vk_command_buffers[m_current_frame_index]);
+
     // end command buffer
     VkResult res_end_command_buffer = _vkEndCommandBuffer(m_vk_command_buffers[m_current_frame_index]);
     if (VK_SUCCESS != res_end_command_buffer) {
         LOG_ERROR("_vkEndCommandBuffer failed!");
-        return;
+        return submit_result;
     }
 
     VkSemaphore semaphores[2] = { ((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[m_current_frame_index])->getResource(),
@@ -408,12 +444,16 @@ void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwa
                                 };
 
     // submit command buffer
-    VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    std::vector<VkSemaphore>          wait_semaphores = {m_image_available_for_render_semaphores[m_current_frame_index]};
+    std::vector<VkPipelineStageFlags> wait_stages     = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    wait_semaphores.insert(wait_semaphores.end(), m_rendering_wait_semaphores.begin(), m_rendering_wait_semaphores.end());
+    wait_stages.insert(wait_stages.end(), m_rendering_wait_stages.begin(), m_rendering_wait_stages.end());
+
     VkSubmitInfo         submit_info   = {};
     submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.waitSemaphoreCount     = 1;
-    submit_info.pWaitSemaphores        = &m_image_available_for_render_semaphores[m_current_frame_index];
-    submit_info.pWaitDstStageMask      = wait_stages;
+    submit_info.waitSemaphoreCount     = static_cast<uint32_t>(wait_semaphores.size());
+    submit_info.pWaitSemaphores        = wait_semaphores.data();
+    submit_info.pWaitDstStageMask      = wait_stages.data();
     submit_info.commandBufferCount     = 1;
     submit_info.pCommandBuffers        = &m_vk_command_buffers[m_current_frame_index];
     submit_info.signalSemaphoreCount = 2;
@@ -423,14 +463,27 @@ void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwa
 
     if (VK_SUCCESS != res_reset_fences) {
         LOG_ERROR("_vkResetFences failed!");
-        return;
+        return submit_result;
     }
     VkResult res_queue_submit =
         vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
 
     if (VK_SUCCESS != res_queue_submit) {
         LOG_ERROR("vkQueueSubmit failed!");
-        return;
+        return submit_result;
+    }
+    m_rendering_wait_semaphores.clear();
+    m_rendering_wait_stages.clear();
+
+    submit_result.is_submitted = true;
+    submit_result.frame_index  = m_current_frame_index;
+    {
+        std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+        GPUTimestampFrame          &frame = m_gpu_timestamp_frames[m_current_frame_index];
+        if (m_is_gpu_timestamp_recording && m_gpu_timestamp_recording_frame_index == m_current_frame_index) {
+            frame.cpu_submit_ns = Profiler::now();
+            frame.is_submitted  = true;
+        }
     }
 
     // present swapchain
@@ -446,14 +499,14 @@ void VulkanRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwa
     if (VK_ERROR_OUT_OF_DATE_KHR == present_result || VK_SUBOPTIMAL_KHR == present_result) {
         recreateSwapchain();
         passUpdateAfterRecreateSwapchain();
-    } else {
-        if (VK_SUCCESS != present_result) {
-            LOG_ERROR("vkQueuePresentKHR failed!");
-            return;
-        }
+        submit_result.is_swapchain_recreated = true;
+    } else if (VK_SUCCESS != present_result) {
+        // 渲染已经提交，fence 和 semaphore 都会被 signal，frame index 仍要前进
+        LOG_ERROR("vkQueuePresentKHR failed!");
     }
 
     m_current_frame_index = (m_current_frame_index + 1) % k_max_frames_in_flight;
+    return submit_result;
 }
 
 RHICommandBuffer* VulkanRHI::beginSingleTimeCommands() {
@@ -561,6 +614,17 @@ void VulkanRHI::createInstance() {
 
     m_vulkan_api_version = VK_API_VERSION_1_0;
 
+    // descriptor indexing is queried through vkGetPhysicalDeviceFeatures2, which is core since 1.1
+    if (m_enable_bindless_material) {
+        uint32_t instance_version = VK_API_VERSION_1_0;
+        if (vkEnumerateInstanceVersion(&instance_version) == VK_SUCCESS && instance_version >= VK_API_VERSION_1_1)
+            m_vulkan_api_version = VK_API_VERSION_1_1;
+        else {
+            LOG_WARN("bindless material requires vulkan 1.1, fall back to per-material descriptor sets");
+            m_enable_bindless_material = false;
+        }
+    }
+
     // app info
     VkApplicationInfo appInfo {};
     appInfo.sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -657,6 +721,10 @@ void VulkanRHI::initializePhysicalDevice() {
 
         if (m_physical_device == VK_NULL_HANDLE)
             LOG_ERROR("failed to find suitable physical device");
+        else if (m_enable_bindless_material && !checkBindlessMaterialSupport(m_physical_device)) {
+            LOG_WARN("descriptor indexing is not supported by the device, fall back to per-material descriptor sets");
+            m_enable_bindless_material = false;
+        }
     }
 }
 
@@ -697,14 +765,30 @@ void VulkanRHI::createLogicalDevice() {
     if (m_enable_point_light_shadow)
         physical_device_features.geometryShader = VK_TRUE;
 
+    // bindless material: non-uniform indexing into a partially bound, update-after-bind texture array
+    std::vector<char const*> device_extensions = m_device_extensions;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features {};
+    descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    if (m_enable_bindless_material) {
+        device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+        descriptor_indexing_features.runtimeDescriptorArray                       = VK_TRUE;
+        descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+        descriptor_indexing_features.descriptorBindingPartiallyBound              = VK_TRUE;
+        descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+    }
+
     // device create info
     VkDeviceCreateInfo device_create_info {};
     device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_create_info.pNext                   = m_enable_bindless_material ? &descriptor_indexing_features : nullptr;
     device_create_info.pQueueCreateInfos       = queue_create_infos.data();
     device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
     device_create_info.pEnabledFeatures        = &physical_device_features;
-    device_create_info.enabledExtensionCount   = static_cast<uint32_t>(m_device_extensions.size());
-    device_create_info.ppEnabledExtensionNames = m_device_extensions.data();
+    device_create_info.enabledExtensionCount   = static_cast<uint32_t>(device_extensions.size());
+    device_create_info.ppEnabledExtensionNames = device_extensions.data();
     device_create_info.enabledLayerCount       = 0;
 
     if (vkCreateDevice(m_physical_device, &device_create_info, nullptr, &m_device) != VK_SUCCESS)
@@ -2201,6 +2285,10 @@ void VulkanRHI::cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, u
     vkCmdDraw(((VulkanCommandBuffer*)commandBuffer)->getResource(), vertexCount, instanceCount, firstVertex, firstInstance);
 }
 
+void VulkanRHI::cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) {
+    vkCmdDrawIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset, drawCount, stride);
+}
+
 void VulkanRHI::cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
     vkCmdDispatch(((VulkanCommandBuffer*)commandBuffer)->getResource(), groupCountX, groupCountY, groupCountZ);
 }
@@ -2209,6 +2297,14 @@ void VulkanRHI::cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer*
     vkCmdDispatchIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset);
 }
 
+void VulkanRHI::cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) {
+    std::vector<VkCommandBuffer> vk_command_buffer_list(commandBufferCount);
+    for (uint32_t i = 0; i < commandBufferCount; ++i)
+        vk_command_buffer_list[i] = ((VulkanCommandBuffer*)pCommandBuffers[i])->getResource();
+
+    vkCmdExecuteCommands(((VulkanCommandBuffer*)commandBuffer)->getResource(), commandBufferCount, vk_command_buffer_list.data());
+}
+
 void VulkanRHI::cmdCopyImageToBuffer(
     RHICommandBuffer* commandBuffer,
     RHIImage* srcImage,
@@ -2294,6 +2390,10 @@ void VulkanRHI::cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuf
                     &copyRegion);
 }
 
+void VulkanRHI::cmdFillBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* dstBuffer, RHIDeviceSize dstOffset, RHIDeviceSize size, uint32_t data) {
+    vkCmdFillBuffer(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)dstBuffer)->getResource(), dstOffset, size, data);
+}
+
 void VulkanRHI::createCommandBuffers() {
     VkCommandBufferAllocateInfo command_buffer_allocate_info {};
     command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -2318,13 +2418,13 @@ void VulkanRHI::createDescriptorPool() {
 
     VkDescriptorPoolSize pool_sizes[7];
     pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-    pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
+    pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3 + 1; // post process dynamic resolution
     pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count;
     pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     pool_sizes[2].descriptorCount = 1 * m_max_material_count;
     pool_sizes[3].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pool_sizes[3].descriptorCount = 3 + 5 * m_max_material_count + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
+    pool_sizes[3].descriptorCount = 3 + 5 * m_max_material_count + 1 + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects, post process scene color
     pool_sizes[4].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
     pool_sizes[4].descriptorCount = 4 + 1 + 1 + 2;
     pool_sizes[5].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -2347,6 +2447,101 @@ void VulkanRHI::createDescriptorPool() {
     ((VulkanDescriptorPool*)m_descriptor_pool)->setResource(m_vk_descriptor_pool);
 }
 
+// the cache file name carries the device and driver identity, so a driver update
+// or a different gpu never tries to reuse incompatible pipeline binaries
+void VulkanRHI::createPipelineCache() {
+    VkPhysicalDeviceProperties physical_device_properties;
+    vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+    std::vector<char> initial_data;
+    if (!m_pipeline_cache_folder.empty()) {
+        std::string file_name = "pipeline_cache_";
+        char        hex[3];
+        for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+            snprintf(hex, sizeof(hex), "%02x", physical_device_properties.pipelineCacheUUID[i]);
+            file_name += hex;
+        }
+        file_name += "_" + std::to_string(physical_device_properties.driverVersion) + ".bin";
+        m_pipeline_cache_path = m_pipeline_cache_folder / file_name;
+
+        std::ifstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+        if (cache_file.is_open()) {
+            initial_data.resize(static_cast<size_t>(cache_file.tellg()));
+            cache_file.seekg(0);
+            cache_file.read(initial_data.data(), initial_data.size());
+        }
+
+        // the driver should reject a foreign blob by itself, but some don't
+        VkPipelineCacheHeaderVersionOne header {};
+        if (initial_data.size() >= sizeof(header))
+            memcpy(&header, initial_data.data(), sizeof(header));
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != physical_device_properties.vendorID ||
+            header.deviceID != physical_device_properties.deviceID ||
+            memcmp(header.pipelineCacheUUID, physical_device_properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            if (!initial_data.empty())
+                LOG_WARN("pipeline cache {} does not match the device, rebuilding", m_pipeline_cache_path.generic_string());
+            initial_data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo pipeline_cache_create_info {};
+    pipeline_cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipeline_cache_create_info.initialDataSize = initial_data.size();
+    pipeline_cache_create_info.pInitialData    = initial_data.empty() ? nullptr : initial_data.data();
+
+    VkPipelineCache vk_pipeline_cache;
+    if (vkCreatePipelineCache(m_device, &pipeline_cache_create_info, nullptr, &vk_pipeline_cache) != VK_SUCCESS) {
+        // a rejected blob must not keep the renderer from starting
+        pipeline_cache_create_info.initialDataSize = 0;
+        pipeline_cache_create_info.pInitialData    = nullptr;
+        if (vkCreatePipelineCache(m_device, &pipeline_cache_create_info, nullptr, &vk_pipeline_cache) != VK_SUCCESS)
+            LOG_ERROR("create pipeline cache");
+    }
+    ((VulkanPipelineCache*)m_pipeline_cache)->setResource(vk_pipeline_cache);
+}
+
+void VulkanRHI::savePipelineCache() {
+    VkPipelineCache vk_pipeline_cache = ((VulkanPipelineCache*)m_pipeline_cache)->getResource();
+    if (m_pipeline_cache_path.empty() || vk_pipeline_cache == VK_NULL_HANDLE)
+        return;
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(m_device, vk_pipeline_cache, &data_size, nullptr) != VK_SUCCESS || data_size == 0)
+        return;
+    std::vector<char> data(data_size);
+    if (vkGetPipelineCacheData(m_device, vk_pipeline_cache, &data_size, data.data()) != VK_SUCCESS)
+        return;
+
+    std::error_code error_code;
+    std::filesystem::create_directories(m_pipeline_cache_folder, error_code);
+
+    // write then rename, a crash while saving must not leave a truncated cache behind
+    std::filesystem::path temp_path = m_pipeline_cache_path;
+    temp_path += ".tmp";
+    {
+        std::ofstream cache_file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!cache_file.is_open()) {
+            LOG_WARN("failed to write pipeline cache {}", temp_path.generic_string());
+            return;
+        }
+        cache_file.write(data.data(), data_size);
+    }
+    std::filesystem::rename(temp_path, m_pipeline_cache_path, error_code);
+    if (error_code)
+        LOG_WARN("failed to save pipeline cache {}", m_pipeline_cache_path.generic_string());
+}
+
+void VulkanRHI::destroyPipelineCache() {
+    VkPipelineCache vk_pipeline_cache = ((VulkanPipelineCache*)m_pipeline_cache)->getResource();
+    if (vk_pipeline_cache == VK_NULL_HANDLE)
+        return;
+
+    // 已经创建的 pipeline 不依赖 cache，保存之后即可销毁
+    vkDestroyPipelineCache(m_device, vk_pipeline_cache, nullptr);
+    ((VulkanPipelineCache*)m_pipeline_cache)->setResource(VK_NULL_HANDLE);
+}
+
 // semaphore : signal an image is ready for rendering // ready for presentation
 // (m_vulkan_context._swapchain_images --> semaphores, fences)
 void VulkanRHI::createSyncPrimitives() {
@@ -2397,6 +2592,8 @@ void VulkanRHI::createFramebufferImageAndView() {
 }
 
 RHISampler* VulkanRHI::getOrCreateDefaultSampler(RHIDefaultSamplerType type) {
+    std::lock_guard<std::mutex> guard(m_sampler_mutex);
+
     switch (type) {
     case Piccolo::Default_Sampler_Linear:
         if (m_linear_sampler == nullptr) {
@@ -2425,6 +2622,8 @@ RHISampler* VulkanRHI::getOrCreateMipmapSampler(uint32_t width, uint32_t height)
         LOG_ERROR("width == 0 || height == 0");
         return nullptr;
     }
+    std::lock_guard<std::mutex> guard(m_sampler_mutex);
+
     RHISampler* sampler;
     uint32_t  mip_levels = floor(log2(std::max(width, height))) + 1;
     auto      find_sampler = m_mipmap_sampler_map.find(mip_levels);
@@ -2659,7 +2858,12 @@ bool VulkanRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllo
 
     VkDescriptorSet vk_descriptor_set;
     pDescriptorSets = new VulkanDescriptorSet;
-    VkResult result = vkAllocateDescriptorSets(m_device, &descriptorset_allocate_info, &vk_descriptor_set);
+    VkResult result;
+    {
+        // descriptor pools are externally synchronized
+        std::lock_guard<std::mutex> guard(m_descriptor_pool_mutex);
+        result = vkAllocateDescriptorSets(m_device, &descriptorset_allocate_info, &vk_descriptor_set);
+    }
     ((VulkanDescriptorSet * )pDescriptorSets)->setResource(vk_descriptor_set);
 
     if (result == VK_SUCCESS)
@@ -2679,7 +2883,7 @@ bool VulkanRHI::allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllo
     command_buffer_allocate_info.commandBufferCount = pAllocateInfo->commandBufferCount;
 
     VkCommandBuffer vk_command_buffer;
-    pCommandBuffers = new RHICommandBuffer();
+    pCommandBuffers = new VulkanCommandBuffer();
     VkResult result = vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, &vk_command_buffer);
     ((VulkanCommandBuffer*)pCommandBuffers)->setResource(vk_command_buffer);
 
@@ -2873,13 +3077,22 @@ RHISemaphore* &VulkanRHI::getTextureCopySemaphore(uint32_t index) {
     return m_image_available_for_texturescopy_semaphores[index];
 }
 
+void VulkanRHI::addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage) {
+    m_rendering_wait_semaphores.push_back(((VulkanSemaphore*)semaphore)->getResource());
+    m_rendering_wait_stages.push_back((VkPipelineStageFlags)wait_stage);
+}
+
 void VulkanRHI::recreateSwapchain() {
     int width  = 0;
     int height = 0;
     glfwGetFramebufferSize(m_window, &width, &height);
     while (width == 0 || height == 0) { // minimized 0,0, pause for now
         glfwGetFramebufferSize(m_window, &width, &height);
-        glfwWaitEvents();
+        // 在渲染线程上时由主线程继续处理窗口事件，这里只等待
+        if (std::this_thread::get_id() == m_window_thread_id)
+            glfwWaitEvents();
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
     VkResult res_wait_for_fences =
@@ -2987,6 +3200,66 @@ bool VulkanRHI::isDeviceSuitable(VkPhysicalDevice physicalm_device) {
     return true;
 }
 
+bool VulkanRHI::checkBindlessMaterialSupport(VkPhysicalDevice physicalm_device) {
+    // upper bound of the texture array, the device limits are usually far above it
+    const uint32_t bindless_texture_count_limit = 1 << 14;
+    // samplers of the other descriptor sets bound together with the material set
+    const uint32_t reserved_sampler_count = 16;
+
+    VkPhysicalDeviceProperties physicalm_device_properties;
+    vkGetPhysicalDeviceProperties(physicalm_device, &physicalm_device_properties);
+    if (physicalm_device_properties.apiVersion < VK_API_VERSION_1_1)
+        return false;
+
+    uint32_t extension_count;
+    vkEnumerateDeviceExtensionProperties(physicalm_device, nullptr, &extension_count, nullptr);
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(physicalm_device, nullptr, &extension_count, available_extensions.data());
+
+    bool is_descriptor_indexing_supported = false;
+    for (const auto &extension : available_extensions) {
+        if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0) {
+            is_descriptor_indexing_supported = true;
+            break;
+        }
+    }
+    if (!is_descriptor_indexing_supported)
+        return false;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features {};
+    descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 physicalm_device_features {};
+    physicalm_device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    physicalm_device_features.pNext = &descriptor_indexing_features;
+    vkGetPhysicalDeviceFeatures2(physicalm_device, &physicalm_device_features);
+
+    if (!descriptor_indexing_features.runtimeDescriptorArray ||
+            !descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing ||
+            !descriptor_indexing_features.descriptorBindingPartiallyBound ||
+            !descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind ||
+            !descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending)
+        return false;
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_properties {};
+    descriptor_indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 physicalm_device_properties2 {};
+    physicalm_device_properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    physicalm_device_properties2.pNext = &descriptor_indexing_properties;
+    vkGetPhysicalDeviceProperties2(physicalm_device, &physicalm_device_properties2);
+
+    // a combined image sampler counts against both the sampler and the sampled image limits
+    uint32_t max_texture_count = std::min({descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                           descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                           descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+                                           descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                           bindless_texture_count_limit + reserved_sampler_count});
+    if (max_texture_count <= reserved_sampler_count)
+        return false;
+
+    m_max_bindless_texture_count = max_texture_count - reserved_sampler_count;
+    return true;
+}
+
 Piccolo::SwapChainSupportDetails VulkanRHI::querySwapChainSupport(VkPhysicalDevice physicalm_device) {
     SwapChainSupportDetails details_result;
 
@@ -3078,6 +3351,8 @@ VkExtent2D VulkanRHI::chooseSwapchainExtentFromDetails(const VkSurfaceCapabiliti
 }
 
 void VulkanRHI::pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) {
+    pushGPUTimestampScope(((VulkanCommandBuffer*)commond_buffer)->getResource(), name);
+
     if (m_enable_debug_utils_label) {
         VkDebugUtilsLabelEXT label_info;
         label_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
@@ -3092,8 +3367,186 @@ void VulkanRHI::pushEvent(RHICommandBuffer* commond_buffer, const char* name, co
 void VulkanRHI::popEvent(RHICommandBuffer* commond_buffer) {
     if (m_enable_debug_utils_label)
         _vkCmdEndDebugUtilsLabelEXT(((VulkanCommandBuffer * )commond_buffer)->getResource());
+
+    popGPUTimestampScope(((VulkanCommandBuffer*)commond_buffer)->getResource());
+}
+
+void VulkanRHI::createGPUTimestampQueryPools() {
+    VkPhysicalDeviceProperties physical_device_properties;
+    vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, queue_families.data());
+
+    // 粒子模拟在 compute 队列上，要求 graphics 和 compute 队列都支持 timestamp
+    uint32_t valid_bits = queue_families[m_queue_indices.graphics_family.value()].timestampValidBits;
+    if (!physical_device_properties.limits.timestampComputeAndGraphics || valid_bits == 0) {
+        LOG_WARN("timestamp queries are not supported, GPU timing is disabled");
+        m_enable_gpu_timestamp = false;
+        return;
+    }
+    m_timestamp_period = physical_device_properties.limits.timestampPeriod;
+    m_timestamp_mask   = valid_bits >= 64 ? ~0ull : ((1ull << valid_bits) - 1);
+
+    VkQueryPoolCreateInfo query_pool_create_info {};
+    query_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_create_info.queryCount = s_max_gpu_timestamp_query_count;
+    for (uint32_t i = 0; i < k_max_frames_in_flight; ++i) {
+        if (vkCreateQueryPool(m_device, &query_pool_create_info, nullptr, &m_gpu_timestamp_frames[i].query_pool) != VK_SUCCESS)
+            throw std::runtime_error("vk create query pool");
+    }
+    m_enable_gpu_timestamp = true;
+
+    if (g_runtime_global_context.m_profiler)
+        m_gpu_profile_track = g_runtime_global_context.m_profiler->getOrCreateTrack("GPU");
+}
+
+void VulkanRHI::destroyGPUTimestampQueryPools() {
+    if (!m_enable_gpu_timestamp)
+        return;
+
+    vkDeviceWaitIdle(m_device);
+    for (uint32_t i = 0; i < k_max_frames_in_flight; ++i) {
+        vkDestroyQueryPool(m_device, m_gpu_timestamp_frames[i].query_pool, nullptr);
+        m_gpu_timestamp_frames[i] = GPUTimestampFrame {};
+    }
+    m_enable_gpu_timestamp = false;
+    m_is_gpu_timestamp_recording = false;
+}
+
+void VulkanRHI::beginGPUTimestampFrame() {
+    if (!m_enable_gpu_timestamp)
+        return;
+
+    VkCommandBuffer command_buffer = m_vk_command_buffers[m_current_frame_index];
+    {
+        std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+        GPUTimestampFrame          &frame = m_gpu_timestamp_frames[m_current_frame_index];
+        frame.query_count  = 0;
+        frame.scopes.clear();
+        frame.open_scopes.clear();
+        frame.is_submitted = false;
+
+        vkCmdResetQueryPool(command_buffer, frame.query_pool, 0, s_max_gpu_timestamp_query_count);
+        m_gpu_timestamp_recording_frame_index = m_current_frame_index;
+        m_is_gpu_timestamp_recording          = true;
+    }
+    pushGPUTimestampScope(command_buffer, "GPU Frame");
+}
+
+void VulkanRHI::pushGPUTimestampScope(VkCommandBuffer command_buffer, const char* name) {
+    std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+    if (!m_is_gpu_timestamp_recording)
+        return;
+
+    GPUTimestampFrame     &frame       = m_gpu_timestamp_frames[m_gpu_timestamp_recording_frame_index];
+    std::vector<uint32_t> &scope_stack = frame.open_scopes[command_buffer];
+    if (frame.query_count + 2 > s_max_gpu_timestamp_query_count) {
+        scope_stack.push_back(UINT32_MAX);
+        return;
+    }
+
+    GPUTimestampScope scope;
+    scope.name        = name;
+    scope.begin_query = frame.query_count;
+    scope.depth       = static_cast<uint32_t>(scope_stack.size());
+    frame.query_count += 2;
+
+    scope_stack.push_back(static_cast<uint32_t>(frame.scopes.size()));
+    frame.scopes.push_back(std::move(scope));
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.query_pool, frame.scopes.back().begin_query);
+}
+
+void VulkanRHI::popGPUTimestampScope(VkCommandBuffer command_buffer) {
+    std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+    if (!m_is_gpu_timestamp_recording)
+        return;
+
+    GPUTimestampFrame &frame = m_gpu_timestamp_frames[m_gpu_timestamp_recording_frame_index];
+    auto               iter  = frame.open_scopes.find(command_buffer);
+    if (iter == frame.open_scopes.end() || iter->second.empty())
+        return;
+
+    uint32_t scope_index = iter->second.back();
+    iter->second.pop_back();
+    if (scope_index == UINT32_MAX)
+        return;
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.query_pool, frame.scopes[scope_index].begin_query + 1);
+}
+
+void VulkanRHI::readbackGPUTimestampFrame(uint8_t frame_index) {
+    if (!m_enable_gpu_timestamp)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+    GPUTimestampFrame          &frame = m_gpu_timestamp_frames[frame_index];
+    if (!frame.is_submitted || frame.query_count == 0)
+        return;
+    frame.is_submitted = false;
+
+    // 每个 query 两个值：timestamp 和 availability，没有写入的 query（如跳过的 pop）availability 为 0
+    std::vector<uint64_t> results(frame.query_count * 2);
+    VkResult              res_get_results =
+        vkGetQueryPoolResults(m_device, frame.query_pool, 0, frame.query_count, results.size() * sizeof(uint64_t), results.data(),
+                              2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (res_get_results != VK_SUCCESS && res_get_results != VK_NOT_READY)
+        return;
+
+    auto get_timestamp = [&](uint32_t query, uint64_t &out_timestamp) {
+        if (results[query * 2 + 1] == 0)
+            return false;
+        out_timestamp = results[query * 2] & m_timestamp_mask;
+        return true;
+    };
+
+    // 第一个 scope 是整帧，以它的开始对齐 CPU 提交时间，GPU 时间线与 CPU 时间线只是近似对齐
+    uint64_t frame_begin_timestamp = 0;
+    uint64_t frame_end_timestamp   = 0;
+    if (!get_timestamp(frame.scopes.front().begin_query, frame_begin_timestamp))
+        return;
+    if (get_timestamp(frame.scopes.front().begin_query + 1, frame_end_timestamp) && frame_end_timestamp >= frame_begin_timestamp) {
+        m_last_gpu_frame_time = static_cast<float>((frame_end_timestamp - frame_begin_timestamp) * m_timestamp_period / 1e6);
+        m_has_gpu_frame_time  = true;
+    }
+
+    #ifdef ENABLE_PROFILER
+    if (!m_gpu_profile_track)
+        return;
+    auto to_cpu_time = [&](uint64_t timestamp) {
+        double offset_ns = (static_cast<double>(timestamp) - static_cast<double>(frame_begin_timestamp)) * m_timestamp_period;
+        return static_cast<uint64_t>(std::max(0.0, static_cast<double>(frame.cpu_submit_ns) + offset_ns));
+    };
+    uint64_t frame_end_ns = 0;
+    for (const GPUTimestampScope &scope : frame.scopes) {
+        uint64_t begin_timestamp = 0;
+        uint64_t end_timestamp   = 0;
+        if (!get_timestamp(scope.begin_query, begin_timestamp) || !get_timestamp(scope.begin_query + 1, end_timestamp) ||
+            end_timestamp < begin_timestamp)
+            continue;
+
+        const char* name = m_gpu_timestamp_names.insert(scope.name).first->c_str();
+        m_gpu_profile_track->record(ProfileEvent {name, to_cpu_time(begin_timestamp), to_cpu_time(end_timestamp), scope.depth});
+        frame_end_ns = std::max(frame_end_ns, to_cpu_time(end_timestamp));
+    }
+    // 读回比 CPU 晚 k_max_frames_in_flight 帧，overlay 按这个范围显示最近读回的一帧
+    if (frame_end_ns != 0)
+        m_gpu_profile_track->setLastFrameRange(to_cpu_time(frame_begin_timestamp), frame_end_ns);
+    #endif
+}
+
+bool VulkanRHI::getLastGPUFrameTime(float &out_frame_time) const {
+    std::lock_guard<std::mutex> lock(m_gpu_timestamp_mutex);
+    if (!m_has_gpu_frame_time)
+        return false;
+    out_frame_time = m_last_gpu_frame_time;
+    return true;
 }
 bool VulkanRHI::isPointLightShadowEnabled() { return m_enable_point_light_shadow; }
+bool VulkanRHI::isBindlessMaterialEnabled() { return m_enable_bindless_material; }
 
 RHICommandBuffer* VulkanRHI::getCurrentCommandBuffer() const {
     return m_current_command_buffer;
@@ -3119,6 +3572,12 @@ RHIQueue* VulkanRHI::getGraphicsQueue() const {
 RHIQueue* VulkanRHI::getComputeQueue() const {
     return m_compute_queue;
 }
+RHIPipelineCache* VulkanRHI::getPipelineCache() const {
+    return m_pipeline_cache;
+}
+uint32_t VulkanRHI::getMaxBindlessTextureCount() const {
+    return m_enable_bindless_material ? m_max_bindless_texture_count : 0;
+}
 RHISwapChainDesc VulkanRHI::getSwapchainInfo() {
     RHISwapChainDesc desc;
     desc.image_format = m_swapchain_image_format;
@@ -6,12 +6,19 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace Piccolo {
-
+class ProfileTrack;
 
 class VulkanRHI final : public RHI {
 public:
@@ -99,9 +106,12 @@ public:
     void cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
     void cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) override;
     void cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) override;
+    void cmdFillBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* dstBuffer, RHIDeviceSize dstOffset, RHIDeviceSize size, uint32_t data) override;
     void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
+    void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) override;
     void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
     void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
+    void cmdExecuteCommands(RHICommandBuffer* commandBuffer, uint32_t commandBufferCount, RHICommandBuffer* const* pCommandBuffers) override;
     void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
     bool endCommandBuffer(RHICommandBuffer* commandBuffer) override;
     void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) override;
@@ -121,17 +131,20 @@ public:
     QueueFamilyIndices getQueueFamilyIndices() const override;
     RHIQueue* getGraphicsQueue() const override;
     RHIQueue* getComputeQueue() const override;
+    RHIPipelineCache* getPipelineCache() const override;
+    uint32_t getMaxBindlessTextureCount() const override;
     RHISwapChainDesc getSwapchainInfo() override;
     RHIDepthImageDesc getDepthImageInfo() const override;
     uint8_t getMaxFramesInFlight() const override;
     uint8_t getCurrentFrameIndex() const override;
     void setCurrentFrameIndex(uint8_t index) override;
+    bool getLastGPUFrameTime(float &out_frame_time) const override;
 
     // command write
     RHICommandBuffer* beginSingleTimeCommands() override;
     void            endSingleTimeCommands(RHICommandBuffer* command_buffer) override;
     bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) override;
-    void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) override;
+    RHISubmitResult submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) override;
     void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) override;
     void popEvent(RHICommandBuffer* commond_buffer) override;
 
@@ -163,6 +176,7 @@ public:
 
     //semaphores
     RHISemaphore* &getTextureCopySemaphore(uint32_t index) override;
+    void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage) override;
 public:
     static uint8_t const k_max_frames_in_flight {3};
 
@@ -183,6 +197,9 @@ public:
 
     RHIDescriptorPool* m_descriptor_pool = new VulkanDescriptorPool();
 
+    // shared by every pipeline creation, loaded from and saved to m_pipeline_cache_path
+    RHIPipelineCache* m_pipeline_cache = new VulkanPipelineCache();
+
     RHICommandPool* m_rhi_command_pool;
 
     RHICommandBuffer* m_command_buffers[k_max_frames_in_flight];
@@ -191,6 +208,7 @@ public:
     QueueFamilyIndices m_queue_indices;
 
     GLFWwindow*        m_window {nullptr};
+    std::thread::id    m_window_thread_id; // 创建窗口的线程，只有它能处理窗口事件
     VkInstance         m_instance {nullptr};
     VkSurfaceKHR       m_surface {nullptr};
     VkPhysicalDevice   m_physical_device {nullptr};
@@ -240,6 +258,10 @@ public:
     RHISemaphore*        m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight];
     VkFence              m_is_frame_in_flight_fences[k_max_frames_in_flight];
 
+    // 只在 submitRendering 成功提交后清空，跳过的帧不会丢失等待
+    std::vector<VkSemaphore>          m_rendering_wait_semaphores;
+    std::vector<VkPipelineStageFlags> m_rendering_wait_stages;
+
     // TODO: set
     VkCommandBuffer   m_vk_current_command_buffer;
 
@@ -256,6 +278,44 @@ private:
     RHISampler* m_nearest_sampler = nullptr;
     std::map<uint32_t, RHISampler*> m_mipmap_sampler_map;
 
+    // pipelines of independent passes are built on worker threads, these guard the externally synchronized objects
+    std::mutex m_descriptor_pool_mutex;
+    std::mutex m_sampler_mutex;
+
+    std::filesystem::path m_pipeline_cache_folder;
+    std::filesystem::path m_pipeline_cache_path;
+
+    // GPU 计时：每个 frame in flight 一个 timestamp query pool，pushEvent/popEvent 时在两端写入 timestamp，
+    // 等这个 frame 的 fence 再次被等到时（k_max_frames_in_flight 帧之后）读回，不会阻塞 GPU
+    struct GPUTimestampScope {
+        std::string name;
+        uint32_t    begin_query {0}; // 结束的 query 为 begin_query + 1
+        uint32_t    depth {0};
+    };
+    struct GPUTimestampFrame {
+        VkQueryPool                    query_pool {VK_NULL_HANDLE};
+        uint32_t                       query_count {0};
+        std::vector<GPUTimestampScope> scopes;
+        // 每个 command buffer 上尚未 pop 的 scope，query 用完后 push 的 scope 记为 UINT32_MAX
+        std::unordered_map<VkCommandBuffer, std::vector<uint32_t>> open_scopes;
+        uint64_t                       cpu_submit_ns {0};
+        bool                           is_submitted {false};
+    };
+    static constexpr uint32_t s_max_gpu_timestamp_query_count {256};
+
+    bool                              m_enable_gpu_timestamp {false};
+    float                             m_timestamp_period {1.f}; // 每个 tick 的纳秒数
+    uint64_t                          m_timestamp_mask {~0ull};
+    GPUTimestampFrame                 m_gpu_timestamp_frames[k_max_frames_in_flight];
+    uint8_t                           m_gpu_timestamp_recording_frame_index {0};
+    bool                              m_is_gpu_timestamp_recording {false};
+    float                             m_last_gpu_frame_time {0.f}; // ms
+    bool                              m_has_gpu_frame_time {false};
+    std::unordered_set<std::string>   m_gpu_timestamp_names; // ProfileEvent 只保存名字的指针
+    std::shared_ptr<ProfileTrack>     m_gpu_profile_track;
+    // 并行录制的 secondary command buffer 也会 pushEvent
+    mutable std::mutex                m_gpu_timestamp_mutex;
+
 private:
     void createInstance();
     void initializeDebugMessenger();
@@ -265,16 +325,33 @@ private:
     void createCommandPool() override;;
     void createCommandBuffers();
     void createDescriptorPool();
+    void createPipelineCache();
+    void savePipelineCache();
+    void destroyPipelineCache();
     void createSyncPrimitives();
     void createAssetAllocator();
+    void createGPUTimestampQueryPools();
+    void destroyGPUTimestampQueryPools();
+
+    // 在 prepareBeforePass 开始录制后重置当前 frame 的 query pool，并开始整帧的 scope
+    void beginGPUTimestampFrame();
+    void pushGPUTimestampScope(VkCommandBuffer command_buffer, const char* name);
+    void popGPUTimestampScope(VkCommandBuffer command_buffer);
+    // 调用前 frame_index 对应的 fence 必须已经 signal
+    void readbackGPUTimestampFrame(uint8_t frame_index);
 
 public:
     bool isPointLightShadowEnabled() override;
+    bool isBindlessMaterialEnabled() override;
 
 private:
     bool m_enable_validation_Layers{ true };
     bool m_enable_debug_utils_label{ true };
     bool m_enable_point_light_shadow{ true };
+    bool m_enable_bindless_material{ false };
+
+    // size of the bindless texture array, clamped to the update-after-bind limits of the device
+    uint32_t m_max_bindless_texture_count{ 0 };
 
     // used in descriptor pool creation
     uint32_t m_max_vertex_blending_mesh_count{ 256 };
@@ -296,6 +373,7 @@ private:
     QueueFamilyIndices      findQueueFamilies(VkPhysicalDevice physical_device);
     bool                    checkDeviceExtensionSupport(VkPhysicalDevice physical_device);
     bool                    isDeviceSuitable(VkPhysicalDevice physical_device);
+    bool                    checkBindlessMaterialSupport(VkPhysicalDevice physical_device);
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physical_device);
 
     VkFormat findDepthFormat();
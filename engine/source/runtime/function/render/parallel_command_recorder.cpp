@@ -0,0 +1,121 @@
+#include "runtime/function/render/parallel_command_recorder.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_pass.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Piccolo {
+void ParallelCommandRecorder::initialize(std::shared_ptr<RHI> rhi, uint32_t worker_count) {
+    m_rhi = rhi;
+
+    // 录制在 job system 的 worker 上进行，调用线程也录制一段
+    if (worker_count == 0)
+        worker_count = g_runtime_global_context.m_job_system->getWorkerCount() + 1;
+    m_worker_count = std::clamp(worker_count, 1u, s_max_worker_count);
+
+    m_worker_command_pools.resize(m_rhi->getMaxFramesInFlight());
+    for (auto &frame_command_pools : m_worker_command_pools) {
+        frame_command_pools.resize(m_worker_count);
+        for (auto &worker_command_pool : frame_command_pools) {
+            RHICommandPoolCreateInfo command_pool_create_info {};
+            command_pool_create_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            command_pool_create_info.pNext            = NULL;
+            command_pool_create_info.flags            = RHI_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            command_pool_create_info.queueFamilyIndex = m_rhi->getQueueFamilyIndices().graphics_family.value();
+
+            if (RHI_SUCCESS != m_rhi->createCommandPool(&command_pool_create_info, worker_command_pool.command_pool))
+                throw std::runtime_error("create worker command pool");
+        }
+    }
+}
+
+void ParallelCommandRecorder::prepareFrame() {
+    for (auto &worker_command_pool : m_worker_command_pools[m_rhi->getCurrentFrameIndex()]) {
+        if (worker_command_pool.used_command_buffer_count == 0)
+            continue;
+        m_rhi->resetCommandPoolPFN(worker_command_pool.command_pool, 0);
+        worker_command_pool.used_command_buffer_count = 0;
+    }
+}
+
+std::vector<RHICommandBuffer*> ParallelCommandRecorder::record(RHIRenderPass*        render_pass,
+                                                               uint32_t              subpass,
+                                                               RHIFramebuffer*       framebuffer,
+                                                               uint32_t              task_count,
+                                                               uint32_t              min_tasks_per_worker,
+                                                               const RecordFunction &record_function) {
+    uint32_t worker_count = std::min(m_worker_count, std::max(1u, task_count / std::max(1u, min_tasks_per_worker)));
+
+    std::vector<WorkerCommandPool> &frame_command_pools = m_worker_command_pools[m_rhi->getCurrentFrameIndex()];
+    std::vector<RHICommandBuffer*>  command_buffers(worker_count, nullptr);
+
+    auto record_range = [&](uint32_t worker_index) {
+        // 每段在自己的 ring buffer 子区间中分配，不与其他段竞争同一把锁
+        RenderPass::RingBufferWorkerScope ring_buffer_scope;
+
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(task_count) * worker_index / worker_count);
+        uint32_t end   = static_cast<uint32_t>(static_cast<uint64_t>(task_count) * (worker_index + 1) / worker_count);
+
+        RHICommandBuffer* command_buffer =
+            beginCommandBuffer(frame_command_pools[worker_index], render_pass, subpass, framebuffer);
+        record_function(command_buffer, begin, end);
+        m_rhi->endCommandBufferPFN(command_buffer);
+
+        command_buffers[worker_index] = command_buffer;
+    };
+
+    std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+
+    JobCounter counter;
+    for (uint32_t worker_index = 1; worker_index < worker_count; ++worker_index)
+        job_system->submit([&record_range, worker_index]() { record_range(worker_index); }, &counter);
+
+    record_range(0);
+
+    job_system->wait(counter);
+
+    return command_buffers;
+}
+
+RHICommandBuffer* ParallelCommandRecorder::beginCommandBuffer(WorkerCommandPool &worker_command_pool,
+                                                              RHIRenderPass*     render_pass,
+                                                              uint32_t           subpass,
+                                                              RHIFramebuffer*    framebuffer) {
+    if (worker_command_pool.used_command_buffer_count == worker_command_pool.command_buffers.size()) {
+        RHICommandBufferAllocateInfo command_buffer_allocate_info {};
+        command_buffer_allocate_info.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = worker_command_pool.command_pool;
+        command_buffer_allocate_info.level              = RHI_COMMAND_BUFFER_LEVEL_SECONDARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        RHICommandBuffer* command_buffer = RHI_NULL_HANDLE;
+        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&command_buffer_allocate_info, command_buffer))
+            throw std::runtime_error("allocate secondary command buffer");
+        worker_command_pool.command_buffers.push_back(command_buffer);
+    }
+    RHICommandBuffer* command_buffer =
+        worker_command_pool.command_buffers[worker_command_pool.used_command_buffer_count++];
+
+    RHICommandBufferInheritanceInfo inheritance_info {};
+    inheritance_info.sType       = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance_info.renderPass  = render_pass;
+    inheritance_info.subpass     = subpass;
+    inheritance_info.framebuffer = framebuffer;
+
+    RHICommandBufferBeginInfo command_buffer_begin_info {};
+    command_buffer_begin_info.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.flags =
+        RHI_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | RHI_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+
+    if (RHI_SUCCESS != m_rhi->beginCommandBufferPFN(command_buffer, &command_buffer_begin_info))
+        throw std::runtime_error("begin secondary command buffer");
+
+    return command_buffer;
+}
+} // namespace Piccolo
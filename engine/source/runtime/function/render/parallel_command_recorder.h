@@ -0,0 +1,55 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Piccolo {
+// records secondary command buffers as jobs on the job system
+// every range index owns one command pool per frame in flight, so no pool is ever touched by two jobs at once
+class ParallelCommandRecorder {
+public:
+    // records the tasks [begin, end) into command_buffer, which has already begun inside the target subpass
+    using RecordFunction = std::function<void(RHICommandBuffer* command_buffer, uint32_t begin, uint32_t end)>;
+
+    // worker_count 0 means one per job system worker plus the calling thread, capped to s_max_worker_count
+    void initialize(std::shared_ptr<RHI> rhi, uint32_t worker_count = 0);
+
+    // recycle the command buffers of the current frame in flight, its fence must have been waited on
+    void prepareFrame();
+
+    uint32_t getWorkerCount() const { return m_worker_count; }
+
+    // split task_count tasks into contiguous ranges of at least min_tasks_per_worker tasks and record the ranges
+    // concurrently, the calling thread records the first one
+    // the returned command buffers keep the task order and are meant for cmdExecuteCommands in the given subpass
+    std::vector<RHICommandBuffer*> record(RHIRenderPass*        render_pass,
+                                          uint32_t              subpass,
+                                          RHIFramebuffer*       framebuffer,
+                                          uint32_t              task_count,
+                                          uint32_t              min_tasks_per_worker,
+                                          const RecordFunction &record_function);
+
+    static constexpr uint32_t s_max_worker_count = 8;
+
+private:
+    struct WorkerCommandPool {
+        RHICommandPool*                command_pool {nullptr};
+        std::vector<RHICommandBuffer*> command_buffers;
+        uint32_t                       used_command_buffer_count {0};
+    };
+
+    RHICommandBuffer* beginCommandBuffer(WorkerCommandPool &worker_command_pool,
+                                         RHIRenderPass*     render_pass,
+                                         uint32_t           subpass,
+                                         RHIFramebuffer*    framebuffer);
+
+    std::shared_ptr<RHI> m_rhi;
+    uint32_t             m_worker_count {1};
+
+    // [frame in flight][worker]
+    std::vector<std::vector<WorkerCommandPool>> m_worker_command_pools;
+};
+} // namespace Piccolo
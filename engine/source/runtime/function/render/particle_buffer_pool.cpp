@@ -0,0 +1,124 @@
+#include "runtime/function/render/particle_buffer_pool.h"
+
+#include "runtime/function/render/render_helper.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+
+namespace Piccolo {
+void ParticleBufferPool::initialize(std::shared_ptr<RHI> rhi, RHIDeviceSize particle_size, uint32_t block_capacity) {
+    m_rhi            = rhi;
+    m_particle_size  = particle_size;
+    m_block_capacity = roundUp(block_capacity, s_allocation_granularity);
+}
+
+void ParticleBufferPool::destroy() {
+    for (Block &block : m_blocks) {
+        ASSERT(block.free_ranges.size() == 1 && block.free_ranges[0].count == block.capacity);
+        for (uint8_t stream = 0; stream < _particle_stream_count; ++stream) {
+            m_rhi->destroyBuffer(block.buffers[stream]);
+            m_rhi->freeMemory(block.memories[stream]);
+        }
+    }
+    m_blocks.clear();
+}
+
+ParticleBufferPool::Allocation ParticleBufferPool::allocate(uint32_t capacity) {
+    Allocation allocation;
+    capacity = roundUp(std::max(capacity, 1u), s_allocation_granularity);
+
+    // first fit over the existing blocks
+    for (uint32_t block_index = 0; block_index < m_blocks.size(); ++block_index) {
+        if (allocateFromBlock(block_index, capacity, allocation))
+            return allocation;
+    }
+
+    createBlock(std::max(capacity, m_block_capacity));
+    allocateFromBlock(static_cast<uint32_t>(m_blocks.size() - 1), capacity, allocation);
+    return allocation;
+}
+
+void ParticleBufferPool::free(Allocation &allocation) {
+    if (!allocation.isValid())
+        return;
+
+    std::vector<Range> &free_ranges = m_blocks[allocation.block].free_ranges;
+    auto next = std::lower_bound(free_ranges.begin(), free_ranges.end(), allocation.first,
+                                 [](const Range &range, uint32_t first) { return range.first < first; });
+    next = free_ranges.insert(next, Range {allocation.first, allocation.capacity});
+
+    // merge with the following range, then with the preceding one
+    if (next + 1 != free_ranges.end() && next->first + next->count == (next + 1)->first) {
+        next->count += (next + 1)->count;
+        free_ranges.erase(next + 1);
+    }
+    if (next != free_ranges.begin() && (next - 1)->first + (next - 1)->count == next->first) {
+        (next - 1)->count += next->count;
+        free_ranges.erase(next);
+    }
+
+    allocation = Allocation {};
+}
+
+RHIBuffer* ParticleBufferPool::getBuffer(const Allocation &allocation, Stream stream) const {
+    return m_blocks[allocation.block].buffers[stream];
+}
+
+RHIDescriptorBufferInfo ParticleBufferPool::getDescriptorBufferInfo(const Allocation &allocation, Stream stream) const {
+    RHIDeviceSize stride = getStride(stream);
+    return {m_blocks[allocation.block].buffers[stream], allocation.first * stride, allocation.capacity * stride};
+}
+
+RHIDeviceSize ParticleBufferPool::getReservedSize() const {
+    RHIDeviceSize size = 0;
+    for (const Block &block : m_blocks) {
+        for (uint8_t stream = 0; stream < _particle_stream_count; ++stream)
+            size += block.capacity * getStride(static_cast<Stream>(stream));
+    }
+    return size;
+}
+
+RHIDeviceSize ParticleBufferPool::getStride(Stream stream) const {
+    return stream <= _particle_stream_render ? m_particle_size : 4 * sizeof(int32_t);
+}
+
+void ParticleBufferPool::createBlock(uint32_t capacity) {
+    Block block;
+    block.capacity = capacity;
+    block.free_ranges.push_back(Range {0, capacity});
+
+    for (uint8_t stream = 0; stream < _particle_stream_count; ++stream) {
+        // the dead list is zero-filled on allocation
+        m_rhi->createBuffer(capacity * getStride(static_cast<Stream>(stream)),
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            block.buffers[stream],
+                            block.memories[stream]);
+    }
+    m_blocks.push_back(block);
+
+    LOG_INFO("particle buffer pool: new block of {} particles, {} MB reserved",
+             capacity,
+             getReservedSize() / (1024 * 1024));
+}
+
+bool ParticleBufferPool::allocateFromBlock(uint32_t block_index, uint32_t capacity, Allocation &allocation) {
+    std::vector<Range> &free_ranges = m_blocks[block_index].free_ranges;
+    for (auto range = free_ranges.begin(); range != free_ranges.end(); ++range) {
+        if (range->count < capacity)
+            continue;
+
+        allocation.block    = block_index;
+        allocation.first    = range->first;
+        allocation.capacity = capacity;
+
+        range->first += capacity;
+        range->count -= capacity;
+        if (range->count == 0)
+            free_ranges.erase(range);
+        return true;
+    }
+    return false;
+}
+} // namespace Piccolo
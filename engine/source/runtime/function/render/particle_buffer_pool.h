@@ -0,0 +1,71 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <memory>
+#include <vector>
+
+namespace Piccolo {
+// particle data and index lists of all emitters are sub-allocated from a few shared blocks
+// ranges released by dead emitters are merged back and reused by later emitters
+class ParticleBufferPool {
+public:
+    enum Stream : uint8_t {
+        _particle_stream_simulate = 0, // Particle, indexed by particle id
+        _particle_stream_render,       // Particle, compacted alive particles read by the billboard
+        _particle_stream_alive_list,   // ivec4
+        _particle_stream_alive_list_next,
+        _particle_stream_dead_list,
+        _particle_stream_count
+    };
+
+    struct Allocation {
+        uint32_t block {UINT32_MAX};
+        uint32_t first {0};
+        uint32_t capacity {0};
+
+        bool isValid() const { return block != UINT32_MAX; }
+    };
+
+    // block_capacity is in particles, blocks are created lazily
+    void initialize(std::shared_ptr<RHI> rhi, RHIDeviceSize particle_size, uint32_t block_capacity);
+    // releases the device memory of all blocks, every allocation must have been freed and the GPU must be done with them
+    // the pool stays usable, blocks are created again on the next allocate
+    void destroy();
+
+    // capacity is rounded up to s_allocation_granularity, a request larger than block_capacity gets its own block
+    Allocation allocate(uint32_t capacity);
+    void       free(Allocation &allocation);
+
+    RHIBuffer*              getBuffer(const Allocation &allocation, Stream stream) const;
+    RHIDescriptorBufferInfo getDescriptorBufferInfo(const Allocation &allocation, Stream stream) const;
+
+    // device memory held by all blocks, used or not
+    RHIDeviceSize getReservedSize() const;
+
+    // 16 particles * 16 byte ivec4 = 256 byte, the largest minStorageBufferOffsetAlignment Vulkan allows
+    static constexpr uint32_t s_allocation_granularity = 16;
+
+private:
+    struct Range {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct Block {
+        RHIBuffer*         buffers[_particle_stream_count] {};
+        RHIDeviceMemory*   memories[_particle_stream_count] {};
+        uint32_t           capacity {0};
+        std::vector<Range> free_ranges; // sorted by first, adjacent ranges are always merged
+    };
+
+    RHIDeviceSize getStride(Stream stream) const;
+    void          createBlock(uint32_t capacity);
+    bool          allocateFromBlock(uint32_t block_index, uint32_t capacity, Allocation &allocation);
+
+    std::shared_ptr<RHI> m_rhi;
+    RHIDeviceSize        m_particle_size {0};
+    uint32_t             m_block_capacity {0};
+    std::vector<Block>   m_blocks;
+};
+} // namespace Piccolo
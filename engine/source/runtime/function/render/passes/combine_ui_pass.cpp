@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/combine_ui_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
@@ -174,7 +176,7 @@ void CombineUIPass::setupPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline))
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline))
         throw std::runtime_error("create post process graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -235,6 +237,8 @@ void CombineUIPass::updateAfterFramebufferRecreate(RHIImageView* scene_input_att
 }
 
 void CombineUIPass::draw() {
+    PROFILE_SCOPE("CombineUIPass::draw");
+
     RHIViewport viewport = {0.0, 0.0,
                             static_cast<float>(m_rhi->getSwapchainInfo().extent.width),
                             static_cast<float>(m_rhi->getSwapchainInfo().extent.height),
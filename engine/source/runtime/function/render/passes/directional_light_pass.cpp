@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/directional_light_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
@@ -336,7 +338,7 @@ void DirectionalLightShadowPass::setupPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline))
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline))
         throw std::runtime_error("create mesh directional light shadow graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -431,8 +433,13 @@ void DirectionalLightShadowPass::setupDescriptorSet() {
                                 descriptor_writes,
                                 0,
                                 NULL);
+
+    for (uint32_t i = 0; i < (sizeof(descriptor_writes) / sizeof(descriptor_writes[0])); ++i)
+        registerRingBufferBinding(descriptor_set_to_write, descriptor_writes[i].dstBinding, descriptor_writes[i].pBufferInfo->range);
 }
 void DirectionalLightShadowPass::drawModel() {
+    PROFILE_SCOPE("DirectionalLightShadowPass::drawModel");
+
     struct MeshNode {
         const Matrix4x4* model_matrix {nullptr};
         const Matrix4x4* joint_matrices {nullptr};
@@ -488,26 +495,10 @@ void DirectionalLightShadowPass::drawModel() {
         m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
 
         // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-        m_global_render_resource->_storage_buffer
-        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-        assert(m_global_render_resource->_storage_buffer
-               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-               (m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-        MeshDirectionalLightShadowPerframeStorageBufferObject &perframe_storage_buffer_object =
-            (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
-                 reinterpret_cast<uintptr_t>(
-                     m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                 perframe_dynamic_offset));
-        perframe_storage_buffer_object = m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        auto perframe_allocation = allocateRingBufferSpace<MeshDirectionalLightShadowPerframeStorageBufferObject>();
+        if (perframe_allocation.data_ptr)
+            *perframe_allocation.data_ptr = m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
         for (auto& [material, mesh_instanced] : directional_light_mesh_drawcall_batch) {
             // TODO: render from near to far
@@ -544,27 +535,14 @@ void DirectionalLightShadowPass::drawModel() {
                             drawcall_max_instance_count;
 
                         // perdrawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                            perdrawcall_dynamic_offset +
-                            sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                               (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                        MeshDirectionalLightShadowPerdrawcallStorageBufferObject &
-                        perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
-                                 reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                             ._global_upload_ringbuffer_memory_pointer) +
-                                 perdrawcall_dynamic_offset));
+                        auto perdrawcall_allocation =
+                            allocateRingBufferSpace<MeshDirectionalLightShadowPerdrawcallStorageBufferObject>();
+                        if (!perframe_allocation.data_ptr || !perdrawcall_allocation.data_ptr)
+                            continue;
+                        uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+                        MeshDirectionalLightShadowPerdrawcallStorageBufferObject &perdrawcall_storage_buffer_object =
+                            *perdrawcall_allocation.data_ptr;
                         for (uint32_t i = 0; i < current_instance_count; ++i) {
                             perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
                                 *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
@@ -583,28 +561,16 @@ void DirectionalLightShadowPass::drawModel() {
                             }
                         }
                         if (least_one_enable_vertex_blending) {
-                            per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+                            auto per_drawcall_vertex_blending_allocation =
+                                allocateRingBufferSpace<MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject>();
+                            if (!per_drawcall_vertex_blending_allocation.data_ptr)
+                                continue;
+                            per_drawcall_vertex_blending_dynamic_offset =
+                                per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                             MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject &
                             per_drawcall_vertex_blending_storage_buffer_object =
-                                (*reinterpret_cast <
-                                 MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject* > (
-                                     reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                 ._global_upload_ringbuffer_memory_pointer) +
-                                     per_drawcall_vertex_blending_dynamic_offset));
+                                *per_drawcall_vertex_blending_allocation.data_ptr;
                             for (uint32_t i = 0; i < current_instance_count; ++i) {
                                 if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices) {
                                     for (uint32_t j = 0;
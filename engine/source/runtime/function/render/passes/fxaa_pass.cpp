@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/fxaa_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_common.h"
 #include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/render_pass.h"
@@ -176,7 +178,7 @@ void FXAAPass::setupPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo,  m_render_pipelines[0].pipeline))
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo,  m_render_pipelines[0].pipeline))
         throw std::runtime_error("create post process graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -222,6 +224,8 @@ void FXAAPass::updateAfterFramebufferRecreate(RHIImageView* input_attachment) {
 }
 
 void FXAAPass::draw() {
+    PROFILE_SCOPE("FXAAPass::draw");
+
     RHIViewport viewport = {0.0, 0.0,
                             static_cast<float>(m_rhi->getSwapchainInfo().extent.width),
                             static_cast<float>(m_rhi->getSwapchainInfo().extent.height),
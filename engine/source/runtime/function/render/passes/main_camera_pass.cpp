@@ -1,17 +1,23 @@
 #include "runtime/function/render/passes/main_camera_pass.h"
+
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_mesh.h"
 
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
+#include <future>
 #include <stdexcept>
 
 #include <axis_frag.h>
 #include <axis_vert.h>
 #include <deferred_lighting_frag.h>
 #include <deferred_lighting_vert.h>
+#include <mesh_bindless_frag.h>
 #include <mesh_frag.h>
+#include <mesh_gbuffer_bindless_frag.h>
 #include <mesh_gbuffer_frag.h>
 #include <mesh_vert.h>
 #include <skybox_frag.h>
@@ -21,12 +27,18 @@
 // TODO: Cancelable (configurable) subpass
 
 namespace Piccolo {
+// drawcall 太少时多线程录制的开销比收益大，直接录制到 primary command buffer
+static constexpr uint32_t s_parallel_mesh_recording_min_drawcall_count = 128;
+static constexpr uint32_t s_parallel_mesh_recording_min_drawcalls_per_worker = 64;
+
 void MainCameraPass::initialize(const RenderPassInitInfo* init_info) {
     RenderPass::initialize(nullptr);
 
     const MainCameraPassInitInfo* _init_info = static_cast<const MainCameraPassInitInfo*>(init_info);
     m_enable_fxaa                            = _init_info->enable_fxaa;
+    m_enable_dynamic_resolution              = _init_info->enable_dynamic_resolution;
 
+    setupRenderGraph();
     setupAttachments();
     setupRenderPass();
     setupDescriptorSetLayouts();
@@ -36,6 +48,8 @@ void MainCameraPass::initialize(const RenderPassInitInfo* init_info) {
     setupSwapchainFramebuffers();
 
     setupParticlePass();
+
+    m_command_recorder.initialize(m_rhi);
 }
 
 void MainCameraPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource) {
@@ -46,360 +60,170 @@ void MainCameraPass::preparePassData(std::shared_ptr<RenderResourceBase> render_
     }
 }
 
+// 以各 subpass 对 attachment 的读写声明整个 render pass，由 render graph 推导 subpass 依赖、剔除无用的 subpass
+// 并让生命周期不重叠的 attachment 共用 image（如 backup_buffer_a 与 post_process_buffer_even）
+void MainCameraPass::setupRenderGraph() {
+    m_render_graph = RenderGraph();
+
+    RHIClearValue clear_black_transparent {};
+    clear_black_transparent.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+    RHIClearValue clear_black {};
+    clear_black.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    RHIClearValue clear_depth {};
+    clear_depth.depthStencil = {1.0f, 0};
+
+    auto addColorAttachment = [&](const char* name, RHIFormat format, RHIImageUsageFlags usage, const RHIClearValue &clear_value) {
+        RenderGraph::AttachmentDesc desc;
+        desc.name        = name;
+        desc.format      = format;
+        desc.usage       = usage;
+        desc.clear_value = clear_value;
+        return m_render_graph.addAttachment(desc);
+    };
+    const RHIImageUsageFlags transient_usage  = RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    const RHIImageUsageFlags post_process_usage = RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_SAMPLED_BIT;
+
+    // ----- attachments, in the order of the attachment enum -----
+    // gbuffer_a 在 render pass 之后还会被粒子拷贝
+    RenderGraph::AttachmentDesc gbuffer_normal_desc;
+    gbuffer_normal_desc.name        = "gbuffer_a";
+    gbuffer_normal_desc.format      = RHI_FORMAT_R8G8B8A8_UNORM;
+    gbuffer_normal_desc.usage       = RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    gbuffer_normal_desc.clear_value = clear_black_transparent;
+    gbuffer_normal_desc.output      = true;
+    m_render_graph.addAttachment(gbuffer_normal_desc);
+    addColorAttachment("gbuffer_b", RHI_FORMAT_R8G8B8A8_UNORM, transient_usage, clear_black_transparent);
+    addColorAttachment("gbuffer_c", RHI_FORMAT_R8G8B8A8_SRGB, transient_usage, clear_black_transparent);
+    // 开启动态分辨率时 post process 要采样 backup_buffer_a 来放大场景
+    addColorAttachment("backup_buffer_a",
+                       RHI_FORMAT_R16G16B16A16_SFLOAT,
+                       m_enable_dynamic_resolution ? post_process_usage : transient_usage,
+                       clear_black);
+    addColorAttachment("backup_buffer_b", RHI_FORMAT_R16G16B16A16_SFLOAT, transient_usage, clear_black);
+    addColorAttachment("post_process_buffer_odd", RHI_FORMAT_R16G16B16A16_SFLOAT, post_process_usage, clear_black);
+    addColorAttachment("post_process_buffer_even", RHI_FORMAT_R16G16B16A16_SFLOAT, post_process_usage, clear_black);
+
+    // depth 在 render pass 之后还会被粒子拷贝
+    RenderGraph::AttachmentDesc depth_desc;
+    depth_desc.name         = "depth";
+    depth_desc.format       = m_rhi->getDepthImageInfo().depth_image_format;
+    depth_desc.clear_value  = clear_depth;
+    depth_desc.final_layout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depth_desc.external     = true;
+    depth_desc.output       = true;
+    m_render_graph.addAttachment(depth_desc);
+
+    RenderGraph::AttachmentDesc swapchain_image_desc;
+    swapchain_image_desc.name         = "swap_chain_image";
+    swapchain_image_desc.format       = m_rhi->getSwapchainInfo().image_format;
+    swapchain_image_desc.clear_value  = clear_black;
+    swapchain_image_desc.final_layout = RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    swapchain_image_desc.external     = true;
+    swapchain_image_desc.output       = true;
+    m_render_graph.addAttachment(swapchain_image_desc);
+
+    // ----- subpasses, in the order of the subpass enum -----
+    uint32_t post_process_read_buffer = _main_camera_pass_post_process_buffer_even;
+    uint32_t post_process_write_buffer = _main_camera_pass_post_process_buffer_odd;
+    auto flipPostProcessBuffers = [&]() { std::swap(post_process_read_buffer, post_process_write_buffer); };
+
+    uint32_t base_pass = m_render_graph.addSubpass("base pass");
+    m_render_graph.addAccess(base_pass, _main_camera_pass_gbuffer_a, RenderGraph::_attachment_access_color_write); // gbuffer_normal_attachment
+    m_render_graph.addAccess(base_pass, _main_camera_pass_gbuffer_b, RenderGraph::_attachment_access_color_write); // gbuffer_metallic_roughness_shadingmodeid_attachment
+    m_render_graph.addAccess(base_pass, _main_camera_pass_gbuffer_c, RenderGraph::_attachment_access_color_write); // gbuffer_albedo_attachment
+    m_render_graph.addAccess(base_pass, _main_camera_pass_depth, RenderGraph::_attachment_access_depth_read_write);
+
+    // lighting 采样 shadow pass 写入的 shadow map
+    uint32_t deferred_lighting_pass = m_render_graph.addSubpass("deferred lighting");
+    m_render_graph.addAccess(deferred_lighting_pass, _main_camera_pass_gbuffer_a, RenderGraph::_attachment_access_input_read);
+    m_render_graph.addAccess(deferred_lighting_pass, _main_camera_pass_gbuffer_b, RenderGraph::_attachment_access_input_read);
+    m_render_graph.addAccess(deferred_lighting_pass, _main_camera_pass_gbuffer_c, RenderGraph::_attachment_access_input_read);
+    m_render_graph.addAccess(deferred_lighting_pass, _main_camera_pass_depth, RenderGraph::_attachment_access_input_read);
+    m_render_graph.addAccess(deferred_lighting_pass, _main_camera_pass_backup_buffer_a, RenderGraph::_attachment_access_color_write);
+    m_render_graph.addExternalRead(deferred_lighting_pass,
+                                   RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                   RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                   RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                   RHI_ACCESS_SHADER_READ_BIT);
+
+    uint32_t forward_lighting_pass = m_render_graph.addSubpass("forward lighting");
+    m_render_graph.addAccess(forward_lighting_pass, _main_camera_pass_backup_buffer_a, RenderGraph::_attachment_access_color_read_write);
+    m_render_graph.addAccess(forward_lighting_pass, _main_camera_pass_depth, RenderGraph::_attachment_access_depth_read_write);
+    m_render_graph.addExternalRead(forward_lighting_pass,
+                                   RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                   RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                   RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                   RHI_ACCESS_SHADER_READ_BIT);
+
+    // 逐像素的后处理合并为一个 subpass，只读写一次全屏 attachment
+    uint32_t post_process_pass = m_render_graph.addSubpass("post process");
+    m_render_graph.addAccess(post_process_pass, _main_camera_pass_backup_buffer_a, RenderGraph::_attachment_access_input_read);
+    m_render_graph.addAccess(post_process_pass, post_process_write_buffer, RenderGraph::_attachment_access_color_write); // post_odd
+    flipPostProcessBuffers();
+
+    // 不开启 fxaa 时，它的结果会被 ui pass 直接覆盖，因此被剔除
+    uint32_t fxaa_pass = m_render_graph.addSubpass("fxaa");
+    m_render_graph.addAccess(fxaa_pass, post_process_read_buffer, RenderGraph::_attachment_access_input_read);   // post_odd
+    m_render_graph.addAccess(fxaa_pass, post_process_write_buffer, RenderGraph::_attachment_access_color_write); // post_even
+    if (m_enable_fxaa)
+        flipPostProcessBuffers();
+
+    // ui pass 先 clear 整个 attachment 再绘制
+    uint32_t ui_pass = m_render_graph.addSubpass("ui");
+    m_render_graph.addAccess(ui_pass, post_process_write_buffer, RenderGraph::_attachment_access_color_write); // post_odd if enable fxaa
+
+    uint32_t combine_ui_pass = m_render_graph.addSubpass("combine ui");
+    m_render_graph.addAccess(combine_ui_pass, post_process_read_buffer, RenderGraph::_attachment_access_input_read);   // post_even if enable fxaa
+    m_render_graph.addAccess(combine_ui_pass, post_process_write_buffer, RenderGraph::_attachment_access_input_read);  // post_odd if enable fxaa (no write actually)
+    m_render_graph.addAccess(combine_ui_pass, _main_camera_pass_swap_chain_image, RenderGraph::_attachment_access_color_write);
+
+    m_render_graph.compile();
+}
+
 void MainCameraPass::setupAttachments() {
     m_framebuffer.attachments.resize(_main_camera_pass_custom_attachment_count +
                                      _main_camera_pass_post_process_attachment_count);
 
-    m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format          = RHI_FORMAT_R8G8B8A8_UNORM;
-    m_framebuffer.attachments[_main_camera_pass_gbuffer_b].format          = RHI_FORMAT_R8G8B8A8_UNORM;
-    m_framebuffer.attachments[_main_camera_pass_gbuffer_c].format          = RHI_FORMAT_R8G8B8A8_SRGB;
-    m_framebuffer.attachments[_main_camera_pass_backup_buffer_a].format  = RHI_FORMAT_R16G16B16A16_SFLOAT;
-    m_framebuffer.attachments[_main_camera_pass_backup_buffer_b].format = RHI_FORMAT_R16G16B16A16_SFLOAT;
-
-    for (int buffer_index = 0; buffer_index < _main_camera_pass_custom_attachment_count; ++buffer_index) {
-        if (buffer_index == _main_camera_pass_gbuffer_a) {
-            m_rhi->createImage(m_rhi->getSwapchainInfo().extent.width,
-                               m_rhi->getSwapchainInfo().extent.height,
-                               m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format,
-                               RHI_IMAGE_TILING_OPTIMAL,
-                               RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSFER_SRC_BIT,
-                               RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                               m_framebuffer.attachments[_main_camera_pass_gbuffer_a].image,
-                               m_framebuffer.attachments[_main_camera_pass_gbuffer_a].mem,
-                               0,
-                               1,
-                               1);
-        } else {
-            m_rhi->createImage(m_rhi->getSwapchainInfo().extent.width,
-                               m_rhi->getSwapchainInfo().extent.height,
-                               m_framebuffer.attachments[buffer_index].format,
-                               RHI_IMAGE_TILING_OPTIMAL,
-                               RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-                               RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                               m_framebuffer.attachments[buffer_index].image,
-                               m_framebuffer.attachments[buffer_index].mem,
-                               0,
-                               1,
-                               1);
+    // 共用 image 的 attachment 只由 owner 创建一次，被剔除的 attachment 不分配
+    for (uint32_t attachment_index = 0; attachment_index < m_framebuffer.attachments.size(); ++attachment_index) {
+        FrameBufferAttachment &attachment = m_framebuffer.attachments[attachment_index];
+        attachment.format = m_render_graph.getAttachmentDesc(attachment_index).format;
+        if (m_render_graph.isAttachmentCulled(attachment_index)) {
+            attachment.image = nullptr;
+            attachment.mem   = nullptr;
+            attachment.view  = nullptr;
+            continue;
+        }
+
+        uint32_t owner = m_render_graph.getAttachmentOwner(attachment_index);
+        if (owner != attachment_index) {
+            attachment = m_framebuffer.attachments[owner];
+            continue;
         }
-        m_rhi->createImageView(m_framebuffer.attachments[buffer_index].image,
-                               m_framebuffer.attachments[buffer_index].format,
-                               RHI_IMAGE_ASPECT_COLOR_BIT,
-                               RHI_IMAGE_VIEW_TYPE_2D,
-                               1,
-                               1,
-                               m_framebuffer.attachments[buffer_index].view);
-    }
 
-    m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].format  = RHI_FORMAT_R16G16B16A16_SFLOAT;
-    m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].format = RHI_FORMAT_R16G16B16A16_SFLOAT;
-    for (int attachment_index = _main_camera_pass_custom_attachment_count;
-         attachment_index <
-         _main_camera_pass_custom_attachment_count + _main_camera_pass_post_process_attachment_count;
-         ++attachment_index) {
         m_rhi->createImage(m_rhi->getSwapchainInfo().extent.width,
                            m_rhi->getSwapchainInfo().extent.height,
-                           m_framebuffer.attachments[attachment_index].format,
+                           attachment.format,
                            RHI_IMAGE_TILING_OPTIMAL,
-                           RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | RHI_IMAGE_USAGE_SAMPLED_BIT,
+                           m_render_graph.getAttachmentImageUsage(attachment_index),
                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                           m_framebuffer.attachments[attachment_index].image,
-                           m_framebuffer.attachments[attachment_index].mem,
+                           attachment.image,
+                           attachment.mem,
                            0,
                            1,
                            1);
-        m_rhi->createImageView(m_framebuffer.attachments[attachment_index].image,
-                               m_framebuffer.attachments[attachment_index].format,
+        m_rhi->createImageView(attachment.image,
+                               attachment.format,
                                RHI_IMAGE_ASPECT_COLOR_BIT,
                                RHI_IMAGE_VIEW_TYPE_2D,
                                1,
                                1,
-                               m_framebuffer.attachments[attachment_index].view);
+                               attachment.view);
     }
 }
 
 void MainCameraPass::setupRenderPass() {
-    // ----- setupRenderPassAttachments -----
-    std::vector<RHIAttachmentDescription> attachments(_main_camera_pass_attachment_count);
-    auto setupAttachmentsCommon = [](RHIAttachmentDescription& attachment_descriptor) {
-        attachment_descriptor.samples        = RHI_SAMPLE_COUNT_1_BIT;
-        attachment_descriptor.loadOp         = RHI_ATTACHMENT_LOAD_OP_CLEAR;
-        attachment_descriptor.storeOp        = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachment_descriptor.stencilLoadOp  = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
-        attachment_descriptor.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-        attachment_descriptor.initialLayout  = RHI_IMAGE_LAYOUT_UNDEFINED;
-        attachment_descriptor.finalLayout    = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    };
-    RHIAttachmentDescription &gbuffer_normal_attachment_description = attachments[_main_camera_pass_gbuffer_a];
-    setupAttachmentsCommon(gbuffer_normal_attachment_description);
-    gbuffer_normal_attachment_description.format  = m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format;
-    gbuffer_normal_attachment_description.storeOp = RHI_ATTACHMENT_STORE_OP_STORE;
-
-    RHIAttachmentDescription &gbuffer_metallic_roughness_shadingmodeid_attachment_description = attachments[_main_camera_pass_gbuffer_b];
-    setupAttachmentsCommon(gbuffer_metallic_roughness_shadingmodeid_attachment_description);
-    gbuffer_metallic_roughness_shadingmodeid_attachment_description.format = m_framebuffer.attachments[_main_camera_pass_gbuffer_b].format;
-
-    RHIAttachmentDescription &gbuffer_albedo_attachment_description = attachments[_main_camera_pass_gbuffer_c];
-    setupAttachmentsCommon(gbuffer_albedo_attachment_description);
-    gbuffer_albedo_attachment_description.format      = m_framebuffer.attachments[_main_camera_pass_gbuffer_c].format;
-    gbuffer_albedo_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    RHIAttachmentDescription &backup_a_color_attachment_description = attachments[_main_camera_pass_backup_buffer_a];
-    setupAttachmentsCommon(backup_a_color_attachment_description);
-    backup_a_color_attachment_description.format      = m_framebuffer.attachments[_main_camera_pass_backup_buffer_a].format;
-    backup_a_color_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    RHIAttachmentDescription &backup_even_color_attachment_description = attachments[_main_camera_pass_backup_buffer_b];
-    setupAttachmentsCommon(backup_even_color_attachment_description);
-    backup_even_color_attachment_description.format = m_framebuffer.attachments[_main_camera_pass_backup_buffer_b].format;
-
-    RHIAttachmentDescription &post_process_odd_color_attachment_description = attachments[_main_camera_pass_post_process_buffer_odd];
-    setupAttachmentsCommon(post_process_odd_color_attachment_description);
-    post_process_odd_color_attachment_description.format = m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].format;
-
-    RHIAttachmentDescription &post_process_even_color_attachment_description = attachments[_main_camera_pass_post_process_buffer_even];
-    setupAttachmentsCommon(post_process_even_color_attachment_description);
-    post_process_even_color_attachment_description.format = m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].format;
-
-    RHIAttachmentDescription &depth_attachment_description = attachments[_main_camera_pass_depth];
-    setupAttachmentsCommon(depth_attachment_description);
-    depth_attachment_description.format      = m_rhi->getDepthImageInfo().depth_image_format;
-    depth_attachment_description.storeOp     = RHI_ATTACHMENT_STORE_OP_STORE;
-    depth_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    RHIAttachmentDescription &swapchain_image_attachment_description = attachments[_main_camera_pass_swap_chain_image];
-    setupAttachmentsCommon(swapchain_image_attachment_description);
-    swapchain_image_attachment_description.format      = m_rhi->getSwapchainInfo().image_format;
-    swapchain_image_attachment_description.storeOp     = RHI_ATTACHMENT_STORE_OP_STORE;
-    swapchain_image_attachment_description.finalLayout = RHI_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    // ----- setupRenderPassSubpasses -----
-    uint32_t post_process_read_buffer = _main_camera_pass_post_process_buffer_even;
-    uint32_t post_process_write_buffer = _main_camera_pass_post_process_buffer_odd;
-    auto flipPostProcessBuffers = [&]() { std::swap(post_process_read_buffer, post_process_write_buffer); };
-    auto setupSubPass = [](RHISubpassDescription &subpass,
-                         const std::vector<RHIAttachmentReference>* input_attachments,
-                         const std::vector<RHIAttachmentReference>* color_attachments,
-                         const std::vector<RHIAttachmentReference>* depth_stencil_attachment,
-                         const std::vector<uint32_t>* preserve_attachments) {
-        subpass.pipelineBindPoint           = RHI_PIPELINE_BIND_POINT_GRAPHICS;
-        if (input_attachments) {
-            subpass.inputAttachmentCount    = input_attachments->size();
-            subpass.pInputAttachments       = input_attachments->data();
-        } else {
-            subpass.inputAttachmentCount    = 0;
-            subpass.pInputAttachments       = nullptr;
-        }
-        if (color_attachments) {
-            subpass.colorAttachmentCount    = color_attachments->size();
-            subpass.pColorAttachments       = color_attachments->data();
-        } else {
-            subpass.colorAttachmentCount    = 0;
-            subpass.pColorAttachments       = nullptr;
-        }
-        if (depth_stencil_attachment) {
-            subpass.pDepthStencilAttachment = depth_stencil_attachment->data();
-        } else {
-            subpass.pDepthStencilAttachment = nullptr;
-        }
-        if (preserve_attachments) {
-            subpass.preserveAttachmentCount = preserve_attachments->size();
-            subpass.pPreserveAttachments    = preserve_attachments->data();
-        } else {
-            subpass.preserveAttachmentCount = 0;
-            subpass.pPreserveAttachments    = nullptr;
-        }
-    };
-
-    std::vector<RHISubpassDescription> subpasses(_main_camera_subpass_count);
-    std::vector<RHIAttachmentReference> base_pass_color_attachments_reference {
-        {_main_camera_pass_gbuffer_a, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}, // gbuffer_normal_attachment
-        {_main_camera_pass_gbuffer_b, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}, // gbuffer_metallic_roughness_shadingmodeid_attachment
-        {_main_camera_pass_gbuffer_c, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}  // gbuffer_albedo_attachment
-    };
-    std::vector<RHIAttachmentReference> base_pass_depth_attachment_reference {
-        {_main_camera_pass_depth, RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL} // depth_attachment_description
-    };
-    setupSubPass(subpasses[_main_camera_subpass_basepass],
-                 nullptr,
-                 &base_pass_color_attachments_reference,
-                 &base_pass_depth_attachment_reference,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> deferred_lighting_pass_input_attachments_reference {
-        {_main_camera_pass_gbuffer_a, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, // gbuffer_normal_attachment
-        {_main_camera_pass_gbuffer_b, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, // gbuffer_metallic_roughness_shadingmodeid_attachment
-        {_main_camera_pass_gbuffer_c, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, // gbuffer_albedo_attachment
-        {_main_camera_pass_depth, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}      // depth_attachment
-    };
-    std::vector<RHIAttachmentReference> deferred_lighting_pass_color_attachment_reference {
-        {_main_camera_pass_backup_buffer_a, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // backup_a_color_attachment
-    };
-    setupSubPass(subpasses[_main_camera_subpass_deferred_lighting],
-                 &deferred_lighting_pass_input_attachments_reference,
-                 &deferred_lighting_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> forward_lighting_pass_color_attachments_reference {
-        {_main_camera_pass_backup_buffer_a, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // backup_a_color_attachment
-    };
-    std::vector<RHIAttachmentReference> forward_lighting_pass_depth_attachment_reference {
-        {_main_camera_pass_depth, RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL} // depth_attachment
-    };
-    setupSubPass(subpasses[_main_camera_subpass_forward_lighting],
-                 nullptr,
-                 &forward_lighting_pass_color_attachments_reference,
-                 &forward_lighting_pass_depth_attachment_reference,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> tone_mapping_pass_input_attachment_reference {
-        {_main_camera_pass_backup_buffer_a, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL} // backup_a_color_attachment
-    };
-    std::vector<RHIAttachmentReference> tone_mapping_pass_color_attachment_reference {
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // post_odd
-    };
-    flipPostProcessBuffers();
-    setupSubPass(subpasses[_main_camera_subpass_tone_mapping],
-                 &tone_mapping_pass_input_attachment_reference,
-                 &tone_mapping_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> color_grading_pass_input_attachment_reference {
-        {post_process_read_buffer, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}  // post_odd
-    };
-    std::vector<RHIAttachmentReference> color_grading_pass_color_attachment_reference {
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // post_even
-    };
-    flipPostProcessBuffers();
-    setupSubPass(subpasses[_main_camera_subpass_color_grading],
-                 &color_grading_pass_input_attachment_reference,
-                 &color_grading_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> vignette_pass_input_attachment_reference {
-        {post_process_read_buffer, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}  // post_even
-    };
-    std::vector<RHIAttachmentReference> vignette_pass_color_attachment_reference {
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // post_odd
-    };
-    flipPostProcessBuffers();
-    setupSubPass(subpasses[_main_camera_subpass_vignette],
-                 &vignette_pass_input_attachment_reference,
-                 &vignette_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> fxaa_pass_input_attachment_reference {
-        {post_process_read_buffer, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}  // post_odd
-    };
-    std::vector<RHIAttachmentReference> fxaa_pass_color_attachment_reference {
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // post_even
-    };
-    if (m_enable_fxaa)
-        flipPostProcessBuffers();
-    setupSubPass(subpasses[_main_camera_subpass_fxaa],
-                 &fxaa_pass_input_attachment_reference,
-                 &fxaa_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    std::vector<RHIAttachmentReference> ui_pass_color_attachment_reference {
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // post_odd if enable fxaa
-    };
-    std::vector<uint32_t> ui_pass_preserve_attachment_reference {
-        {post_process_read_buffer} // preserve post_even if enable fxaa
-    };
-    setupSubPass(subpasses[_main_camera_subpass_ui],
-                 nullptr,
-                 &ui_pass_color_attachment_reference,
-                 nullptr,
-                 &ui_pass_preserve_attachment_reference);
-
-    std::vector<RHIAttachmentReference> combine_ui_pass_input_attachments_reference {
-        {post_process_read_buffer, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL}, // post_even if enable fxaa
-        {post_process_write_buffer, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL} // post_odd if enable fxaa (no write actually)
-    };
-    std::vector<RHIAttachmentReference> combine_ui_pass_color_attachment_reference {
-        {_main_camera_pass_swap_chain_image, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL} // swapchain_image_attachment_description
-    };
-    setupSubPass(subpasses[_main_camera_subpass_combine_ui],
-                 &combine_ui_pass_input_attachments_reference,
-                 &combine_ui_pass_color_attachment_reference,
-                 nullptr,
-                 nullptr);
-
-    // ----- setupRenderPassDependencies -----
-    std::vector<RHISubpassDependency> dependencies(9);
-    auto setCommonMaskAndFlags = [](RHISubpassDependency &dependency) {
-        dependency.srcStageMask = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstStageMask = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        dependency.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        dependency.dependencyFlags = RHI_DEPENDENCY_BY_REGION_BIT;
-    };
-
-    RHISubpassDependency &deferred_lighting_pass_depend_on_shadow_map_pass = dependencies[0];
-    deferred_lighting_pass_depend_on_shadow_map_pass.srcSubpass      = RHI_SUBPASS_EXTERNAL;
-    deferred_lighting_pass_depend_on_shadow_map_pass.dstSubpass      = _main_camera_subpass_deferred_lighting;
-    deferred_lighting_pass_depend_on_shadow_map_pass.srcStageMask    = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    deferred_lighting_pass_depend_on_shadow_map_pass.dstStageMask    = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    deferred_lighting_pass_depend_on_shadow_map_pass.srcAccessMask   = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    deferred_lighting_pass_depend_on_shadow_map_pass.dstAccessMask   = RHI_ACCESS_SHADER_READ_BIT;
-    deferred_lighting_pass_depend_on_shadow_map_pass.dependencyFlags = 0; // NOT BY REGION
-
-    RHISubpassDependency &deferred_lighting_pass_depend_on_base_pass = dependencies[1];
-    deferred_lighting_pass_depend_on_base_pass.srcSubpass = _main_camera_subpass_basepass;
-    deferred_lighting_pass_depend_on_base_pass.dstSubpass = _main_camera_subpass_deferred_lighting;
-    setCommonMaskAndFlags(deferred_lighting_pass_depend_on_base_pass);
-
-    RHISubpassDependency &forward_lighting_pass_depend_on_deferred_lighting_pass = dependencies[2];
-    forward_lighting_pass_depend_on_deferred_lighting_pass.srcSubpass = _main_camera_subpass_deferred_lighting;
-    forward_lighting_pass_depend_on_deferred_lighting_pass.dstSubpass = _main_camera_subpass_forward_lighting;
-    setCommonMaskAndFlags(forward_lighting_pass_depend_on_deferred_lighting_pass);
-
-    RHISubpassDependency &tone_mapping_pass_depend_on_lighting_pass = dependencies[3];
-    tone_mapping_pass_depend_on_lighting_pass.srcSubpass = _main_camera_subpass_forward_lighting;
-    tone_mapping_pass_depend_on_lighting_pass.dstSubpass = _main_camera_subpass_tone_mapping;
-    setCommonMaskAndFlags(tone_mapping_pass_depend_on_lighting_pass);
-
-    RHISubpassDependency &color_grading_pass_depend_on_tone_mapping_pass = dependencies[4];
-    color_grading_pass_depend_on_tone_mapping_pass.srcSubpass = _main_camera_subpass_tone_mapping;
-    color_grading_pass_depend_on_tone_mapping_pass.dstSubpass = _main_camera_subpass_color_grading;
-    setCommonMaskAndFlags(color_grading_pass_depend_on_tone_mapping_pass);
-
-    RHISubpassDependency &vignette_pass_depend_on_color_grading_pass = dependencies[5];
-    vignette_pass_depend_on_color_grading_pass.srcSubpass = _main_camera_subpass_color_grading;
-    vignette_pass_depend_on_color_grading_pass.dstSubpass = _main_camera_subpass_vignette;
-    setCommonMaskAndFlags(vignette_pass_depend_on_color_grading_pass);
-
-    RHISubpassDependency &fxaa_pass_depend_on_vignette_pass = dependencies[6];
-    fxaa_pass_depend_on_vignette_pass.srcSubpass = _main_camera_subpass_vignette;
-    fxaa_pass_depend_on_vignette_pass.dstSubpass = _main_camera_subpass_fxaa;
-    setCommonMaskAndFlags(fxaa_pass_depend_on_vignette_pass);
-
-    RHISubpassDependency &ui_pass_depend_on_fxaa_pass = dependencies[7];
-    ui_pass_depend_on_fxaa_pass.srcSubpass = _main_camera_subpass_fxaa;
-    ui_pass_depend_on_fxaa_pass.dstSubpass = _main_camera_subpass_ui;
-    setCommonMaskAndFlags(ui_pass_depend_on_fxaa_pass);
-
-    RHISubpassDependency &combine_ui_pass_depend_on_ui_pass = dependencies[8];
-    combine_ui_pass_depend_on_ui_pass.srcSubpass = _main_camera_subpass_ui;
-    combine_ui_pass_depend_on_ui_pass.dstSubpass = _main_camera_subpass_combine_ui;
-    setCommonMaskAndFlags(combine_ui_pass_depend_on_ui_pass);
-
-    RHIRenderPassCreateInfo renderpass_create_info {};
-    renderpass_create_info.sType           = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderpass_create_info.attachmentCount = attachments.size();
-    renderpass_create_info.pAttachments    = attachments.data();
-    renderpass_create_info.subpassCount    = subpasses.size();
-    renderpass_create_info.pSubpasses      = subpasses.data();
-    renderpass_create_info.dependencyCount = dependencies.size();
-    renderpass_create_info.pDependencies   = dependencies.data();
-
-    if (m_rhi->createRenderPass(&renderpass_create_info, m_framebuffer.render_pass) != RHI_SUCCESS)
+    if (!m_render_graph.createRenderPass(m_rhi.get(), m_framebuffer.render_pass))
         throw std::runtime_error("failed to create render pass");
 }
 
@@ -478,6 +302,11 @@ void MainCameraPass::setupMeshGlobalDescriptorSetLayout() {
 
 // Mesh Per Material Layout
 void MainCameraPass::setupMeshPerMaterialDescriptorSetLayout() {
+    if (m_rhi->isBindlessMaterialEnabled()) {
+        setupBindlessMaterialDescriptorSetLayout();
+        return;
+    }
+
     std::vector<RHIDescriptorSetLayoutBinding> mesh_material_layout_bindings(6);
     // mesh_material_layout_uniform_buffer_binding
     mesh_material_layout_bindings[0].binding            = 0; // (set = 2, binding = 0 in fragment shader)
@@ -513,6 +342,44 @@ void MainCameraPass::setupMeshPerMaterialDescriptorSetLayout() {
         throw std::runtime_error("create mesh material layout");
 }
 
+// one set for all materials: binding 0 the material parameters, binding 1 every material texture
+void MainCameraPass::setupBindlessMaterialDescriptorSetLayout() {
+    RHIDescriptorSetLayoutBinding bindless_material_layout_bindings[2];
+    bindless_material_layout_bindings[0].binding            = 0; // (set = 2, binding = 0 in fragment shader)
+    bindless_material_layout_bindings[0].descriptorType     = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindless_material_layout_bindings[0].descriptorCount    = 1;
+    bindless_material_layout_bindings[0].stageFlags         = RHI_SHADER_STAGE_FRAGMENT_BIT;
+    bindless_material_layout_bindings[0].pImmutableSamplers = nullptr;
+
+    bindless_material_layout_bindings[1].binding            = 1; // (set = 2, binding = 1 in fragment shader)
+    bindless_material_layout_bindings[1].descriptorType     = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindless_material_layout_bindings[1].descriptorCount    = m_rhi->getMaxBindlessTextureCount();
+    bindless_material_layout_bindings[1].stageFlags         = RHI_SHADER_STAGE_FRAGMENT_BIT;
+    bindless_material_layout_bindings[1].pImmutableSamplers = nullptr;
+
+    // textures of newly loaded materials are written while earlier frames are still in flight
+    RHIDescriptorBindingFlags binding_flags[2] = {
+        0,
+        RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT};
+
+    RHIDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info;
+    binding_flags_create_info.sType         = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    binding_flags_create_info.pNext         = NULL;
+    binding_flags_create_info.bindingCount  = sizeof(binding_flags) / sizeof(binding_flags[0]);
+    binding_flags_create_info.pBindingFlags = binding_flags;
+
+    RHIDescriptorSetLayoutCreateInfo bindless_material_layout_create_info;
+    bindless_material_layout_create_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    bindless_material_layout_create_info.pNext        = &binding_flags_create_info;
+    bindless_material_layout_create_info.flags        = RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    bindless_material_layout_create_info.bindingCount = sizeof(bindless_material_layout_bindings) / sizeof(bindless_material_layout_bindings[0]);
+    bindless_material_layout_create_info.pBindings    = bindless_material_layout_bindings;
+
+    if (m_rhi->createDescriptorSetLayout(&bindless_material_layout_create_info, m_descriptor_infos[_mesh_per_material].layout) != RHI_SUCCESS)
+        throw std::runtime_error("create bindless material layout");
+}
+
 // skybox layout
 void MainCameraPass::setupSkyboxDescriptorSetLayout() {
     std::vector<RHIDescriptorSetLayoutBinding> skybox_layout_bindings(2);
@@ -591,11 +458,19 @@ void MainCameraPass::setupDeferredLightingDescriptorSetLayout() {
 
 void MainCameraPass::setupPipelines() {
     m_render_pipelines.resize(_render_pipeline_type_count);
-    setupMeshGBufferPipeline();
-    setupDeferredLightingPipeline();
-    setupForwardLightingPipeline();
-    setupSkyboxPipeline();
-    setupAxisPipeline();
+
+    // each pipeline only writes its own slot of m_render_pipelines, compile them concurrently
+    std::future<void> pipeline_setups[] = {
+        std::async(std::launch::async, [this]() { setupMeshGBufferPipeline(); }),
+        std::async(std::launch::async, [this]() { setupDeferredLightingPipeline(); }),
+        std::async(std::launch::async, [this]() { setupForwardLightingPipeline(); }),
+        std::async(std::launch::async, [this]() { setupSkyboxPipeline(); }),
+        std::async(std::launch::async, [this]() { setupAxisPipeline(); })
+    };
+    for (auto &pipeline_setup : pipeline_setups)
+        pipeline_setup.wait();
+    for (auto &pipeline_setup : pipeline_setups)
+        pipeline_setup.get();
 }
 
 // mesh gbuffer
@@ -612,7 +487,8 @@ void MainCameraPass::setupMeshGBufferPipeline() {
         throw std::runtime_error("create mesh gbuffer pipeline layout");
 
     RHIShader* vert_shader_module = m_rhi->createShaderModule(MESH_VERT);
-    RHIShader* frag_shader_module = m_rhi->createShaderModule(MESH_GBUFFER_FRAG);
+    RHIShader* frag_shader_module =
+        m_rhi->createShaderModule(m_rhi->isBindlessMaterialEnabled() ? MESH_GBUFFER_BINDLESS_FRAG : MESH_GBUFFER_FRAG);
 
     RHIPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info {};
     vert_pipeline_shader_stage_create_info.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -724,7 +600,7 @@ void MainCameraPass::setupMeshGBufferPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(),
         1,
         &pipelineInfo,
         m_render_pipelines[_render_pipeline_type_mesh_gbuffer].pipeline))
@@ -859,7 +735,7 @@ void MainCameraPass::setupDeferredLightingPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(),
         1,
         &pipelineInfo,
         m_render_pipelines[_render_pipeline_type_deferred_lighting].pipeline))
@@ -883,7 +759,8 @@ void MainCameraPass::setupForwardLightingPipeline() {
         throw std::runtime_error("create forward lighting pipeline layout");
 
     RHIShader* vert_shader_module = m_rhi->createShaderModule(MESH_VERT);
-    RHIShader* frag_shader_module = m_rhi->createShaderModule(MESH_FRAG);
+    RHIShader* frag_shader_module =
+        m_rhi->createShaderModule(m_rhi->isBindlessMaterialEnabled() ? MESH_BINDLESS_FRAG : MESH_FRAG);
 
     RHIPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info {};
     vert_pipeline_shader_stage_create_info.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -993,7 +870,7 @@ void MainCameraPass::setupForwardLightingPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+    if (m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(),
                                         1,
                                         &pipelineInfo,
                                         m_render_pipelines[_render_pipeline_type_forward_lighting].pipeline) !=
@@ -1126,7 +1003,7 @@ void MainCameraPass::setupSkyboxPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(),
         1,
         &pipelineInfo,
         m_render_pipelines[_render_pipeline_type_skybox].pipeline))
@@ -1258,7 +1135,7 @@ void MainCameraPass::setupAxisPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(),
         1,
         &pipelineInfo,
         m_render_pipelines[_render_pipeline_type_axis].pipeline))
@@ -1373,6 +1250,10 @@ void MainCameraPass::setupMeshGlobalDescriptorSet() {
                                 mesh_descriptor_writes_info.data(),
                                 0,
                                 NULL);
+
+    registerRingBufferBinding(m_descriptor_infos[_mesh_global].descriptor_set, 0, mesh_perframe_storage_buffer_info.range);
+    registerRingBufferBinding(m_descriptor_infos[_mesh_global].descriptor_set, 1, mesh_perdrawcall_storage_buffer_info.range);
+    registerRingBufferBinding(m_descriptor_infos[_mesh_global].descriptor_set, 2, mesh_per_drawcall_vertex_blending_storage_buffer_info.range);
 }
 
 // setup the skybox descriptor set
@@ -1414,6 +1295,8 @@ void MainCameraPass::setupSkyboxDescriptorSet() {
     skybox_descriptor_writes_info[1].pImageInfo     = &specular_texture_image_info;
 
     m_rhi->updateDescriptorSets(skybox_descriptor_writes_info.size(), skybox_descriptor_writes_info.data(), 0, NULL);
+
+    registerRingBufferBinding(m_descriptor_infos[_skybox].descriptor_set, 0, mesh_perframe_storage_buffer_info.range);
 }
 
 // setup the axis descriptor set
@@ -1458,6 +1341,8 @@ void MainCameraPass::setupAxisDescriptorSet() {
                                 axis_descriptor_writes_info.data(),
                                 0,
                                 NULL);
+
+    registerRingBufferBinding(m_descriptor_infos[_axis].descriptor_set, 0, mesh_perframe_storage_buffer_info.range);
 }
 
 // setup the gbuffer lighting descriptor set
@@ -1536,24 +1421,24 @@ void MainCameraPass::setupSwapchainFramebuffers() {
 
     // create frame buffer for every imageview
     for (size_t i = 0; i < m_rhi->getSwapchainInfo().imageViews.size(); i++) {
-        RHIImageView* framebuffer_attachments_for_image_view[_main_camera_pass_attachment_count] = {
-            m_framebuffer.attachments[_main_camera_pass_gbuffer_a].view,
-            m_framebuffer.attachments[_main_camera_pass_gbuffer_b].view,
-            m_framebuffer.attachments[_main_camera_pass_gbuffer_c].view,
-            m_framebuffer.attachments[_main_camera_pass_backup_buffer_a].view,
-            m_framebuffer.attachments[_main_camera_pass_backup_buffer_b].view,
-            m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].view,
-            m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].view,
-            m_rhi->getDepthImageInfo().depth_image_view,
-            m_rhi->getSwapchainInfo().imageViews[i]
-        };
+        // 按 render graph 实际分配的 attachment 排列
+        std::vector<RHIImageView*> framebuffer_attachments_for_image_view(m_render_graph.getPhysicalAttachmentCount());
+        for (uint32_t physical_index = 0; physical_index < framebuffer_attachments_for_image_view.size(); ++physical_index) {
+            uint32_t attachment_index = m_render_graph.getPhysicalAttachmentOwner(physical_index);
+            if (attachment_index == _main_camera_pass_depth)
+                framebuffer_attachments_for_image_view[physical_index] = m_rhi->getDepthImageInfo().depth_image_view;
+            else if (attachment_index == _main_camera_pass_swap_chain_image)
+                framebuffer_attachments_for_image_view[physical_index] = m_rhi->getSwapchainInfo().imageViews[i];
+            else
+                framebuffer_attachments_for_image_view[physical_index] = m_framebuffer.attachments[attachment_index].view;
+        }
 
         RHIFramebufferCreateInfo framebuffer_create_info {};
         framebuffer_create_info.sType           = RHI_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebuffer_create_info.flags           = 0U;
         framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
-        framebuffer_create_info.attachmentCount = _main_camera_pass_attachment_count;
-        framebuffer_create_info.pAttachments    = framebuffer_attachments_for_image_view;
+        framebuffer_create_info.attachmentCount = static_cast<uint32_t>(framebuffer_attachments_for_image_view.size());
+        framebuffer_create_info.pAttachments    = framebuffer_attachments_for_image_view.data();
         framebuffer_create_info.width           = m_rhi->getSwapchainInfo().extent.width;
         framebuffer_create_info.height          = m_rhi->getSwapchainInfo().extent.height;
         framebuffer_create_info.layers          = 1;
@@ -1565,7 +1450,9 @@ void MainCameraPass::setupSwapchainFramebuffers() {
 }
 
 void MainCameraPass::updateAfterFramebufferRecreate() {
-    for (size_t i = 0; i < m_framebuffer.attachments.size(); i++) {
+    for (uint32_t i = 0; i < m_framebuffer.attachments.size(); i++) {
+        if (m_render_graph.isAttachmentCulled(i) || m_render_graph.getAttachmentOwner(i) != i)
+            continue;
         m_rhi->destroyImage(m_framebuffer.attachments[i].image);
         m_rhi->destroyImageView(m_framebuffer.attachments[i].view);
         m_rhi->freeMemory(m_framebuffer.attachments[i].mem);
@@ -1587,14 +1474,17 @@ void MainCameraPass::updateAfterFramebufferRecreate() {
 }
 
 // main camera pass draw function for deferred rendering
-void MainCameraPass::draw(ColorGradingPass &color_grading_pass,
-                          VignettePass     &vignette_pass,
+void MainCameraPass::draw(PostProcessPass  &post_process_pass,
                           FXAAPass         &fxaa_pass,
-                          ToneMappingPass  &tone_mapping_pass,
                           UIPass           &ui_pass,
                           CombineUIPass    &combine_ui_pass,
                           ParticlePass     &particle_pass,
                           uint32_t          current_swapchain_image_index) {
+    PROFILE_SCOPE("MainCameraPass::draw");
+
+    m_command_recorder.prepareFrame();
+    prepareMeshDrawcalls();
+
     {
         RHIRenderPassBeginInfo renderpass_begin_info {};
         renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -1603,27 +1493,24 @@ void MainCameraPass::draw(ColorGradingPass &color_grading_pass,
         renderpass_begin_info.renderArea.offset = {0, 0};
         renderpass_begin_info.renderArea.extent = m_rhi->getSwapchainInfo().extent;
 
-        RHIClearValue clear_values[_main_camera_pass_attachment_count];
-        clear_values[_main_camera_pass_gbuffer_a].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_gbuffer_b].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_gbuffer_c].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_backup_buffer_a].color        = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_backup_buffer_b].color       = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_post_process_buffer_odd].color  = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_post_process_buffer_even].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_depth].depthStencil             = {1.0f, 0};
-        clear_values[_main_camera_pass_swap_chain_image].color         = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-        renderpass_begin_info.pClearValues    = clear_values;
+        std::vector<RHIClearValue> clear_values = m_render_graph.getClearValues();
+        renderpass_begin_info.clearValueCount   = static_cast<uint32_t>(clear_values.size());
+        renderpass_begin_info.pClearValues      = clear_values.data();
 
-        m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(), &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
+        m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(),
+                                     &renderpass_begin_info,
+                                     m_record_mesh_in_parallel ? RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : RHI_SUBPASS_CONTENTS_INLINE);
     }
 
     // ----- base pass -----
     float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "BasePass of G-Buffer", color);
-    drawMesh(_render_pipeline_type_mesh_gbuffer); // 延迟渲染首先绘制 GBuffer
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
+    // 延迟渲染首先绘制 GBuffer
+    std::vector<RHICommandBuffer*> basepass_command_buffers =
+        drawMesh(_render_pipeline_type_mesh_gbuffer, m_swapchain_framebuffers[current_swapchain_image_index], "BasePass of G-Buffer");
+    if (!basepass_command_buffers.empty())
+        m_rhi->cmdExecuteCommands(m_rhi->getCurrentCommandBuffer(),
+                                  static_cast<uint32_t>(basepass_command_buffers.size()),
+                                  basepass_command_buffers.data());
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
     // ----- deferred lighting pass -----
@@ -1638,26 +1525,14 @@ void MainCameraPass::draw(ColorGradingPass &color_grading_pass,
     m_rhi->popEvent(particle_pass.getRenderCommandBufferHandle());
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
-    // ----- tone mapping pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Tone Map", color);
-    tone_mapping_pass.draw();
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
-
-    // ----- color grading pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Color Grading", color);
-    color_grading_pass.draw();
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
-
-    // ----- vignette pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Vignette", color);
-    vignette_pass.draw();
+    // ----- post process pass (tone mapping + color grading + vignette) -----
+    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Post Process", color);
+    post_process_pass.draw();
     m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
     // ----- FXAA pass (optionally jumped) -----
-    if (m_enable_fxaa) {
+    if (!m_render_graph.isSubpassCulled(_main_camera_subpass_fxaa)) {
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "FXAA", color);
         fxaa_pass.draw();
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
@@ -1701,14 +1576,17 @@ void MainCameraPass::draw(ColorGradingPass &color_grading_pass,
 }
 
 // main camera pass draw function for forward rendering
-void MainCameraPass::drawForward(ColorGradingPass &color_grading_pass,
-                                 VignettePass     &vignette_pass,
+void MainCameraPass::drawForward(PostProcessPass  &post_process_pass,
                                  FXAAPass         &fxaa_pass,
-                                 ToneMappingPass  &tone_mapping_pass,
                                  UIPass           &ui_pass,
                                  CombineUIPass    &combine_ui_pass,
                                  ParticlePass     &particle_pass,
                                  uint32_t          current_swapchain_image_index) {
+    PROFILE_SCOPE("MainCameraPass::drawForward");
+
+    m_command_recorder.prepareFrame();
+    prepareMeshDrawcalls();
+
     {
         RHIRenderPassBeginInfo renderpass_begin_info {};
         renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -1717,16 +1595,9 @@ void MainCameraPass::drawForward(ColorGradingPass &color_grading_pass,
         renderpass_begin_info.renderArea.offset = {0, 0};
         renderpass_begin_info.renderArea.extent = m_rhi->getSwapchainInfo().extent;
 
-        RHIClearValue clear_values[_main_camera_pass_attachment_count];
-        clear_values[_main_camera_pass_gbuffer_a].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_gbuffer_b].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_gbuffer_c].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-        clear_values[_main_camera_pass_backup_buffer_a].color  = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_backup_buffer_b].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[_main_camera_pass_depth].depthStencil       = {1.0f, 0};
-        clear_values[_main_camera_pass_swap_chain_image].color   = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        renderpass_begin_info.clearValueCount                    = (sizeof(clear_values) / sizeof(clear_values[0]));
-        renderpass_begin_info.pClearValues                       = clear_values;
+        std::vector<RHIClearValue> clear_values = m_render_graph.getClearValues();
+        renderpass_begin_info.clearValueCount   = static_cast<uint32_t>(clear_values.size());
+        renderpass_begin_info.pClearValues      = clear_values.data();
 
         m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(), &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
     }
@@ -1736,42 +1607,51 @@ void MainCameraPass::drawForward(ColorGradingPass &color_grading_pass,
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
     // ----- deferred lighting pass (jumped) -----
-    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
+    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(),
+                             m_record_mesh_in_parallel ? RHI_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : RHI_SUBPASS_CONTENTS_INLINE);
 
     // ----- forward lighting pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Forward Lighting of Model", color);
-    drawMesh(_render_pipeline_type_forward_lighting);
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Forward Lighting of Skybox", color);
-    drawSkybox();
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-
-    m_rhi->pushEvent(particle_pass.getRenderCommandBufferHandle(), "Forward Lighting of ParticleBillboard", color);
-    particle_pass.draw();
-    m_rhi->popEvent(particle_pass.getRenderCommandBufferHandle());
-    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
-
-    // ----- tone mapping pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Tone Map", color);
-    tone_mapping_pass.draw();
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-    m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
+    RHIFramebuffer* framebuffer = m_swapchain_framebuffers[current_swapchain_image_index];
+    std::vector<RHICommandBuffer*> forward_command_buffers =
+        drawMesh(_render_pipeline_type_forward_lighting, framebuffer, "Forward Lighting of Model");
+    if (m_record_mesh_in_parallel) {
+        // subpass 只接受 secondary command buffer，天空盒和粒子也录制到 secondary 中，排在 mesh 之后
+        std::vector<RHICommandBuffer*> tail_command_buffers = m_command_recorder.record(
+            m_framebuffer.render_pass, _main_camera_subpass_forward_lighting, framebuffer, 1, 1,
+            [this, &particle_pass, &color](RHICommandBuffer* command_buffer, uint32_t, uint32_t) {
+                m_rhi->pushEvent(command_buffer, "Forward Lighting of Skybox", color);
+                drawSkybox(command_buffer);
+                m_rhi->popEvent(command_buffer);
+
+                particle_pass.setRenderCommandBufferHandle(command_buffer);
+                m_rhi->pushEvent(command_buffer, "Forward Lighting of ParticleBillboard", color);
+                particle_pass.draw();
+                m_rhi->popEvent(command_buffer);
+            });
+        forward_command_buffers.insert(forward_command_buffers.end(), tail_command_buffers.begin(), tail_command_buffers.end());
+        m_rhi->cmdExecuteCommands(m_rhi->getCurrentCommandBuffer(),
+                                  static_cast<uint32_t>(forward_command_buffers.size()),
+                                  forward_command_buffers.data());
+        particle_pass.setRenderCommandBufferHandle(m_rhi->getCurrentCommandBuffer());
+    } else {
+        m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Forward Lighting of Skybox", color);
+        drawSkybox(m_rhi->getCurrentCommandBuffer());
+        m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
 
-    // ----- color grading pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Color Grading", color);
-    color_grading_pass.draw();
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
+        m_rhi->pushEvent(particle_pass.getRenderCommandBufferHandle(), "Forward Lighting of ParticleBillboard", color);
+        particle_pass.draw();
+        m_rhi->popEvent(particle_pass.getRenderCommandBufferHandle());
+    }
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
-    // ----- vignette pass -----
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Vignette", color);
-    vignette_pass.draw();
+    // ----- post process pass (tone mapping + color grading + vignette) -----
+    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Post Process", color);
+    post_process_pass.draw();
     m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     m_rhi->cmdNextSubpassPFN(m_rhi->getCurrentCommandBuffer(), RHI_SUBPASS_CONTENTS_INLINE);
 
     // ----- FXAA pass (optionally jumped) -----
-    if (m_enable_fxaa) {
+    if (!m_render_graph.isSubpassCulled(_main_camera_subpass_fxaa)) {
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "FXAA", color);
         fxaa_pass.draw();
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
@@ -1817,6 +1697,9 @@ void MainCameraPass::drawForward(ColorGradingPass &color_grading_pass,
 std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> MainCameraPass::reorganizeMeshNodes(std::vector<RenderMeshNode>* visible_mesh_nodes) {
     std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> drawcall_batch;
 
+    // bindless material 下材质通过 instance 的 material_index 索引，同一 mesh 的不同材质可以合成一个 drawcall
+    bool enable_bindless_material = m_rhi->isBindlessMaterialEnabled();
+
     for (const RenderMeshNode& node : *visible_mesh_nodes) {
         MeshNode mesh_node;
         mesh_node.model_matrix = node.model_matrix;
@@ -1824,161 +1707,208 @@ std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> MainC
             mesh_node.joint_matrices = node.joint_matrices;
             mesh_node.joint_count = node.joint_count;
         }
-        auto& mesh_map = drawcall_batch[node.ref_material]; // [] 操作符，找不着就创建新的，找到了就用已有的
+        if (enable_bindless_material)
+            mesh_node.material_index = node.ref_material->bindless_material_index;
+        auto& mesh_map = drawcall_batch[enable_bindless_material ? nullptr : node.ref_material]; // [] 操作符，找不着就创建新的，找到了就用已有的
         mesh_map[node.ref_mesh].push_back(std::move(mesh_node));
     }
 
     return drawcall_batch;
 }
 
-template<typename T>
-MainCameraPass::RingBufferAllocation<T> MainCameraPass::allocateRingBufferSpace() {
-    uint32_t dynamic_offset = roundUp(
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-    m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-            dynamic_offset + sizeof(T);
-
-    assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-          (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-           m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+void MainCameraPass::prepareMeshDrawcalls() {
+    // reorganize mesh
+    m_mesh_drawcall_batch = reorganizeMeshNodes(m_visible_nodes.p_main_camera_visible_mesh_nodes);
 
-    T* data_ptr = reinterpret_cast<T*>(
-        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-        dynamic_offset);
+    m_mesh_drawcalls.clear();
+    uint32_t drawcall_max_instance_count =
+        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+    for (auto &pair1 : m_mesh_drawcall_batch) {
+        // TODO: render from near to far
+        for (auto &pair2 : pair1.second) {
+            const std::vector<MeshNode> &mesh_nodes = pair2.second;
+            uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
+            for (uint32_t first_instance = 0; first_instance < total_instance_count; first_instance += drawcall_max_instance_count) {
+                MeshDrawcall drawcall;
+                drawcall.material       = pair1.first;
+                drawcall.mesh           = pair2.first;
+                drawcall.mesh_nodes     = &mesh_nodes[first_instance];
+                drawcall.instance_count = std::min(total_instance_count - first_instance, drawcall_max_instance_count);
+                m_mesh_drawcalls.push_back(drawcall);
+            }
+        }
+    }
 
-    return {data_ptr, dynamic_offset};
+    m_record_mesh_in_parallel = m_command_recorder.getWorkerCount() > 1 &&
+                                m_mesh_drawcalls.size() >= s_parallel_mesh_recording_min_drawcall_count;
 }
 
-void MainCameraPass::drawMesh(RenderPipeLineType render_pipeline_type) {
-    // reorganize mesh
-    auto drawcall_batch = reorganizeMeshNodes(m_visible_nodes.p_main_camera_visible_mesh_nodes);
-
-    m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(),
-                              RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                              m_render_pipelines[render_pipeline_type].pipeline);
-    m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-    m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
-
+std::vector<RHICommandBuffer*> MainCameraPass::drawMesh(RenderPipeLineType render_pipeline_type,
+                                                        RHIFramebuffer*    framebuffer,
+                                                        const char*        event_name) {
     // perframe storage buffer
     auto perframe_allocation = allocateRingBufferSpace<MeshPerframeStorageBufferObject>();
+    if (!perframe_allocation.data_ptr)
+        return {};
     *perframe_allocation.data_ptr = m_mesh_perframe_storage_buffer_object;
     uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
-    for (auto &pair1 : drawcall_batch) {
-        VulkanPBRMaterial &material = (*pair1.first);
-        auto &mesh_instanced = pair1.second;
+    float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    if (!m_record_mesh_in_parallel) {
+        m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), event_name, color);
+        recordMeshDrawcalls(m_rhi->getCurrentCommandBuffer(),
+                            render_pipeline_type,
+                            perframe_dynamic_offset,
+                            0,
+                            static_cast<uint32_t>(m_mesh_drawcalls.size()));
+        m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
+        return {};
+    }
+
+    // 每个线程录制一段连续的 drawcall，调试标签也要录制在各自的 secondary command buffer 中
+    uint32_t subpass = render_pipeline_type == _render_pipeline_type_mesh_gbuffer ? _main_camera_subpass_basepass :
+                                                                                     _main_camera_subpass_forward_lighting;
+    return m_command_recorder.record(m_framebuffer.render_pass,
+                                     subpass,
+                                     framebuffer,
+                                     static_cast<uint32_t>(m_mesh_drawcalls.size()),
+                                     s_parallel_mesh_recording_min_drawcalls_per_worker,
+                                     [&](RHICommandBuffer* command_buffer, uint32_t begin, uint32_t end) {
+                                         m_rhi->pushEvent(command_buffer, event_name, color);
+                                         recordMeshDrawcalls(command_buffer, render_pipeline_type, perframe_dynamic_offset, begin, end);
+                                         m_rhi->popEvent(command_buffer);
+                                     });
+}
 
-        // bind per material
-        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+// 录制 m_mesh_drawcalls 中 [begin, end) 的 drawcall，可在多个线程中并发调用
+void MainCameraPass::recordMeshDrawcalls(RHICommandBuffer*  command_buffer,
+                                         RenderPipeLineType render_pipeline_type,
+                                         uint32_t           perframe_dynamic_offset,
+                                         uint32_t           begin,
+                                         uint32_t           end) {
+    m_rhi->cmdBindPipelinePFN(command_buffer,
+                              RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                              m_render_pipelines[render_pipeline_type].pipeline);
+    m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, &m_scene_viewport);
+    m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, &m_scene_scissor);
+
+    // all materials share one set, bind it once
+    bool enable_bindless_material = m_rhi->isBindlessMaterialEnabled();
+    if (enable_bindless_material && begin < end) {
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
                                         RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                         m_render_pipelines[render_pipeline_type].layout,
                                         2,
                                         1,
-                                        &material.material_descriptor_set,
+                                        &m_global_render_resource->_bindless_material_resource._descriptor_set,
                                         0,
                                         NULL);
+    }
 
-        // TODO: render from near to far
+    // drawcall 按 material、mesh 排列，只在切换时重新绑定
+    VulkanPBRMaterial* bound_material = nullptr;
+    VulkanMesh*        bound_mesh     = nullptr;
+    for (uint32_t drawcall_index = begin; drawcall_index < end; ++drawcall_index) {
+        const MeshDrawcall &drawcall = m_mesh_drawcalls[drawcall_index];
+        VulkanMesh &mesh = *drawcall.mesh;
+        const MeshNode* mesh_nodes = drawcall.mesh_nodes;
+        uint32_t current_instance_count = drawcall.instance_count;
 
-        for (auto &pair2 : mesh_instanced) {
-            VulkanMesh &mesh = (*pair2.first);
-            auto &mesh_nodes = pair2.second;
+        // bind per material
+        if (!enable_bindless_material && drawcall.material != bound_material) {
+            bound_material = drawcall.material;
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                            m_render_pipelines[render_pipeline_type].layout,
+                                            2,
+                                            1,
+                                            &bound_material->material_descriptor_set,
+                                            0,
+                                            NULL);
+        }
 
-            uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-            if (total_instance_count > 0) {
-                // bind per mesh
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                m_render_pipelines[render_pipeline_type].layout,
-                                                1,
-                                                1,
-                                                &mesh.mesh_vertex_blending_descriptor_set,
-                                                0,
-                                                NULL);
-
-                RHIBuffer* vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
-                                               mesh.mesh_vertex_varying_enable_blending_buffer,
-                                               mesh.mesh_vertex_varying_buffer
-                                              };
-                RHIDeviceSize offsets[]        = {0, 0, 0};
-                m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
-                                               0,
-                                               (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
-                                               vertex_buffers,
-                                               offsets);
-                m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
-
-                uint32_t drawcall_max_instance_count =
-                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                uint32_t drawcall_count =
-                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index) {
-                    uint32_t current_instance_count =
-                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                         drawcall_max_instance_count) ?
-                        (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                        drawcall_max_instance_count;
-
-                    // per drawcall storage buffer
-                    auto per_drawcall_allocation = allocateRingBufferSpace<MeshPerdrawcallStorageBufferObject>();
-                    uint32_t per_drawcall_dynamic_offset = per_drawcall_allocation.dynamic_offset;
-                    for (uint32_t i = 0; i < current_instance_count; ++i) {
-                        per_drawcall_allocation.data_ptr->mesh_instances[i].model_matrix =
-                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                        per_drawcall_allocation.data_ptr->mesh_instances[i].enable_vertex_blending =
-                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0f : -1.0f;
-                    }
+        // bind per mesh
+        if (drawcall.mesh != bound_mesh) {
+            bound_mesh = drawcall.mesh;
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                            m_render_pipelines[render_pipeline_type].layout,
+                                            1,
+                                            1,
+                                            &mesh.mesh_vertex_blending_descriptor_set,
+                                            0,
+                                            NULL);
+
+            RHIBuffer* vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                           mesh.mesh_vertex_varying_enable_blending_buffer,
+                                           mesh.mesh_vertex_varying_buffer
+                                          };
+            RHIDeviceSize offsets[]        = {0, 0, 0};
+            m_rhi->cmdBindVertexBuffersPFN(command_buffer,
+                                           0,
+                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                           vertex_buffers,
+                                           offsets);
+            m_rhi->cmdBindIndexBufferPFN(command_buffer, mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+        }
 
-                    // per drawcall vertex blending storage buffer
-                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                    bool     least_one_enable_vertex_blending = true;
-                    for (uint32_t i = 0; i < current_instance_count; ++i) {
-                        if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices) {
-                            least_one_enable_vertex_blending = false;
-                            break;
-                        }
-                    }
-                    if (least_one_enable_vertex_blending) {
-                        auto per_drawcall_vertex_blending_allocation = allocateRingBufferSpace<MeshPerdrawcallVertexBlendingStorageBufferObject>();
-                        per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
-                        for (uint32_t i = 0; i < current_instance_count; ++i) {
-                            if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices) {
-                                for (uint32_t j = 0; j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count; ++j) {
-                                    per_drawcall_vertex_blending_allocation.data_ptr->joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices[j];
-                                }
-                            }
-                        }
-                    } else {
-                        per_drawcall_vertex_blending_dynamic_offset = 0;
-                    }
+        // per drawcall storage buffer
+        auto per_drawcall_allocation = allocateRingBufferSpace<MeshPerdrawcallStorageBufferObject>();
+        if (!per_drawcall_allocation.data_ptr)
+            continue;
+        uint32_t per_drawcall_dynamic_offset = per_drawcall_allocation.dynamic_offset;
+        for (uint32_t i = 0; i < current_instance_count; ++i) {
+            per_drawcall_allocation.data_ptr->mesh_instances[i].model_matrix           = *mesh_nodes[i].model_matrix;
+            per_drawcall_allocation.data_ptr->mesh_instances[i].enable_vertex_blending = mesh_nodes[i].joint_matrices ? 1.0f : -1.0f;
+            per_drawcall_allocation.data_ptr->mesh_instances[i].material_index         = mesh_nodes[i].material_index;
+        }
 
-                    // bind perdrawcall
-                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                   per_drawcall_dynamic_offset,
-                                                   per_drawcall_vertex_blending_dynamic_offset};
-                    m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                    RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                    m_render_pipelines[render_pipeline_type].layout,
-                                                    0,
-                                                    1,
-                                                    &m_descriptor_infos[_mesh_global].descriptor_set,
-                                                    3,
-                                                    dynamic_offsets);
-
-                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                             mesh.mesh_index_count,
-                                             current_instance_count,
-                                             0,
-                                             0,
-                                             0);
+        // per drawcall vertex blending storage buffer
+        uint32_t per_drawcall_vertex_blending_dynamic_offset;
+        bool     least_one_enable_vertex_blending = true;
+        for (uint32_t i = 0; i < current_instance_count; ++i) {
+            if (!mesh_nodes[i].joint_matrices) {
+                least_one_enable_vertex_blending = false;
+                break;
+            }
+        }
+        if (least_one_enable_vertex_blending) {
+            auto per_drawcall_vertex_blending_allocation = allocateRingBufferSpace<MeshPerdrawcallVertexBlendingStorageBufferObject>();
+            if (!per_drawcall_vertex_blending_allocation.data_ptr)
+                continue;
+            per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
+            for (uint32_t i = 0; i < current_instance_count; ++i) {
+                if (mesh_nodes[i].joint_matrices) {
+                    for (uint32_t j = 0; j < mesh_nodes[i].joint_count; ++j) {
+                        per_drawcall_vertex_blending_allocation.data_ptr->joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
+                            mesh_nodes[i].joint_matrices[j];
+                    }
                 }
             }
+        } else {
+            per_drawcall_vertex_blending_dynamic_offset = 0;
         }
+
+        // bind perdrawcall
+        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                       per_drawcall_dynamic_offset,
+                                       per_drawcall_vertex_blending_dynamic_offset};
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_render_pipelines[render_pipeline_type].layout,
+                                        0,
+                                        1,
+                                        &m_descriptor_infos[_mesh_global].descriptor_set,
+                                        3,
+                                        dynamic_offsets);
+
+        m_rhi->cmdDrawIndexedPFN(command_buffer,
+                                 mesh.mesh_index_count,
+                                 current_instance_count,
+                                 0,
+                                 0,
+                                 0);
     }
 }
 
@@ -1987,10 +1917,12 @@ void MainCameraPass::drawDeferredLighting() {
                               RHI_PIPELINE_BIND_POINT_GRAPHICS,
                               m_render_pipelines[_render_pipeline_type_deferred_lighting].pipeline);
 
-    m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-    m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
+    m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, &m_scene_viewport);
+    m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, &m_scene_scissor);
 
     auto perframe_allocation = allocateRingBufferSpace<MeshPerframeStorageBufferObject>();
+    if (!perframe_allocation.data_ptr)
+        return;
     *perframe_allocation.data_ptr = m_mesh_perframe_storage_buffer_object;
     uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
@@ -2011,15 +1943,19 @@ void MainCameraPass::drawDeferredLighting() {
 }
 
 // forward rendering 的天空盒绘制，延迟渲染的天空盒被整合在 drawDeferredLighting() 中
-void MainCameraPass::drawSkybox() {
+void MainCameraPass::drawSkybox(RHICommandBuffer* command_buffer) {
     auto perframe_allocation = allocateRingBufferSpace<MeshPerframeStorageBufferObject>();
+    if (!perframe_allocation.data_ptr)
+        return;
     *perframe_allocation.data_ptr = m_mesh_perframe_storage_buffer_object;
     uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
-    m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(),
+    m_rhi->cmdBindPipelinePFN(command_buffer,
                               RHI_PIPELINE_BIND_POINT_GRAPHICS,
                               m_render_pipelines[_render_pipeline_type_skybox].pipeline);
-    m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+    m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, &m_scene_viewport);
+    m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, &m_scene_scissor);
+    m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
                                     RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                     m_render_pipelines[_render_pipeline_type_skybox].layout,
                                     0,
@@ -2027,7 +1963,7 @@ void MainCameraPass::drawSkybox() {
                                     &m_descriptor_infos[_skybox].descriptor_set,
                                     1,
                                     &perframe_dynamic_offset);
-    m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), 36, 1, 0, 0); // 2 triangles(6 vertex) each face, 6 faces
+    m_rhi->cmdDraw(command_buffer, 36, 1, 0, 0); // 2 triangles(6 vertex) each face, 6 faces
 }
 
 void MainCameraPass::drawAxis() {
@@ -2035,6 +1971,8 @@ void MainCameraPass::drawAxis() {
         return;
 
     auto perframe_allocation = allocateRingBufferSpace<MeshPerframeStorageBufferObject>();
+    if (!perframe_allocation.data_ptr)
+        return;
     *perframe_allocation.data_ptr = m_mesh_perframe_storage_buffer_object;
     uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
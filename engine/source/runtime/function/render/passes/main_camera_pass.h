@@ -1,13 +1,13 @@
 #pragma once
 
+#include "runtime/function/render/parallel_command_recorder.h"
+#include "runtime/function/render/render_graph.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
 
-#include "runtime/function/render/passes/color_grading_pass.h"
-#include "runtime/function/render/passes/vignette_pass.h"
 #include "runtime/function/render/passes/combine_ui_pass.h"
 #include "runtime/function/render/passes/fxaa_pass.h"
-#include "runtime/function/render/passes/tone_mapping_pass.h"
+#include "runtime/function/render/passes/post_process_pass.h"
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 
@@ -21,6 +21,7 @@ class RenderResourceBase;
 
 struct MainCameraPassInitInfo : RenderPassInitInfo {
     bool enable_fxaa;
+    bool enable_dynamic_resolution {false};
 };
 
 // RenderMeshNode 中的 ref 信息、node_id、enable_vertex_blending 信息在合批后不需要
@@ -28,6 +29,15 @@ struct MeshNode {
     const Matrix4x4* model_matrix {nullptr};
     const Matrix4x4* joint_matrices {nullptr};
     uint32_t         joint_count {0};
+    uint32_t         material_index {0}; // 仅 bindless material 使用，材质不再参与合批
+};
+
+// 合批后的一个 drawcall，按 material、mesh 的顺序展平，以便按区间切分给多个线程录制
+struct MeshDrawcall {
+    VulkanPBRMaterial* material {nullptr};
+    VulkanMesh*        mesh {nullptr};
+    const MeshNode*    mesh_nodes {nullptr};
+    uint32_t           instance_count {0};
 };
 
 class MainCameraPass : public RenderPass {
@@ -66,19 +76,15 @@ public:
 
     void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
 
-    void draw(ColorGradingPass &color_grading_pass,
-              VignettePass &vignette_pass,
+    void draw(PostProcessPass &post_process_pass,
               FXAAPass &fxaa_pass,
-              ToneMappingPass &tone_mapping_pass,
               UIPass &ui_pass,
               CombineUIPass &combine_ui_pass,
               ParticlePass &particle_pass,
               uint32_t current_swapchain_image_index);
 
-    void drawForward(ColorGradingPass &color_grading_pass,
-                     VignettePass &vignette_pass,
+    void drawForward(PostProcessPass &post_process_pass,
                      FXAAPass &fxaa_pass,
-                     ToneMappingPass &tone_mapping_pass,
                      UIPass &ui_pass,
                      CombineUIPass &combine_ui_pass,
                      ParticlePass &particle_pass,
@@ -91,6 +97,7 @@ public:
 
     bool                            m_is_show_axis{ false };
     bool                            m_enable_fxaa{ false };
+    bool                            m_enable_dynamic_resolution{ false };
     size_t                          m_selected_axis{ 3 };
     MeshPerframeStorageBufferObject m_mesh_perframe_storage_buffer_object;
     AxisStorageBufferObject         m_axis_storage_buffer_object;
@@ -103,6 +110,7 @@ public:
 
 private:
     void setupParticlePass();
+    void setupRenderGraph();
     void setupAttachments();
     void setupRenderPass();
     void setupPipelines();
@@ -114,6 +122,7 @@ private:
     void setupPerMeshDescriptorSetLayout();
     void setupMeshGlobalDescriptorSetLayout();
     void setupMeshPerMaterialDescriptorSetLayout();
+    void setupBindlessMaterialDescriptorSetLayout();
     void setupSkyboxDescriptorSetLayout();
     void setupAxisDescriptorSetLayout();
     void setupDeferredLightingDescriptorSetLayout();
@@ -132,24 +141,30 @@ private:
     void setupGbufferLightingDescriptorSet();
     void setupFramebufferDescriptorSet();
 
-    template<typename T>
-    struct RingBufferAllocation {
-        T* data_ptr;
-        uint32_t dynamic_offset;
-    };
-    template<typename T>
-    RingBufferAllocation<T> allocateRingBufferSpace();
-
-    void drawMesh(RenderPipeLineType render_pipeline_type);
+    // 合批并展平本帧的 mesh drawcall，决定是否多线程录制，需在 begin render pass 之前调用
+    void prepareMeshDrawcalls();
+    // 单线程时直接录制到 primary command buffer 并返回空；多线程时返回尚未执行的 secondary command buffer
+    std::vector<RHICommandBuffer*> drawMesh(RenderPipeLineType render_pipeline_type, RHIFramebuffer* framebuffer, const char* event_name);
+    void recordMeshDrawcalls(RHICommandBuffer*  command_buffer,
+                             RenderPipeLineType render_pipeline_type,
+                             uint32_t           perframe_dynamic_offset,
+                             uint32_t           begin,
+                             uint32_t           end);
     void drawDeferredLighting();
-    void drawSkybox();
+    void drawSkybox(RHICommandBuffer* command_buffer);
     void drawAxis();
 
 private:
     // 根据 material 和 mesh 进行重新分组 (re-batch)
     std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> reorganizeMeshNodes(std::vector<RenderMeshNode> *visible_mesh_nodes);
 
+    RenderGraph                  m_render_graph;
     std::vector<RHIFramebuffer*> m_swapchain_framebuffers;
     std::shared_ptr<ParticlePass> m_particle_pass;
+
+    std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> m_mesh_drawcall_batch; // m_mesh_drawcalls 引用其中的 MeshNode
+    std::vector<MeshDrawcall> m_mesh_drawcalls;
+    bool                      m_record_mesh_in_parallel {false};
+    ParallelCommandRecorder   m_command_recorder;
 };
 } // namespace Piccolo
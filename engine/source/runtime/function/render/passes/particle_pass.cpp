@@ -1,10 +1,13 @@
 #include "runtime/function/render/passes/particle_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_camera.h"
+#include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_system.h"
 
 #include "core/base/macro.h"
@@ -17,28 +20,16 @@
 #include <particlebillboard_vert.h>
 
 namespace Piccolo {
-void ParticleEmitterBufferBatch::freeUpBatch(std::shared_ptr<RHI> rhi) {
-    rhi->freeMemory(m_counter_host_memory);
-    rhi->freeMemory(m_position_host_memory);
-    rhi->freeMemory(m_position_device_memory);
+void ParticleEmitterBufferBatch::freeUpBatch(std::shared_ptr<RHI> rhi, ParticleBufferPool &particle_buffer_pool) {
     rhi->freeMemory(m_counter_device_memory);
     rhi->freeMemory(m_indirect_dispatch_argument_memory);
-    rhi->freeMemory(m_alive_list_memory);
-    rhi->freeMemory(m_alive_list_next_memory);
-    rhi->freeMemory(m_dead_list_memory);
     rhi->freeMemory(m_particle_component_res_memory);
-    rhi->freeMemory(m_position_render_memory);
 
-    rhi->destroyBuffer(m_position_render_buffer);
-    rhi->destroyBuffer(m_position_device_buffer);
-    rhi->destroyBuffer(m_position_host_buffer);
     rhi->destroyBuffer(m_counter_device_buffer);
-    rhi->destroyBuffer(m_counter_host_buffer);
     rhi->destroyBuffer(m_indirect_dispatch_argument_buffer);
-    rhi->destroyBuffer(m_alive_list_buffer);
-    rhi->destroyBuffer(m_alive_list_next_buffer);
-    rhi->destroyBuffer(m_dead_list_buffer);
     rhi->destroyBuffer(m_particle_component_res_buffer);
+
+    particle_buffer_pool.free(m_particle_allocation);
 }
 
 void ParticlePass::initialize(const RenderPassInitInfo* init_info) {
@@ -49,11 +40,23 @@ void ParticlePass::initialize(const RenderPassInitInfo* init_info) {
 }
 
 void ParticlePass::draw() {
+    PROFILE_SCOPE("ParticlePass::draw");
+
+    ClusterFrustum frustum = CreateClusterFrustumFromMatrix(
+        m_particlebillboard_perframe_storage_buffer_object.proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
     for (int i = 0; i < m_emitter_count; ++i) {
+        // 以 emitter 位置和粒子可能到达的最远距离剔除整个 emitter
+        const ParticleEmitterBufferBatch &batch = m_emitter_buffer_batches[i];
+        Vector3 center(batch.m_emitter_desc.m_position.x, batch.m_emitter_desc.m_position.y, batch.m_emitter_desc.m_position.z);
+        Vector3 extent(batch.m_bounding_radius, batch.m_bounding_radius, batch.m_bounding_radius);
+        if (!TiledFrustumIntersectBox(frustum, BoundingBox(center - extent, center + extent)))
+            continue;
+
         m_rhi->cmdBindPipelinePFN(
             m_render_command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[1].pipeline);
-        m_rhi->cmdSetViewportPFN(m_render_command_buffer, 0, 1, m_rhi->getSwapchainInfo().viewport);
-        m_rhi->cmdSetScissorPFN(m_render_command_buffer, 0, 1, m_rhi->getSwapchainInfo().scissor);
+        m_rhi->cmdSetViewportPFN(m_render_command_buffer, 0, 1, &m_scene_viewport);
+        m_rhi->cmdSetScissorPFN(m_render_command_buffer, 0, 1, &m_scene_scissor);
         m_rhi->cmdBindDescriptorSetsPFN(m_render_command_buffer,
                                         RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                         m_render_pipelines[1].layout,
@@ -63,7 +66,12 @@ void ParticlePass::draw() {
                                         0,
                                         NULL);
 
-        m_rhi->cmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+        // instance 数量由模拟写入，不需要读回 CPU
+        m_rhi->cmdDrawIndirect(m_render_command_buffer,
+                               batch.m_indirect_dispatch_argument_buffer,
+                               s_argument_offset_draw,
+                               1,
+                               sizeof(uvec4));
     }
 }
 
@@ -132,23 +140,68 @@ void ParticlePass::preparePassData(std::shared_ptr<RenderResourceBase> render_re
                &m_particlebillboard_perframe_storage_buffer_object,
                sizeof(m_particlebillboard_perframe_storage_buffer_object));
 
-        m_viewport_params = *m_rhi->getSwapchainInfo().viewport;
+        m_viewport_params = m_scene_viewport;
+        waitForSimulation();
         updateUniformBuffer();
         updateEmitterTransform();
     }
 }
 
-void ParticlePass::simulate() {
-    for (auto i : m_emitter_tick_indices) {
-        RHICommandBufferBeginInfo cmdBufInfo {};
-        cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+// 等待上一帧的模拟完成，之后才能复用 compute command buffer 和改写 compute 读取的 uniform
+// 模拟在上一帧末尾提交，到这里 GPU 通常早已完成，不会真正阻塞
+void ParticlePass::waitForSimulation() {
+    if (!m_is_simulation_pending)
+        return;
 
-        // particle compute pass
-        if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            throw std::runtime_error("begin command buffer");
+    if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
+        throw std::runtime_error("wait for fence");
+    m_is_simulation_pending = false;
+}
+
+// 所有 emitter 录制在同一个 command buffer 中一次提交，CPU 不等待其完成：
+// 等待本帧的渲染（包括 depth/normal 的复制），完成后通知下一帧的渲染，粒子数量直接写入 indirect draw 的参数
+void ParticlePass::simulate(uint8_t submitted_frame_index) {
+    PROFILE_SCOPE("ParticlePass::simulate");
+
+    waitForSimulation();
+
+    RHICommandBufferBeginInfo cmdBufInfo {};
+    cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    // particle compute pass
+    if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
+        throw std::runtime_error("begin command buffer");
+
+    auto setBufferBarrier = [&](RHIBuffer* buffer,
+            RHIAccessFlags srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT, RHIAccessFlags dstAccessMask = RHI_ACCESS_SHADER_READ_BIT,
+            RHIPipelineStageFlagBits srcStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT, RHIPipelineStageFlagBits dstStageMask = RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT
+    ) {
+        RHIBufferMemoryBarrier bufferBarrier {};
+        bufferBarrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.buffer              = buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = srcAccessMask;
+        bufferBarrier.dstAccessMask       = dstAccessMask;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+                                  srcStageMask, dstStageMask,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+    };
+
+    float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    m_rhi->pushEvent(m_compute_command_buffer, "Particle compute", color);
+
+    for (auto i : m_emitter_tick_indices) {
+        const ParticleBufferPool::Allocation &allocation = m_emitter_buffer_batches[i].m_particle_allocation;
 
-        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-        m_rhi->pushEvent(m_compute_command_buffer, "Particle compute", color);
         m_rhi->pushEvent(m_compute_command_buffer, "Particle Kickoff", color);
 
         m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
@@ -169,30 +222,6 @@ void ParticlePass::simulate() {
 
         m_rhi->popEvent(m_compute_command_buffer); // end particle kickoff label
 
-        auto setBufferBarrier = [&](RHIBuffer* buffer,
-                RHIAccessFlags srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT, RHIAccessFlags dstAccessMask = RHI_ACCESS_SHADER_READ_BIT,
-                RHIPipelineStageFlagBits srcStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT, RHIPipelineStageFlagBits dstStageMask = RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT
-        ) {
-            RHIBufferMemoryBarrier bufferBarrier {};
-            bufferBarrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            bufferBarrier.buffer              = buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = srcAccessMask;
-            bufferBarrier.dstAccessMask       = dstAccessMask;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      srcStageMask, dstStageMask,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-        };
-
         setBufferBarrier(m_emitter_buffer_batches[i].m_counter_device_buffer);
 
         setBufferBarrier(m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
@@ -209,17 +238,17 @@ void ParticlePass::simulate() {
 
         m_rhi->popEvent(m_compute_command_buffer); // end particle emit label
 
-        setBufferBarrier(m_emitter_buffer_batches[i].m_position_device_buffer);
+        setBufferBarrier(m_particle_buffer_pool.getBuffer(allocation, ParticleBufferPool::_particle_stream_simulate));
 
-        setBufferBarrier(m_emitter_buffer_batches[i].m_position_render_buffer);
+        setBufferBarrier(m_particle_buffer_pool.getBuffer(allocation, ParticleBufferPool::_particle_stream_render));
 
         setBufferBarrier(m_emitter_buffer_batches[i].m_counter_device_buffer);
 
-        setBufferBarrier(m_emitter_buffer_batches[i].m_alive_list_buffer);
+        setBufferBarrier(m_particle_buffer_pool.getBuffer(allocation, ParticleBufferPool::_particle_stream_alive_list));
 
-        setBufferBarrier(m_emitter_buffer_batches[i].m_dead_list_buffer);
+        setBufferBarrier(m_particle_buffer_pool.getBuffer(allocation, ParticleBufferPool::_particle_stream_dead_list));
 
-        setBufferBarrier(m_emitter_buffer_batches[i].m_alive_list_next_buffer);
+        setBufferBarrier(m_particle_buffer_pool.getBuffer(allocation, ParticleBufferPool::_particle_stream_alive_list_next));
 
         m_rhi->pushEvent(m_compute_command_buffer, "Particle Simulate", color);
 
@@ -230,114 +259,94 @@ void ParticlePass::simulate() {
 
         m_rhi->popEvent(m_compute_command_buffer); // end particle simulate label
 
-        if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
-            throw std::runtime_error("end command buffer");
-        m_rhi->resetFencesPFN(1, &m_fence);
-
-        RHISubmitInfo computeSubmitInfo {};
-        computeSubmitInfo.sType              = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-        computeSubmitInfo.pWaitDstStageMask  = 0;
-        computeSubmitInfo.commandBufferCount = 1;
-        computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
-
-        if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
-            throw std::runtime_error("compute queue submit");
-
-        if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
-            throw std::runtime_error("wait for fence");
+        m_rhi->pushEvent(m_compute_command_buffer, "Particle Draw Argument", color);
 
-        if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            throw std::runtime_error("begin command buffer");
-
-        m_rhi->pushEvent(m_compute_command_buffer, "Copy Particle Counter Buffer", color);
-
-        // Barrier to ensure that shader writes are finished before buffer is read back from GPU
+        // Barrier to ensure that shader writes are finished before the counter is copied
         setBufferBarrier(m_emitter_buffer_batches[i].m_counter_device_buffer,
                          RHI_ACCESS_SHADER_WRITE_BIT,
                          RHI_ACCESS_TRANSFER_READ_BIT,
                          RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          RHI_PIPELINE_STAGE_TRANSFER_BIT);
-        // Read back to host visible buffer
 
+        // alive_count_after_sim -> instanceCount of the indirect draw
         RHIBufferCopy copyRegion {};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        copyRegion.size      = sizeof(ParticleCounter);
+        copyRegion.srcOffset = offsetof(ParticleCounter, alive_count_after_sim);
+        copyRegion.dstOffset = s_argument_offset_draw + sizeof(uint32_t);
+        copyRegion.size      = sizeof(uint32_t);
 
         m_rhi->cmdCopyBuffer(m_compute_command_buffer,
                              m_emitter_buffer_batches[i].m_counter_device_buffer,
-                             m_emitter_buffer_batches[i].m_counter_host_buffer,
+                             m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                              1,
                              &copyRegion);
 
-        // Barrier to ensure that shader writes are finished before buffer is read back from GPU
-        setBufferBarrier(m_emitter_buffer_batches[i].m_counter_host_buffer,
+        // the draw reads it next frame, the kickoff of next simulation rewrites the buffer
+        setBufferBarrier(m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                          RHI_ACCESS_TRANSFER_WRITE_BIT,
-                         RHI_ACCESS_HOST_READ_BIT,
+                         RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT,
                          RHI_PIPELINE_STAGE_TRANSFER_BIT,
-                         RHI_PIPELINE_STAGE_HOST_BIT);
+                         RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 
-        m_rhi->popEvent(m_compute_command_buffer); // end particle counter copy label
+        m_rhi->popEvent(m_compute_command_buffer); // end particle draw argument label
+    }
 
-        m_rhi->popEvent(m_compute_command_buffer); // end particle compute label
+    m_rhi->popEvent(m_compute_command_buffer); // end particle compute label
 
-        if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
-            throw std::runtime_error("end command buffer");
+    if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
+        throw std::runtime_error("end command buffer");
 
-        // Submit compute work
-        m_rhi->resetFencesPFN(1, &m_fence);
-        computeSubmitInfo                        = {};
-        const VkPipelineStageFlags waitStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-        computeSubmitInfo.sType                  = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-        computeSubmitInfo.pWaitDstStageMask      = &waitStageMask;
-        computeSubmitInfo.commandBufferCount     = 1;
-        computeSubmitInfo.pCommandBuffers        = &m_compute_command_buffer;
+    // 每次成功的 submitRendering 都 signal 一次 texture copy semaphore，没有 emitter 需要 tick 时也要提交来等待它
+    m_rhi->resetFencesPFN(1, &m_fence);
+    RHIPipelineStageFlags waitStageMask         = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    RHISubmitInfo         computeSubmitInfo     = {};
+    computeSubmitInfo.sType                     = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+    computeSubmitInfo.waitSemaphoreCount        = 1;
+    computeSubmitInfo.pWaitSemaphores           = &m_rhi->getTextureCopySemaphore(submitted_frame_index);
+    computeSubmitInfo.pWaitDstStageMask         = &waitStageMask;
+    computeSubmitInfo.commandBufferCount        = 1;
+    computeSubmitInfo.pCommandBuffers           = &m_compute_command_buffer;
+    computeSubmitInfo.signalSemaphoreCount      = 1;
+    computeSubmitInfo.pSignalSemaphores         = &m_simulate_finished_semaphore;
 
-        if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
-            throw std::runtime_error("compute queue submit");
+    if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
+        throw std::runtime_error("compute queue submit");
 
-        if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
-            throw std::runtime_error("wait for fence");
+    // 粒子的 vertex shader 读取模拟结果，下一帧的复制会覆盖模拟读取的 depth/normal
+    m_rhi->addRenderingWaitSemaphore(m_simulate_finished_semaphore,
+                                     RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT);
 
-        m_rhi->queueWaitIdle(m_rhi->getComputeQueue());
+    m_is_simulation_pending = true;
+    m_emitter_tick_indices.clear();
+    m_emitter_transform_indices.clear();
+}
 
-        // Make device writes visible to the host
-        void* mapped;
-        m_rhi->mapMemory(m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
-
-        m_rhi->invalidateMappedMemoryRanges(
-            nullptr, m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE);
-
-        // Copy to output
-        ParticleCounter counterNext {};
-        memcpy(&counterNext, mapped, sizeof(ParticleCounter));
-        m_rhi->unmapMemory(m_emitter_buffer_batches[i].m_counter_host_memory);
-
-        if constexpr (s_verbose_particle_alive_info)
-            LOG_INFO("{} {} {} {}",
-                     counterNext.dead_count,
-                     counterNext.alive_count,
-                     counterNext.alive_count_after_sim,
-                     counterNext.emit_count);
-        m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
-    }
+void ParticlePass::skipSimulation(uint8_t submitted_frame_index) {
+    waitForSimulation();
+
+    m_rhi->resetFencesPFN(1, &m_fence);
+    RHIPipelineStageFlags waitStageMask     = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    RHISubmitInfo         computeSubmitInfo = {};
+    computeSubmitInfo.sType                 = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+    computeSubmitInfo.waitSemaphoreCount    = 1;
+    computeSubmitInfo.pWaitSemaphores       = &m_rhi->getTextureCopySemaphore(submitted_frame_index);
+    computeSubmitInfo.pWaitDstStageMask     = &waitStageMask;
+    computeSubmitInfo.commandBufferCount    = 0;
+    computeSubmitInfo.pCommandBuffers       = nullptr;
+    computeSubmitInfo.signalSemaphoreCount  = 0;
+    computeSubmitInfo.pSignalSemaphores     = nullptr;
+
+    if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
+        throw std::runtime_error("compute queue submit");
+
+    m_is_simulation_pending = true;
     m_emitter_tick_indices.clear();
     m_emitter_transform_indices.clear();
 }
 
+// 录制在本帧的主 command buffer 中，紧跟 main camera pass 之后
+// 模拟等待 submitRendering signal 的 texture copy semaphore，因此不需要单独提交，也不需要等待队列空闲
 void ParticlePass::copyNormalAndDepthImage() {
-    uint8_t index =
-        (m_rhi->getCurrentFrameIndex() + m_rhi->getMaxFramesInFlight() - 1) % m_rhi->getMaxFramesInFlight();
-
-    m_rhi->waitForFencesPFN(1, &(m_rhi->getFenceList()[index]), VK_TRUE, UINT64_MAX);
-
-    RHICommandBufferBeginInfo command_buffer_begin_info {};
-    command_buffer_begin_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    command_buffer_begin_info.flags            = 0;
-    command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-    bool res_begin_command_buffer = m_rhi->beginCommandBufferPFN(m_copy_command_buffer, &command_buffer_begin_info);
-    assert(RHI_SUCCESS == res_begin_command_buffer);
+    RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
 
     auto copyImage = [&](RHIImage* src_image, RHIImage* dst_image, bool is_depth = true) {
         RHIImageSubresourceRange subresourceRange = {static_cast<RHIImageAspectFlags>(is_depth ? RHI_IMAGE_ASPECT_DEPTH_BIT : RHI_IMAGE_ASPECT_COLOR_BIT), 0, 1, 0, 1};
@@ -353,7 +362,7 @@ void ParticlePass::copyNormalAndDepthImage() {
         imagememorybarrier.srcAccessMask = 0;
         imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
         imagememorybarrier.image         = dst_image;
-        m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+        m_rhi->cmdPipelineBarrier(command_buffer,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   0,
@@ -365,13 +374,15 @@ void ParticlePass::copyNormalAndDepthImage() {
                                   &imagememorybarrier);
 
         // 第二个 barrier：准备 src 图像，确保转换为传输源布局，确保之前的深度写入操作完成
-        imagememorybarrier.oldLayout     = RHI_IMAGE_LAYOUT_UNDEFINED;
+        // 旧布局即 main camera pass 的 final layout，不能用 UNDEFINED 丢弃内容
+        imagememorybarrier.oldLayout     = is_depth ? RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+                                                    : RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         imagememorybarrier.newLayout     = RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         imagememorybarrier.srcAccessMask = is_depth ? RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
                                                     : RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
         imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_READ_BIT;
         imagememorybarrier.image         = src_image;
-        m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+        m_rhi->cmdPipelineBarrier(command_buffer,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   0,
@@ -383,7 +394,7 @@ void ParticlePass::copyNormalAndDepthImage() {
                                   &imagememorybarrier);
 
         // 执行图像复制操作
-        m_rhi->cmdCopyImageToImage(m_copy_command_buffer,
+        m_rhi->cmdCopyImageToImage(command_buffer,
                                    src_image,
                                    is_depth ? RHI_IMAGE_ASPECT_DEPTH_BIT : RHI_IMAGE_ASPECT_COLOR_BIT,
                                    dst_image,
@@ -399,7 +410,7 @@ void ParticlePass::copyNormalAndDepthImage() {
         imagememorybarrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT | (is_depth ?
                                            RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT : RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT);
         imagememorybarrier.image         = src_image;
-        m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+        m_rhi->cmdPipelineBarrier(command_buffer,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   0,
@@ -417,7 +428,7 @@ void ParticlePass::copyNormalAndDepthImage() {
         imagememorybarrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
         imagememorybarrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT;
         imagememorybarrier.image         = dst_image;
-        m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+        m_rhi->cmdPipelineBarrier(command_buffer,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                   0,
@@ -431,48 +442,52 @@ void ParticlePass::copyNormalAndDepthImage() {
 
     float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
     // copy depth image
-    m_rhi->pushEvent(m_copy_command_buffer, "Copy Depth Image for Particle", color);
+    m_rhi->pushEvent(command_buffer, "Copy Depth Image for Particle", color);
     copyImage(m_src_depth_image, m_dst_depth_image);
-    m_rhi->popEvent(m_copy_command_buffer);
+    m_rhi->popEvent(command_buffer);
 
     // copy normal image
-    m_rhi->pushEvent(m_copy_command_buffer, "Copy Normal Image for Particle", color);
+    m_rhi->pushEvent(command_buffer, "Copy Normal Image for Particle", color);
     copyImage(m_src_normal_image, m_dst_normal_image, false);
-    m_rhi->popEvent(m_copy_command_buffer);
-
-    bool res_end_command_buffer = m_rhi->endCommandBufferPFN(m_copy_command_buffer);
-    assert(RHI_SUCCESS == res_end_command_buffer);
-
-    bool res_reset_fences = m_rhi->resetFencesPFN(1, &m_rhi->getFenceList()[index]);
-    assert(RHI_SUCCESS == res_reset_fences);
-
-    RHIPipelineStageFlags wait_stages[] = {RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    RHISubmitInfo         submit_info   = {};
-    submit_info.sType                   = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.waitSemaphoreCount      = 1;
-    submit_info.pWaitSemaphores         = &(m_rhi->getTextureCopySemaphore(index));
-    submit_info.pWaitDstStageMask       = wait_stages;
-    submit_info.commandBufferCount      = 1;
-    submit_info.pCommandBuffers         = &m_copy_command_buffer;
-    submit_info.signalSemaphoreCount    = 0;
-    submit_info.pSignalSemaphores       = nullptr;
-    bool res_queue_submit =
-        m_rhi->queueSubmit(m_rhi->getGraphicsQueue(), 1, &submit_info, m_rhi->getFenceList()[index]);
-    assert(RHI_SUCCESS == res_queue_submit);
+    m_rhi->popEvent(command_buffer);
+}
 
-    m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
+// 粒子在生命周期内可能到达的最远距离，与 particle_emit.comp 中的发射方式对应，偏保守
+float ParticlePass::calculateEmitterBoundingRadius(const ParticleEmitterDesc &desc, const Vector3 &gravity) {
+    float spawn_radius = std::max(0.1f * std::fabs(desc.m_position.w) * std::sqrt(3.0f), std::sqrt(2.0f));
+    float max_speed    = Vector3(desc.m_velocity.x, desc.m_velocity.y, desc.m_velocity.z).length() +
+                         2.0f * std::fabs(desc.m_velocity.w);
+    float max_acc      = (Vector3(desc.m_acceleration.x, desc.m_acceleration.y, desc.m_acceleration.z) + gravity).length();
+    float max_life     = desc.m_life.x + std::fabs(desc.m_life.y);
+    float max_size     = std::max(desc.m_size.x, desc.m_size.y);
+    return spawn_radius + max_speed * max_life + 0.5f * max_acc * max_life * max_life + max_size;
+}
+
+// 同时存活的粒子数上限：每 emit_gap 帧发射 emit_count 个，每个粒子存活 life / time_step 帧
+uint32_t ParticlePass::calculateEmitterCapacity(const ParticleEmitterDesc &desc) {
+    const GlobalParticleRes &global_res = m_particle_manager->getGlobalParticleRes();
+
+    float    max_life    = desc.m_life.x + std::fabs(desc.m_life.y);
+    float    life_frames = std::min(std::ceil(max_life / std::max(global_res.m_time_step, 1e-6f)),
+                                    static_cast<float>(s_max_particles));
+    uint64_t emissions   = static_cast<uint64_t>(life_frames) / std::max(global_res.m_emit_gap, 1) + 1;
+    uint64_t capacity    = emissions * std::max(global_res.m_emit_count, 1);
+    return static_cast<uint32_t>(std::min<uint64_t>(capacity, s_max_particles));
 }
 
 void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
+    m_emitter_buffer_batches[id].m_particle_allocation = m_particle_buffer_pool.allocate(calculateEmitterCapacity(desc));
+    const ParticleBufferPool::Allocation &allocation  = m_emitter_buffer_batches[id].m_particle_allocation;
+
     const VkDeviceSize counterBufferSize = sizeof(ParticleCounter);
     ParticleCounter    counter;
-    counter.alive_count           = m_emitter_buffer_batches[id].m_num_particle;
-    counter.dead_count            = s_max_particles - m_emitter_buffer_batches[id].m_num_particle;
+    counter.alive_count           = 0;
+    counter.dead_count            = allocation.capacity;
     counter.emit_count            = 0;
-    counter.alive_count_after_sim = m_emitter_buffer_batches[id].m_num_particle;
+    counter.alive_count_after_sim = 0;
 
     if constexpr (s_verbose_particle_alive_info) {
-        LOG_INFO("Emitter {} info:", id);
+        LOG_INFO("Emitter {} info: capacity {}", id, allocation.capacity);
         LOG_INFO("Dead {}, Alive {}, After sim {}, Emit {}",
                  counter.dead_count,
                  counter.alive_count,
@@ -484,55 +499,27 @@ void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
         const VkDeviceSize      indirectArgumentSize = sizeof(IndirectArgumemt);
         struct IndirectArgumemt indirectargument     = {};
         indirectargument.alive_flap_bit              = 1;
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        indirectargument.draw_argument               = {4, 0, 0, 0}; // vertex, instance, first vertex, first instance
+        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                         RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
                                          RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                          m_emitter_buffer_batches[id].m_indirect_dispatch_argument_buffer,
                                          m_emitter_buffer_batches[id].m_indirect_dispatch_argument_memory,
                                          indirectArgumentSize,
                                          &indirectargument,
                                          indirectArgumentSize);
-
-        const VkDeviceSize aliveListSize = 4 * sizeof(uint32_t) * s_max_particles;
-        std::vector<int>   aliveindices(s_max_particles * 4, 0);
-        for (int i = 0; i < s_max_particles; ++i)
-            aliveindices[i * 4] = i;
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                         RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                         m_emitter_buffer_batches[id].m_alive_list_buffer,
-                                         m_emitter_buffer_batches[id].m_alive_list_memory,
-                                         aliveListSize,
-                                         aliveindices.data(),
-                                         aliveListSize);
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                         RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                         m_emitter_buffer_batches[id].m_alive_list_next_buffer,
-                                         m_emitter_buffer_batches[id].m_alive_list_next_memory,
-                                         aliveListSize);
-
-        const VkDeviceSize   deadListSize = 4 * sizeof(uint32_t) * s_max_particles;
-        std::vector<int32_t> deadindices(s_max_particles * 4, 0);
-        for (int32_t i = 0; i < s_max_particles; ++i)
-            deadindices[i * 4] = s_max_particles - 1 - i;
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                         RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                         m_emitter_buffer_batches[id].m_dead_list_buffer,
-                                         m_emitter_buffer_batches[id].m_dead_list_memory,
-                                         deadListSize,
-                                         deadindices.data(),
-                                         deadListSize);
     }
 
-    RHIFence*       fence = nullptr;
-    ParticleCounter counterNext {};
-    // fill in data of ParticleCounter
+    RHIFence* fence = nullptr;
+    // fill in data of ParticleCounter and reset the dead list
     {
+        // staging buffer, released once the copy is done
+        RHIBuffer*       counter_host_buffer = nullptr;
+        RHIDeviceMemory* counter_host_memory = nullptr;
         m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_TRANSFER_SRC_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
                                          RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                         m_emitter_buffer_batches[id].m_counter_host_buffer,
-                                         m_emitter_buffer_batches[id].m_counter_host_memory,
+                                         counter_host_buffer,
+                                         counter_host_memory,
                                          counterBufferSize,
                                          &counter,
                                          sizeof(counter));
@@ -540,12 +527,11 @@ void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
         // Flush writes to host visible buffer
         void* mapped;
 
-        m_rhi->mapMemory(m_emitter_buffer_batches[id].m_counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
+        m_rhi->mapMemory(counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
 
-        m_rhi->flushMappedMemoryRanges(
-            nullptr, m_emitter_buffer_batches[id].m_counter_host_memory, 0, RHI_WHOLE_SIZE);
+        m_rhi->flushMappedMemoryRanges(nullptr, counter_host_memory, 0, RHI_WHOLE_SIZE);
 
-        m_rhi->unmapMemory(m_emitter_buffer_batches[id].m_counter_host_memory);
+        m_rhi->unmapMemory(counter_host_memory);
 
         m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
                                          RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
@@ -574,11 +560,17 @@ void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
         copyRegion.dstOffset     = 0;
         copyRegion.size          = counterBufferSize;
         m_rhi->cmdCopyBuffer(copyCmd,
-                             m_emitter_buffer_batches[id].m_counter_host_buffer,
+                             counter_host_buffer,
                              m_emitter_buffer_batches[id].m_counter_device_buffer,
                              1,
                              &copyRegion);
 
+        // a zero-filled dead list holds every particle of the allocation, see particle_emit.comp
+        // particle data and the alive lists are always written before being read, so they are left as they are
+        RHIDescriptorBufferInfo deadList =
+            m_particle_buffer_pool.getDescriptorBufferInfo(allocation, ParticleBufferPool::_particle_stream_dead_list);
+        m_rhi->cmdFillBuffer(copyCmd, deadList.buffer, deadList.offset, deadList.range, 0);
+
         if (RHI_SUCCESS != m_rhi->endCommandBuffer(copyCmd))
             throw std::runtime_error("buffer copy");
 
@@ -601,10 +593,14 @@ void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
 
         m_rhi->destroyFence(fence);
         m_rhi->freeCommandBuffers(m_rhi->getCommandPool(), 1, copyCmd);
+
+        m_rhi->freeMemory(counter_host_memory);
+        m_rhi->destroyBuffer(counter_host_buffer);
     }
 
-    const VkDeviceSize staggingBufferSize        = s_max_particles * sizeof(Particle);
     m_emitter_buffer_batches[id].m_emitter_desc = desc;
+    m_emitter_buffer_batches[id].m_bounding_radius =
+        calculateEmitterBoundingRadius(desc, m_particle_manager->getGlobalParticleRes().m_gravity);
 
     // fill in data of ParticleEmitterDesc
     {
@@ -623,82 +619,6 @@ void ParticlePass::createEmitter(int id, const ParticleEmitterDesc &desc) {
                                             0,
                                             &m_emitter_buffer_batches[id].m_emitter_desc_mapped))
             throw std::runtime_error("map emitter component res buffer");
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_TRANSFER_SRC_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                         RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                         m_emitter_buffer_batches[id].m_position_host_buffer,
-                                         m_emitter_buffer_batches[id].m_position_host_memory,
-                                         staggingBufferSize);
-
-        // Flush writes to host visible buffer
-        void* mapped;
-        m_rhi->mapMemory(m_emitter_buffer_batches[id].m_position_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
-
-        m_rhi->flushMappedMemoryRanges(
-            nullptr, m_emitter_buffer_batches[id].m_position_host_memory, 0, RHI_WHOLE_SIZE);
-
-        m_rhi->unmapMemory(m_emitter_buffer_batches[id].m_position_host_memory);
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                         RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                         RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                         m_emitter_buffer_batches[id].m_position_device_buffer,
-                                         m_emitter_buffer_batches[id].m_position_device_memory,
-                                         staggingBufferSize);
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                         RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                         RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                         m_emitter_buffer_batches[id].m_position_render_buffer,
-                                         m_emitter_buffer_batches[id].m_position_render_memory,
-                                         staggingBufferSize);
-
-        // Copy to staging buffer
-        RHICommandBufferAllocateInfo cmdBufAllocateInfo {};
-        cmdBufAllocateInfo.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        cmdBufAllocateInfo.commandPool        = m_rhi->getCommandPool();
-        cmdBufAllocateInfo.level              = RHI_COMMAND_BUFFER_LEVEL_PRIMARY;
-        cmdBufAllocateInfo.commandBufferCount = 1;
-        RHICommandBuffer* copyCmd;
-        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, copyCmd))
-            throw std::runtime_error("alloc command buffer");
-        RHICommandBufferBeginInfo cmdBufInfo {};
-        cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        if (RHI_SUCCESS != m_rhi->beginCommandBuffer(copyCmd, &cmdBufInfo))
-            throw std::runtime_error("begin command buffer");
-
-        RHIBufferCopy copyRegion = {};
-        copyRegion.srcOffset     = 0;
-        copyRegion.dstOffset     = 0;
-        copyRegion.size          = staggingBufferSize;
-        m_rhi->cmdCopyBuffer(copyCmd,
-                             m_emitter_buffer_batches[id].m_position_host_buffer,
-                             m_emitter_buffer_batches[id].m_position_device_buffer,
-                             1,
-                             &copyRegion);
-
-        if (RHI_SUCCESS != m_rhi->endCommandBuffer(copyCmd))
-            throw std::runtime_error("buffer copy");
-
-        RHISubmitInfo submitInfo {};
-        submitInfo.sType              = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers    = &copyCmd;
-        RHIFenceCreateInfo fenceInfo {};
-        fenceInfo.sType = RHI_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = 0;
-        if (RHI_SUCCESS != m_rhi->createFence(&fenceInfo, fence))
-            throw std::runtime_error("create fence");
-
-        // Submit to the queue
-        if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &submitInfo, fence))
-            throw std::runtime_error("queue submit");
-
-        if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &fence, RHI_TRUE, UINT64_MAX))
-            throw std::runtime_error("wait fence submit");
-
-        m_rhi->destroyFence(fence);
-        m_rhi->freeCommandBuffers(m_rhi->getCommandPool(), 1, copyCmd);
     }
 }
 
@@ -714,6 +634,8 @@ void ParticlePass::setDepthAndNormalImage(RHIImage* depth_image, RHIImage* norma
 }
 
 void ParticlePass::setupParticlePass() {
+    m_particle_buffer_pool.initialize(m_rhi, sizeof(Particle), s_particle_pool_block_capacity);
+
     prepareUniformBuffer();
     setupDescriptorSetLayout();
     setupPipelines();
@@ -726,14 +648,17 @@ void ParticlePass::setupParticlePass() {
     cmdBufAllocateInfo.commandBufferCount = 1;
     if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_compute_command_buffer))
         throw std::runtime_error("alloc compute command buffer");
-    if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_copy_command_buffer))
-        throw std::runtime_error("alloc copy command buffer");
 
     RHIFenceCreateInfo fenceCreateInfo {};
     fenceCreateInfo.sType = RHI_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceCreateInfo.flags = 0;
     if (RHI_SUCCESS != m_rhi->createFence(&fenceCreateInfo, m_fence))
         throw std::runtime_error("create fence");
+
+    RHISemaphoreCreateInfo semaphoreCreateInfo {};
+    semaphoreCreateInfo.sType = RHI_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    if (RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo, m_simulate_finished_semaphore))
+        throw std::runtime_error("create semaphore");
 }
 
 void ParticlePass::setRenderCommandBufferHandle(RHICommandBuffer* command_buffer) {
@@ -743,13 +668,22 @@ void ParticlePass::setRenderCommandBufferHandle(RHICommandBuffer* command_buffer
 void ParticlePass::setRenderPassHandle(RHIRenderPass* render_pass) { m_render_pass = render_pass; }
 
 void ParticlePass::setEmitterCount(int count) {
+    // 正在进行的模拟和上一帧的 billboard 绘制可能仍在使用这些 buffer
+    waitForSimulation();
+    m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
     for (int i = 0; i < m_emitter_buffer_batches.size(); ++i)
-        m_emitter_buffer_batches[i].freeUpBatch(m_rhi);
+        m_emitter_buffer_batches[i].freeUpBatch(m_rhi, m_particle_buffer_pool);
+    // 所有 emitter 都已释放，归还上一个场景的 block，新场景按需重新分配
+    m_particle_buffer_pool.destroy();
 
     m_emitter_count = count;
     m_emitter_buffer_batches.resize(m_emitter_count);
 }
 
+void ParticlePass::clear() {
+    setEmitterCount(0);
+}
+
 void ParticlePass::setTickIndices(const std::vector<ParticleEmitterID> &tick_indices) {
     m_emitter_tick_indices = tick_indices;
 }
@@ -767,10 +701,11 @@ void ParticlePass::updateUniformBuffer() {
     float rnd2 = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
     m_ubo.pack = Vector4 {rnd0, rnd1, rnd2, static_cast<float>(m_rhi->getCurrentFrameIndex())};
 
-    m_ubo.viewport.x = m_rhi->getSwapchainInfo().viewport->x;
-    m_ubo.viewport.y = m_rhi->getSwapchainInfo().viewport->y;
-    m_ubo.viewport.z = m_rhi->getSwapchainInfo().viewport->width;
-    m_ubo.viewport.w = m_rhi->getSwapchainInfo().viewport->height;
+    // 粒子碰撞采样的 depth 来自场景 subpass，因此使用场景的 viewport
+    m_ubo.viewport.x = m_scene_viewport.x;
+    m_ubo.viewport.y = m_scene_viewport.y;
+    m_ubo.viewport.z = m_scene_viewport.width;
+    m_ubo.viewport.w = m_scene_viewport.height;
     m_ubo.extent.x   = m_rhi->getSwapchainInfo().scissor->extent.width;
     m_ubo.extent.y   = m_rhi->getSwapchainInfo().scissor->extent.height;
 
@@ -1102,7 +1037,7 @@ void ParticlePass::setupPipelines() {
 
         computePipelineCreateInfo.pStages = &shaderStage;
         if (RHI_SUCCESS != m_rhi->createComputePipelines(
-                /*pipelineCache*/ nullptr, 1, &computePipelineCreateInfo, m_kickoff_pipeline))
+                m_rhi->getPipelineCache(), 1, &computePipelineCreateInfo, m_kickoff_pipeline))
             throw std::runtime_error("create particle kickoff pipe");
     }
 
@@ -1113,7 +1048,7 @@ void ParticlePass::setupPipelines() {
 
         computePipelineCreateInfo.pStages = &shaderStage;
         if (RHI_SUCCESS != m_rhi->createComputePipelines(
-                /*pipelineCache*/ nullptr, 1, &computePipelineCreateInfo, m_emit_pipeline))
+                m_rhi->getPipelineCache(), 1, &computePipelineCreateInfo, m_emit_pipeline))
             throw std::runtime_error("create particle emit pipe");
     }
 
@@ -1125,7 +1060,7 @@ void ParticlePass::setupPipelines() {
         computePipelineCreateInfo.pStages = &shaderStage;
 
         if (RHI_SUCCESS != m_rhi->createComputePipelines(
-                /*pipelineCache*/ nullptr, 1, &computePipelineCreateInfo, m_simulate_pipeline))
+                m_rhi->getPipelineCache(), 1, &computePipelineCreateInfo, m_simulate_pipeline))
             throw std::runtime_error("create particle simulate pipe");
     }
 
@@ -1251,7 +1186,7 @@ void ParticlePass::setupPipelines() {
         pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[1].pipeline) !=
+        if (m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[1].pipeline) !=
             RHI_SUCCESS)
             throw std::runtime_error("create particle billboard graphics pipeline");
 
@@ -1278,11 +1213,9 @@ void ParticlePass::setupParticleDescriptorSet() {
         particlebillboard_perframe_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
         particlebillboard_perframe_storage_buffer_info.buffer = m_particle_billboard_uniform_buffer;
 
-        RHIDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
-        particlebillboard_perdrawcall_storage_buffer_info.offset                  = 0;
-        particlebillboard_perdrawcall_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
-        particlebillboard_perdrawcall_storage_buffer_info.buffer =
-            m_emitter_buffer_batches[eid].m_position_render_buffer;
+        RHIDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info =
+            m_particle_buffer_pool.getDescriptorBufferInfo(m_emitter_buffer_batches[eid].m_particle_allocation,
+                                                           ParticleBufferPool::_particle_stream_render);
 
         RHIWriteDescriptorSet particlebillboard_descriptor_writes_info[3];
 
@@ -1375,7 +1308,7 @@ void ParticlePass::prepareUniformBuffer() {
     float rnd1        = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
     float rnd2        = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
     m_ubo.pack        = Vector4 {rnd0, static_cast<float>(m_rhi->getCurrentFrameIndex()), rnd1, rnd2};
-    m_ubo.xemit_count = 100000;
+    m_ubo.xemit_count = global_res.m_emit_count;
 
     m_viewport_params = *m_rhi->getSwapchainInfo().viewport;
     m_ubo.viewport.x  = m_viewport_params.x;
@@ -1443,9 +1376,8 @@ void ParticlePass::updateDescriptorSet() {
                 descriptorset.descriptorCount        = 1;
             }
 
-            RHIDescriptorBufferInfo positionBufferDescriptor = {
-                m_emitter_buffer_batches[eid].m_position_device_buffer, 0, RHI_WHOLE_SIZE
-            };
+            RHIDescriptorBufferInfo positionBufferDescriptor = m_particle_buffer_pool.getDescriptorBufferInfo(
+                m_emitter_buffer_batches[eid].m_particle_allocation, ParticleBufferPool::_particle_stream_simulate);
             {
                 RHIWriteDescriptorSet &descriptorset = computeWriteDescriptorSets[1];
                 descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1482,9 +1414,8 @@ void ParticlePass::updateDescriptorSet() {
                 descriptorset.descriptorCount        = 1;
             }
 
-            RHIDescriptorBufferInfo aliveListBufferDescriptor = {
-                m_emitter_buffer_batches[eid].m_alive_list_buffer, 0, RHI_WHOLE_SIZE
-            };
+            RHIDescriptorBufferInfo aliveListBufferDescriptor = m_particle_buffer_pool.getDescriptorBufferInfo(
+                m_emitter_buffer_batches[eid].m_particle_allocation, ParticleBufferPool::_particle_stream_alive_list);
             {
                 RHIWriteDescriptorSet &descriptorset = computeWriteDescriptorSets[4];
                 descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1495,9 +1426,8 @@ void ParticlePass::updateDescriptorSet() {
                 descriptorset.descriptorCount        = 1;
             }
 
-            RHIDescriptorBufferInfo deadListBufferDescriptor = {
-                m_emitter_buffer_batches[eid].m_dead_list_buffer, 0, RHI_WHOLE_SIZE
-            };
+            RHIDescriptorBufferInfo deadListBufferDescriptor = m_particle_buffer_pool.getDescriptorBufferInfo(
+                m_emitter_buffer_batches[eid].m_particle_allocation, ParticleBufferPool::_particle_stream_dead_list);
             {
                 RHIWriteDescriptorSet &descriptorset = computeWriteDescriptorSets[5];
                 descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1508,9 +1438,8 @@ void ParticlePass::updateDescriptorSet() {
                 descriptorset.descriptorCount        = 1;
             }
 
-            RHIDescriptorBufferInfo aliveListNextBufferDescriptor = {
-                m_emitter_buffer_batches[eid].m_alive_list_next_buffer, 0, RHI_WHOLE_SIZE
-            };
+            RHIDescriptorBufferInfo aliveListNextBufferDescriptor = m_particle_buffer_pool.getDescriptorBufferInfo(
+                m_emitter_buffer_batches[eid].m_particle_allocation, ParticleBufferPool::_particle_stream_alive_list_next);
             {
                 RHIWriteDescriptorSet &descriptorset = computeWriteDescriptorSets[6];
                 descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1547,9 +1476,8 @@ void ParticlePass::updateDescriptorSet() {
                 descriptorset.descriptorCount        = 1;
             }
 
-            RHIDescriptorBufferInfo positionRenderbufferDescriptor = {
-                m_emitter_buffer_batches[eid].m_position_render_buffer, 0, RHI_WHOLE_SIZE
-            };
+            RHIDescriptorBufferInfo positionRenderbufferDescriptor = m_particle_buffer_pool.getDescriptorBufferInfo(
+                m_emitter_buffer_batches[eid].m_particle_allocation, ParticleBufferPool::_particle_stream_render);
             {
                 RHIWriteDescriptorSet &descriptorset = computeWriteDescriptorSets[9];
                 descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
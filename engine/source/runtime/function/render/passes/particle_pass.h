@@ -2,6 +2,7 @@
 
 #include "runtime/function/particle/particle_common.h"
 #include "runtime/function/particle/particle_manager.h"
+#include "runtime/function/render/particle_buffer_pool.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
 
@@ -12,34 +13,24 @@ struct ParticlePassInitInfo : RenderPassInitInfo {
 
 class ParticleEmitterBufferBatch {
 public:
-    RHIBuffer* m_position_render_buffer = nullptr;
-    RHIBuffer* m_position_device_buffer = nullptr;
-    RHIBuffer* m_position_host_buffer = nullptr;
     RHIBuffer* m_counter_device_buffer = nullptr;
-    RHIBuffer* m_counter_host_buffer = nullptr;
     RHIBuffer* m_indirect_dispatch_argument_buffer = nullptr;
-    RHIBuffer* m_alive_list_buffer = nullptr;
-    RHIBuffer* m_alive_list_next_buffer = nullptr;
-    RHIBuffer* m_dead_list_buffer = nullptr;
     RHIBuffer* m_particle_component_res_buffer = nullptr;
 
-    RHIDeviceMemory* m_counter_host_memory = nullptr;
-    RHIDeviceMemory* m_position_host_memory = nullptr;
-    RHIDeviceMemory* m_position_device_memory = nullptr;
     RHIDeviceMemory* m_counter_device_memory = nullptr;
     RHIDeviceMemory* m_indirect_dispatch_argument_memory = nullptr;
-    RHIDeviceMemory* m_alive_list_memory = nullptr;
-    RHIDeviceMemory* m_alive_list_next_memory = nullptr;
-    RHIDeviceMemory* m_dead_list_memory = nullptr;
     RHIDeviceMemory* m_particle_component_res_memory = nullptr;
-    RHIDeviceMemory* m_position_render_memory = nullptr;
+
+    // particles, render particles, alive and dead lists, sized by calculateEmitterCapacity
+    ParticleBufferPool::Allocation m_particle_allocation;
 
     void* m_emitter_desc_mapped {nullptr};
 
     ParticleEmitterDesc m_emitter_desc;
 
-    uint32_t m_num_particle {0};
-    void freeUpBatch(std::shared_ptr<RHI> rhi);
+    // 以 emitter 位置为中心，粒子可能到达的范围，用于剔除
+    float m_bounding_radius {0.0f};
+    void freeUpBatch(std::shared_ptr<RHI> rhi, ParticleBufferPool &particle_buffer_pool);
 };
 
 class ParticlePass : public RenderPass {
@@ -49,7 +40,10 @@ public:
     void updateAfterFramebufferRecreate();
     void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
 
-    void simulate();
+    // 只在 submitRendering 成功提交后调用，等待 submitted_frame_index 上的 texture copy semaphore
+    void simulate(uint8_t submitted_frame_index);
+    // 不模拟，只提交一次空的 compute 来消耗 texture copy semaphore
+    void skipSimulation(uint8_t submitted_frame_index);
     void copyNormalAndDepthImage();
     void createEmitter(int id, const ParticleEmitterDesc &desc);
     void initializeEmitters();
@@ -59,11 +53,16 @@ public:
     void setRenderCommandBufferHandle(RHICommandBuffer* command_buffer);
     void setRenderPassHandle(RHIRenderPass* render_pass);
     void setEmitterCount(int count);
+    // 释放所有 emitter 的 buffer 和 buffer pool 的内存，在 RHI 销毁之前调用
+    void clear();
     void setTickIndices(const std::vector<ParticleEmitterID> &tick_indices);
     void setTransformIndices(const std::vector<ParticleEmitterTransformDesc> &transform_indices);
     RHICommandBuffer* getRenderCommandBufferHandle() { return m_render_command_buffer; }
 
 private:
+    void waitForSimulation();
+    float calculateEmitterBoundingRadius(const ParticleEmitterDesc &desc, const Vector3 &gravity);
+    uint32_t calculateEmitterCapacity(const ParticleEmitterDesc &desc);
     void updateUniformBuffer();
     void updateEmitterTransform();
 
@@ -82,7 +81,6 @@ private:
 
     RHICommandBuffer* m_compute_command_buffer = nullptr;
     RHICommandBuffer* m_render_command_buffer = nullptr;
-    RHICommandBuffer* m_copy_command_buffer = nullptr;
 
     RHIBuffer* m_scene_uniform_buffer = nullptr;
     RHIBuffer* m_compute_uniform_buffer = nullptr;
@@ -92,6 +90,9 @@ private:
 
     RHIFence* m_fence = nullptr;
 
+    // 模拟完成 -> 下一帧渲染开始
+    RHISemaphore* m_simulate_finished_semaphore = nullptr;
+
     RHIImage*        m_src_depth_image = nullptr;
     RHIImage*        m_dst_normal_image = nullptr;
     RHIImage*        m_src_normal_image = nullptr;
@@ -151,10 +152,13 @@ private:
     // indirect dispath parameter offset
     static const uint32_t s_argument_offset_emit     = 0;
     static const uint32_t s_argument_offset_simulate = s_argument_offset_emit + sizeof(uvec4);
+    static const uint32_t s_argument_offset_draw     = s_argument_offset_simulate + 2 * sizeof(uvec4);
     struct IndirectArgumemt {
         uvec4 emit_argument;
         uvec4 simulate_argument;
         int   alive_flap_bit;
+        int   padding[3];
+        uvec4 draw_argument; // VkDrawIndirectCommand
     };
 
     struct ParticleCounter {
@@ -165,6 +169,7 @@ private:
     };
 
     std::vector<ParticleEmitterBufferBatch> m_emitter_buffer_batches;
+    ParticleBufferPool                      m_particle_buffer_pool;
     std::shared_ptr<ParticleManager>        m_particle_manager;
 
     DefaultRNG m_random_engine;
@@ -173,8 +178,14 @@ private:
 
     static constexpr bool s_verbose_particle_alive_info {false};
 
+    // 小 emitter 共用一个 block，超过 block 大小的 emitter 单独分配
+    static constexpr uint32_t s_particle_pool_block_capacity {65536};
+
     std::vector<ParticleEmitterID> m_emitter_tick_indices;
 
+    // 已提交但 CPU 尚未确认完成的模拟
+    bool m_is_simulation_pending {false};
+
     std::vector<ParticleEmitterTransformDesc> m_emitter_transform_indices;
 };
 } // namespace Piccolo
@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/pick_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
@@ -11,7 +13,7 @@
 
 
 
-#include <map>
+#include <algorithm>
 #include <stdexcept>
 
 namespace Piccolo {
@@ -27,6 +29,7 @@ void PickPass::initialize(const RenderPassInitInfo* init_info) {
     setupDescriptorSetLayout();
     setupPipeline();
     setupDescriptorSet();
+    setupReadbackBuffer();
 }
 void PickPass::postInitialize() {}
 void PickPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource) {
@@ -38,7 +41,6 @@ void PickPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resour
         _mesh_inefficient_pick_perframe_storage_buffer_object.rt_height = m_rhi->getSwapchainInfo().extent.height;
     }
 }
-void PickPass::draw() {}
 void PickPass::setupAttachments() {
     m_framebuffer.attachments.resize(1);
     m_framebuffer.attachments[0].format = RHI_FORMAT_R32_UINT;
@@ -70,7 +72,7 @@ void PickPass::setupRenderPass() {
     color_attachment_description.storeOp        = RHI_ATTACHMENT_STORE_OP_STORE;
     color_attachment_description.stencilLoadOp  = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
     color_attachment_description.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
-    color_attachment_description.initialLayout  = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment_description.initialLayout  = RHI_IMAGE_LAYOUT_UNDEFINED;
     color_attachment_description.finalLayout    = RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 
     RHIAttachmentDescription depth_attachment_description {};
@@ -99,14 +101,36 @@ void PickPass::setupRenderPass() {
     subpass.pColorAttachments       = &color_attachment_reference;
     subpass.pDepthStencilAttachment = &depth_attachment_reference;
 
+    // 录制在本帧的 command buffer 中：depth 与上一帧粒子的复制、本帧的 main camera pass 共用，
+    // color 结束后被复制到 readback buffer
+    RHISubpassDependency dependencies[2] {};
+    dependencies[0].srcSubpass      = RHI_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass      = 0;
+    dependencies[0].srcStageMask    = RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                      RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[0].dstStageMask    = RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[0].srcAccessMask   = RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | RHI_ACCESS_TRANSFER_READ_BIT;
+    dependencies[0].dstAccessMask   = RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                      RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    dependencies[1].srcSubpass      = 0;
+    dependencies[1].dstSubpass      = RHI_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask    = RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].dstStageMask    = RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[1].srcAccessMask   = RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask   = RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                      RHI_ACCESS_TRANSFER_READ_BIT;
+    dependencies[1].dependencyFlags = 0;
+
     RHIRenderPassCreateInfo renderpass_create_info {};
     renderpass_create_info.sType           = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderpass_create_info.attachmentCount = sizeof(attachments) / sizeof(attachments[0]);
     renderpass_create_info.pAttachments    = attachments;
     renderpass_create_info.subpassCount    = 1;
     renderpass_create_info.pSubpasses      = &subpass;
-    renderpass_create_info.dependencyCount = 0;
-    renderpass_create_info.pDependencies   = NULL;
+    renderpass_create_info.dependencyCount = sizeof(dependencies) / sizeof(dependencies[0]);
+    renderpass_create_info.pDependencies   = dependencies;
 
     if (m_rhi->createRenderPass(&renderpass_create_info, m_framebuffer.render_pass) != RHI_SUCCESS)
         throw std::runtime_error("create inefficient pick render pass");
@@ -299,7 +323,7 @@ void PickPass::setupPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline) != RHI_SUCCESS)
+    if (m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline) != RHI_SUCCESS)
         throw std::runtime_error("create mesh inefficient pick graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -378,6 +402,24 @@ void PickPass::setupDescriptorSet() {
                                 mesh_descriptor_writes_info,
                                 0,
                                 NULL);
+
+    for (uint32_t i = 0; i < sizeof(mesh_descriptor_writes_info) / sizeof(mesh_descriptor_writes_info[0]); ++i)
+        registerRingBufferBinding(m_descriptor_infos[0].descriptor_set,
+                                  mesh_descriptor_writes_info[i].dstBinding,
+                                  mesh_descriptor_writes_info[i].pBufferInfo->range);
+}
+void PickPass::setupReadbackBuffer() {
+    // 每个 frame in flight 一个 uint32_t，常驻映射
+    RHIDeviceSize buffer_size = sizeof(uint32_t) * m_rhi->getMaxFramesInFlight();
+    m_rhi->createBuffer(buffer_size,
+                        RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        m_readback_buffer,
+                        m_readback_buffer_memory);
+    if (!m_rhi->mapMemory(m_readback_buffer_memory, 0, buffer_size, 0, reinterpret_cast<void**>(&m_readback_data)))
+        throw std::runtime_error("map pick readback buffer");
+
+    m_readback_callbacks.resize(m_rhi->getMaxFramesInFlight());
 }
 void PickPass::recreateFramebuffer() {
     for (size_t i = 0; i < m_framebuffer.attachments.size(); i++) {
@@ -390,367 +432,207 @@ void PickPass::recreateFramebuffer() {
     setupAttachments();
     setupFramebuffer();
 }
-uint32_t PickPass::pick(const Vector2 &picked_uv) {
-    uint32_t pixel_x =
-        static_cast<uint32_t>(picked_uv.x * m_rhi->getSwapchainInfo().viewport->width + m_rhi->getSwapchainInfo().viewport->x);
-    uint32_t pixel_y =
-        static_cast<uint32_t>(picked_uv.y * m_rhi->getSwapchainInfo().viewport->height + m_rhi->getSwapchainInfo().viewport->y);
-    uint32_t picked_pixel_index = m_rhi->getSwapchainInfo().extent.width * pixel_y + pixel_x;
-    if (pixel_x >= m_rhi->getSwapchainInfo().extent.width || pixel_y >= m_rhi->getSwapchainInfo().extent.height)
-        return 0;
-
-    struct MeshNode {
-        const Matrix4x4* model_matrix {nullptr};
-        const Matrix4x4* joint_matrices {nullptr};
-        uint32_t         joint_count {0};
-        uint32_t         node_id;
-    };
-
-    std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
-
-    // reorganize mesh
-    for (RenderMeshNode &node : * (m_visible_nodes.p_main_camera_visible_mesh_nodes)) {
-        auto &mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-        auto &model_nodes    = mesh_instanced[node.ref_mesh];
-
-        MeshNode temp;
-        temp.model_matrix = node.model_matrix;
-        temp.node_id      = node.node_id;
-        if (node.ref_mesh->enable_vertex_blending) {
-            temp.joint_matrices = node.joint_matrices;
-            temp.joint_count    = node.joint_count;
-        }
+void PickPass::requestPick(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked) {
+    m_pending_pick_uv       = picked_uv;
+    m_pending_pick_callback = std::move(on_picked);
+}
 
-        model_nodes.push_back(temp);
+// 在 shadow pass 之后、main camera pass 之前录制到本帧的 command buffer 中，
+// 只渲染光标所在的一个像素，并把它复制到当前 frame index 的 readback slot
+void PickPass::draw() {
+    PROFILE_SCOPE("PickPass::draw");
+
+    // waitForFences 之后，当前 frame index 上一次提交的复制已经完成
+    uint8_t frame_index = m_rhi->getCurrentFrameIndex();
+    if (m_readback_callbacks[frame_index]) {
+        uint32_t node_id = m_readback_data[frame_index];
+        std::function<void(uint32_t)> on_picked = std::move(m_readback_callbacks[frame_index]);
+        m_readback_callbacks[frame_index] = nullptr;
+        on_picked(node_id);
     }
 
-    m_rhi->prepareContext();
-
-    // reset storage buffer offset
-    m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()];
-
-    m_rhi->waitForFences();
-
-    m_rhi->resetCommandPool();
-
-    RHICommandBufferBeginInfo command_buffer_begin_info {};
-    command_buffer_begin_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    command_buffer_begin_info.flags            = 0;
-    command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-    bool res_begin_command_buffer = m_rhi->beginCommandBufferPFN(
-                                        m_rhi->getCurrentCommandBuffer(), &command_buffer_begin_info);
-    assert(RHI_SUCCESS == res_begin_command_buffer);
-
-    {
-        RHIImageMemoryBarrier transfer_to_render_barrier {};
-        transfer_to_render_barrier.sType               = RHI_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        transfer_to_render_barrier.pNext               = nullptr;
-        transfer_to_render_barrier.srcAccessMask       = 0;
-        transfer_to_render_barrier.dstAccessMask       = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        transfer_to_render_barrier.oldLayout           = RHI_IMAGE_LAYOUT_UNDEFINED;
-        transfer_to_render_barrier.newLayout           = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        transfer_to_render_barrier.srcQueueFamilyIndex = m_rhi->getQueueFamilyIndices().graphics_family.value();
-        transfer_to_render_barrier.dstQueueFamilyIndex = m_rhi->getQueueFamilyIndices().graphics_family.value();
-        transfer_to_render_barrier.image               = m_framebuffer.attachments[0].image;
-        transfer_to_render_barrier.subresourceRange = { RHI_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
-        m_rhi->cmdPipelineBarrier(m_rhi->getCurrentCommandBuffer(),
-                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                  0,
-                                  0,
-                                  nullptr,
-                                  0,
-                                  nullptr,
-                                  1,
-                                  &transfer_to_render_barrier);
+    if (!m_pending_pick_callback)
+        return;
+
+    const RHIViewport* viewport = m_rhi->getSwapchainInfo().viewport;
+    const RHIExtent2D  extent   = m_rhi->getSwapchainInfo().extent;
+    float pixel_x = m_pending_pick_uv.x * viewport->width + viewport->x;
+    float pixel_y = m_pending_pick_uv.y * viewport->height + viewport->y;
+    if (pixel_x < 0.0f || pixel_y < 0.0f || pixel_x >= extent.width || pixel_y >= extent.height) {
+        std::function<void(uint32_t)> on_picked = std::move(m_pending_pick_callback);
+        m_pending_pick_callback = nullptr;
+        on_picked(0);
+        return;
     }
 
-    m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-    m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
+    // perframe storage buffer
+    auto perframe_allocation = allocateRingBufferSpace<MeshInefficientPickPerframeStorageBufferObject>();
+    if (!perframe_allocation.data_ptr)
+        return; // 留到下一帧再录制
+    *perframe_allocation.data_ptr = _mesh_inefficient_pick_perframe_storage_buffer_object;
+    uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
+
+    m_readback_callbacks[frame_index] = std::move(m_pending_pick_callback);
+    m_pending_pick_callback = nullptr;
+
+    // pick 不需要 material，按 mesh 排序后相同 mesh 的 node 连续排列
+    m_pick_mesh_nodes.clear();
+    for (const RenderMeshNode &node : *(m_visible_nodes.p_main_camera_visible_mesh_nodes))
+        m_pick_mesh_nodes.push_back(&node);
+    std::sort(m_pick_mesh_nodes.begin(),
+              m_pick_mesh_nodes.end(),
+              [](const RenderMeshNode* lhs, const RenderMeshNode* rhs) { return lhs->ref_mesh < rhs->ref_mesh; });
+
+    RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+
+    float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    m_rhi->pushEvent(command_buffer, "Mesh Inefficient Pick", color);
+
+    // render area 和 scissor 都只覆盖光标所在的像素，clear 也只作用于这个像素
+    RHIRect2D pick_rect {};
+    pick_rect.offset = {static_cast<int32_t>(pixel_x), static_cast<int32_t>(pixel_y)};
+    pick_rect.extent = {1, 1};
 
     RHIRenderPassBeginInfo renderpass_begin_info {};
-    renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-    renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-    renderpass_begin_info.renderArea.offset = {0, 0};
-    renderpass_begin_info.renderArea.extent = m_rhi->getSwapchainInfo().extent;
+    renderpass_begin_info.sType       = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderpass_begin_info.renderPass  = m_framebuffer.render_pass;
+    renderpass_begin_info.framebuffer = m_framebuffer.framebuffer;
+    renderpass_begin_info.renderArea  = pick_rect;
 
     RHIClearColorValue color_value         = {0, 0, 0, 0};
     RHIClearValue      clearValues[2]      = {color_value, {1.0f, 0}};
     renderpass_begin_info.clearValueCount  = 2;
     renderpass_begin_info.pClearValues     = clearValues;
 
-    m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(),
-                                 &renderpass_begin_info,
-                                 RHI_SUBPASS_CONTENTS_INLINE); // no second buffer
-
-    float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Mesh Inefficient Pick", color);
-
-    m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(),
-                              RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                              m_render_pipelines[0].pipeline);
-    m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-    m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
+    m_rhi->cmdBeginRenderPassPFN(command_buffer, &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
+
+    m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
+    m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, viewport);
+    m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, &pick_rect);
+
+    uint32_t drawcall_max_instance_count =
+        (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
+         sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices[0]));
+
+    size_t node_count = m_pick_mesh_nodes.size();
+    for (size_t first = 0; first < node_count;) {
+        VulkanMesh &mesh = *m_pick_mesh_nodes[first]->ref_mesh;
+
+        // 同一 mesh 的连续 node 中不超过一个 drawcall 的容量
+        size_t last = first + 1;
+        while (last < node_count && last - first < drawcall_max_instance_count &&
+                m_pick_mesh_nodes[last]->ref_mesh == &mesh)
+            ++last;
+        uint32_t current_instance_count = static_cast<uint32_t>(last - first);
+        const RenderMeshNode* const* mesh_nodes = &m_pick_mesh_nodes[first];
+        first = last;
+
+        // bind per mesh
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_render_pipelines[0].layout,
+                                        1,
+                                        1,
+                                        &mesh.mesh_vertex_blending_descriptor_set,
+                                        0,
+                                        NULL);
+
+        RHIBuffer* vertex_buffers[] = { mesh.mesh_vertex_position_buffer };
+        RHIDeviceSize offsets[] = { 0 };
+        m_rhi->cmdBindVertexBuffersPFN(command_buffer, 0, 1, vertex_buffers, offsets);
+        m_rhi->cmdBindIndexBufferPFN(command_buffer, mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+        // perdrawcall storage buffer
+        auto perdrawcall_allocation = allocateRingBufferSpace<MeshInefficientPickPerdrawcallStorageBufferObject>();
+        if (!perdrawcall_allocation.data_ptr)
+            continue;
+        uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
+
+        MeshInefficientPickPerdrawcallStorageBufferObject &perdrawcall_storage_buffer_object =
+            *perdrawcall_allocation.data_ptr;
+        for (uint32_t i = 0; i < current_instance_count; ++i) {
+            perdrawcall_storage_buffer_object.model_matrices[i] = *mesh_nodes[i]->model_matrix;
+            perdrawcall_storage_buffer_object.node_ids[i]       = mesh_nodes[i]->node_id;
+        }
 
-    // perframe storage buffer
-    uint32_t perframe_dynamic_offset =
-        roundUp(m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-    m_global_render_resource->_storage_buffer
-    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-        perframe_dynamic_offset + sizeof(MeshInefficientPickPerframeStorageBufferObject);
-    assert(m_global_render_resource->_storage_buffer
-           ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-           (m_global_render_resource->_storage_buffer
-            ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-            m_global_render_resource->_storage_buffer
-            ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-    (*reinterpret_cast<MeshInefficientPickPerframeStorageBufferObject*>(
-         reinterpret_cast<uintptr_t>(
-             m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-         perframe_dynamic_offset)) = _mesh_inefficient_pick_perframe_storage_buffer_object;
-
-    for (auto &pair1 : main_camera_mesh_drawcall_batch) {
-        VulkanPBRMaterial &material       = (*pair1.first);
-        auto              &mesh_instanced = pair1.second;
-
-        // TODO: render from near to far
-
-        for (auto &pair2 : mesh_instanced) {
-            VulkanMesh &mesh       = (*pair2.first);
-            auto       &mesh_nodes = pair2.second;
-
-            uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-            if (total_instance_count > 0) {
-                // bind per mesh
-                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                m_render_pipelines[0].layout,
-                                                1,
-                                                1,
-                                                &mesh.mesh_vertex_blending_descriptor_set,
-                                                0,
-                                                NULL);
-
-                RHIBuffer* vertex_buffers[] = { mesh.mesh_vertex_position_buffer };
-                RHIDeviceSize offsets[] = { 0 };
-                m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
-                                               0,
-                                               1,
-                                               vertex_buffers,
-                                               offsets);
-                m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(),
-                                             mesh.mesh_index_buffer,
-                                             0,
-                                             RHI_INDEX_TYPE_UINT16);
-
-                uint32_t drawcall_max_instance_count =
-                    (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
-                     sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices[0]));
-                uint32_t drawcall_count =
-                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index) {
-                    uint32_t current_instance_count =
-                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                         drawcall_max_instance_count) ?
-                        (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                        drawcall_max_instance_count;
-
-                    // perdrawcall storage buffer
-                    uint32_t perdrawcall_dynamic_offset =
-                        roundUp(m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                    m_global_render_resource->_storage_buffer
-                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                        perdrawcall_dynamic_offset + sizeof(MeshInefficientPickPerdrawcallStorageBufferObject);
-                    assert(m_global_render_resource->_storage_buffer
-                           ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                           (m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                            m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                    MeshInefficientPickPerdrawcallStorageBufferObject &perdrawcall_storage_buffer_object =
-                        (*reinterpret_cast<MeshInefficientPickPerdrawcallStorageBufferObject*>(
-                             reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                         ._global_upload_ringbuffer_memory_pointer) +
-                             perdrawcall_dynamic_offset));
-                    for (uint32_t i = 0; i < current_instance_count; ++i) {
-                        perdrawcall_storage_buffer_object.model_matrices[i] =
-                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                        perdrawcall_storage_buffer_object.node_ids[i] =
-                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].node_id;
-                    }
-
-                    // per drawcall vertex blending storage buffer
-                    uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                    if (mesh.enable_vertex_blending) {
-                        per_drawcall_vertex_blending_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                            per_drawcall_vertex_blending_dynamic_offset +
-                            sizeof(MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                               (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                        MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject &
-                        per_drawcall_vertex_blending_storage_buffer_object =
-                            (*reinterpret_cast <
-                             MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject* > (
-                                 reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                             ._global_upload_ringbuffer_memory_pointer) +
-                                 per_drawcall_vertex_blending_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i) {
-                            for (uint32_t j = 0;
-                                 j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                 ++j) {
-                                per_drawcall_vertex_blending_storage_buffer_object
-                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices[j];
-                            }
-                        }
-                    } else
-                        per_drawcall_vertex_blending_dynamic_offset = 0;
-
-                    // bind perdrawcall
-                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                   perdrawcall_dynamic_offset,
-                                                   per_drawcall_vertex_blending_dynamic_offset
-                                                  };
-                    m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                    RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                    m_render_pipelines[0].layout,
-                                                    0,
-                                                    1,
-                                                    &m_descriptor_infos[0].descriptor_set,
-                                                    sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0]),
-                                                    dynamic_offsets);
-
-                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                             mesh.mesh_index_count,
-                                             current_instance_count,
-                                             0,
-                                             0,
-                                             0);
+        // per drawcall vertex blending storage buffer
+        uint32_t per_drawcall_vertex_blending_dynamic_offset;
+        if (mesh.enable_vertex_blending) {
+            auto per_drawcall_vertex_blending_allocation =
+                allocateRingBufferSpace<MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject>();
+            if (!per_drawcall_vertex_blending_allocation.data_ptr)
+                continue;
+            per_drawcall_vertex_blending_dynamic_offset = per_drawcall_vertex_blending_allocation.dynamic_offset;
+
+            MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject &
+            per_drawcall_vertex_blending_storage_buffer_object = *per_drawcall_vertex_blending_allocation.data_ptr;
+            for (uint32_t i = 0; i < current_instance_count; ++i) {
+                for (uint32_t j = 0; j < mesh_nodes[i]->joint_count; ++j) {
+                    per_drawcall_vertex_blending_storage_buffer_object
+                    .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] = mesh_nodes[i]->joint_matrices[j];
                 }
             }
-        }
+        } else
+            per_drawcall_vertex_blending_dynamic_offset = 0;
+
+        // bind perdrawcall
+        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                       perdrawcall_dynamic_offset,
+                                       per_drawcall_vertex_blending_dynamic_offset
+                                      };
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_render_pipelines[0].layout,
+                                        0,
+                                        1,
+                                        &m_descriptor_infos[0].descriptor_set,
+                                        sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0]),
+                                        dynamic_offsets);
+
+        m_rhi->cmdDrawIndexedPFN(command_buffer, mesh.mesh_index_count, current_instance_count, 0, 0, 0);
     }
 
-    m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
-
-    // end render pass
-    m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
-
-    // end command buffer
-    bool res_end_command_buffer = m_rhi->endCommandBufferPFN(m_rhi->getCurrentCommandBuffer());
-    assert(RHI_SUCCESS == res_end_command_buffer);
-
-    bool res_reset_fences = m_rhi->resetFencesPFN(1, &m_rhi->getFenceList()[m_rhi->getCurrentFrameIndex()]);
-    assert(RHI_SUCCESS == res_reset_fences);
-
-    RHISubmitInfo submit_info = {};
-    submit_info.sType = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.waitSemaphoreCount = 0;
-    submit_info.pWaitSemaphores = NULL;
-    submit_info.pWaitDstStageMask = 0;
-    submit_info.commandBufferCount = 1;
-    RHICommandBuffer* commandBuffer = m_rhi->getCurrentCommandBuffer();
-    submit_info.pCommandBuffers = &commandBuffer;
-    submit_info.signalSemaphoreCount = 0;
-    submit_info.pSignalSemaphores = NULL;
-
-    bool res_queue_submit = m_rhi->queueSubmit(m_rhi->getGraphicsQueue(),
-                            1,
-                            &submit_info,
-                            m_rhi->getFenceList()[m_rhi->getCurrentFrameIndex()]);
-    assert(RHI_SUCCESS == res_queue_submit);
-
-    m_rhi->setCurrentFrameIndex((m_rhi->getCurrentFrameIndex() + 1) % m_rhi->getMaxFramesInFlight());
-
-    // implicit host read barrier
-    bool res_wait_for_fences = m_rhi->waitForFencesPFN(m_rhi->getMaxFramesInFlight(),
-                               m_rhi->getFenceList(),
-                               RHI_TRUE,
-                               UINT64_MAX);
-    assert(RHI_SUCCESS == res_wait_for_fences);
-
-    auto command_buffer = m_rhi->beginSingleTimeCommands();
+    // end render pass，subpass dependency 保证 color 写入对下面的复制可见
+    m_rhi->cmdEndRenderPassPFN(command_buffer);
 
     RHIBufferImageCopy region {};
-    region.bufferOffset                    = 0;
+    region.bufferOffset                    = sizeof(uint32_t) * frame_index;
     region.bufferRowLength                 = 0;
     region.bufferImageHeight               = 0;
     region.imageSubresource.aspectMask     = RHI_IMAGE_ASPECT_COLOR_BIT;
     region.imageSubresource.mipLevel       = 0;
     region.imageSubresource.baseArrayLayer = 0;
     region.imageSubresource.layerCount     = 1;
-    region.imageOffset                     = {0, 0, 0};
-    region.imageExtent = { m_rhi->getSwapchainInfo().extent.width, m_rhi->getSwapchainInfo().extent.height, 1 };
+    region.imageOffset                     = {pick_rect.offset.x, pick_rect.offset.y, 0};
+    region.imageExtent                     = {1, 1, 1};
+    m_rhi->cmdCopyImageToBuffer(command_buffer,
+                                m_framebuffer.attachments[0].image,
+                                RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                m_readback_buffer,
+                                1,
+                                &region);
 
-    uint32_t   buffer_size = m_rhi->getSwapchainInfo().extent.width * m_rhi->getSwapchainInfo().extent.height * 4;
-    RHIBuffer* inefficient_staging_buffer;
-    RHIDeviceMemory* inefficient_staging_buffer_memory;
-    m_rhi->createBuffer(buffer_size,
-                        RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                        RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                        inefficient_staging_buffer,
-                        inefficient_staging_buffer_memory);
-
-    RHIImageMemoryBarrier copy_to_buffer_barrier {};
-    copy_to_buffer_barrier.sType               = RHI_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    copy_to_buffer_barrier.pNext               = nullptr;
-    copy_to_buffer_barrier.srcAccessMask       = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    copy_to_buffer_barrier.dstAccessMask       = RHI_ACCESS_TRANSFER_READ_BIT;
-    copy_to_buffer_barrier.oldLayout           = RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    copy_to_buffer_barrier.newLayout           = RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    copy_to_buffer_barrier.srcQueueFamilyIndex = m_rhi->getQueueFamilyIndices().graphics_family.value();
-    copy_to_buffer_barrier.dstQueueFamilyIndex = m_rhi->getQueueFamilyIndices().graphics_family.value();
-    copy_to_buffer_barrier.image               = m_framebuffer.attachments[0].image;
-    copy_to_buffer_barrier.subresourceRange    = { RHI_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    // frame fence 之后 host 读取复制的结果
+    RHIBufferMemoryBarrier host_read_barrier {};
+    host_read_barrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    host_read_barrier.srcAccessMask       = RHI_ACCESS_TRANSFER_WRITE_BIT;
+    host_read_barrier.dstAccessMask       = RHI_ACCESS_HOST_READ_BIT;
+    host_read_barrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+    host_read_barrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+    host_read_barrier.buffer              = m_readback_buffer;
+    host_read_barrier.offset              = region.bufferOffset;
+    host_read_barrier.size                = sizeof(uint32_t);
     m_rhi->cmdPipelineBarrier(command_buffer,
-                              RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                               RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                              RHI_PIPELINE_STAGE_HOST_BIT,
                               0,
                               0,
                               nullptr,
-                              0,
-                              nullptr,
                               1,
-                              &copy_to_buffer_barrier);
-
-    m_rhi->cmdCopyImageToBuffer(command_buffer,
-                                m_framebuffer.attachments[0].image,
-                                RHI_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                inefficient_staging_buffer,
-                                1,
-                                &region);
-
-    m_rhi->endSingleTimeCommands(command_buffer);
-
-    uint32_t* data = nullptr;
-    m_rhi->mapMemory(inefficient_staging_buffer_memory, 0, buffer_size, 0, (void**)&data);
-
-    uint32_t node_id = data[picked_pixel_index];
-    m_rhi->unmapMemory(inefficient_staging_buffer_memory);
-
-    m_rhi->destroyBuffer(inefficient_staging_buffer);
-    m_rhi->freeMemory(inefficient_staging_buffer_memory);
+                              &host_read_barrier,
+                              0,
+                              nullptr);
 
-    return node_id;
+    m_rhi->popEvent(command_buffer);
 }
 } // namespace Piccolo
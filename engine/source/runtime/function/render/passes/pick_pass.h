@@ -3,6 +3,9 @@
 #include "runtime/core/math/vector2.h"
 #include "runtime/function/render/render_pass.h"
 
+#include <functional>
+#include <vector>
+
 namespace Piccolo {
 class RenderResourceBase;
 
@@ -17,8 +20,9 @@ public:
     void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
     void draw() override final;
 
-    uint32_t pick(const Vector2 &picked_uv);
-    void     recreateFramebuffer();
+    // 在之后的帧中录制，结果在该帧完成后通过 on_picked 返回，不阻塞；一帧内的多次请求只保留最后一次
+    void requestPick(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked);
+    void recreateFramebuffer();
 
     MeshInefficientPickPerframeStorageBufferObject _mesh_inefficient_pick_perframe_storage_buffer_object;
 
@@ -29,6 +33,7 @@ private:
     void setupDescriptorSetLayout();
     void setupPipeline();
     void setupDescriptorSet();
+    void setupReadbackBuffer();
 
 private:
     RHIImage*        _object_id_image = nullptr;
@@ -36,5 +41,16 @@ private:
     RHIImageView*      _object_id_image_view = nullptr;
 
     RHIDescriptorSetLayout* _per_mesh_layout = nullptr;
+
+    Vector2                       m_pending_pick_uv;
+    std::function<void(uint32_t)> m_pending_pick_callback;
+
+    // 按 frame index 存放已录制的请求，该 frame index 的 fence 等待之后读取结果
+    RHIBuffer*                                 m_readback_buffer        = nullptr;
+    RHIDeviceMemory*                           m_readback_buffer_memory = nullptr;
+    uint32_t*                                  m_readback_data          = nullptr;
+    std::vector<std::function<void(uint32_t)>> m_readback_callbacks;
+
+    std::vector<const RenderMeshNode*> m_pick_mesh_nodes;
 };
 } // namespace Piccolo
@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/point_light_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
@@ -34,6 +36,8 @@ void PointLightShadowPass::preparePassData(std::shared_ptr<RenderResourceBase> r
     }
 }
 void PointLightShadowPass::draw() {
+    PROFILE_SCOPE("PointLightShadowPass::draw");
+
     float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
     m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Point Light Shadow", color);
 
@@ -350,7 +354,7 @@ void PointLightShadowPass::setupPipeline() {
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline) != RHI_SUCCESS)
+    if (m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline) != RHI_SUCCESS)
         throw std::runtime_error("create mesh point light shadow graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -443,6 +447,9 @@ void PointLightShadowPass::setupDescriptorSet() {
                                 descriptor_writes,
                                 0,
                                 NULL);
+
+    for (uint32_t i = 0; i < (sizeof(descriptor_writes) / sizeof(descriptor_writes[0])); ++i)
+        registerRingBufferBinding(descriptor_set_to_write, descriptor_writes[i].dstBinding, descriptor_writes[i].pBufferInfo->range);
 }
 void PointLightShadowPass::drawModel() {
     struct MeshNode {
@@ -493,23 +500,10 @@ void PointLightShadowPass::drawModel() {
             m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
 
         // perframe storage buffer
-        uint32_t perframe_dynamic_offset =
-            roundUp(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-
-        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-
-        assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-               (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-        MeshPointLightShadowPerframeStorageBufferObject &perframe_storage_buffer_object =
-            (*reinterpret_cast<MeshPointLightShadowPerframeStorageBufferObject*>(
-                 reinterpret_cast<uintptr_t>(
-                     m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                 perframe_dynamic_offset));
-        perframe_storage_buffer_object = m_mesh_point_light_shadow_perframe_storage_buffer_object;
+        auto perframe_allocation = allocateRingBufferSpace<MeshPointLightShadowPerframeStorageBufferObject>();
+        if (perframe_allocation.data_ptr)
+            *perframe_allocation.data_ptr = m_mesh_point_light_shadow_perframe_storage_buffer_object;
+        uint32_t perframe_dynamic_offset = perframe_allocation.dynamic_offset;
 
         for (auto &pair1 : point_lights_mesh_drawcall_batch) {
             VulkanPBRMaterial &material       = (*pair1.first);
@@ -553,25 +547,14 @@ void PointLightShadowPass::drawModel() {
                             drawcall_max_instance_count;
 
                         // perdrawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                               (m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+                        auto perdrawcall_allocation =
+                            allocateRingBufferSpace<MeshPointLightShadowPerdrawcallStorageBufferObject>();
+                        if (!perframe_allocation.data_ptr || !perdrawcall_allocation.data_ptr)
+                            continue;
+                        uint32_t perdrawcall_dynamic_offset = perdrawcall_allocation.dynamic_offset;
 
                         MeshPointLightShadowPerdrawcallStorageBufferObject &perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPointLightShadowPerdrawcallStorageBufferObject*>(
-                                 reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                             ._global_upload_ringbuffer_memory_pointer) +
-                                 perdrawcall_dynamic_offset));
+                            *perdrawcall_allocation.data_ptr;
                         for (uint32_t i = 0; i < current_instance_count; ++i) {
                             perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
                                 *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
@@ -590,28 +573,16 @@ void PointLightShadowPass::drawModel() {
                             }
                         }
                         if (mesh.enable_vertex_blending) {
-                            per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+                            auto per_drawcall_vertex_blending_allocation =
+                                allocateRingBufferSpace<MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject>();
+                            if (!per_drawcall_vertex_blending_allocation.data_ptr)
+                                continue;
+                            per_drawcall_vertex_blending_dynamic_offset =
+                                per_drawcall_vertex_blending_allocation.dynamic_offset;
 
                             MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject &
                             per_drawcall_vertex_blending_storage_buffer_object =
-                                (*reinterpret_cast <
-                                 MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject* > (
-                                     reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                 ._global_upload_ringbuffer_memory_pointer) +
-                                     per_drawcall_vertex_blending_dynamic_offset));
+                                *per_drawcall_vertex_blending_allocation.data_ptr;
                             for (uint32_t i = 0; i < current_instance_count; ++i) {
                                 if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices) {
                                     for (uint32_t j = 0;
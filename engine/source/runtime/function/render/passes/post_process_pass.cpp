@@ -1,22 +1,28 @@
-#include "runtime/function/render/passes/color_grading_pass.h"
+#include "runtime/function/render/passes/post_process_pass.h"
+
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
-#include <color_grading_frag.h>
+#include <post_process_frag.h>
 #include <post_process_vert.h>
 
 #include <stdexcept>
 
-// 以 color grading pass 为例，展示 MainCameraPass 的子 pass 的典型实现
+// 以 post process pass 为例，展示 MainCameraPass 的子 pass 的典型实现
 
 namespace Piccolo {
-void ColorGradingPass::initialize(const RenderPassInitInfo* init_info) {
+void PostProcessPass::initialize(const RenderPassInitInfo* init_info) {
     // 作为 MainCameraPass 的子 pass 的典型初始化步骤为：先 initialize 父类，再填充 init_info，然后调 4 个函数进行具体初始化操作
     RenderPass::initialize(nullptr);
 
-    const ColorGradingPassInitInfo* _init_info = static_cast<const ColorGradingPassInitInfo*>(init_info);
-    m_framebuffer.render_pass                  = _init_info->render_pass; // 会在这里拿到 color grading lut 贴图
+    const PostProcessPassInitInfo* _init_info = static_cast<const PostProcessPassInitInfo*>(init_info);
+    m_framebuffer.render_pass                 = _init_info->render_pass; // 会在这里拿到 color grading lut 贴图
+    m_enable_tone_mapping                     = _init_info->enable_tone_mapping;
+    m_enable_color_grading                    = _init_info->enable_color_grading;
+    m_enable_vignette                         = _init_info->enable_vignette;
+    m_enable_dynamic_resolution               = _init_info->enable_dynamic_resolution;
 
     setupDescriptorSetLayout();
     setupPipeline();
@@ -25,11 +31,12 @@ void ColorGradingPass::initialize(const RenderPassInitInfo* init_info) {
 }
 
 // 设置 shader 使用的描述符布局，如输入输出资源的排布和用到的纹理
-void ColorGradingPass::setupDescriptorSetLayout() {
+void PostProcessPass::setupDescriptorSetLayout() {
     m_descriptor_infos.resize(1);
 
-    // 这里用到两个 descriptor set layout，一个是 tone_mapping 的输出，现在 color_grading 的输入；一个是 color grading 所用的纹理
-    RHIDescriptorSetLayoutBinding post_process_global_layout_bindings[2] = {};
+    // 这里用到四个 binding，一个是 lighting 的输出，现在后处理的输入；一个是 color grading 所用的纹理（不开启 color grading 时 shader 不访问）；
+    // 最后两个是动态分辨率放大时采样的 lighting 输出和 viewport 信息（不开启动态分辨率时 shader 不访问）
+    RHIDescriptorSetLayoutBinding post_process_global_layout_bindings[4] = {};
 
     RHIDescriptorSetLayoutBinding &post_process_global_layout_input_attachment_binding = post_process_global_layout_bindings[0];
     post_process_global_layout_input_attachment_binding.binding         = 0;
@@ -43,6 +50,18 @@ void ColorGradingPass::setupDescriptorSetLayout() {
     post_process_global_layout_LUT_binding.descriptorCount = 1;
     post_process_global_layout_LUT_binding.stageFlags      = RHI_SHADER_STAGE_FRAGMENT_BIT;
 
+    RHIDescriptorSetLayoutBinding &post_process_global_layout_scene_color_binding = post_process_global_layout_bindings[2];
+    post_process_global_layout_scene_color_binding.binding         = 2;
+    post_process_global_layout_scene_color_binding.descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    post_process_global_layout_scene_color_binding.descriptorCount = 1;
+    post_process_global_layout_scene_color_binding.stageFlags      = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
+    RHIDescriptorSetLayoutBinding &post_process_global_layout_dynamic_resolution_binding = post_process_global_layout_bindings[3];
+    post_process_global_layout_dynamic_resolution_binding.binding         = 3;
+    post_process_global_layout_dynamic_resolution_binding.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    post_process_global_layout_dynamic_resolution_binding.descriptorCount = 1;
+    post_process_global_layout_dynamic_resolution_binding.stageFlags      = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
     RHIDescriptorSetLayoutCreateInfo post_process_global_layout_create_info;
     post_process_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     post_process_global_layout_create_info.pNext = NULL;
@@ -55,7 +74,7 @@ void ColorGradingPass::setupDescriptorSetLayout() {
 }
 
 // 设置 graphics pipeline 的相关信息，包括 shader 模块、顶点输入状态、输入装配状态、视口状态、光栅化状态、多重采样状态、颜色混合状态、深度模板状态等
-void ColorGradingPass::setupPipeline() {
+void PostProcessPass::setupPipeline() {
     m_render_pipelines.resize(1);
 
     RHIDescriptorSetLayout*      descriptorset_layouts[1] = {m_descriptor_infos[0].layout};
@@ -68,7 +87,7 @@ void ColorGradingPass::setupPipeline() {
         throw std::runtime_error("create post process pipeline layout");
 
     RHIShader* vert_shader_module = m_rhi->createShaderModule(POST_PROCESS_VERT); // 覆盖全屏的顶点着色器
-    RHIShader* frag_shader_module = m_rhi->createShaderModule(COLOR_GRADING_FRAG);
+    RHIShader* frag_shader_module = m_rhi->createShaderModule(POST_PROCESS_FRAG);
 
     RHIPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info {};
     vert_pipeline_shader_stage_create_info.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -82,6 +101,26 @@ void ColorGradingPass::setupPipeline() {
     frag_pipeline_shader_stage_create_info.module = frag_shader_module;
     frag_pipeline_shader_stage_create_info.pName  = "main";
 
+    // 与 post_process.frag 中的 constant_id 一一对应
+    RHIBool32 specialization_data[4] = {m_enable_tone_mapping ? RHI_TRUE : RHI_FALSE,
+                                        m_enable_color_grading ? RHI_TRUE : RHI_FALSE,
+                                        m_enable_vignette ? RHI_TRUE : RHI_FALSE,
+                                        m_enable_dynamic_resolution ? RHI_TRUE : RHI_FALSE};
+    RHISpecializationMapEntry        specialization_map_entries[4];
+    const RHISpecializationMapEntry* specialization_map_entry_pointers[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+        specialization_map_entries[i].constantID = i;
+        specialization_map_entries[i].offset     = sizeof(RHIBool32) * i;
+        specialization_map_entries[i].size       = sizeof(RHIBool32);
+        specialization_map_entry_pointers[i]     = &specialization_map_entries[i];
+    }
+    RHISpecializationInfo specialization_info {};
+    specialization_info.mapEntryCount = 4;
+    specialization_info.pMapEntries   = specialization_map_entry_pointers;
+    specialization_info.dataSize      = sizeof(specialization_data);
+    specialization_info.pData         = specialization_data;
+    frag_pipeline_shader_stage_create_info.pSpecializationInfo = &specialization_info;
+
     RHIPipelineShaderStageCreateInfo shader_stages[] = {vert_pipeline_shader_stage_create_info,
                                                         frag_pipeline_shader_stage_create_info
                                                        };
@@ -173,11 +212,11 @@ void ColorGradingPass::setupPipeline() {
     pipelineInfo.pDepthStencilState  = &depth_stencil_create_info;
     pipelineInfo.layout              = m_render_pipelines[0].layout;
     pipelineInfo.renderPass          = m_framebuffer.render_pass;
-    pipelineInfo.subpass             = _main_camera_subpass_color_grading;
+    pipelineInfo.subpass             = _main_camera_subpass_post_process;
     pipelineInfo.basePipelineHandle  = RHI_NULL_HANDLE;
     pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline))
+    if (RHI_SUCCESS != m_rhi->createGraphicsPipelines(m_rhi->getPipelineCache(), 1, &pipelineInfo, m_render_pipelines[0].pipeline))
         throw std::runtime_error("create post process graphics pipeline");
 
     m_rhi->destroyShaderModule(vert_shader_module);
@@ -185,7 +224,7 @@ void ColorGradingPass::setupPipeline() {
 }
 
 // 设置描述符集，绑定输入附件和 color grading LUT 贴图
-void ColorGradingPass::setupDescriptorSet() {
+void PostProcessPass::setupDescriptorSet() {
     RHIDescriptorSetAllocateInfo post_process_global_descriptor_set_alloc_info;
     post_process_global_descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     post_process_global_descriptor_set_alloc_info.pNext              = NULL;
@@ -195,10 +234,29 @@ void ColorGradingPass::setupDescriptorSet() {
 
     if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&post_process_global_descriptor_set_alloc_info, m_descriptor_infos[0].descriptor_set))
         throw std::runtime_error("allocate post process global descriptor set");
+
+    // viewport 信息每帧写入 ring buffer，只需要在这里写一次描述符
+    RHIDescriptorBufferInfo dynamic_resolution_storage_buffer_info = {};
+    dynamic_resolution_storage_buffer_info.offset = 0;
+    dynamic_resolution_storage_buffer_info.range  = sizeof(PostProcessDynamicResolutionStorageBufferObject);
+    dynamic_resolution_storage_buffer_info.buffer = m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+
+    RHIWriteDescriptorSet dynamic_resolution_write_info {};
+    dynamic_resolution_write_info.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    dynamic_resolution_write_info.pNext           = NULL;
+    dynamic_resolution_write_info.dstSet          = m_descriptor_infos[0].descriptor_set;
+    dynamic_resolution_write_info.dstBinding      = 3;
+    dynamic_resolution_write_info.dstArrayElement = 0;
+    dynamic_resolution_write_info.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    dynamic_resolution_write_info.descriptorCount = 1;
+    dynamic_resolution_write_info.pBufferInfo     = &dynamic_resolution_storage_buffer_info;
+
+    m_rhi->updateDescriptorSets(1, &dynamic_resolution_write_info, 0, NULL);
+    registerRingBufferBinding(m_descriptor_infos[0].descriptor_set, 3, dynamic_resolution_storage_buffer_info.range);
 }
 
 // 当窗口大小改变时，重新创建帧缓冲和描述符集
-void ColorGradingPass::updateAfterFramebufferRecreate(RHIImageView* input_attachment) {
+void PostProcessPass::updateAfterFramebufferRecreate(RHIImageView* input_attachment) {
     RHIDescriptorImageInfo post_process_per_frame_input_attachment_info = {};
     post_process_per_frame_input_attachment_info.sampler = m_rhi->getOrCreateDefaultSampler(Default_Sampler_Nearest);
     post_process_per_frame_input_attachment_info.imageView   = input_attachment;
@@ -210,7 +268,14 @@ void ColorGradingPass::updateAfterFramebufferRecreate(RHIImageView* input_attach
         m_global_render_resource->_color_grading_resource._color_grading_LUT_texture_image_view;
     color_grading_LUT_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    RHIWriteDescriptorSet post_process_descriptor_writes_info[2];
+    // 不开启动态分辨率时 input attachment 不能被采样，binding 2 用 LUT 贴图占位（shader 不访问）
+    RHIDescriptorImageInfo scene_color_image_info = color_grading_LUT_image_info;
+    if (m_enable_dynamic_resolution) {
+        scene_color_image_info.imageView = input_attachment;
+        scene_color_image_info.sampler   = m_rhi->getOrCreateDefaultSampler(Default_Sampler_Linear);
+    }
+
+    RHIWriteDescriptorSet post_process_descriptor_writes_info[3];
 
     RHIWriteDescriptorSet &post_process_descriptor_input_attachment_write_info =
         post_process_descriptor_writes_info[0];
@@ -233,6 +298,11 @@ void ColorGradingPass::updateAfterFramebufferRecreate(RHIImageView* input_attach
     post_process_descriptor_LUT_write_info.descriptorCount       = 1;
     post_process_descriptor_LUT_write_info.pImageInfo            = &color_grading_LUT_image_info;
 
+    RHIWriteDescriptorSet &post_process_descriptor_scene_color_write_info = post_process_descriptor_writes_info[2];
+    post_process_descriptor_scene_color_write_info            = post_process_descriptor_LUT_write_info;
+    post_process_descriptor_scene_color_write_info.dstBinding = 2;
+    post_process_descriptor_scene_color_write_info.pImageInfo = &scene_color_image_info;
+
     m_rhi->updateDescriptorSets(sizeof(post_process_descriptor_writes_info) /
                                 sizeof(post_process_descriptor_writes_info[0]),
                                 post_process_descriptor_writes_info,
@@ -240,8 +310,30 @@ void ColorGradingPass::updateAfterFramebufferRecreate(RHIImageView* input_attach
                                 NULL);
 }
 
+// 把整个 viewport 的像素映射到场景 subpass 渲染的区域，不开启动态分辨率时 shader 不访问，只绑定 offset 0
+void PostProcessPass::prepareDynamicResolutionData() {
+    m_dynamic_resolution_dynamic_offset = 0;
+    if (!m_enable_dynamic_resolution)
+        return;
+
+    auto dynamic_resolution_allocation = allocateRingBufferSpace<PostProcessDynamicResolutionStorageBufferObject>();
+    // 作为本帧第一次分配只有分片小于一个对象时才会失败，ring buffer 下一帧会扩容，这一帧仍然绘制
+    if (!dynamic_resolution_allocation.data_ptr)
+        return;
+    const RHIViewport* viewport = m_rhi->getSwapchainInfo().viewport;
+    const RHIExtent2D  extent   = m_rhi->getSwapchainInfo().extent;
+    dynamic_resolution_allocation.data_ptr->viewport       = Vector4(viewport->x, viewport->y, viewport->width, viewport->height);
+    dynamic_resolution_allocation.data_ptr->scene_viewport =
+        Vector4(m_scene_viewport.x, m_scene_viewport.y, m_scene_viewport.width, m_scene_viewport.height);
+    dynamic_resolution_allocation.data_ptr->inv_extent =
+        Vector4(1.0f / static_cast<float>(extent.width), 1.0f / static_cast<float>(extent.height), 0.0f, 0.0f);
+    m_dynamic_resolution_dynamic_offset = dynamic_resolution_allocation.dynamic_offset;
+}
+
 // 提交预先准备好的 command buffer，会在 MainCameraPass 的 draw() 函数中被调用
-void ColorGradingPass::draw() {
+void PostProcessPass::draw() {
+    PROFILE_SCOPE("PostProcessPass::draw");
+
     m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
     m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
     m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
@@ -251,8 +343,8 @@ void ColorGradingPass::draw() {
                                     0,
                                     1,
                                     &m_descriptor_infos[0].descriptor_set,
-                                    0,
-                                    NULL);
+                                    1,
+                                    &m_dynamic_resolution_dynamic_offset);
 
     m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), 3, 1, 0, 0);
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo {
+struct PostProcessPassInitInfo : RenderPassInitInfo {
+    RHIRenderPass* render_pass;
+    RHIImageView* input_attachment;
+    bool enable_tone_mapping {true};
+    bool enable_color_grading {true};
+    bool enable_vignette {true};
+    bool enable_dynamic_resolution {false};
+};
+
+// tone mapping、color grading、vignette 这些逐像素的后处理合并为一个 subpass
+// 开启的效果组合在初始化时以 specialization constant 选出 shader 变体
+// 开启动态分辨率时顺带把场景 subpass 渲染的缩小区域放大到整个 viewport
+class PostProcessPass : public RenderPass {
+public:
+    void initialize(const RenderPassInitInfo* init_info) override final;
+    void draw() override final;
+
+    // 每帧在 ring buffer 重置之后、其他 pass 录制之前调用，最先从本帧的分片中分配，保证 draw() 不受 ring buffer 溢出影响
+    void prepareDynamicResolutionData();
+
+    void updateAfterFramebufferRecreate(RHIImageView* input_attachment);
+
+private:
+    void setupDescriptorSetLayout();
+    void setupPipeline();
+    void setupDescriptorSet();
+
+    bool m_enable_tone_mapping {true};
+    bool m_enable_color_grading {true};
+    bool m_enable_vignette {true};
+    bool m_enable_dynamic_resolution {false};
+
+    uint32_t m_dynamic_resolution_dynamic_offset {0};
+};
+} // namespace Piccolo
@@ -1,5 +1,7 @@
 #include "runtime/function/render/passes/ui_pass.h"
 
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 
 #include "runtime/resource/config_manager/config_manager.h"
@@ -27,6 +29,7 @@ void UIPass::initializeUIRenderBackend(WindowUI* window_ui) {
     init_info.QueueFamily               = m_rhi->getQueueFamilyIndices().graphics_family.value();
     init_info.Queue                     = ((VulkanQueue*)m_rhi->getGraphicsQueue())->getResource();
     init_info.DescriptorPool            = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_vk_descriptor_pool;
+    init_info.PipelineCache             = ((VulkanPipelineCache*)m_rhi->getPipelineCache())->getResource();
     init_info.Subpass                   = _main_camera_subpass_ui;
 
     // may be different from the real swapchain image count
@@ -75,6 +78,8 @@ void UIPass::uploadFonts() {
 }
 
 void UIPass::draw() {
+    PROFILE_SCOPE("UIPass::draw");
+
     if (m_window_ui) {
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
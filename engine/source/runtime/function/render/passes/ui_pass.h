@@ -19,6 +19,6 @@ private:
     void uploadFonts();
 
 private:
-    WindowUI* m_window_ui;
+    WindowUI* m_window_ui {nullptr};
 };
 } // namespace Piccolo
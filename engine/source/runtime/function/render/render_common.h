@@ -51,7 +51,7 @@ struct MeshPerframeStorageBufferObject {
 
 struct VulkanMeshInstance {
     float     enable_vertex_blending;
-    float     _padding_enable_vertex_blending_1;
+    uint32_t  material_index; // index into the bindless material buffer, unused otherwise
     float     _padding_enable_vertex_blending_2;
     float     _padding_enable_vertex_blending_3;
     Matrix4x4 model_matrix;
@@ -78,6 +78,20 @@ struct MeshPerMaterialUniformBufferObject {
     uint32_t is_double_sided = 0;
 };
 
+// one element of the bindless material buffer, std430 layout of BindlessMaterial in bindless_material.h
+struct MeshBindlessMaterialStorageBufferObject {
+    MeshPerMaterialUniformBufferObject factors;
+
+    uint32_t base_color_texture_index         = 0;
+    uint32_t metallic_roughness_texture_index = 0;
+    uint32_t normal_texture_index             = 0;
+    uint32_t occlusion_texture_index          = 0;
+    uint32_t emissive_texture_index           = 0;
+    uint32_t _padding_texture_index_1         = 0;
+    uint32_t _padding_texture_index_2         = 0;
+};
+static_assert(sizeof(MeshBindlessMaterialStorageBufferObject) == 80, "must match the std430 array stride");
+
 struct MeshPointLightShadowPerframeStorageBufferObject {
     uint32_t point_light_num;
     uint32_t _padding_point_light_num_1;
@@ -111,6 +125,13 @@ struct AxisStorageBufferObject {
     uint32_t  selected_axis = 3;
 };
 
+// 动态分辨率放大时 post process 用来把整个 viewport 的像素映射到场景区域
+struct PostProcessDynamicResolutionStorageBufferObject {
+    Vector4 viewport;       // x, y, width, height
+    Vector4 scene_viewport; // x, y, width, height
+    Vector4 inv_extent;     // 1 / attachment width, 1 / attachment height, 未使用, 未使用
+};
+
 struct ParticleBillboardPerframeStorageBufferObject {
     Matrix4x4 proj_view_matrix;
     Vector3   right_direction;
@@ -203,6 +224,9 @@ struct VulkanPBRMaterial {
     VmaAllocation   material_uniform_buffer_allocation;
 
     RHIDescriptorSet* material_descriptor_set;
+
+    // only valid when bindless materials are enabled, the material has no descriptor set then
+    uint32_t bindless_material_index {0};
 };
 
 // nodes
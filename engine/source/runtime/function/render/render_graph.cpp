@@ -0,0 +1,357 @@
+#include "runtime/function/render/render_graph.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace Piccolo {
+static bool isWriteAccess(RenderGraph::AttachmentAccess access) {
+    return access != RenderGraph::_attachment_access_input_read;
+}
+
+// 只能用作 attachment 的 usage 才能和 transient 一起使用
+static constexpr RHIImageUsageFlags s_attachment_only_usage = RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                              RHI_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                              RHI_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                                                              RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+uint32_t RenderGraph::addAttachment(const AttachmentDesc &desc) {
+    Attachment attachment;
+    attachment.desc = desc;
+    m_attachments.push_back(attachment);
+    return static_cast<uint32_t>(m_attachments.size() - 1);
+}
+
+uint32_t RenderGraph::addSubpass(const char* name) {
+    Subpass subpass;
+    subpass.name = name;
+    m_subpasses.push_back(subpass);
+    return static_cast<uint32_t>(m_subpasses.size() - 1);
+}
+
+void RenderGraph::addAccess(uint32_t subpass, uint32_t attachment, AttachmentAccess access) {
+    m_subpasses[subpass].accesses.push_back({attachment, access});
+}
+
+void RenderGraph::addExternalRead(uint32_t              subpass,
+                                  RHIPipelineStageFlags src_stage_mask,
+                                  RHIAccessFlags        src_access_mask,
+                                  RHIPipelineStageFlags dst_stage_mask,
+                                  RHIAccessFlags        dst_access_mask) {
+    m_subpasses[subpass].external_reads.push_back({src_stage_mask, src_access_mask, dst_stage_mask, dst_access_mask});
+}
+
+void RenderGraph::compile() {
+    cullSubpasses();
+    computeLifetimes();
+    assignPhysicalAttachments();
+
+    for (const Subpass &subpass : m_subpasses) {
+        if (subpass.culled)
+            LOG_INFO("render graph: subpass {} culled", subpass.name);
+    }
+    for (const Attachment &attachment : m_attachments) {
+        if (attachment.physical_index == RHI_ATTACHMENT_UNUSED)
+            LOG_INFO("render graph: attachment {} culled", attachment.desc.name);
+    }
+    LOG_INFO("render graph: {} attachments backed by {} images", m_attachments.size(), m_physical_attachments.size());
+}
+
+// 从后往前，只有写入了后面仍需要的 attachment 的 subpass 才保留
+void RenderGraph::cullSubpasses() {
+    std::vector<bool> needed(m_attachments.size(), false);
+    for (size_t attachment_index = 0; attachment_index < m_attachments.size(); ++attachment_index)
+        needed[attachment_index] = m_attachments[attachment_index].desc.output;
+
+    for (auto subpass = m_subpasses.rbegin(); subpass != m_subpasses.rend(); ++subpass) {
+        subpass->culled = true;
+        for (const Access &access : subpass->accesses) {
+            if (isWriteAccess(access.access) && needed[access.attachment])
+                subpass->culled = false;
+        }
+        if (subpass->culled)
+            continue;
+
+        // 被完全覆盖的内容不再需要，读取的内容则需要前面的 subpass 写入
+        for (const Access &access : subpass->accesses) {
+            if (access.access == _attachment_access_color_write)
+                needed[access.attachment] = false;
+        }
+        for (const Access &access : subpass->accesses) {
+            if (access.access != _attachment_access_color_write)
+                needed[access.attachment] = true;
+        }
+    }
+}
+
+void RenderGraph::computeLifetimes() {
+    uint32_t subpass_count = static_cast<uint32_t>(m_subpasses.size());
+    for (uint32_t subpass_index = 0; subpass_index < subpass_count; ++subpass_index) {
+        if (m_subpasses[subpass_index].culled)
+            continue;
+        for (const Access &access : m_subpasses[subpass_index].accesses) {
+            Attachment &attachment = m_attachments[access.attachment];
+            attachment.first_use = std::min(attachment.first_use, subpass_index);
+            attachment.last_use  = std::max(attachment.last_use, subpass_index);
+        }
+    }
+
+    // output 的内容要保留到 render pass 结束
+    for (Attachment &attachment : m_attachments) {
+        if (attachment.desc.output && attachment.first_use != RHI_SUBPASS_EXTERNAL)
+            attachment.last_use = subpass_count;
+    }
+}
+
+void RenderGraph::assignPhysicalAttachments() {
+    std::vector<uint32_t> order;
+    for (uint32_t attachment_index = 0; attachment_index < m_attachments.size(); ++attachment_index) {
+        if (m_attachments[attachment_index].first_use != RHI_SUBPASS_EXTERNAL)
+            order.push_back(attachment_index);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+        return m_attachments[lhs].first_use < m_attachments[rhs].first_use;
+    });
+
+    m_physical_attachments.clear();
+    for (uint32_t attachment_index : order) {
+        Attachment &attachment = m_attachments[attachment_index];
+        bool aliasable = !attachment.desc.external && !attachment.desc.output;
+
+        // 复用一个格式相同、生命周期已经结束的 image
+        attachment.physical_index = RHI_ATTACHMENT_UNUSED;
+        if (aliasable) {
+            for (uint32_t physical_index = 0; physical_index < m_physical_attachments.size(); ++physical_index) {
+                PhysicalAttachment &physical_attachment = m_physical_attachments[physical_index];
+                if (physical_attachment.aliasable &&
+                    m_attachments[physical_attachment.owner].desc.format == attachment.desc.format &&
+                    physical_attachment.last_use < attachment.first_use) {
+                    physical_attachment.owner        = std::min(physical_attachment.owner, attachment_index);
+                    physical_attachment.last_use     = attachment.last_use;
+                    physical_attachment.usage       |= attachment.desc.usage;
+                    physical_attachment.final_layout = attachment.desc.final_layout;
+                    attachment.physical_index        = physical_index;
+                    break;
+                }
+            }
+        }
+        if (attachment.physical_index == RHI_ATTACHMENT_UNUSED) {
+            attachment.physical_index = static_cast<uint32_t>(m_physical_attachments.size());
+            m_physical_attachments.push_back(
+                {attachment_index, attachment.last_use, attachment.desc.usage, attachment.desc.final_layout, aliasable});
+        }
+    }
+
+    for (PhysicalAttachment &physical_attachment : m_physical_attachments) {
+        if (physical_attachment.usage & ~s_attachment_only_usage)
+            physical_attachment.usage &= ~RHI_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+
+    // 按 owner 的声明顺序排列，便于和逻辑 attachment 对照
+    std::vector<uint32_t> sorted(m_physical_attachments.size());
+    for (uint32_t physical_index = 0; physical_index < sorted.size(); ++physical_index)
+        sorted[physical_index] = physical_index;
+    std::sort(sorted.begin(), sorted.end(), [this](uint32_t lhs, uint32_t rhs) {
+        return m_physical_attachments[lhs].owner < m_physical_attachments[rhs].owner;
+    });
+    std::vector<uint32_t>           remap(sorted.size());
+    std::vector<PhysicalAttachment> physical_attachments;
+    for (uint32_t sorted_index = 0; sorted_index < sorted.size(); ++sorted_index) {
+        remap[sorted[sorted_index]] = sorted_index;
+        physical_attachments.push_back(m_physical_attachments[sorted[sorted_index]]);
+    }
+    m_physical_attachments = std::move(physical_attachments);
+    for (Attachment &attachment : m_attachments) {
+        if (attachment.physical_index != RHI_ATTACHMENT_UNUSED)
+            attachment.physical_index = remap[attachment.physical_index];
+    }
+}
+
+uint32_t RenderGraph::getAttachmentOwner(uint32_t attachment) const {
+    uint32_t physical_index = m_attachments[attachment].physical_index;
+    return physical_index == RHI_ATTACHMENT_UNUSED ? attachment : m_physical_attachments[physical_index].owner;
+}
+
+RHIImageUsageFlags RenderGraph::getAttachmentImageUsage(uint32_t attachment) const {
+    uint32_t physical_index = m_attachments[attachment].physical_index;
+    return physical_index == RHI_ATTACHMENT_UNUSED ? m_attachments[attachment].desc.usage : m_physical_attachments[physical_index].usage;
+}
+
+std::vector<RHIClearValue> RenderGraph::getClearValues() const {
+    std::vector<RHIClearValue> clear_values;
+    for (const PhysicalAttachment &physical_attachment : m_physical_attachments)
+        clear_values.push_back(m_attachments[physical_attachment.owner].desc.clear_value);
+    return clear_values;
+}
+
+// 按每个 image 上一次的写入和之后的读取推导 RAW、WAR、WAW 依赖，同一对 subpass 之间的依赖合并成一个
+std::vector<RHISubpassDependency> RenderGraph::buildDependencies() const {
+    auto getStageMask = [](AttachmentAccess access) -> RHIPipelineStageFlags {
+        if (access == _attachment_access_depth_read_write)
+            return RHI_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | RHI_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        if (access == _attachment_access_input_read)
+            return RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        return RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    };
+    auto getSrcAccessMask = [](AttachmentAccess access) -> RHIAccessFlags {
+        if (access == _attachment_access_depth_read_write)
+            return RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        if (access == _attachment_access_input_read)
+            return 0; // WAR 只需要执行依赖
+        return RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    };
+    auto getDstAccessMask = [](AttachmentAccess access) -> RHIAccessFlags {
+        if (access == _attachment_access_depth_read_write)
+            return RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        if (access == _attachment_access_input_read)
+            return RHI_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+        return RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT | RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    };
+
+    std::map<std::pair<uint32_t, uint32_t>, RHISubpassDependency> dependencies;
+    auto addDependency = [&](uint32_t src_subpass, AttachmentAccess src_access, uint32_t dst_subpass, AttachmentAccess dst_access) {
+        if (src_subpass == dst_subpass)
+            return;
+        RHISubpassDependency &dependency = dependencies[{src_subpass, dst_subpass}];
+        dependency.srcSubpass       = src_subpass;
+        dependency.dstSubpass       = dst_subpass;
+        dependency.srcStageMask    |= getStageMask(src_access);
+        dependency.dstStageMask    |= getStageMask(dst_access);
+        dependency.srcAccessMask   |= getSrcAccessMask(src_access);
+        dependency.dstAccessMask   |= getDstAccessMask(dst_access);
+        dependency.dependencyFlags  = RHI_DEPENDENCY_BY_REGION_BIT;
+    };
+
+    struct ImageState {
+        bool                 written {false};
+        Access               last_write {};
+        uint32_t             last_write_subpass {0};
+        std::vector<std::pair<uint32_t, AttachmentAccess>> reads_since_write;
+    };
+    std::vector<ImageState> image_states(m_physical_attachments.size());
+
+    for (uint32_t subpass_index = 0; subpass_index < m_subpasses.size(); ++subpass_index) {
+        const Subpass &subpass = m_subpasses[subpass_index];
+        if (subpass.culled)
+            continue;
+
+        for (const Access &access : subpass.accesses) {
+            ImageState &state = image_states[m_attachments[access.attachment].physical_index];
+            if (state.written)
+                addDependency(state.last_write_subpass, state.last_write.access, subpass_index, access.access);
+            if (!isWriteAccess(access.access)) {
+                state.reads_since_write.push_back({subpass_index, access.access});
+                continue;
+            }
+            for (const auto &read : state.reads_since_write)
+                addDependency(read.first, read.second, subpass_index, access.access);
+            state.reads_since_write.clear();
+            state.written            = true;
+            state.last_write         = access;
+            state.last_write_subpass = subpass_index;
+        }
+
+        for (const ExternalRead &external_read : subpass.external_reads) {
+            RHISubpassDependency &dependency = dependencies[{RHI_SUBPASS_EXTERNAL, subpass_index}];
+            dependency.srcSubpass       = RHI_SUBPASS_EXTERNAL;
+            dependency.dstSubpass       = subpass_index;
+            dependency.srcStageMask    |= external_read.src_stage_mask;
+            dependency.dstStageMask    |= external_read.dst_stage_mask;
+            dependency.srcAccessMask   |= external_read.src_access_mask;
+            dependency.dstAccessMask   |= external_read.dst_access_mask;
+            dependency.dependencyFlags  = 0; // NOT BY REGION
+        }
+    }
+
+    std::vector<RHISubpassDependency> result;
+    for (auto &pair : dependencies)
+        result.push_back(pair.second);
+    return result;
+}
+
+bool RenderGraph::createRenderPass(RHI* rhi, RHIRenderPass* &render_pass) const {
+    std::vector<RHIAttachmentDescription> attachments(m_physical_attachments.size());
+    for (size_t physical_index = 0; physical_index < m_physical_attachments.size(); ++physical_index) {
+        const PhysicalAttachment &physical_attachment = m_physical_attachments[physical_index];
+        const AttachmentDesc     &owner_desc          = m_attachments[physical_attachment.owner].desc;
+
+        RHIAttachmentDescription &attachment = attachments[physical_index];
+        attachment.format         = owner_desc.format;
+        attachment.samples        = RHI_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp         = RHI_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp        = owner_desc.output ? RHI_ATTACHMENT_STORE_OP_STORE : RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.stencilLoadOp  = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout  = RHI_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout    = physical_attachment.final_layout;
+    }
+
+    struct SubpassReferences {
+        std::vector<RHIAttachmentReference> input_attachments;
+        std::vector<RHIAttachmentReference> color_attachments;
+        std::vector<RHIAttachmentReference> depth_attachment;
+        std::vector<uint32_t>               preserve_attachments;
+    };
+    std::vector<SubpassReferences>     references(m_subpasses.size());
+    std::vector<RHISubpassDescription> subpasses(m_subpasses.size());
+    for (uint32_t subpass_index = 0; subpass_index < m_subpasses.size(); ++subpass_index) {
+        const Subpass     &subpass   = m_subpasses[subpass_index];
+        SubpassReferences &reference = references[subpass_index];
+
+        // 被剔除的 subpass 保留引用的数量，pipeline 的 color blend attachment 数量因此仍然匹配
+        std::vector<bool> used(m_physical_attachments.size(), false);
+        for (const Access &access : subpass.accesses) {
+            uint32_t physical_index = subpass.culled ? RHI_ATTACHMENT_UNUSED : m_attachments[access.attachment].physical_index;
+            if (physical_index != RHI_ATTACHMENT_UNUSED)
+                used[physical_index] = true;
+            switch (access.access) {
+                case _attachment_access_color_write:
+                case _attachment_access_color_read_write:
+                    reference.color_attachments.push_back({physical_index, RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+                    break;
+                case _attachment_access_depth_read_write:
+                    reference.depth_attachment.push_back({physical_index, RHI_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+                    break;
+                case _attachment_access_input_read:
+                    reference.input_attachments.push_back({physical_index, RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+                    break;
+            }
+        }
+
+        // 生命周期跨过该 subpass 却没有被它使用的 attachment 需要 preserve
+        for (const Attachment &attachment : m_attachments) {
+            if (attachment.physical_index == RHI_ATTACHMENT_UNUSED || used[attachment.physical_index])
+                continue;
+            if (attachment.first_use < subpass_index && subpass_index < attachment.last_use) {
+                used[attachment.physical_index] = true;
+                reference.preserve_attachments.push_back(attachment.physical_index);
+            }
+        }
+
+        RHISubpassDescription &description  = subpasses[subpass_index];
+        description.pipelineBindPoint       = RHI_PIPELINE_BIND_POINT_GRAPHICS;
+        description.inputAttachmentCount    = static_cast<uint32_t>(reference.input_attachments.size());
+        description.pInputAttachments       = reference.input_attachments.empty() ? nullptr : reference.input_attachments.data();
+        description.colorAttachmentCount    = static_cast<uint32_t>(reference.color_attachments.size());
+        description.pColorAttachments       = reference.color_attachments.empty() ? nullptr : reference.color_attachments.data();
+        description.pDepthStencilAttachment = reference.depth_attachment.empty() ? nullptr : reference.depth_attachment.data();
+        description.preserveAttachmentCount = static_cast<uint32_t>(reference.preserve_attachments.size());
+        description.pPreserveAttachments    = reference.preserve_attachments.empty() ? nullptr : reference.preserve_attachments.data();
+    }
+
+    std::vector<RHISubpassDependency> dependencies = buildDependencies();
+
+    RHIRenderPassCreateInfo renderpass_create_info {};
+    renderpass_create_info.sType           = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderpass_create_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderpass_create_info.pAttachments    = attachments.data();
+    renderpass_create_info.subpassCount    = static_cast<uint32_t>(subpasses.size());
+    renderpass_create_info.pSubpasses      = subpasses.data();
+    renderpass_create_info.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderpass_create_info.pDependencies   = dependencies.data();
+
+    return rhi->createRenderPass(&renderpass_create_info, render_pass);
+}
+} // namespace Piccolo
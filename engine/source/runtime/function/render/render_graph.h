@@ -0,0 +1,108 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <vector>
+
+namespace Piccolo {
+// 以 subpass 对 attachment 的读写来描述一个 render pass，由此推导出：
+// 1. 被剔除的 subpass：其结果没有被任何后续 subpass 或 render pass 之外使用
+// 2. subpass dependency（包括 attachment 的 layout 转换）和 preserve attachment
+// 3. 实际分配的 attachment：生命周期不重叠、格式相同的 transient attachment 共用同一张 image
+// subpass 的下标与声明顺序一致，被剔除的 subpass 仍然保留（引用变为 RHI_ATTACHMENT_UNUSED），已有的 pipeline 因此保持兼容
+class RenderGraph {
+public:
+    enum AttachmentAccess : uint8_t {
+        _attachment_access_color_write = 0,  // 覆盖整个 attachment，不依赖之前的内容（全屏绘制或先 clear）
+        _attachment_access_color_read_write, // 在之前的内容上继续绘制，如混合
+        _attachment_access_depth_read_write,
+        _attachment_access_input_read,
+    };
+
+    struct AttachmentDesc {
+        const char*        name {nullptr};
+        RHIFormat          format {RHI_FORMAT_UNDEFINED};
+        RHIImageUsageFlags usage {0};
+        RHIClearValue      clear_value {};
+        RHIImageLayout     final_layout {RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        bool               external {false}; // image 由外部提供（如 depth、swapchain），不在这里分配
+        bool               output {false};   // 内容在 render pass 之后仍会被使用，不参与剔除和 aliasing
+    };
+
+    // 返回 attachment 的逻辑下标，按声明顺序递增
+    uint32_t addAttachment(const AttachmentDesc &desc);
+    // 返回 subpass 下标，按声明顺序递增
+    uint32_t addSubpass(const char* name);
+    // 同一 subpass 内 color 与 input 的声明顺序即 shader 中的 location 与 input_attachment_index
+    void addAccess(uint32_t subpass, uint32_t attachment, AttachmentAccess access);
+    // subpass 采样了其它 render pass 写入的 image，如 shadow map
+    void addExternalRead(uint32_t              subpass,
+                         RHIPipelineStageFlags src_stage_mask,
+                         RHIAccessFlags        src_access_mask,
+                         RHIPipelineStageFlags dst_stage_mask,
+                         RHIAccessFlags        dst_access_mask);
+
+    // 声明完成后调用，之后下面的查询和 createRenderPass 才有效
+    void compile();
+
+    bool createRenderPass(RHI* rhi, RHIRenderPass* &render_pass) const;
+
+    bool isSubpassCulled(uint32_t subpass) const { return m_subpasses[subpass].culled; }
+    bool isAttachmentCulled(uint32_t attachment) const { return m_attachments[attachment].physical_index == RHI_ATTACHMENT_UNUSED; }
+
+    const AttachmentDesc &getAttachmentDesc(uint32_t attachment) const { return m_attachments[attachment].desc; }
+    // 与 attachment 共用 image 的逻辑 attachment 中下标最小的一个，由它负责创建和销毁 image
+    uint32_t getAttachmentOwner(uint32_t attachment) const;
+    // 共用 image 的所有逻辑 attachment 的 usage 之和
+    RHIImageUsageFlags getAttachmentImageUsage(uint32_t attachment) const;
+
+    uint32_t getPhysicalAttachmentCount() const { return static_cast<uint32_t>(m_physical_attachments.size()); }
+    uint32_t getPhysicalAttachmentOwner(uint32_t physical_index) const { return m_physical_attachments[physical_index].owner; }
+    // 按实际 attachment 的顺序排列，用于 begin render pass
+    std::vector<RHIClearValue> getClearValues() const;
+
+private:
+    struct Access {
+        uint32_t         attachment;
+        AttachmentAccess access;
+    };
+
+    struct ExternalRead {
+        RHIPipelineStageFlags src_stage_mask;
+        RHIAccessFlags        src_access_mask;
+        RHIPipelineStageFlags dst_stage_mask;
+        RHIAccessFlags        dst_access_mask;
+    };
+
+    struct Subpass {
+        const char*               name;
+        std::vector<Access>       accesses;
+        std::vector<ExternalRead> external_reads;
+        bool                      culled {false};
+    };
+
+    struct Attachment {
+        AttachmentDesc desc;
+        uint32_t       first_use {RHI_SUBPASS_EXTERNAL};
+        uint32_t       last_use {0};
+        uint32_t       physical_index {RHI_ATTACHMENT_UNUSED};
+    };
+
+    struct PhysicalAttachment {
+        uint32_t           owner;
+        uint32_t           last_use;
+        RHIImageUsageFlags usage;
+        RHIImageLayout     final_layout;
+        bool               aliasable;
+    };
+
+    void cullSubpasses();
+    void computeLifetimes();
+    void assignPhysicalAttachments();
+    std::vector<RHISubpassDependency> buildDependencies() const;
+
+    std::vector<Attachment>         m_attachments;
+    std::vector<Subpass>            m_subpasses;
+    std::vector<PhysicalAttachment> m_physical_attachments;
+};
+} // namespace Piccolo
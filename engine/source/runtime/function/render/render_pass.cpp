@@ -2,12 +2,29 @@
 
 #include "runtime/core/base/macro.h"
 
+#include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_resource.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 
+#include <algorithm>
+#include <mutex>
+
 Piccolo::VisibleNodes Piccolo::RenderPass::m_visible_nodes;
+Piccolo::RHIViewport  Piccolo::RenderPass::m_scene_viewport;
+Piccolo::RHIRect2D    Piccolo::RenderPass::m_scene_scissor;
 
 namespace Piccolo {
+// guards the end of each frame slice, workers inside a RingBufferWorkerScope only take it once per chunk
+static std::mutex s_ring_buffer_allocation_mutex;
+
+static thread_local RenderPass::RingBufferWorkerScope* s_ring_buffer_worker_scope = nullptr;
+
+RenderPass::RingBufferWorkerScope::RingBufferWorkerScope() : m_previous_scope(s_ring_buffer_worker_scope) {
+    s_ring_buffer_worker_scope = this;
+}
+
+RenderPass::RingBufferWorkerScope::~RingBufferWorkerScope() { s_ring_buffer_worker_scope = m_previous_scope; }
+
 void RenderPass::initialize(const RenderPassInitInfo* init_info) {
     m_global_render_resource = &(std::static_pointer_cast<RenderResource>(m_render_resource)->m_global_render_resource);
 }
@@ -24,6 +41,79 @@ std::vector<RHIImageView*> RenderPass::getFramebufferImageViews() const {
     return image_views;
 }
 
+void RenderPass::updateAfterRingBufferRecreate() {
+    std::vector<RHIDescriptorBufferInfo> buffer_infos(m_ring_buffer_bindings.size());
+    std::vector<RHIWriteDescriptorSet>   descriptor_writes(m_ring_buffer_bindings.size());
+    for (size_t i = 0; i < m_ring_buffer_bindings.size(); ++i) {
+        buffer_infos[i].buffer = m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        buffer_infos[i].offset = 0;
+        buffer_infos[i].range  = m_ring_buffer_bindings[i].range;
+
+        descriptor_writes[i]                 = {};
+        descriptor_writes[i].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[i].pNext           = NULL;
+        descriptor_writes[i].dstSet          = m_ring_buffer_bindings[i].descriptor_set;
+        descriptor_writes[i].dstBinding      = m_ring_buffer_bindings[i].binding;
+        descriptor_writes[i].dstArrayElement = 0;
+        descriptor_writes[i].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        descriptor_writes[i].descriptorCount = 1;
+        descriptor_writes[i].pBufferInfo     = &buffer_infos[i];
+    }
+
+    if (!descriptor_writes.empty())
+        m_rhi->updateDescriptorSets(descriptor_writes.size(), descriptor_writes.data(), 0, NULL);
+}
+
+void* RenderPass::allocateRingBufferSpace(uint32_t size, uint32_t &dynamic_offset) {
+    StorageBuffer &storage_buffer = m_global_render_resource->_storage_buffer;
+    uint8_t        frame_index    = m_rhi->getCurrentFrameIndex();
+
+    RingBufferWorkerScope* worker_scope = s_ring_buffer_worker_scope;
+    if (worker_scope) {
+        dynamic_offset = roundUp(worker_scope->m_end, storage_buffer._min_storage_buffer_offset_alignment);
+        if (worker_scope->m_limit != 0 && dynamic_offset + size <= worker_scope->m_limit) {
+            worker_scope->m_end = dynamic_offset + size;
+            return reinterpret_cast<void*>(
+                reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) + dynamic_offset);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s_ring_buffer_allocation_mutex);
+
+    dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                             storage_buffer._min_storage_buffer_offset_alignment);
+
+    uint32_t frame_slice_end = storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                               storage_buffer._global_upload_ringbuffers_size[frame_index];
+    if (dynamic_offset + size > frame_slice_end) {
+        // the ring buffer is grown at the start of the next frame, until then the caller has to skip the upload
+        if (storage_buffer._global_upload_ringbuffers_overflow[frame_index] == 0)
+            LOG_WARN("global upload ring buffer overflow, draw calls are dropped in this frame");
+        storage_buffer._global_upload_ringbuffers_overflow[frame_index] += size;
+        dynamic_offset = 0;
+        return nullptr;
+    }
+
+    // a worker reserves a whole chunk, near the end of the slice it only takes what this allocation needs
+    uint32_t reserved_size = size;
+    if (worker_scope && dynamic_offset + s_ring_buffer_worker_chunk_size <= frame_slice_end)
+        reserved_size = std::max(size, s_ring_buffer_worker_chunk_size);
+
+    storage_buffer._global_upload_ringbuffers_end[frame_index] = dynamic_offset + reserved_size;
+
+    if (worker_scope) {
+        worker_scope->m_end   = dynamic_offset + size;
+        worker_scope->m_limit = dynamic_offset + reserved_size;
+    }
+
+    return reinterpret_cast<void*>(
+        reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) + dynamic_offset);
+}
+
+void RenderPass::registerRingBufferBinding(RHIDescriptorSet* descriptor_set, uint32_t binding, RHIDeviceSize range) {
+    m_ring_buffer_bindings.push_back({descriptor_set, binding, range});
+}
+
 std::vector<RHIDescriptorSetLayout*> RenderPass::getDescriptorSetLayouts() const {
     std::vector<RHIDescriptorSetLayout*> layouts;
     for (auto &desc : m_descriptor_infos)
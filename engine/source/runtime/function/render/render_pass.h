@@ -33,9 +33,7 @@ enum {
     _main_camera_subpass_basepass = 0,
     _main_camera_subpass_deferred_lighting,
     _main_camera_subpass_forward_lighting,
-    _main_camera_subpass_tone_mapping,
-    _main_camera_subpass_color_grading,
-    _main_camera_subpass_vignette,
+    _main_camera_subpass_post_process, // tone mapping + color grading + vignette
     _main_camera_subpass_fxaa,
     _main_camera_subpass_ui,
     _main_camera_subpass_combine_ui,
@@ -77,6 +75,32 @@ public:
         RHIPipeline*       pipeline;
     };
 
+    template<typename T>
+    struct RingBufferAllocation {
+        T*       data_ptr; // nullptr when the frame's slice of the ring buffer is exhausted
+        uint32_t dynamic_offset;
+    };
+
+    // 并行录制时每个 worker 在自己的 scope 内分配：从本帧分片中一次预留一块作为私有的子区间，块内分配不加锁
+    // scope 只在当前线程生效，可以嵌套，不能跨帧保留
+    class RingBufferWorkerScope {
+    public:
+        RingBufferWorkerScope();
+        ~RingBufferWorkerScope();
+
+        RingBufferWorkerScope(const RingBufferWorkerScope &)            = delete;
+        RingBufferWorkerScope &operator=(const RingBufferWorkerScope &) = delete;
+
+    private:
+        friend class RenderPass;
+
+        RingBufferWorkerScope* m_previous_scope {nullptr};
+        uint32_t               m_end {0};   // 子区间中下一次分配的起点
+        uint32_t               m_limit {0}; // 子区间的终点，为 0 时还没有预留
+    };
+
+    static constexpr uint32_t s_ring_buffer_worker_chunk_size = 64 * 1024;
+
     GlobalRenderResource* m_global_render_resource {nullptr}; // 该 pass 可能使用的全局资源，如 IBL、color grading, storage buffer
 
     std::vector<Descriptor>         m_descriptor_infos; // 描述符信息
@@ -92,8 +116,33 @@ public:
     virtual std::vector<RHIImageView*>           getFramebufferImageViews() const;
     virtual std::vector<RHIDescriptorSetLayout*> getDescriptorSetLayouts() const;
 
+    // rewrite the descriptors pointing into the global upload ring buffer after it was reallocated
+    void updateAfterRingBufferRecreate();
+
     static VisibleNodes m_visible_nodes; // 可见对象，在所有 render pass 中共享（所以是 static）
 
+    // 场景 subpass（base pass、lighting、粒子）使用的 viewport，开启动态分辨率时为 swapchain viewport 按比例缩小的左上角区域
+    static RHIViewport m_scene_viewport;
+    static RHIRect2D   m_scene_scissor;
+
+protected:
+    template<typename T>
+    RingBufferAllocation<T> allocateRingBufferSpace() {
+        uint32_t dynamic_offset = 0;
+        T*       data_ptr       = static_cast<T*>(allocateRingBufferSpace(sizeof(T), dynamic_offset));
+        return {data_ptr, dynamic_offset};
+    }
+    void* allocateRingBufferSpace(uint32_t size, uint32_t &dynamic_offset); // thread safe
+
+    // remember a dynamic storage buffer binding of the ring buffer, it is rewritten in updateAfterRingBufferRecreate
+    void registerRingBufferBinding(RHIDescriptorSet* descriptor_set, uint32_t binding, RHIDeviceSize range);
+
 private:
+    struct RingBufferBinding {
+        RHIDescriptorSet* descriptor_set;
+        uint32_t          binding;
+        RHIDeviceSize     range;
+    };
+    std::vector<RingBufferBinding> m_ring_buffer_bindings;
 };
 } // namespace Piccolo
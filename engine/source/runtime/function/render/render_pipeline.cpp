@@ -1,14 +1,15 @@
 #include "runtime/function/render/render_pipeline.h"
+
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 
-#include "runtime/function/render/passes/color_grading_pass.h"
-#include "runtime/function/render/passes/vignette_pass.h"
 #include "runtime/function/render/passes/combine_ui_pass.h"
 #include "runtime/function/render/passes/directional_light_pass.h"
 #include "runtime/function/render/passes/main_camera_pass.h"
 #include "runtime/function/render/passes/pick_pass.h"
 #include "runtime/function/render/passes/point_light_pass.h"
-#include "runtime/function/render/passes/tone_mapping_pass.h"
+#include "runtime/function/render/passes/post_process_pass.h"
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 
@@ -16,14 +17,18 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <chrono>
+#include <functional>
+#include <future>
+
 namespace Piccolo {
 void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
+    const auto initialize_begin_time = std::chrono::steady_clock::now();
+
     m_point_light_shadow_pass = std::make_shared<PointLightShadowPass>();
     m_directional_light_pass  = std::make_shared<DirectionalLightShadowPass>();
     m_main_camera_pass        = std::make_shared<MainCameraPass>();
-    m_tone_mapping_pass       = std::make_shared<ToneMappingPass>();
-    m_color_grading_pass      = std::make_shared<ColorGradingPass>();
-    m_vignette_pass           = std::make_shared<VignettePass>();
+    m_post_process_pass       = std::make_shared<PostProcessPass>();
     m_ui_pass                 = std::make_shared<UIPass>();
     m_combine_ui_pass         = std::make_shared<CombineUIPass>();
     m_pick_pass               = std::make_shared<PickPass>();
@@ -37,9 +42,7 @@ void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
     m_point_light_shadow_pass->setCommonInfo(pass_common_info);
     m_directional_light_pass->setCommonInfo(pass_common_info);
     m_main_camera_pass->setCommonInfo(pass_common_info);
-    m_tone_mapping_pass->setCommonInfo(pass_common_info);
-    m_color_grading_pass->setCommonInfo(pass_common_info);
-    m_vignette_pass->setCommonInfo(pass_common_info);
+    m_post_process_pass->setCommonInfo(pass_common_info);
     m_ui_pass->setCommonInfo(pass_common_info);
     m_combine_ui_pass->setCommonInfo(pass_common_info);
     m_pick_pass->setCommonInfo(pass_common_info);
@@ -49,6 +52,9 @@ void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
     m_point_light_shadow_pass->initialize(nullptr);
     m_directional_light_pass->initialize(nullptr);
 
+    m_dynamic_resolution.initialize(init_info.dynamic_resolution);
+    updateSceneViewport();
+
     std::shared_ptr<MainCameraPass> main_camera_pass = std::static_pointer_cast<MainCameraPass>(m_main_camera_pass);
     std::shared_ptr<RenderPass> _main_camera_pass    = std::static_pointer_cast<RenderPass>(m_main_camera_pass);
     std::shared_ptr<ParticlePass> particle_pass      = std::static_pointer_cast<ParticlePass>(m_particle_pass);
@@ -61,7 +67,8 @@ void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
     main_camera_pass->m_directional_light_shadow_color_image_view = std::static_pointer_cast<RenderPass>(m_directional_light_pass)->m_framebuffer.attachments[0].view;
 
     MainCameraPassInitInfo main_camera_init_info;
-    main_camera_init_info.enable_fxaa = init_info.enable_fxaa;
+    main_camera_init_info.enable_fxaa               = init_info.enable_fxaa;
+    main_camera_init_info.enable_dynamic_resolution = init_info.dynamic_resolution.enable;
     main_camera_pass->setParticlePass(particle_pass);
     m_main_camera_pass->initialize(&main_camera_init_info);
 
@@ -71,33 +78,34 @@ void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
     std::static_pointer_cast<PointLightShadowPass>(m_point_light_shadow_pass)->setPerMeshLayout(descriptor_layouts[MainCameraPass::LayoutType::_per_mesh]);
     std::static_pointer_cast<DirectionalLightShadowPass>(m_directional_light_pass)->setPerMeshLayout(descriptor_layouts[MainCameraPass::LayoutType::_per_mesh]);
 
-    m_point_light_shadow_pass->postInitialize();
-    m_directional_light_pass->postInitialize();
-
-    ToneMappingPassInitInfo tone_mapping_init_info;
-    tone_mapping_init_info.render_pass      = _main_camera_pass->getRenderPass();
-    tone_mapping_init_info.input_attachment = _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_a];
-    m_tone_mapping_pass->initialize(&tone_mapping_init_info);
-
+    // everything below only depends on the main camera render pass and the layouts created above, so the
+    // pipelines of these passes are compiled concurrently. the rhi serializes descriptor pool and sampler access
+    std::vector<std::future<void>> pass_initializations;
+    auto initializeAsync = [&pass_initializations](std::function<void()> initialize_pass) {
+        pass_initializations.push_back(std::async(std::launch::async, std::move(initialize_pass)));
+    };
+
+    initializeAsync([this]() { m_point_light_shadow_pass->postInitialize(); });
+    initializeAsync([this]() { m_directional_light_pass->postInitialize(); });
+
+    PostProcessPassInitInfo post_process_init_info;
+    post_process_init_info.render_pass               = _main_camera_pass->getRenderPass();
+    post_process_init_info.input_attachment          = _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_a];
+    post_process_init_info.enable_tone_mapping       = init_info.enable_tone_mapping;
+    post_process_init_info.enable_color_grading      = init_info.enable_color_grading;
+    post_process_init_info.enable_vignette           = init_info.enable_vignette;
+    post_process_init_info.enable_dynamic_resolution = init_info.dynamic_resolution.enable;
+    initializeAsync([this, post_process_init_info]() { m_post_process_pass->initialize(&post_process_init_info); });
+
+    // post process pass 写入 post_odd
     uint32_t post_process_read_buffer = _main_camera_pass_post_process_buffer_odd;
     uint32_t post_process_write_buffer = _main_camera_pass_post_process_buffer_even;
     auto flipPostProcessBuffers = [&]() { std::swap(post_process_read_buffer, post_process_write_buffer); };
-    ColorGradingPassInitInfo color_grading_init_info;
-    color_grading_init_info.render_pass      = _main_camera_pass->getRenderPass();
-    color_grading_init_info.input_attachment = _main_camera_pass->getFramebufferImageViews()[post_process_read_buffer]; // post_odd
-    m_color_grading_pass->initialize(&color_grading_init_info);
-    flipPostProcessBuffers();
-
-    VignettePassInitInfo vignette_init_info;
-    vignette_init_info.render_pass      = _main_camera_pass->getRenderPass();
-    vignette_init_info.input_attachment = _main_camera_pass->getFramebufferImageViews()[post_process_read_buffer]; // post_even
-    m_vignette_pass->initialize(&vignette_init_info);
-    flipPostProcessBuffers();
 
     FXAAPassInitInfo fxaa_init_info;
     fxaa_init_info.render_pass = _main_camera_pass->getRenderPass();
     fxaa_init_info.input_attachment = _main_camera_pass->getFramebufferImageViews()[post_process_read_buffer]; // post_odd
-    m_fxaa_pass->initialize(&fxaa_init_info);
+    initializeAsync([this, fxaa_init_info]() { m_fxaa_pass->initialize(&fxaa_init_info); });
     if (init_info.enable_fxaa)
         flipPostProcessBuffers();
 
@@ -109,20 +117,35 @@ void RenderPipeline::initialize(RenderPipelineInitInfo init_info) {
     combine_ui_init_info.render_pass            = _main_camera_pass->getRenderPass();
     combine_ui_init_info.scene_input_attachment = _main_camera_pass->getFramebufferImageViews()[post_process_read_buffer];  // post_even if enable_fxaa
     combine_ui_init_info.ui_input_attachment    = _main_camera_pass->getFramebufferImageViews()[post_process_write_buffer]; // post_odd if enable_fxaa (no write actually)
-    m_combine_ui_pass->initialize(&combine_ui_init_info);
+    initializeAsync([this, combine_ui_init_info]() { m_combine_ui_pass->initialize(&combine_ui_init_info); });
 
     PickPassInitInfo pick_init_info;
     pick_init_info.per_mesh_layout = descriptor_layouts[MainCameraPass::LayoutType::_per_mesh];
-    m_pick_pass->initialize(&pick_init_info);
+    initializeAsync([this, pick_init_info]() { m_pick_pass->initialize(&pick_init_info); });
+
+    for (auto &pass_initialization : pass_initializations)
+        pass_initialization.get();
+
+    const auto initialize_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - initialize_begin_time);
+    LOG_INFO("render pipeline initialized in {} ms", initialize_time.count());
+}
+
+void RenderPipeline::clear() {
+    if (m_particle_pass)
+        static_cast<ParticlePass*>(m_particle_pass.get())->clear();
 }
 
 void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource) {
+    PROFILE_SCOPE("RenderPipeline::forwardRender");
+
     VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
     RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-    vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+    if (vulkan_resource->resetRingBufferOffset(rhi, vulkan_rhi->m_current_frame_index))
+        passUpdateAfterRecreateRingBuffer();
 
     vulkan_rhi->waitForFences();
+    sampleFrameTime();
 
     vulkan_rhi->resetCommandPool();
 
@@ -130,14 +153,16 @@ void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<Ren
     if (recreate_swapchain)
         return;
 
+    static_cast<PostProcessPass*>(m_post_process_pass.get())->prepareDynamicResolutionData();
+
     static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
     static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
 
-    ColorGradingPass &color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
-    VignettePass     &vignette_pass      = *(static_cast<VignettePass*>(m_vignette_pass.get()));
+    static_cast<PickPass*>(m_pick_pass.get())->draw();
+
+    PostProcessPass  &post_process_pass  = *(static_cast<PostProcessPass*>(m_post_process_pass.get()));
     FXAAPass         &fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
-    ToneMappingPass  &tone_mapping_pass  = *(static_cast<ToneMappingPass*>(m_tone_mapping_pass.get()));
     UIPass           &ui_pass            = *(static_cast<UIPass*>(m_ui_pass.get()));
     CombineUIPass    &combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
     ParticlePass     &particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
@@ -145,29 +170,39 @@ void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<Ren
     static_cast<ParticlePass*>(m_particle_pass.get())->setRenderCommandBufferHandle(
         static_cast<MainCameraPass*>(m_main_camera_pass.get())->getRenderCommandBuffer());
 
-    static_cast<MainCameraPass*>(m_main_camera_pass.get())->drawForward(color_grading_pass,
-                                                                        vignette_pass,
+    static_cast<MainCameraPass*>(m_main_camera_pass.get())->drawForward(post_process_pass,
                                                                         fxaa_pass,
-                                                                        tone_mapping_pass,
                                                                         ui_pass,
                                                                         combine_ui_pass,
                                                                         particle_pass,
                                                                         vulkan_rhi->m_current_swapchain_image_index);
 
+    particle_pass.copyNormalAndDepthImage();
+
     g_runtime_global_context.m_debugdraw_manager->draw(vulkan_rhi->m_current_swapchain_image_index);
 
-    vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-    static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
-    static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
+    RHISubmitResult submit_result =
+        vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+    if (submit_result.is_submitted) {
+        // 重建后的 depth/normal 是新创建的图像，本帧的复制写入的是已销毁的旧图像，跳过这一帧的模拟
+        if (submit_result.is_swapchain_recreated)
+            particle_pass.skipSimulation(submit_result.frame_index);
+        else
+            particle_pass.simulate(submit_result.frame_index);
+    }
 }
 
 void RenderPipeline::deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource) {
+    PROFILE_SCOPE("RenderPipeline::deferredRender");
+
     VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
     RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-    vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+    if (vulkan_resource->resetRingBufferOffset(rhi, vulkan_rhi->m_current_frame_index))
+        passUpdateAfterRecreateRingBuffer();
 
     vulkan_rhi->waitForFences();
+    sampleFrameTime();
 
     vulkan_rhi->resetCommandPool();
 
@@ -176,14 +211,16 @@ void RenderPipeline::deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<Re
     if (recreate_swapchain)
         return;
 
+    static_cast<PostProcessPass*>(m_post_process_pass.get())->prepareDynamicResolutionData();
+
     static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
     static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
 
-    ColorGradingPass &color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
-    VignettePass     &vignette_pass      = *(static_cast<VignettePass*>(m_vignette_pass.get()));
+    static_cast<PickPass*>(m_pick_pass.get())->draw();
+
+    PostProcessPass  &post_process_pass  = *(static_cast<PostProcessPass*>(m_post_process_pass.get()));
     FXAAPass         &fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
-    ToneMappingPass  &tone_mapping_pass  = *(static_cast<ToneMappingPass*>(m_tone_mapping_pass.get()));
     UIPass           &ui_pass            = *(static_cast<UIPass*>(m_ui_pass.get()));
     CombineUIPass    &combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
     ParticlePass     &particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
@@ -191,28 +228,32 @@ void RenderPipeline::deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<Re
     static_cast<ParticlePass*>(m_particle_pass.get())->setRenderCommandBufferHandle(
         static_cast<MainCameraPass*>(m_main_camera_pass.get())->getRenderCommandBuffer());
 
-    static_cast<MainCameraPass*>(m_main_camera_pass.get())->draw(color_grading_pass,
-                                                                 vignette_pass,
+    static_cast<MainCameraPass*>(m_main_camera_pass.get())->draw(post_process_pass,
                                                                  fxaa_pass,
-                                                                 tone_mapping_pass,
                                                                  ui_pass,
                                                                  combine_ui_pass,
                                                                  particle_pass,
                                                                  vulkan_rhi->m_current_swapchain_image_index);
 
+    particle_pass.copyNormalAndDepthImage();
+
     g_runtime_global_context.m_debugdraw_manager->draw(vulkan_rhi->m_current_swapchain_image_index);
 
-    vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-    static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
-    static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
+    RHISubmitResult submit_result =
+        vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+    if (submit_result.is_submitted) {
+        // 重建后的 depth/normal 是新创建的图像，本帧的复制写入的是已销毁的旧图像，跳过这一帧的模拟
+        if (submit_result.is_swapchain_recreated)
+            particle_pass.skipSimulation(submit_result.frame_index);
+        else
+            particle_pass.simulate(submit_result.frame_index);
+    }
 }
 
 void RenderPipeline::passUpdateAfterRecreateSwapchain() {
     MainCameraPass   &main_camera_pass   = *(static_cast<MainCameraPass*>(m_main_camera_pass.get()));
-    ColorGradingPass &color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
-    VignettePass     &vignette_pass      = *(static_cast<VignettePass*>(m_vignette_pass.get()));
+    PostProcessPass  &post_process_pass  = *(static_cast<PostProcessPass*>(m_post_process_pass.get()));
     FXAAPass         &fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
-    ToneMappingPass  &tone_mapping_pass  = *(static_cast<ToneMappingPass*>(m_tone_mapping_pass.get()));
     CombineUIPass    &combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
     PickPass         &pick_pass          = *(static_cast<PickPass*>(m_pick_pass.get()));
     ParticlePass     &particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
@@ -223,11 +264,7 @@ void RenderPipeline::passUpdateAfterRecreateSwapchain() {
     uint32_t post_process_read_buffer = _main_camera_pass_post_process_buffer_odd;
     uint32_t post_process_write_buffer = _main_camera_pass_post_process_buffer_even;
     auto flipPostProcessBuffers = [&]() { std::swap(post_process_read_buffer, post_process_write_buffer); };
-    tone_mapping_pass.updateAfterFramebufferRecreate(main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_a]);
-    color_grading_pass.updateAfterFramebufferRecreate(main_camera_pass.getFramebufferImageViews()[post_process_read_buffer]); // post_odd
-    flipPostProcessBuffers();
-    vignette_pass.updateAfterFramebufferRecreate(main_camera_pass.getFramebufferImageViews()[post_process_read_buffer]); // post_even
-    flipPostProcessBuffers();
+    post_process_pass.updateAfterFramebufferRecreate(main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_a]);
     fxaa_pass.updateAfterFramebufferRecreate(main_camera_pass.getFramebufferImageViews()[post_process_read_buffer]); // post_odd
     if (main_camera_pass.m_enable_fxaa)
         flipPostProcessBuffers();
@@ -239,9 +276,17 @@ void RenderPipeline::passUpdateAfterRecreateSwapchain() {
     g_runtime_global_context.m_debugdraw_manager->updateAfterRecreateSwapchain();
 }
 
-uint32_t RenderPipeline::getGuidOfPickedMesh(const Vector2 &picked_uv) {
+void RenderPipeline::passUpdateAfterRecreateRingBuffer() {
+    static_cast<RenderPass*>(m_main_camera_pass.get())->updateAfterRingBufferRecreate();
+    static_cast<RenderPass*>(m_directional_light_pass.get())->updateAfterRingBufferRecreate();
+    static_cast<RenderPass*>(m_point_light_shadow_pass.get())->updateAfterRingBufferRecreate();
+    static_cast<RenderPass*>(m_pick_pass.get())->updateAfterRingBufferRecreate();
+    static_cast<RenderPass*>(m_post_process_pass.get())->updateAfterRingBufferRecreate();
+}
+
+void RenderPipeline::requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked) {
     PickPass &pick_pass = *(static_cast<PickPass*>(m_pick_pass.get()));
-    return pick_pass.pick(picked_uv);
+    pick_pass.requestPick(picked_uv, std::move(on_picked));
 }
 
 void RenderPipeline::setAxisVisibleState(bool state) {
@@ -7,6 +7,8 @@ class RenderPipeline : public RenderPipelineBase {
 public:
     virtual void initialize(RenderPipelineInitInfo init_info) override final;
 
+    virtual void clear() override final;
+
     virtual void forwardRender(std::shared_ptr<RHI>                rhi,
                                std::shared_ptr<RenderResourceBase> render_resource) override final;
 
@@ -15,7 +17,9 @@ public:
 
     void passUpdateAfterRecreateSwapchain();
 
-    virtual uint32_t getGuidOfPickedMesh(const Vector2 &picked_uv) override final;
+    void passUpdateAfterRecreateRingBuffer();
+
+    virtual void requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked) override final;
 
     void setAxisVisibleState(bool state);
 
@@ -1,10 +1,14 @@
 #include "runtime/function/render/render_pipeline_base.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
+#include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/render_pass.h"
 #include "runtime/core/base/macro.h"
 #include "runtime/function/global/global_context.h"
 
 namespace Piccolo {
 void RenderPipelineBase::preparePassData(std::shared_ptr<RenderResourceBase> render_resource) {
+    updateSceneViewport();
+
     m_main_camera_pass->preparePassData(render_resource);
     m_pick_pass->preparePassData(render_resource);
     m_directional_light_pass->preparePassData(render_resource);
@@ -18,6 +22,26 @@ void RenderPipelineBase::forwardRender(std::shared_ptr<RHI>                rhi,
 void RenderPipelineBase::deferredRender(std::shared_ptr<RHI>                rhi,
                                         std::shared_ptr<RenderResourceBase> render_resource)
 {}
+void RenderPipelineBase::sampleFrameTime() {
+    const auto now = std::chrono::steady_clock::now();
+    // 有 GPU timestamp 时使用 GPU 帧耗时，不受垂直同步和 CPU 一侧等待的影响
+    float gpu_frame_time = 0.f;
+    if (m_rhi->getLastGPUFrameTime(gpu_frame_time))
+        m_dynamic_resolution.addFrameTimeSample(gpu_frame_time);
+    else if (m_has_last_frame_time_point)
+        m_dynamic_resolution.addFrameTimeSample(std::chrono::duration<float, std::milli>(now - m_last_frame_time_point).count());
+    m_last_frame_time_point     = now;
+    m_has_last_frame_time_point = true;
+}
+void RenderPipelineBase::updateSceneViewport() {
+    const RHISwapChainDesc swapchain_info = m_rhi->getSwapchainInfo();
+    if (!m_dynamic_resolution.isEnabled()) {
+        RenderPass::m_scene_viewport = *swapchain_info.viewport;
+        RenderPass::m_scene_scissor  = *swapchain_info.scissor;
+        return;
+    }
+    m_dynamic_resolution.computeSceneViewport(*swapchain_info.viewport, RenderPass::m_scene_viewport, RenderPass::m_scene_scissor);
+}
 void RenderPipelineBase::initializeUIRenderBackend(WindowUI* window_ui) {
     m_ui_pass->initializeUIRenderBackend(window_ui);
 }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "runtime/core/math/vector2.h"
+#include "runtime/function/render/dynamic_resolution.h"
 #include "runtime/function/render/render_pass_base.h"
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -13,6 +16,10 @@ class WindowUI;
 
 struct RenderPipelineInitInfo {
     bool                                enable_fxaa {false};
+    bool                                enable_tone_mapping {true};
+    bool                                enable_color_grading {true};
+    bool                                enable_vignette {true};
+    DynamicResolutionConfig             dynamic_resolution;
     std::shared_ptr<RenderResourceBase> render_resource;
 };
 
@@ -31,18 +38,25 @@ public:
     virtual void deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
 
     void             initializeUIRenderBackend(WindowUI* window_ui);
-    virtual uint32_t getGuidOfPickedMesh(const Vector2 &picked_uv) = 0;
+    virtual void     requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked) = 0;
 
 protected:
+    // 优先使用 GPU timestamp 读回的帧耗时，不支持时以相邻两帧等到 fence 的间隔作为帧耗时，交给动态分辨率的控制器
+    void sampleFrameTime();
+    // 由控制器当前的比例更新场景 subpass 使用的 viewport
+    void updateSceneViewport();
+
     std::shared_ptr<RHI> m_rhi;
 
+    DynamicResolutionController           m_dynamic_resolution;
+    std::chrono::steady_clock::time_point m_last_frame_time_point;
+    bool                                  m_has_last_frame_time_point {false};
+
     std::shared_ptr<RenderPassBase> m_directional_light_pass;
     std::shared_ptr<RenderPassBase> m_point_light_shadow_pass;
     std::shared_ptr<RenderPassBase> m_main_camera_pass;
-    std::shared_ptr<RenderPassBase> m_color_grading_pass;
-    std::shared_ptr<RenderPassBase> m_vignette_pass;
+    std::shared_ptr<RenderPassBase> m_post_process_pass;
     std::shared_ptr<RenderPassBase> m_fxaa_pass;
-    std::shared_ptr<RenderPassBase> m_tone_mapping_pass;
     std::shared_ptr<RenderPassBase> m_ui_pass;
     std::shared_ptr<RenderPassBase> m_combine_ui_pass;
     std::shared_ptr<RenderPassBase> m_pick_pass;
@@ -11,9 +11,25 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace Piccolo {
+// the global upload ring buffer starts with this many bytes per frame in flight and grows on demand
+static constexpr uint32_t s_global_upload_ringbuffer_initial_frame_size = 1024 * 1024 * 16;
+static constexpr uint32_t s_global_upload_ringbuffer_max_frame_size     = 1024 * 1024 * 512;
+// number of consecutive frames with less than a quarter of the slice used before the ring buffer shrinks
+static constexpr uint32_t s_global_upload_ringbuffer_shrink_frame_count = 600;
+// the bindless material buffer doubles whenever it is full
+static constexpr uint32_t s_bindless_material_initial_capacity = 256;
+
+static uint32_t nextPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result < (1u << 31))
+        result <<= 1;
+    return result;
+}
+
 void RenderResource::clear() {
 }
 
@@ -377,10 +393,21 @@ VulkanPBRMaterial &RenderResource::getOrCreateVulkanMaterial(std::shared_ptr<RHI
 
         VulkanPBRMaterial &now_material = res.first->second;
 
+        MeshPerMaterialUniformBufferObject material_factors;
+        material_factors.is_blend          = entity.m_blend;
+        material_factors.is_double_sided   = entity.m_double_sided;
+        material_factors.baseColorFactor   = entity.m_base_color_factor;
+        material_factors.metallicFactor    = entity.m_metallic_factor;
+        material_factors.roughnessFactor   = entity.m_roughness_factor;
+        material_factors.normalScale       = entity.m_normal_scale;
+        material_factors.occlusionStrength = entity.m_occlusion_strength;
+        material_factors.emissiveFactor    = entity.m_emissive_factor;
+
         // similiarly to the vertex/index buffer, we should allocate the uniform
         // buffer in DEVICE_LOCAL memory and use the temp stage buffer to copy the
         // data
-        {
+        // bindless materials keep their parameters in the shared material buffer instead
+        if (!rhi->isBindlessMaterialEnabled()) {
             // temporary staging buffer
 
             RHIDeviceSize buffer_size = sizeof(MeshPerMaterialUniformBufferObject);
@@ -404,16 +431,7 @@ VulkanPBRMaterial &RenderResource::getOrCreateVulkanMaterial(std::shared_ptr<RHI
                 0,
                 &staging_buffer_data);
 
-            MeshPerMaterialUniformBufferObject &material_uniform_buffer_info =
-                (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_buffer_data));
-            material_uniform_buffer_info.is_blend = entity.m_blend;
-            material_uniform_buffer_info.is_double_sided = entity.m_double_sided;
-            material_uniform_buffer_info.baseColorFactor = entity.m_base_color_factor;
-            material_uniform_buffer_info.metallicFactor = entity.m_metallic_factor;
-            material_uniform_buffer_info.roughnessFactor = entity.m_roughness_factor;
-            material_uniform_buffer_info.normalScale = entity.m_normal_scale;
-            material_uniform_buffer_info.occlusionStrength = entity.m_occlusion_strength;
-            material_uniform_buffer_info.emissiveFactor = entity.m_emissive_factor;
+            (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_buffer_data)) = material_factors;
 
             rhi->unmapMemory(inefficient_staging_buffer_memory);
 
@@ -467,6 +485,31 @@ VulkanPBRMaterial &RenderResource::getOrCreateVulkanMaterial(std::shared_ptr<RHI
 
         updateTextureImageData(rhi, update_texture_data);
 
+        if (rhi->isBindlessMaterialEnabled()) {
+            MeshBindlessMaterialStorageBufferObject bindless_material;
+            bindless_material.factors = material_factors;
+            bindless_material.base_color_texture_index = registerBindlessTexture(
+                rhi, now_material.base_color_image_view,
+                rhi->getOrCreateMipmapSampler(base_color_image_width, base_color_image_height));
+            bindless_material.metallic_roughness_texture_index = registerBindlessTexture(
+                rhi, now_material.metallic_roughness_image_view,
+                rhi->getOrCreateMipmapSampler(metallic_roughness_width, metallic_roughness_height));
+            bindless_material.normal_texture_index = registerBindlessTexture(
+                rhi, now_material.normal_image_view,
+                rhi->getOrCreateMipmapSampler(normal_roughness_width, normal_roughness_height));
+            bindless_material.occlusion_texture_index = registerBindlessTexture(
+                rhi, now_material.occlusion_image_view,
+                rhi->getOrCreateMipmapSampler(occlusion_image_width, occlusion_image_height));
+            bindless_material.emissive_texture_index = registerBindlessTexture(
+                rhi, now_material.emissive_image_view,
+                rhi->getOrCreateMipmapSampler(emissive_image_width, emissive_image_height));
+
+            now_material.material_uniform_buffer = RHI_NULL_HANDLE;
+            now_material.material_descriptor_set = RHI_NULL_HANDLE;
+            now_material.bindless_material_index = registerBindlessMaterial(rhi, bindless_material);
+            return now_material;
+        }
+
         RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
         material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         material_descriptor_set_alloc_info.pNext = NULL;
@@ -1075,15 +1118,125 @@ VulkanPBRMaterial &RenderResource::getEntityMaterial(RenderEntity entity) {
         throw std::runtime_error("failed to get entity material");
 }
 
-void RenderResource::resetRingBufferOffset(uint8_t current_frame_index) {
-    m_global_render_resource._storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
-        m_global_render_resource._storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
+bool RenderResource::resetRingBufferOffset(std::shared_ptr<RHI> rhi, uint8_t current_frame_index) {
+    StorageBuffer &_storage_buffer = m_global_render_resource._storage_buffer;
+
+    // the slice still holds what this frame index used the last time round
+    uint32_t frame_usage = _storage_buffer._global_upload_ringbuffers_end[current_frame_index] -
+                           _storage_buffer._global_upload_ringbuffers_begin[current_frame_index] +
+                           _storage_buffer._global_upload_ringbuffers_overflow[current_frame_index];
+    uint32_t frame_capacity = _storage_buffer._global_upload_ringbuffers_size[current_frame_index];
+
+    m_ring_buffer_statistics.last_frame_usage = frame_usage;
+    m_ring_buffer_statistics.high_water_mark  = std::max(m_ring_buffer_statistics.high_water_mark, frame_usage);
+    if (_storage_buffer._global_upload_ringbuffers_overflow[current_frame_index] > 0)
+        ++m_ring_buffer_statistics.overflow_frame_count;
+
+    _storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
+        _storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
+    _storage_buffer._global_upload_ringbuffers_overflow[current_frame_index] = 0;
+
+    // the other slices still hold the usage of the frames recorded after this one
+    uint32_t peak_usage = frame_usage;
+    for (size_t i = 0; i < _storage_buffer._global_upload_ringbuffers_size.size(); ++i) {
+        if (i == current_frame_index)
+            continue;
+        peak_usage = std::max(peak_usage,
+                              _storage_buffer._global_upload_ringbuffers_end[i] -
+                                  _storage_buffer._global_upload_ringbuffers_begin[i] +
+                                  _storage_buffer._global_upload_ringbuffers_overflow[i]);
+    }
+
+    // grow as soon as a frame comes close to its slice, so that at most one frame loses draw calls
+    if (peak_usage > frame_capacity - frame_capacity / 8) {
+        uint32_t new_frame_capacity = std::min(nextPowerOfTwo(peak_usage + peak_usage / 2),
+                                               s_global_upload_ringbuffer_max_frame_size);
+        if (new_frame_capacity <= frame_capacity) {
+            if (frame_usage > frame_capacity)
+                LOG_ERROR("global upload ring buffer exhausted, {} bytes requested in one frame", frame_usage);
+            return false;
+        }
+
+        recreateRingBuffer(rhi, new_frame_capacity);
+        ++m_ring_buffer_statistics.grow_count;
+        LOG_INFO("global upload ring buffer grown to {} bytes per frame, peak frame usage {} bytes",
+                 new_frame_capacity,
+                 peak_usage);
+        return true;
+    }
+
+    // give memory back only after usage stayed low for a while, to avoid bouncing between two sizes
+    std::vector<uint32_t> &frame_high_water_marks = m_ring_buffer_statistics.frame_high_water_marks;
+    if (frame_capacity > s_global_upload_ringbuffer_initial_frame_size && frame_usage < frame_capacity / 4) {
+        frame_high_water_marks[current_frame_index] = std::max(frame_high_water_marks[current_frame_index], frame_usage);
+        if (++m_ring_buffer_low_usage_frame_count < s_global_upload_ringbuffer_shrink_frame_count)
+            return false;
+
+        // every slice gets the same size, so the busiest slice decides
+        uint32_t window_peak = *std::max_element(frame_high_water_marks.begin(), frame_high_water_marks.end());
+        uint32_t new_frame_capacity = std::max(nextPowerOfTwo(window_peak * 2),
+                                               s_global_upload_ringbuffer_initial_frame_size);
+        recreateRingBuffer(rhi, new_frame_capacity);
+        ++m_ring_buffer_statistics.shrink_count;
+        LOG_INFO("global upload ring buffer shrunk to {} bytes per frame, peak frame usage {} bytes",
+                 new_frame_capacity,
+                 window_peak);
+        return true;
+    }
+
+    m_ring_buffer_low_usage_frame_count = 0;
+    std::fill(frame_high_water_marks.begin(), frame_high_water_marks.end(), 0);
+    return false;
+}
+
+void RenderResource::createAndMapRingBuffer(std::shared_ptr<RHI> rhi, uint32_t frame_size) {
+    StorageBuffer &_storage_buffer  = m_global_render_resource._storage_buffer;
+    uint32_t       frames_in_flight = rhi->getMaxFramesInFlight();
+
+    // every frame in flight owns an equally sized slice, the dynamic offsets are relative to the whole buffer
+    frame_size = roundUp(frame_size, _storage_buffer._min_storage_buffer_offset_alignment);
+    rhi->createBuffer(frame_size * frames_in_flight,
+                      RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                      RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      _storage_buffer._global_upload_ringbuffer,
+                      _storage_buffer._global_upload_ringbuffer_memory);
+
+    rhi->mapMemory(_storage_buffer._global_upload_ringbuffer_memory,
+                   0,
+                   RHI_WHOLE_SIZE,
+                   0,
+                   &_storage_buffer._global_upload_ringbuffer_memory_pointer);
+
+    _storage_buffer._global_upload_ringbuffers_begin.resize(frames_in_flight);
+    _storage_buffer._global_upload_ringbuffers_end.resize(frames_in_flight);
+    _storage_buffer._global_upload_ringbuffers_size.resize(frames_in_flight);
+    _storage_buffer._global_upload_ringbuffers_overflow.assign(frames_in_flight, 0);
+    for (uint32_t i = 0; i < frames_in_flight; ++i) {
+        _storage_buffer._global_upload_ringbuffers_begin[i] = frame_size * i;
+        _storage_buffer._global_upload_ringbuffers_end[i]   = frame_size * i;
+        _storage_buffer._global_upload_ringbuffers_size[i]  = frame_size;
+    }
+
+    m_ring_buffer_statistics.frame_capacity = frame_size;
+    m_ring_buffer_statistics.frame_high_water_marks.assign(frames_in_flight, 0);
+    m_ring_buffer_low_usage_frame_count = 0;
+}
+
+void RenderResource::recreateRingBuffer(std::shared_ptr<RHI> rhi, uint32_t frame_size) {
+    StorageBuffer &_storage_buffer = m_global_render_resource._storage_buffer;
+
+    // every slice may still be read by a frame in flight
+    rhi->waitForFencesPFN(rhi->getMaxFramesInFlight(), rhi->getFenceList(), RHI_TRUE, UINT64_MAX);
+
+    rhi->unmapMemory(_storage_buffer._global_upload_ringbuffer_memory);
+    rhi->destroyBuffer(_storage_buffer._global_upload_ringbuffer);
+    rhi->freeMemory(_storage_buffer._global_upload_ringbuffer_memory);
+
+    createAndMapRingBuffer(rhi, frame_size);
 }
 
 void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi) {
-    VulkanRHI* raw_rhi = static_cast<VulkanRHI*>(rhi.get());
     StorageBuffer &_storage_buffer = m_global_render_resource._storage_buffer;
-    uint32_t       frames_in_flight = raw_rhi->k_max_frames_in_flight;
 
     RHIPhysicalDeviceProperties properties;
     rhi->getPhysicalDeviceProperties(&properties);
@@ -1096,24 +1249,8 @@ void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi) {
     _storage_buffer._non_coherent_atom_size = properties.limits.nonCoherentAtomSize;
 
     // In Vulkan, the storage buffer should be pre-allocated.
-    // The size is 128MB in NVIDIA D3D11
-    // driver(https://developer.nvidia.com/content/constant-buffers-without-constant-pain-0).
-    uint32_t global_storage_buffer_size = 1024 * 1024 * 128;
-    rhi->createBuffer(global_storage_buffer_size,
-                      RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                      RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                      _storage_buffer._global_upload_ringbuffer,
-                      _storage_buffer._global_upload_ringbuffer_memory);
-
-    _storage_buffer._global_upload_ringbuffers_begin.resize(frames_in_flight);
-    _storage_buffer._global_upload_ringbuffers_end.resize(frames_in_flight);
-    _storage_buffer._global_upload_ringbuffers_size.resize(frames_in_flight);
-    for (uint32_t i = 0; i < frames_in_flight; ++i) {
-        _storage_buffer._global_upload_ringbuffers_begin[i] = (global_storage_buffer_size * i) / frames_in_flight;
-        _storage_buffer._global_upload_ringbuffers_size[i] =
-            (global_storage_buffer_size * (i + 1)) / frames_in_flight -
-            (global_storage_buffer_size * i) / frames_in_flight;
-    }
+    // It starts small and is resized in resetRingBufferOffset according to the measured per frame usage.
+    createAndMapRingBuffer(rhi, s_global_upload_ringbuffer_initial_frame_size);
 
     // axis
     rhi->createBuffer(sizeof(AxisStorageBufferObject),
@@ -1130,18 +1267,144 @@ void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi) {
                       _storage_buffer._global_null_descriptor_storage_buffer_memory);
 
     // TODO: Unmap when program terminates
-    rhi->mapMemory(_storage_buffer._global_upload_ringbuffer_memory,
+    rhi->mapMemory(_storage_buffer._axis_inefficient_storage_buffer_memory,
                    0,
                    RHI_WHOLE_SIZE,
                    0,
-                   &_storage_buffer._global_upload_ringbuffer_memory_pointer);
+                   &_storage_buffer._axis_inefficient_storage_buffer_memory_pointer);
 
-    rhi->mapMemory(_storage_buffer._axis_inefficient_storage_buffer_memory,
+    static_assert(64 >= sizeof(MeshVertex::VulkanMeshVertexJointBinding), "");
+}
+void RenderResource::createBindlessMaterialResource(std::shared_ptr<RHI> rhi) {
+    BindlessMaterialResource &bindless_material_resource = m_global_render_resource._bindless_material_resource;
+    bindless_material_resource._texture_capacity         = rhi->getMaxBindlessTextureCount();
+
+    // update-after-bind sets have to come from a pool created with the matching flag
+    RHIDescriptorPoolSize pool_sizes[2];
+    pool_sizes[0].type            = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_sizes[0].descriptorCount = 1;
+    pool_sizes[1].type            = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pool_sizes[1].descriptorCount = bindless_material_resource._texture_capacity;
+
+    RHIDescriptorPoolCreateInfo pool_info {};
+    pool_info.sType         = RHI_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.pNext         = NULL;
+    pool_info.flags         = RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_info.maxSets       = 1;
+    pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
+    pool_info.pPoolSizes    = pool_sizes;
+
+    if (RHI_SUCCESS != rhi->createDescriptorPool(&pool_info, bindless_material_resource._descriptor_pool))
+        throw std::runtime_error("create bindless material descriptor pool");
+
+    RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
+    material_descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    material_descriptor_set_alloc_info.pNext              = NULL;
+    material_descriptor_set_alloc_info.descriptorPool     = bindless_material_resource._descriptor_pool;
+    material_descriptor_set_alloc_info.descriptorSetCount = 1;
+    material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
+
+    if (RHI_SUCCESS != rhi->allocateDescriptorSets(&material_descriptor_set_alloc_info,
+                                                   bindless_material_resource._descriptor_set))
+        throw std::runtime_error("allocate bindless material descriptor set");
+
+    createBindlessMaterialBuffer(rhi, s_bindless_material_initial_capacity);
+}
+
+void RenderResource::createBindlessMaterialBuffer(std::shared_ptr<RHI> rhi, uint32_t material_capacity) {
+    BindlessMaterialResource &bindless_material_resource = m_global_render_resource._bindless_material_resource;
+
+    RHIBuffer*       old_material_buffer                = bindless_material_resource._material_buffer;
+    RHIDeviceMemory* old_material_buffer_memory         = bindless_material_resource._material_buffer_memory;
+    void*            old_material_buffer_memory_pointer = bindless_material_resource._material_buffer_memory_pointer;
+
+    RHIDeviceSize buffer_size = sizeof(MeshBindlessMaterialStorageBufferObject) * material_capacity;
+    rhi->createBuffer(buffer_size,
+                      RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                      RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      bindless_material_resource._material_buffer,
+                      bindless_material_resource._material_buffer_memory);
+    rhi->mapMemory(bindless_material_resource._material_buffer_memory,
                    0,
                    RHI_WHOLE_SIZE,
                    0,
-                   &_storage_buffer._axis_inefficient_storage_buffer_memory_pointer);
+                   &bindless_material_resource._material_buffer_memory_pointer);
 
-    static_assert(64 >= sizeof(MeshVertex::VulkanMeshVertexJointBinding), "");
+    if (old_material_buffer != RHI_NULL_HANDLE) {
+        memcpy(bindless_material_resource._material_buffer_memory_pointer,
+               old_material_buffer_memory_pointer,
+               sizeof(MeshBindlessMaterialStorageBufferObject) * bindless_material_resource._material_count);
+
+        // the material buffer binding is not update-after-bind, the frames in flight must be done with it
+        rhi->waitForFencesPFN(rhi->getMaxFramesInFlight(), rhi->getFenceList(), RHI_TRUE, UINT64_MAX);
+
+        rhi->unmapMemory(old_material_buffer_memory);
+        rhi->destroyBuffer(old_material_buffer);
+        rhi->freeMemory(old_material_buffer_memory);
+    }
+    bindless_material_resource._material_capacity = material_capacity;
+
+    RHIDescriptorBufferInfo material_buffer_info = {};
+    material_buffer_info.offset = 0;
+    material_buffer_info.range  = buffer_size;
+    material_buffer_info.buffer = bindless_material_resource._material_buffer;
+
+    RHIWriteDescriptorSet material_buffer_write_info;
+    material_buffer_write_info.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    material_buffer_write_info.pNext           = NULL;
+    material_buffer_write_info.dstSet          = bindless_material_resource._descriptor_set;
+    material_buffer_write_info.dstBinding      = 0;
+    material_buffer_write_info.dstArrayElement = 0;
+    material_buffer_write_info.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    material_buffer_write_info.descriptorCount = 1;
+    material_buffer_write_info.pBufferInfo     = &material_buffer_info;
+
+    rhi->updateDescriptorSets(1, &material_buffer_write_info, 0, nullptr);
+}
+
+uint32_t RenderResource::registerBindlessTexture(std::shared_ptr<RHI> rhi, RHIImageView* image_view, RHISampler* sampler) {
+    BindlessMaterialResource &bindless_material_resource = m_global_render_resource._bindless_material_resource;
+    if (bindless_material_resource._descriptor_set == RHI_NULL_HANDLE)
+        createBindlessMaterialResource(rhi);
+
+    if (bindless_material_resource._texture_count >= bindless_material_resource._texture_capacity) {
+        LOG_ERROR("bindless texture array is full ({} textures)", bindless_material_resource._texture_capacity);
+        return 0;
+    }
+
+    RHIDescriptorImageInfo image_info = {};
+    image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    image_info.imageView   = image_view;
+    image_info.sampler     = sampler;
+
+    // the new slot is not read by any frame in flight, which update-unused-while-pending allows
+    RHIWriteDescriptorSet texture_write_info;
+    texture_write_info.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    texture_write_info.pNext           = NULL;
+    texture_write_info.dstSet          = bindless_material_resource._descriptor_set;
+    texture_write_info.dstBinding      = 1;
+    texture_write_info.dstArrayElement = bindless_material_resource._texture_count;
+    texture_write_info.descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    texture_write_info.descriptorCount = 1;
+    texture_write_info.pImageInfo      = &image_info;
+
+    rhi->updateDescriptorSets(1, &texture_write_info, 0, nullptr);
+
+    return bindless_material_resource._texture_count++;
+}
+
+uint32_t RenderResource::registerBindlessMaterial(std::shared_ptr<RHI>                           rhi,
+                                                  const MeshBindlessMaterialStorageBufferObject &material) {
+    BindlessMaterialResource &bindless_material_resource = m_global_render_resource._bindless_material_resource;
+    if (bindless_material_resource._descriptor_set == RHI_NULL_HANDLE)
+        createBindlessMaterialResource(rhi);
+
+    if (bindless_material_resource._material_count == bindless_material_resource._material_capacity)
+        createBindlessMaterialBuffer(rhi, bindless_material_resource._material_capacity * 2);
+
+    static_cast<MeshBindlessMaterialStorageBufferObject*>(
+        bindless_material_resource._material_buffer_memory_pointer)[bindless_material_resource._material_count] = material;
+
+    return bindless_material_resource._material_count++;
 }
 } // namespace Piccolo
@@ -78,6 +78,7 @@ struct StorageBuffer {
     std::vector<uint32_t> _global_upload_ringbuffers_begin;
     std::vector<uint32_t> _global_upload_ringbuffers_end;
     std::vector<uint32_t> _global_upload_ringbuffers_size;
+    std::vector<uint32_t> _global_upload_ringbuffers_overflow; // bytes requested after the frame's slice was exhausted
 
     RHIBuffer* _global_null_descriptor_storage_buffer;
     RHIDeviceMemory* _global_null_descriptor_storage_buffer_memory;
@@ -88,10 +89,41 @@ struct StorageBuffer {
     void* _axis_inefficient_storage_buffer_memory_pointer;
 };
 
+// usage of the global upload ring buffer, sampled whenever a frame slice is recycled
+struct RingBufferStatistics {
+    uint32_t frame_capacity {0};      // size of each frame's slice
+    uint32_t last_frame_usage {0};    // including the bytes that did not fit
+    uint32_t high_water_mark {0};     // peak frame usage over all slices, kept across resizes
+    // peak usage of each frame-in-flight slice in the current shrink window, the window restarts
+    // on resize and whenever a frame uses more than a quarter of its slice
+    std::vector<uint32_t> frame_high_water_marks;
+    uint32_t overflow_frame_count {0};
+    uint32_t grow_count {0};
+    uint32_t shrink_count {0};
+};
+
+// every material lives in one descriptor set, only used when bindless materials are enabled
+struct BindlessMaterialResource {
+    RHIDescriptorPool* _descriptor_pool {nullptr};
+    RHIDescriptorSet*  _descriptor_set {nullptr};
+
+    // material parameters indexed by VulkanMeshInstance::material_index, grows on demand
+    RHIBuffer*       _material_buffer {nullptr};
+    RHIDeviceMemory* _material_buffer_memory {nullptr};
+    void*            _material_buffer_memory_pointer {nullptr};
+    uint32_t         _material_capacity {0};
+    uint32_t         _material_count {0};
+
+    // slots of the texture array in use, the array itself is sized from the device limits
+    uint32_t _texture_capacity {0};
+    uint32_t _texture_count {0};
+};
+
 struct GlobalRenderResource {
-    IBLResource          _ibl_resource;
-    ColorGradingResource _color_grading_resource;
-    StorageBuffer        _storage_buffer;
+    IBLResource              _ibl_resource;
+    ColorGradingResource     _color_grading_resource;
+    StorageBuffer            _storage_buffer;
+    BindlessMaterialResource _bindless_material_resource;
 };
 
 class RenderResource : public RenderResourceBase {
@@ -121,7 +153,11 @@ public:
 
     VulkanPBRMaterial &getEntityMaterial(RenderEntity entity);
 
-    void resetRingBufferOffset(uint8_t current_frame_index);
+    // recycle the frame's slice of the ring buffer, return true if the ring buffer was grown or shrunk
+    // and the descriptor sets referencing it need to be rewritten
+    bool resetRingBufferOffset(std::shared_ptr<RHI> rhi, uint8_t current_frame_index);
+
+    const RingBufferStatistics &getRingBufferStatistics() const { return m_ring_buffer_statistics; }
 
     // global rendering resource, include IBL data, global storage buffer
     GlobalRenderResource m_global_render_resource;
@@ -146,6 +182,8 @@ public:
 
 private:
     void createAndMapStorageBuffer(std::shared_ptr<RHI> rhi);
+    void createAndMapRingBuffer(std::shared_ptr<RHI> rhi, uint32_t frame_size);
+    void recreateRingBuffer(std::shared_ptr<RHI> rhi, uint32_t frame_size);
     void createIBLSamplers(std::shared_ptr<RHI> rhi);
     void createIBLTextures(std::shared_ptr<RHI>                        rhi,
                            std::array<std::shared_ptr<TextureData>, 6> irradiance_maps,
@@ -178,5 +216,13 @@ private:
                            void*                index_buffer_data,
                            VulkanMesh          &now_mesh);
     void updateTextureImageData(std::shared_ptr<RHI> rhi, const TextureDataToUpdate &texture_data);
+
+    void     createBindlessMaterialResource(std::shared_ptr<RHI> rhi);
+    void     createBindlessMaterialBuffer(std::shared_ptr<RHI> rhi, uint32_t material_capacity);
+    uint32_t registerBindlessTexture(std::shared_ptr<RHI> rhi, RHIImageView* image_view, RHISampler* sampler);
+    uint32_t registerBindlessMaterial(std::shared_ptr<RHI> rhi, const MeshBindlessMaterialStorageBufferObject &material);
+
+    RingBufferStatistics m_ring_buffer_statistics;
+    uint32_t             m_ring_buffer_low_usage_frame_count {0};
 };
 } // namespace Piccolo
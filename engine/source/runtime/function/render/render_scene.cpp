@@ -1,7 +1,11 @@
 #include "runtime/function/render/render_scene.h"
+
+#include "runtime/core/profiler/profiler.h"
+
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_type.h"
 
 namespace Piccolo {
 void RenderScene::clear() {
@@ -9,6 +13,8 @@ void RenderScene::clear() {
 
 void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                        std::shared_ptr<RenderCamera>   camera) {
+    PROFILE_SCOPE("RenderScene::updateVisibleObjects");
+
     updateVisibleObjectsDirectionalLight(render_resource, camera);
     updateVisibleObjectsPointLight(render_resource);
     updateVisibleObjectsMainCamera(render_resource, camera);
@@ -57,6 +63,7 @@ void RenderScene::deleteEntityByGObjectID(GObjectID go_id) {
             if (it->m_instance_id == find_guid) {
                 m_render_entities.erase(it);
                 m_instance_id_allocator.freeGuid(find_guid);
+                markRenderEntitiesDirty();
                 break;
             }
         }
@@ -67,6 +74,80 @@ void RenderScene::clearForLevelReloading() {
     m_instance_id_allocator.clear();
     m_mesh_object_id_map.clear();
     m_render_entities.clear();
+    markRenderEntitiesDirty();
+}
+
+void RenderScene::addMeshTriangleBVH(size_t mesh_asset_id, const StaticMeshData &mesh_data) {
+    if (!mesh_data.m_vertex_buffer || !mesh_data.m_index_buffer)
+        return;
+
+    const BufferData &vertex_buffer = *mesh_data.m_vertex_buffer;
+    const BufferData &index_buffer  = *mesh_data.m_index_buffer;
+    const MeshVertexDataDefinition* vertices = static_cast<const MeshVertexDataDefinition*>(vertex_buffer.m_data);
+    const uint16_t*                 indices  = static_cast<const uint16_t*>(index_buffer.m_data);
+    size_t vertex_count   = vertex_buffer.m_size / sizeof(MeshVertexDataDefinition);
+    size_t triangle_count = index_buffer.m_size / sizeof(uint16_t) / 3;
+
+    std::vector<Vector3> triangle_vertices;
+    triangle_vertices.reserve(triangle_count * 3);
+    for (size_t i = 0; i < triangle_count * 3; i += 3) {
+        if (indices[i] >= vertex_count || indices[i + 1] >= vertex_count || indices[i + 2] >= vertex_count)
+            continue;
+        for (size_t j = 0; j < 3; ++j) {
+            const MeshVertexDataDefinition &vertex = vertices[indices[i + j]];
+            triangle_vertices.emplace_back(vertex.x, vertex.y, vertex.z);
+        }
+    }
+    m_mesh_triangle_bvhs[mesh_asset_id].build(std::move(triangle_vertices));
+}
+
+void RenderScene::rebuildEntityBVH() {
+    std::vector<AxisAlignedBox> entity_bounds;
+    entity_bounds.reserve(m_render_entities.size());
+    for (const RenderEntity &entity : m_render_entities) {
+        BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
+                                             entity.m_bounding_box.getMaxCorner()};
+        BoundingBox world_bounding_box = BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
+        entity_bounds.emplace_back((world_bounding_box.min_bound + world_bounding_box.max_bound) * 0.5f,
+                                   (world_bounding_box.max_bound - world_bounding_box.min_bound) * 0.5f);
+    }
+    m_entity_bvh.build(entity_bounds);
+    m_is_entity_bvh_dirty = false;
+}
+
+uint32_t RenderScene::raycastMeshInstance(const Ray &ray, bool exact) {
+    if (m_is_entity_bvh_dirty)
+        rebuildEntityBVH();
+
+    auto intersectEntity = [&](uint32_t entity_index, float t_max, float &t) {
+        const RenderEntity &entity = m_render_entities[entity_index];
+
+        auto find_it = m_mesh_triangle_bvhs.find(entity.m_mesh_asset_id);
+        if (!exact || entity.m_enable_vertex_blending || find_it == m_mesh_triangle_bvhs.end() || find_it->second.empty()) {
+            // 场景 BVH 的叶节点只保证与节点的包围盒相交，这里再与实体自己的包围盒求交
+            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
+                                                 entity.m_bounding_box.getMaxCorner()};
+            Vector3 inv_direction(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+            BoundingBox world_bounding_box = BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
+            return RayIntersectsBox(
+                ray, inv_direction, world_bounding_box.min_bound, world_bounding_box.max_bound, t_max, t);
+        }
+
+        // 变换到模型空间，direction 不归一化，t 与世界空间一致
+        Matrix4x4 inverse_model_matrix = entity.m_model_matrix.inverse();
+        Vector4   local_origin         = inverse_model_matrix * Vector4(ray.origin, 1.0f);
+        Vector4   local_direction      = inverse_model_matrix * Vector4(ray.direction, 0.0f);
+        Ray       local_ray;
+        local_ray.origin    = Vector3(local_origin.x, local_origin.y, local_origin.z);
+        local_ray.direction = Vector3(local_direction.x, local_direction.y, local_direction.z);
+        return find_it->second.raycast(local_ray, t_max, t);
+    };
+
+    uint32_t hit_entity;
+    float    hit_t;
+    if (!m_entity_bvh.raycast(ray, intersectEntity, std::numeric_limits<float>::max(), hit_entity, hit_t))
+        return 0;
+    return m_render_entities[hit_entity].m_instance_id;
 }
 
 void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
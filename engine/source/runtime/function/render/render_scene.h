@@ -1,5 +1,7 @@
 #pragma once
 
+#include "runtime/core/math/bvh.h"
+
 #include "runtime/function/framework/object/object_id_allocator.h"
 
 #include "runtime/function/render/light.h"
@@ -54,6 +56,13 @@ public:
 
     void clearForLevelReloading();
 
+    // 修改 m_render_entities 之后调用，下一次 ray 拾取时重建场景 BVH
+    void markRenderEntitiesDirty() { m_is_entity_bvh_dirty = true; }
+    void addMeshTriangleBVH(size_t mesh_asset_id, const StaticMeshData &mesh_data);
+    // CPU ray 拾取，返回最近命中的 instance id，没有命中时返回 0
+    // exact 为 true 时与 mesh 的三角形求交，否则（以及蒙皮 mesh）只与世界空间包围盒求交
+    uint32_t raycastMeshInstance(const Ray &ray, bool exact);
+
 private:
     GuidAllocator<GameObjectPartId>   m_instance_id_allocator;
     GuidAllocator<MeshSourceDesc>     m_mesh_asset_id_allocator;
@@ -61,6 +70,13 @@ private:
 
     std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
 
+    BVH                                     m_entity_bvh;
+    bool                                    m_is_entity_bvh_dirty {true};
+    std::unordered_map<size_t, TriangleBVH> m_mesh_triangle_bvhs; // 模型空间中的三角形
+
+
+    void rebuildEntityBVH();
+
     void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
         std::shared_ptr<RenderCamera>   camera);
     void updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource);
@@ -1,6 +1,7 @@
 #include "runtime/function/render/render_system.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/config_manager/config_manager.h"
@@ -33,7 +34,9 @@ void RenderSystem::initialize(RenderSystemInitInfo init_info) {
 
     // render context initialize
     RHIInitInfo rhi_init_info;
-    rhi_init_info.window_system = init_info.window_system;
+    rhi_init_info.window_system            = init_info.window_system;
+    rhi_init_info.pipeline_cache_folder    = config_manager->getPipelineCacheFolder();
+    rhi_init_info.enable_bindless_material = config_manager->isBindlessMaterialEnabled();
 
     m_rhi = std::make_shared<VulkanRHI>();
     m_rhi->initialize(rhi_init_info);
@@ -73,8 +76,15 @@ void RenderSystem::initialize(RenderSystemInitInfo init_info) {
 
     // initialize render pipeline
     RenderPipelineInitInfo pipeline_init_info;
-    pipeline_init_info.enable_fxaa     = global_rendering_res.m_enable_fxaa;
-    pipeline_init_info.render_resource = m_render_resource;
+    pipeline_init_info.enable_fxaa          = global_rendering_res.m_enable_fxaa;
+    pipeline_init_info.enable_tone_mapping  = global_rendering_res.m_enable_tone_mapping;
+    pipeline_init_info.enable_color_grading = global_rendering_res.m_enable_color_grading;
+    pipeline_init_info.enable_vignette      = global_rendering_res.m_enable_vignette;
+    pipeline_init_info.render_resource      = m_render_resource;
+
+    pipeline_init_info.dynamic_resolution.enable            = global_rendering_res.m_enable_dynamic_resolution;
+    pipeline_init_info.dynamic_resolution.target_frame_time = global_rendering_res.m_dynamic_resolution_target_frame_time;
+    pipeline_init_info.dynamic_resolution.min_scale         = global_rendering_res.m_dynamic_resolution_min_scale;
 
     m_render_pipeline        = std::make_shared<RenderPipeline>();
     m_render_pipeline->m_rhi = m_rhi;
@@ -92,6 +102,8 @@ void RenderSystem::initialize(RenderSystemInitInfo init_info) {
 }
 
 void RenderSystem::tick(float delta_time) {
+    PROFILE_SCOPE("RenderSystem::tick");
+
     // process swap data between logic and render contexts. swap 其实并不准确，因为只是 render 从 logic 单方面拿数据
     processSwapData();
 
@@ -120,6 +132,10 @@ void RenderSystem::tick(float delta_time) {
 }
 
 void RenderSystem::clear() {
+    // pass 持有的 GPU 资源需要在 RHI 销毁之前释放
+    if (m_render_pipeline)
+        m_render_pipeline->clear();
+
     if (m_rhi)
         m_rhi->clear();
     m_rhi.reset();
@@ -132,8 +148,6 @@ void RenderSystem::clear() {
         m_render_resource->clear();
     m_render_resource.reset();
 
-    if (m_render_pipeline)
-        m_render_pipeline->clear();
     m_render_pipeline.reset();
 }
 
@@ -164,8 +178,22 @@ EngineContentViewport RenderSystem::getEngineContentViewport() const {
     return {x, y, width, height};
 }
 
-uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2 &picked_uv) {
-    return m_render_pipeline->getGuidOfPickedMesh(picked_uv);
+void RenderSystem::requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked) {
+    m_render_pipeline->requestGuidOfPickedMesh(picked_uv, std::move(on_picked));
+}
+
+uint32_t RenderSystem::getGuidOfRayPickedMesh(const Vector2 &picked_uv, bool exact) const {
+    // 与 pick pass 相同的 uv，y 轴向下
+    Vector2 fov                = m_render_camera->getFOV();
+    float   tan_half_fov_x     = Math::tan(Math::degreesToRadians(fov.x) * 0.5f);
+    float   tan_half_fov_y     = Math::tan(Math::degreesToRadians(fov.y) * 0.5f);
+    Vector2 screen_center_uv   = Vector2(picked_uv.x, 1.0f - picked_uv.y) * 2.0f - Vector2(1.0f, 1.0f);
+
+    Ray ray;
+    ray.origin    = m_render_camera->position();
+    ray.direction = m_render_camera->forward() + m_render_camera->right() * (screen_center_uv.x * tan_half_fov_x) +
+                    m_render_camera->up() * (screen_center_uv.y * tan_half_fov_y);
+    return m_render_scene->raycastMeshInstance(ray, exact);
 }
 
 GObjectID RenderSystem::getGObjectIDByMeshID(uint32_t mesh_id) const {
@@ -211,6 +239,8 @@ void RenderSystem::initializeUIRenderBackend(WindowUI* window_ui) {
 }
 
 void RenderSystem::processSwapData() {
+    PROFILE_SCOPE("RenderSystem::processSwapData");
+
     RenderSwapData &swap_data = m_swap_context.getRenderSwapData();
 
     std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -253,6 +283,8 @@ void RenderSystem::processSwapData() {
                     render_entity.m_bounding_box = m_render_resource->getCachedBoundingBox(mesh_source);
 
                 render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
+                if (!is_mesh_loaded)
+                    m_render_scene->addMeshTriangleBVH(render_entity.m_mesh_asset_id, mesh_data.m_static_mesh_data);
                 render_entity.m_enable_vertex_blending =
                     game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
                 render_entity.m_joint_matrices.resize(
@@ -298,6 +330,7 @@ void RenderSystem::processSwapData() {
                     m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
 
                 // add object to render scene if needed
+                m_render_scene->markRenderEntitiesDirty();
                 if (!is_entity_in_scene)
                     m_render_scene->m_render_entities.push_back(render_entity);
                 else {
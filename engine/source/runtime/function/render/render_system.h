@@ -6,6 +6,7 @@
 #include "runtime/function/render/render_type.h"
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -49,7 +50,9 @@ public:
     void      setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type);
     void      initializeUIRenderBackend(WindowUI* window_ui);
     void      updateEngineContentViewport(float offset_x, float offset_y, float width, float height);
-    uint32_t  getGuidOfPickedMesh(const Vector2 &picked_uv);
+    void      requestGuidOfPickedMesh(const Vector2 &picked_uv, std::function<void(uint32_t)> on_picked);
+    // 不经过 GPU 的拾取，立即返回，没有命中时返回 0
+    uint32_t  getGuidOfRayPickedMesh(const Vector2 &picked_uv, bool exact = true) const;
     GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
 
     EngineContentViewport getEngineContentViewport() const;
@@ -18,6 +18,7 @@ namespace Piccolo {
 #define RHI_UUID_SIZE                      16U
 #define RHI_MAX_MEMORY_HEAPS               16U
 #define RHI_SUBPASS_EXTERNAL               (~0U)
+#define RHI_ATTACHMENT_UNUSED              (~0U)
 #define RHI_QUEUE_FAMILY_IGNORED           (~0U)
 #define RHI_WHOLE_SIZE                     (~0ULL)
 #define RHI_NULL_HANDLE                       nullptr
@@ -1589,6 +1590,26 @@ enum RHIDependencyFlagBits {
     RHI_DEPENDENCY_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
 };
 
+enum RHIDescriptorPoolCreateFlagBits {
+    RHI_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT = 0x00000001,
+    RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT = 0x00000002,
+    RHI_DESCRIPTOR_POOL_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+};
+
+enum RHIDescriptorSetLayoutCreateFlagBits {
+    RHI_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR = 0x00000001,
+    RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT = 0x00000002,
+    RHI_DESCRIPTOR_SET_LAYOUT_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+};
+
+enum RHIDescriptorBindingFlagBits {
+    RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT = 0x00000001,
+    RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT = 0x00000002,
+    RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT = 0x00000004,
+    RHI_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT = 0x00000008,
+    RHI_DESCRIPTOR_BINDING_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+};
+
 typedef uint32_t RHIAccessFlags;
 typedef uint32_t RHIImageAspectFlags;
 typedef uint32_t RHIFormatFeatureFlags;
@@ -1636,6 +1657,7 @@ typedef uint32_t RHISamplerCreateFlags;
 typedef uint32_t RHIDescriptorPoolCreateFlags;
 typedef uint32_t RHIDescriptorPoolResetFlags;
 typedef uint32_t RHIDescriptorSetLayoutCreateFlags;
+typedef uint32_t RHIDescriptorBindingFlags;
 typedef uint32_t RHIAttachmentDescriptionFlags;
 typedef uint32_t RHIDependencyFlags;
 typedef uint32_t RHIFramebufferCreateFlags;
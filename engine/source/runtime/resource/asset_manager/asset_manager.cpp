@@ -7,6 +7,29 @@
 #include <filesystem>
 
 namespace Piccolo {
+bool AssetManager::loadAssetJson(const std::string &asset_url, Json &out_asset_json) const {
+    // read json file to string
+    std::filesystem::path asset_path = getFullPath(asset_url);
+    std::ifstream         asset_json_file(asset_path);
+    if (!asset_json_file) {
+        LOG_ERROR("open file: {} failed!", asset_path.generic_string());
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << asset_json_file.rdbuf();
+    std::string asset_json_text(buffer.str());
+
+    // parse to json object
+    std::string error;
+    out_asset_json = Json::parse(asset_json_text, error, JsonParse::COMMENTS);
+    if (!error.empty()) {
+        LOG_ERROR("parse json file {} failed!", asset_url);
+        return false;
+    }
+    return true;
+}
+
 std::filesystem::path AssetManager::getFullPath(const std::string &relative_path) const {
     return std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder() / relative_path);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/profiler/profiler.h"
 #include "runtime/core/meta/serializer/serializer.h"
 
 #include <filesystem>
@@ -16,30 +17,20 @@ class AssetManager {
 public:
     template<typename AssetType>
     bool loadAsset(const std::string &asset_url, AssetType &out_asset) const {
-        // read json file to string
-        std::filesystem::path asset_path = getFullPath(asset_url);
-        std::ifstream asset_json_file(asset_path);
-        if (!asset_json_file) {
-            LOG_ERROR("open file: {} failed!", asset_path.generic_string());
-            return false;
-        }
+        PROFILE_SCOPE("AssetManager::loadAsset");
 
-        std::stringstream buffer;
-        buffer << asset_json_file.rdbuf();
-        std::string asset_json_text(buffer.str());
-
-        // parse to json object and read to runtime res object
-        std::string error;
-        auto&& asset_json = Json::parse(asset_json_text, error, JsonParse::COMMENTS);
-        if (!error.empty()) {
-            LOG_ERROR("parse json file {} failed!", asset_url);
+        Json asset_json;
+        if (!loadAssetJson(asset_url, asset_json))
             return false;
-        }
 
+        // read to runtime res object
         Serializer::read(asset_json, out_asset);
         return true;
     }
 
+    // 只读取并解析 json，同一个 asset 需要实例化多次时，可以缓存结果后多次 Serializer::read
+    bool loadAssetJson(const std::string &asset_url, Json &out_asset_json) const;
+
     template<typename AssetType>
     bool saveAsset(const AssetType &out_asset, const std::string &asset_url) const {
         std::ofstream asset_json_file(getFullPath(asset_url));
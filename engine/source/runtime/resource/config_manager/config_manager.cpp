@@ -30,6 +30,16 @@ void ConfigManager::initialize(const std::filesystem::path &config_file_path) {
                 m_editor_small_icon_path = m_root_folder / value;
             else if (name == "FontFile")
                 m_editor_font_path = m_root_folder / value;
+            else if (name == "PipelineCacheFolder")
+                m_pipeline_cache_folder = m_root_folder / value;
+            else if (name == "EnableBindlessMaterial")
+                m_enable_bindless_material = value == "1" || value == "true";
+            else if (name == "EnableRenderThread")
+                m_enable_render_thread = value == "1" || value == "true";
+            else if (name == "LogicTickFrequency")
+                m_logic_tick_frequency = static_cast<uint32_t>(std::stoul(value));
+            else if (name == "MaxLogicTicksPerFrame")
+                m_max_logic_ticks_per_frame = static_cast<uint32_t>(std::stoul(value));
             else if (name == "GlobalRenderingRes")
                 m_global_rendering_res_url = value;
             else if (name == "GlobalParticleRes")
@@ -54,6 +64,16 @@ const std::filesystem::path &ConfigManager::getEditorSmallIconPath() const { ret
 
 const std::filesystem::path &ConfigManager::getEditorFontPath() const { return m_editor_font_path; }
 
+const std::filesystem::path &ConfigManager::getPipelineCacheFolder() const { return m_pipeline_cache_folder; }
+
+bool ConfigManager::isBindlessMaterialEnabled() const { return m_enable_bindless_material; }
+
+bool ConfigManager::isRenderThreadEnabled() const { return m_enable_render_thread; }
+
+uint32_t ConfigManager::getLogicTickFrequency() const { return m_logic_tick_frequency; }
+
+uint32_t ConfigManager::getMaxLogicTicksPerFrame() const { return m_max_logic_ticks_per_frame; }
+
 const std::string &ConfigManager::getDefaultWorldUrl() const { return m_default_world_url; }
 
 const std::string &ConfigManager::getGlobalRenderingResUrl() const { return m_global_rendering_res_url; }
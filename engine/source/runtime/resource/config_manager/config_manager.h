@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 
 namespace Piccolo {
@@ -15,6 +16,13 @@ public:
     const std::filesystem::path &getEditorBigIconPath() const;
     const std::filesystem::path &getEditorSmallIconPath() const;
     const std::filesystem::path &getEditorFontPath() const;
+    const std::filesystem::path &getPipelineCacheFolder() const;
+
+    bool isBindlessMaterialEnabled() const;
+    bool isRenderThreadEnabled() const;
+
+    uint32_t getLogicTickFrequency() const;
+    uint32_t getMaxLogicTicksPerFrame() const;
 
     #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     const std::filesystem::path &getJoltPhysicsAssetFolder() const;
@@ -31,6 +39,14 @@ private:
     std::filesystem::path m_editor_big_icon_path;
     std::filesystem::path m_editor_small_icon_path;
     std::filesystem::path m_editor_font_path;
+    std::filesystem::path m_pipeline_cache_folder;
+
+    bool m_enable_bindless_material {false};
+    bool m_enable_render_thread {false};
+
+    // 逻辑固定步长的频率，为 0 时每帧按帧时间 tick 一次
+    uint32_t m_logic_tick_frequency {0};
+    uint32_t m_max_logic_ticks_per_frame {1};
 
     #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     std::filesystem::path m_jolt_physics_asset_folder;
@@ -48,6 +48,12 @@ CLASS(GlobalRenderingRes, Fields) {
 
 public:
     bool                m_enable_fxaa {false};
+    bool                m_enable_tone_mapping {true};
+    bool                m_enable_color_grading {true};
+    bool                m_enable_vignette {true};
+    bool                m_enable_dynamic_resolution {false};
+    float               m_dynamic_resolution_target_frame_time {16.6f}; // ms
+    float               m_dynamic_resolution_min_scale {0.5f};
     SkyBoxIrradianceMap m_skybox_irradiance_map;
     SkyBoxSpecularMap   m_skybox_specular_map;
     std::string         m_brdf_map;
@@ -0,0 +1,169 @@
+#include "runtime/core/math/bvh.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+using namespace Piccolo;
+
+static int s_failure_count = 0;
+
+#define EXPECT_TRUE(expression)                                                         \
+    do {                                                                                \
+        if (!(expression)) {                                                            \
+            std::printf("%s:%d: expected %s\n", __FILE__, __LINE__, #expression);       \
+            ++s_failure_count;                                                          \
+        }                                                                               \
+    } while (false)
+
+#define EXPECT_NEAR(actual, expected)                                                   \
+    EXPECT_TRUE(std::fabs((actual) - (expected)) < 1e-4f)
+
+static const float k_no_limit = std::numeric_limits<float>::max();
+
+static Vector3 inverse(const Vector3 &direction) {
+    return Vector3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+}
+
+static void testRayIntersectsTriangle() {
+    const Vector3 v0(0.0f, 0.0f, 0.0f);
+    const Vector3 v1(1.0f, 0.0f, 0.0f);
+    const Vector3 v2(0.0f, 1.0f, 0.0f);
+
+    float t = -1.0f;
+
+    // 正面命中，t 以 direction 的长度为单位
+    Ray ray {Vector3(0.25f, 0.25f, 2.0f), Vector3(0.0f, 0.0f, -2.0f)};
+    EXPECT_TRUE(RayIntersectsTriangle(ray, v0, v1, v2, k_no_limit, t));
+    EXPECT_NEAR(t, 1.0f);
+
+    // 背面同样命中
+    ray = Ray {Vector3(0.25f, 0.25f, -1.0f), Vector3(0.0f, 0.0f, 1.0f)};
+    EXPECT_TRUE(RayIntersectsTriangle(ray, v0, v1, v2, k_no_limit, t));
+    EXPECT_NEAR(t, 1.0f);
+
+    // 三角形之外
+    ray = Ray {Vector3(0.75f, 0.75f, 1.0f), Vector3(0.0f, 0.0f, -1.0f)};
+    EXPECT_TRUE(!RayIntersectsTriangle(ray, v0, v1, v2, k_no_limit, t));
+
+    // 三角形在 ray 后方
+    ray = Ray {Vector3(0.25f, 0.25f, 1.0f), Vector3(0.0f, 0.0f, 1.0f)};
+    EXPECT_TRUE(!RayIntersectsTriangle(ray, v0, v1, v2, k_no_limit, t));
+
+    // 与三角形平行
+    ray = Ray {Vector3(-1.0f, 0.25f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)};
+    EXPECT_TRUE(!RayIntersectsTriangle(ray, v0, v1, v2, k_no_limit, t));
+
+    // t_max 之外不算命中，且不改写 t
+    ray = Ray {Vector3(0.25f, 0.25f, 2.0f), Vector3(0.0f, 0.0f, -1.0f)};
+    t   = -1.0f;
+    EXPECT_TRUE(!RayIntersectsTriangle(ray, v0, v1, v2, 2.0f, t));
+    EXPECT_NEAR(t, -1.0f);
+    EXPECT_TRUE(RayIntersectsTriangle(ray, v0, v1, v2, 2.5f, t));
+    EXPECT_NEAR(t, 2.0f);
+}
+
+static void testRayIntersectsBox() {
+    const AxisAlignedBox box(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 1.0f, 1.0f));
+
+    float t_enter = -1.0f;
+
+    Ray ray {Vector3(-3.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)};
+    EXPECT_TRUE(RayIntersectsBox(ray, inverse(ray.direction), box, k_no_limit, t_enter));
+    EXPECT_NEAR(t_enter, 2.0f);
+
+    // 起点在 box 内时从 0 开始
+    ray = Ray {Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)};
+    EXPECT_TRUE(RayIntersectsBox(ray, inverse(ray.direction), box, k_no_limit, t_enter));
+    EXPECT_NEAR(t_enter, 0.0f);
+
+    ray = Ray {Vector3(-3.0f, 2.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)};
+    EXPECT_TRUE(!RayIntersectsBox(ray, inverse(ray.direction), box, k_no_limit, t_enter));
+
+    ray = Ray {Vector3(-3.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f)};
+    EXPECT_TRUE(!RayIntersectsBox(ray, inverse(ray.direction), box, 1.5f, t_enter));
+}
+
+// 沿 x 轴排成一行的单位立方体，BVH 的结果应与逐个求交一致
+static void testBVHRaycastReturnsNearestPrimitive() {
+    std::vector<AxisAlignedBox> boxes;
+    for (int i = 0; i < 37; ++i)
+        boxes.emplace_back(Vector3(3.0f * i, 0.0f, 0.0f), Vector3(0.5f, 0.5f, 0.5f));
+
+    BVH bvh;
+    bvh.build(boxes);
+    EXPECT_TRUE(!bvh.empty());
+
+    auto intersectBox = [&](uint32_t index, float t_max, float &t) {
+        Ray ray {Vector3(100.0f, 0.0f, 0.0f), Vector3(-1.0f, 0.0f, 0.0f)};
+        return RayIntersectsBox(ray, inverse(ray.direction), boxes[index], t_max, t);
+    };
+
+    // 从 +x 方向射入，最近的是 x = 99 的第 33 个
+    Ray      ray {Vector3(100.0f, 0.0f, 0.0f), Vector3(-1.0f, 0.0f, 0.0f)};
+    uint32_t hit_primitive = 0;
+    float    hit_t         = 0.0f;
+    EXPECT_TRUE(bvh.raycast(ray, intersectBox, k_no_limit, hit_primitive, hit_t));
+    EXPECT_TRUE(hit_primitive == 33);
+    EXPECT_NEAR(hit_t, 0.5f);
+
+    // 从立方体之间穿过
+    auto intersectNothing = [&](uint32_t index, float t_max, float &t) {
+        Ray miss_ray {Vector3(1.5f, -5.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)};
+        return RayIntersectsBox(miss_ray, inverse(miss_ray.direction), boxes[index], t_max, t);
+    };
+    ray = Ray {Vector3(1.5f, -5.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)};
+    EXPECT_TRUE(!bvh.raycast(ray, intersectNothing, k_no_limit, hit_primitive, hit_t));
+
+    BVH empty_bvh;
+    empty_bvh.build({});
+    EXPECT_TRUE(empty_bvh.empty());
+    EXPECT_TRUE(!empty_bvh.raycast(ray, intersectNothing, k_no_limit, hit_primitive, hit_t));
+}
+
+// 中心在原点、边长为 2 的立方体，12 个三角形
+static void testTriangleBVHRaycast() {
+    const Vector3 corners[8] = {Vector3(-1, -1, -1), Vector3(1, -1, -1), Vector3(1, 1, -1), Vector3(-1, 1, -1),
+                                Vector3(-1, -1, 1),  Vector3(1, -1, 1),  Vector3(1, 1, 1),  Vector3(-1, 1, 1)};
+    const int     faces[6][4]  = {{0, 1, 2, 3}, {4, 5, 6, 7}, {0, 1, 5, 4}, {3, 2, 6, 7}, {0, 3, 7, 4}, {1, 2, 6, 5}};
+
+    std::vector<Vector3> triangle_vertices;
+    for (const auto &face : faces) {
+        for (int index : {face[0], face[1], face[2], face[0], face[2], face[3]})
+            triangle_vertices.push_back(corners[index]);
+    }
+
+    TriangleBVH bvh;
+    bvh.build(triangle_vertices);
+
+    float hit_t = 0.0f;
+    Ray   ray {Vector3(0.3f, 0.2f, 5.0f), Vector3(0.0f, 0.0f, -1.0f)};
+    EXPECT_TRUE(bvh.raycast(ray, k_no_limit, hit_t));
+    EXPECT_NEAR(hit_t, 4.0f);
+
+    // 从内部射出时命中远处的面
+    ray = Ray {Vector3(0.0f, 0.0f, 0.0f), Vector3(2.0f, 0.1f, 0.0f)};
+    EXPECT_TRUE(bvh.raycast(ray, k_no_limit, hit_t));
+    EXPECT_NEAR(hit_t, 0.5f);
+
+    ray = Ray {Vector3(3.0f, 3.0f, 5.0f), Vector3(0.0f, 0.0f, -1.0f)};
+    EXPECT_TRUE(!bvh.raycast(ray, k_no_limit, hit_t));
+
+    ray = Ray {Vector3(0.3f, 0.2f, 5.0f), Vector3(0.0f, 0.0f, -1.0f)};
+    EXPECT_TRUE(!bvh.raycast(ray, 3.5f, hit_t));
+}
+
+int main() {
+    testRayIntersectsTriangle();
+    testRayIntersectsBox();
+    testBVHRaycastReturnsNearestPrimitive();
+    testTriangleBVHRaycast();
+
+    if (s_failure_count > 0) {
+        std::printf("%d check(s) failed\n", s_failure_count);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}